@@ -0,0 +1,13 @@
+class BenchDispatch {
+	// the interpreter's dispatch cost: a counting loop of 10 bytecodes an iteration, all of them cheap. see: tests/benchDispatch.sh.
+	public static void main(String[] args) {
+		int n = 20000000;
+		int sum = 0;
+		long start = System.nanoTime();
+		for (int i = 0; i < n; i ++) {
+			sum += i & 7;
+		}
+		long ns = System.nanoTime() - start;
+		System.out.println("sum " + sum + ": " + (ns / 1000000) + " ms, " + (ns * 10 / n) + " ns/10 iterations.");
+	}
+}
@@ -0,0 +1,45 @@
+import java.util.*;
+
+// the identity hash must survive the gc moving the object. run with a small young generation, e.g.: -Xmx64m -Xmn4m Test19
+
+class Test19 {
+
+	static byte[][] garbage = new byte[16][];
+
+	static void churn() {		// about 32m: some minor gcs, and the survivors get promoted.
+		for (int i = 0; i < 32 * 1024; i ++) {
+			garbage[i & 15] = new byte[1024];
+		}
+	}
+
+	public static void main(String[] args) {
+		Object obj = new Object();
+		int hash = System.identityHashCode(obj);
+		int hashCode = obj.hashCode();
+		IdentityHashMap<Object, String> map = new IdentityHashMap<>();
+		map.put(obj, "obj");
+
+		boolean ok = (hash == hashCode);
+		for (int round = 0; round < 20; round ++) {
+			churn();
+			if (System.identityHashCode(obj) != hash || obj.hashCode() != hash || !"obj".equals(map.get(obj))) {
+				System.out.println("round " + round + ": the hash changed: " + hash + " -> " + System.identityHashCode(obj));
+				ok = false;
+			}
+		}
+
+		// an address is 8-aligned: the hashes of new objects are not all.
+		int aligned = 0;
+		for (int i = 0; i < 64; i ++) {
+			if ((System.identityHashCode(new Object()) & 7) == 0) {
+				aligned ++;
+			}
+		}
+		if (aligned == 64) {
+			System.out.println("the hashes are addresses.");
+			ok = false;
+		}
+
+		System.out.println(ok ? "ok" : "FAILED");
+	}
+}
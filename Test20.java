@@ -0,0 +1,69 @@
+import java.lang.ref.*;
+
+// the References: a WeakReference is cleared and enqueued by the gc, a SoftReference only goes before an OutOfMemoryError.
+// run with a small heap, e.g.: -Xmx64m -Xmn4m Test20
+
+class Test20 {
+
+	static class Node {
+		Node next;
+		byte[] data = new byte[64 * 1024];
+		Node(Node next) { this.next = next; }
+	}
+
+	static byte[][] garbage = new byte[16][];
+
+	static void churn() {		// about 8m: some minor gcs.
+		for (int i = 0; i < 8 * 1024; i ++) {
+			garbage[i & 15] = new byte[1024];
+		}
+	}
+
+	// the referents are only reachable from the References: no local of main() holds them.
+	static WeakReference<Object> newWeak(ReferenceQueue<Object> queue) {
+		return new WeakReference<Object>(new Object(), queue);
+	}
+
+	static SoftReference<byte[]> newSoft() {
+		return new SoftReference<byte[]>(new byte[1024 * 1024]);
+	}
+
+	public static void main(String[] args) {
+		boolean ok = true;
+
+		// 1. the weak one is cleared, and shows up in its queue. the soft one is in use: it survives the ordinary pauses.
+		ReferenceQueue<Object> queue = new ReferenceQueue<>();
+		WeakReference<Object> weak = newWeak(queue);
+		SoftReference<byte[]> soft = newSoft();
+		Reference<?> polled = null;
+		for (int round = 0; round < 100 && polled == null; round ++) {
+			churn();
+			polled = queue.poll();
+			if (soft.get() == null) {
+				System.out.println("round " + round + ": the SoftReference is cleared by an ordinary pause.");
+				ok = false;
+				break;
+			}
+		}
+		if (polled != weak || weak.get() != null) {
+			System.out.println("the WeakReference is not cleared and enqueued: " + polled + ", " + weak.get());
+			ok = false;
+		}
+
+		// 2. fill the heap: the soft one goes before the OutOfMemoryError.
+		Node list = null;
+		try {
+			while (true) {
+				list = new Node(list);
+			}
+		} catch (OutOfMemoryError e) {
+			list = null;		// room for the println()s.
+		}
+		if (soft.get() != null) {
+			System.out.println("the SoftReference is not cleared before the OutOfMemoryError.");
+			ok = false;
+		}
+
+		System.out.println(ok ? "ok" : "FAILED");
+	}
+}
@@ -2,6 +2,7 @@
 #define __CLASS_PARSER_H__
 
 #include <iostream>
+#include <cstdint>
 #include <unordered_map>
 #include <vector>
 #include <arpa/inet.h>
@@ -270,6 +271,27 @@ void print_methods(method_info *bufs, int length, cp_info **constant_pool);
 
 extern std::unordered_map<u1, std::pair<std::string, int>> bccode_map;
 
+// how many bytes the operands of each bytecode eat. the same as `bccode_map[bc].second`, but with no hashing at all.
+// (-1: tableswitch, -2: lookupswitch, -3: wide. their real length is computed by the interpreter.)
+constexpr int8_t bccode_length[256] = {
+	 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,		// 0x00 ~ 0x0f
+	 1,  2,  1,  2,  2,  1,  1,  1,  1,  1,  0,  0,  0,  0,  0,  0,		// 0x10 ~ 0x1f
+	 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,		// 0x20 ~ 0x2f
+	 0,  0,  0,  0,  0,  0,  1,  1,  1,  1,  1,  0,  0,  0,  0,  0,		// 0x30 ~ 0x3f
+	 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,		// 0x40 ~ 0x4f
+	 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,		// 0x50 ~ 0x5f
+	 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,		// 0x60 ~ 0x6f
+	 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,		// 0x70 ~ 0x7f
+	 0,  0,  0,  0,  2,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,		// 0x80 ~ 0x8f
+	 0,  0,  0,  0,  0,  0,  0,  0,  0,  2,  2,  2,  2,  2,  2,  2,		// 0x90 ~ 0x9f
+	 2,  2,  2,  2,  2,  2,  2,  2,  2,  1, -1, -2,  0,  0,  0,  0,		// 0xa0 ~ 0xaf
+	 0,  0,  2,  2,  2,  2,  2,  2,  2,  4,  4,  2,  1,  2,  0,  0,		// 0xb0 ~ 0xbf
+	 2,  2,  0,  0, -3,  3,  2,  2,  4,  4,  0,  1,  2,  2,  2,  2,		// 0xc0 ~ 0xcf
+	 2,  2,  2,  2,  2,  4,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,		// 0xd0 ~ 0xdf
+	 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,		// 0xe0 ~ 0xef
+	 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,		// 0xf0 ~ 0xff
+};
+
 int get_args_size (method_info *bufs, std::wstring & method_name, int i);
 
 void print_attributes(attribute_info *ptr, cp_info **constant_pool);
@@ -57,7 +57,24 @@ private:
 		return string_table;
 	}
 	static Oop *intern_to_oop(const wstring & str);
+	static int & value_offset() {		// of `value:[C` and `hash:I` in a String: read raw by the gc, which must not box them on the heap.
+		static int value_offset = -1;
+		return value_offset;
+	}
+	static int & hash_offset() {
+		static int hash_offset = -1;
+		return hash_offset;
+	}
+	static void init_offsets(InstanceOop *stringoop);
 public:
+	static TypeArrayOop * & value_of(InstanceOop *stringoop) {
+		if (value_offset() == -1)	init_offsets(stringoop);
+		return stringoop->field_at<TypeArrayOop *>(value_offset());
+	}
+	static int hash_of(InstanceOop *stringoop);		// the cached `hash`, computed and cached first if it's 0.
+	static int hash_of(TypeArrayOop *value);		// String.hashCode() of the chars.
+	static bool equals(TypeArrayOop *lhs, TypeArrayOop *rhs);
+
 	static wstring print_stringOop(InstanceOop *stringoop);
 	static wstring stringOop_to_wstring(InstanceOop *stringoop);
 	static inline __attribute__((always_inline)) Oop *intern(const wstring & str) {
@@ -79,6 +96,9 @@ public:
 #endif
 			return stringoop;
 		} else {
+			// the StringTable is weak: the found one may be unreachable at the beginning of the concurrent marking, and would be
+			// swept. logged as if it were overwritten, the marker keeps it alive.
+			Satb::pre_write_barrier(*iter);
 #ifdef STRING_DEBUG
 	sync_wcout{} << java_lang_string::print_stringOop((InstanceOop *)*iter) << " (return directly)" << std::endl;
 #endif
@@ -86,4 +86,9 @@ class vm_thread;
 
 void native_throw_Exception(InstanceKlass *excp_klass, vm_thread *thread, list<Oop *> & _stack, const std::wstring & msg);
 
+// for the natives which allocate as much as the java code asks for, like the allocation bytecodes: `alloc()` runs again
+// after a full gc if the heap is exhausted, so it must read the oops it needs from `Handle`s. if it still returns nullptr,
+// an OutOfMemoryError is thrown and nullptr returned.
+Oop *native_try_allocate(vm_thread *thread, list<Oop *> & _stack, const function<Oop *()> & alloc);
+
 #endif /* INCLUDE_NATIVE_NATIVE_HPP_ */
@@ -0,0 +1,24 @@
+/*
+ * sun_management_HotSpotDiagnostic.hpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#ifndef INCLUDE_NATIVE_SUN_MANAGEMENT_HOTSPOTDIAGNOSTIC_HPP_
+#define INCLUDE_NATIVE_SUN_MANAGEMENT_HOTSPOTDIAGNOSTIC_HPP_
+
+#include "runtime/oop.hpp"
+#include <list>
+
+using std::list;
+
+void JVM_DumpHeap(list<Oop *> & _stack);
+
+
+
+void *sun_management_hotSpotDiagnostic_search_method(const wstring & signature);
+
+
+
+
+#endif /* INCLUDE_NATIVE_SUN_MANAGEMENT_HOTSPOTDIAGNOSTIC_HPP_ */
@@ -13,6 +13,8 @@
 #include <memory>
 #include <string>
 #include <list>
+#include <cstdint>
+#include <cassert>
 #include "oop.hpp"
 
 using std::list;
@@ -33,17 +35,96 @@ using std::shared_ptr;
 class Method;
 class vm_thread;
 
+/**
+ * a raw interpreter slot. int/float/reference take one slot, and long/double take two slots (the value lives in the lower one) as the Spec says.
+ * the slots hold the values directly, so the interpreter needn't box primitives into `IntOop`s anymore.
+ */
+union Slot {
+	int32_t i;
+	float f;
+	int64_t l;
+	double d;
+	Oop *ref;
+	uint64_t raw;
+};
+
+enum SlotTag : uint8_t {		// gc uses it to tell reference slots from primitive slots.
+	SLOT_PRIMITIVE = 0,
+	SLOT_REFERENCE = 1,
+};
+
+struct OperandStack {		// sized by `max_stack`. slots and tags live in the thread's JavaStack.
+public:
+	Slot *slots = nullptr;
+	uint8_t *tags = nullptr;
+	int sp = 0;						// the next free slot.
+	int capacity = 0;
+public:
+	int size() { return sp; }
+	bool empty() { return sp == 0; }
+	void clear() { sp = 0; }
+	// reference
+	void push(Oop *ref) { assert(sp < capacity); slots[sp].ref = ref; tags[sp ++] = SLOT_REFERENCE; }
+	Oop *top() { assert(sp > 0 && tags[sp-1] == SLOT_REFERENCE); return slots[sp-1].ref; }
+	void pop() { assert(sp > 0); sp --; }			// pop only one slot.
+	Oop *pop_ref() { assert(sp > 0 && tags[sp-1] == SLOT_REFERENCE); return slots[-- sp].ref; }
+	// int (boolean, byte, char, short, int)
+	void push_int(int value) { assert(sp < capacity); slots[sp].raw = 0; slots[sp].i = value; tags[sp ++] = SLOT_PRIMITIVE; }
+	int top_int() { assert(sp > 0 && tags[sp-1] == SLOT_PRIMITIVE); return slots[sp-1].i; }
+	int pop_int() { assert(sp > 0 && tags[sp-1] == SLOT_PRIMITIVE); return slots[-- sp].i; }
+	// float
+	void push_float(float value) { assert(sp < capacity); slots[sp].raw = 0; slots[sp].f = value; tags[sp ++] = SLOT_PRIMITIVE; }
+	float top_float() { assert(sp > 0 && tags[sp-1] == SLOT_PRIMITIVE); return slots[sp-1].f; }
+	float pop_float() { assert(sp > 0 && tags[sp-1] == SLOT_PRIMITIVE); return slots[-- sp].f; }
+	// long
+	void push_long(long value) { assert(sp + 1 < capacity); slots[sp].l = value; slots[sp+1].raw = 0; tags[sp] = tags[sp+1] = SLOT_PRIMITIVE; sp += 2; }
+	long top_long() { assert(sp > 1); return slots[sp-2].l; }
+	long pop_long() { assert(sp > 1); sp -= 2; return slots[sp].l; }
+	// double
+	void push_double(double value) { assert(sp + 1 < capacity); slots[sp].d = value; slots[sp+1].raw = 0; tags[sp] = tags[sp+1] = SLOT_PRIMITIVE; sp += 2; }
+	double top_double() { assert(sp > 1); return slots[sp-2].d; }
+	double pop_double() { assert(sp > 1); sp -= 2; return slots[sp].d; }
+	// raw slot, for `dup` family and argument passing. `depth` 0 is the top.
+	Slot & peek(int depth) { assert(depth < sp); return slots[sp-1-depth]; }
+	uint8_t peek_tag(int depth) { assert(depth < sp); return tags[sp-1-depth]; }
+	void push_slot(Slot value, uint8_t tag) { assert(sp < capacity); slots[sp] = value; tags[sp ++] = tag; }
+};
+
+struct LocalVariableTable {		// sized by `max_locals`. slots and tags live in the thread's JavaStack.
+public:
+	Slot *slots = nullptr;
+	uint8_t *tags = nullptr;
+	int length = 0;
+public:
+	int size() { return length; }
+	bool is_ref(int index) { assert(index >= 0 && index < length); return tags[index] == SLOT_REFERENCE; }
+	Oop *get_ref(int index) { assert(index >= 0 && index < length && tags[index] == SLOT_REFERENCE); return slots[index].ref; }
+	int get_int(int index) { assert(index >= 0 && index < length && tags[index] == SLOT_PRIMITIVE); return slots[index].i; }
+	float get_float(int index) { assert(index >= 0 && index < length && tags[index] == SLOT_PRIMITIVE); return slots[index].f; }
+	long get_long(int index) { assert(index >= 0 && index + 1 < length); return slots[index].l; }
+	double get_double(int index) { assert(index >= 0 && index + 1 < length); return slots[index].d; }
+	void set_ref(int index, Oop *ref) { assert(index >= 0 && index < length); slots[index].ref = ref; tags[index] = SLOT_REFERENCE; }
+	void set_int(int index, int value) { assert(index >= 0 && index < length); slots[index].raw = 0; slots[index].i = value; tags[index] = SLOT_PRIMITIVE; }
+	void set_float(int index, float value) { assert(index >= 0 && index < length); slots[index].raw = 0; slots[index].f = value; tags[index] = SLOT_PRIMITIVE; }
+	void set_long(int index, long value) { assert(index >= 0 && index + 1 < length); slots[index].l = value; slots[index+1].raw = 0; tags[index] = tags[index+1] = SLOT_PRIMITIVE; }
+	void set_double(int index, double value) { assert(index >= 0 && index + 1 < length); slots[index].d = value; slots[index+1].raw = 0; tags[index] = tags[index+1] = SLOT_PRIMITIVE; }
+};
+
 struct StackFrame {		// Only a Bean class!
 public:
 	bool valid_frame = true;				// is this frame valid/used ?
-	stack<Oop *> op_stack;			// the inner opcode stack.		// ignore Method::max_stack_size...
-	vector<Oop *> localVariableTable;	// this StackFrame's lvt.		// ignore Method::max_local_size...
+	OperandStack op_stack;				// the inner opcode stack.
+	LocalVariableTable localVariableTable;	// this StackFrame's lvt.
 	Method *method;			// the method will be executed in this StackFrame.
 	uint8_t *return_pc;					// return_pc to return to the caller's code segment
-	StackFrame *prev;					// the caller's StackFrame	// the same as `rbp`
+	StackFrame *prev;					// the caller's StackFrame	// the same as `rbp`. if not nullptr, the return value is pushed onto its op_stack directly instead of being boxed.
+	StackFrame *link = nullptr;			// the frame below this one on the JavaStack, whether it is the caller or not.
+	Oop *monitor_obj = nullptr;			// the locked obj/mirror of a synchronized method. released on return or unwinding.
+	bool backup_switch = false;			// `sync_wcout::_switch()` of the caller, restored on return.
 	bool has_exception = false;
 public:
-	StackFrame(Method *method, uint8_t *return_pc, StackFrame *prev, const list<Oop *> & list, vm_thread *thread, bool is_native = false);
+	StackFrame(Method *method, uint8_t *return_pc, StackFrame *prev) : method(method), return_pc(return_pc), prev(prev) {}	// the slots are set by JavaStack.
+	StackFrame(const StackFrame &) = delete;		// lives in the JavaStack only.
 	bool is_valid() { return valid_frame; }
 	void set_invalid() { valid_frame = false; }
 	void clear_all();
@@ -52,7 +133,48 @@ public:
 	wstring print_arg_msg(Oop *value, vm_thread *thread);
 };
 
-class vm_thread;
+/**
+ * the interpreter stack of one thread: a contiguous region, followed by a guard page. frames are bump-allocated in it as:
+ *
+ *		[lvt][StackFrame][op_stack] [lvt][StackFrame][op_stack] ...
+ *
+ * a callee's lvt overlays the argument slots on the top of its caller's op_stack (the same as the hotspot interpreter),
+ * so an invocation needn't copy or allocate anything, and a frame is popped by resetting `last`.
+ * the slot tags live in a parallel region, `tags[i]` is the SlotTag of `slots[i]`.
+ */
+class JavaStack {
+public:
+	static const int RESERVED_SLOTS = 4 * 1024;			// the last slots, only for building the StackOverflowError.
+private:
+	Slot *slots = nullptr;
+	uint8_t *tags = nullptr;
+	int capacity = 0;					// slots, without the guard page.
+	size_t slots_bytes = 0;				// mmapped bytes of `slots`/`tags`, with the guard page.
+	size_t tags_bytes = 0;
+	StackFrame *last = nullptr;			// the top frame.
+	int frame_num = 0;
+	bool in_reserved_zone = false;
+private:
+	uint8_t *tag_of(Slot *slot) { return tags + (slot - slots); }
+	int limit() { return in_reserved_zone ? capacity : capacity - RESERVED_SLOTS; }
+	StackFrame *new_frame(Method *method, uint8_t *return_pc, StackFrame *prev, Slot *base, int max_locals, int max_stack, int limit);
+public:
+	void init(size_t stack_size);		// `-Xss`, in bytes.
+	void destroy();
+	bool empty() { return last == nullptr; }
+	int size() { return frame_num; }
+	StackFrame & back() { assert(last != nullptr); return *last; }
+	StackFrame *top_frame() { return last; }		// walk the frames from the top by `StackFrame::link`.
+	Slot *top() {		// the first free slot, above the last frame's op_stack.
+		assert(slots != nullptr);
+		return last == nullptr ? slots : last->op_stack.slots + last->op_stack.sp;
+	}
+	StackFrame & push_frame(Method *method, uint8_t *return_pc, StackFrame *prev, const list<Oop *> & args);	// unbox the args onto the top. used by the vm itself.
+	StackFrame *push_frame(Method *method, uint8_t *return_pc, StackFrame *prev, OperandStack & caller_stack, int arg_slot_num);	// the lvt overlays the args on `caller_stack`. nullptr if overflowed.
+	void pop_frame();
+	bool is_in_reserved_zone() { return in_reserved_zone; }
+	void set_in_reserved_zone(bool in) { in_reserved_zone = in; }
+};
 
 struct DebugTool {		// the debug tool can only display the target method's bytecode execution.
 	static bool & is_open();
@@ -72,6 +194,25 @@ struct DebugTool {		// the debug tool can only display the target method's bytec
 
 };
 
+/**
+ * private quickened bytecodes, in the reserved range after `breakpoint`.
+ * after the first successful resolution, the interpreter rewrites a bytecode in the method's code into its fast form.
+ * the operands are kept as is: the constant pool index also indexes the resolved entry in `rt_constant_pool::cache`.
+ */
+enum FastBytecode : uint8_t {
+	FAST_LDC = 0xcb,
+	FAST_LDC_W = 0xcc,
+	FAST_LDC2_W = 0xcd,
+	FAST_GETSTATIC = 0xce,		// only when the class has been initialized.
+	FAST_PUTSTATIC = 0xcf,		// only when the class has been initialized.
+	FAST_GETFIELD = 0xd0,
+	FAST_PUTFIELD = 0xd1,
+	FAST_INVOKEVIRTUAL = 0xd2,
+	FAST_INVOKESPECIAL = 0xd3,
+	FAST_INVOKESTATIC = 0xd4,	// only when the class has been initialized.
+	FAST_INVOKEINTERFACE = 0xd5,
+};
+
 struct BytecodeEngine {
 public:
 	static Oop * execute(vm_thread & thread, StackFrame & cur_frame, int thread_no);
@@ -88,12 +229,29 @@ private:		// for invokeDynamic
 	static InstanceOop *MethodType_make_impl(vector<MirrorOop *> & args, MirrorOop *ret, vm_thread & thread);
 	static InstanceOop *MethodHandles_Lookup_make(vm_thread & thread);
 private:
-	static void getField(Field_info *new_field, stack<Oop *> & op_stack);
-	static void getStatic(Field_info *new_field, stack<Oop *> & op_stack, vm_thread & thread);
-	static void putField(Field_info *new_field, stack<Oop *> & op_stack);
-	static void putStatic(Field_info *new_field, stack<Oop *> & op_stack, vm_thread & thread);
-	static void invokeStatic(Method *new_method, stack<Oop *> & op_stack, vm_thread & thread, StackFrame & cur_frame, uint8_t * & pc);	// invokeStatic and invokeSpecial
-	static void invokeVirtual(Method *new_method, stack<Oop *> & op_stack, vm_thread & thread, StackFrame & cur_frame, uint8_t * & pc);	// invokeVirtual and invokeInterface
+	static void getField(Field_info *new_field, OperandStack & op_stack);
+	static void getStatic(Field_info *new_field, OperandStack & op_stack, vm_thread & thread, bool check_clinit = true);
+	static void putField(Field_info *new_field, OperandStack & op_stack);
+	static void putStatic(Field_info *new_field, OperandStack & op_stack, vm_thread & thread, bool check_clinit = true);
+	// `bytecode` is the java bytecode (0xb6 ~ 0xb9): `*pc` may have been quickened by another thread.
+	// return the pushed frame of an interpreted target for `execute()` to switch to, or nullptr if the call is over already (native, banned or throwing).
+	static StackFrame *invokeStatic(Method *new_method, OperandStack & op_stack, vm_thread & thread, StackFrame & cur_frame, uint8_t * & pc, uint8_t bytecode, bool check_clinit = true);	// invokeStatic and invokeSpecial
+	static StackFrame *invokeVirtual(Method *new_method, OperandStack & op_stack, vm_thread & thread, StackFrame & cur_frame, uint8_t * & pc, uint8_t bytecode);	// invokeVirtual and invokeInterface
+	static bool is_static_initialized(Field_info *new_field);
+	static StackFrame *invokeInterpreted(Method *target_method, OperandStack & op_stack, vm_thread & thread, StackFrame & cur_frame, uint8_t * & pc, bool has_this, Oop *locked = nullptr);
+public:		// boxing only happens on the boundary: fields, arrays, natives and `vm_thread::add_frame_and_execute`.
+	static Oop *box_slot(OperandStack & op_stack, wchar_t kind);								// pop a value of `kind` and box it.
+	static void unbox_to_slot(OperandStack & op_stack, Oop *value, wchar_t kind);			// unbox `value` of `kind` and push it.
+	static void pop_args_boxed(OperandStack & op_stack, const vector<wchar_t> & kinds, list<Oop *> & arg_list);
+	static void box_args(LocalVariableTable & lvt, const vector<wchar_t> & kinds, bool has_this, list<Oop *> & arg_list);	// box the args in a native frame's lvt.
+	static void throw_stack_overflow(OperandStack & op_stack, vm_thread & thread, StackFrame & cur_frame, int arg_slot_num, Oop *locked = nullptr);	// `locked`: the monitor of a synchronized callee, left first.
+	static void throw_out_of_memory(OperandStack & op_stack, vm_thread & thread);		// push a new OutOfMemoryError.
+	static bool check_pending_out_of_memory(OperandStack & op_stack, vm_thread & thread);	// true if an OutOfMemoryError is pushed.
+	static bool & throwing_out_of_memory() {		// the OutOfMemoryError's constructor may allocate in the vm reserve too.
+		static thread_local bool throwing_out_of_memory = false;
+		return throwing_out_of_memory;
+	}
+	static wchar_t type_to_kind(Type type);
 };
 
 
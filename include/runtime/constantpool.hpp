@@ -14,6 +14,7 @@
 #include <boost/any.hpp>
 #include <cassert>
 #include <memory>
+#include "utils/lock.hpp"
 
 using std::vector;
 using std::pair;
@@ -23,6 +24,24 @@ using std::shared_ptr;
 class Klass;
 class InstanceKlass;
 class GC;
+class Oop;
+class Method;
+class Field_info;
+
+struct rt_cache_entry {		// the resolved entry which a quickened bytecode uses. indexed the same as the `pool`.
+	union {
+		Field_info *field;		// getfield/putfield/getstatic/putstatic
+		Method *method;			// invokevirtual/invokespecial/invokestatic/invokeinterface
+		Oop *oop;				// ldc String. gc will update it.
+		Klass *klass;			// ldc Class
+		int i;
+		float f;
+		long l;
+		double d;
+	};
+	int tag = 0;				// CONSTANT_xxx. 0 means not resolved yet.
+	rt_cache_entry() : l(0) {}
+};
 
 class rt_constant_pool {	// runtime constant pool
 	friend GC;
@@ -31,18 +50,24 @@ private:
 	int this_class_index;
 	cp_info **bufs;
 	vector<pair<int, boost::any>> pool;
+	vector<rt_cache_entry> cache;		// for the quickened bytecodes.
+	Lock quicken_lock;
 	ClassLoader *loader;
 private:
 	Klass *if_didnt_load_then_load(ClassLoader *loader, const wstring & name);
 public:
 	explicit rt_constant_pool(InstanceKlass *this_class, ClassLoader *loader, ClassFile *cf)
-			: this_class(this_class), loader(loader), this_class_index(cf->this_class), bufs(cf->constant_pool), pool(cf->constant_pool_count-1, std::make_pair(0, boost::any())) {}	// 别忘了 -1 啊！！！！		// bufs 前边加上 const 竟然会报错 ???
+			: this_class(this_class), loader(loader), this_class_index(cf->this_class), bufs(cf->constant_pool), pool(cf->constant_pool_count-1, std::make_pair(0, boost::any())), cache(cf->constant_pool_count-1) {}	// 别忘了 -1 啊！！！！		// bufs 前边加上 const 竟然会报错 ???
 private:
 	const pair<int, boost::any> & if_didnt_parse_then_parse(int index);
 public:
 	pair<int, boost::any> operator[] (int index) {
 		return if_didnt_parse_then_parse(index);
 	}
+public:
+	const rt_cache_entry & cache_at(int index) { return cache[index]; }
+	wstring symbolic_descriptor(int index);		// the descriptor of a Fieldref/Methodref/InterfaceMethodref/InvokeDynamic, without resolving it.
+	void quicken(uint8_t *pc, uint8_t fast_bytecode, int index, const rt_cache_entry & entry);
 public:
 	void print_debug();
 };
@@ -72,6 +72,8 @@ private:
 
 	ConstantValue_attribute *constant_value = nullptr;	// only one
 	u2 signature_index = 0;
+
+	int offset = -1;		// non-static field: byte offset of the value in the InstanceOop's inline fields. set by `InstanceKlass::parse_fields()`.
 	// TODO: support Annotations
 
 private:
@@ -87,6 +89,8 @@ public:
 	Klass *get_type_klass() { if_didnt_parse_then_parse(); return true_type; }	// small lock to keep safe.		// **MUST PARSE HERE**!!!!!
 	u2 get_flag() { return access_flags; }
 	CodeStub *get_rva() { if (rva) return &rva->stub; else return nullptr;}
+	int get_offset() { return offset; }
+	void set_offset(int offset) { this->offset = offset; }
 public:
 	bool is_public() { return (access_flags & ACC_PUBLIC) == ACC_PUBLIC; }
 	bool is_static() { return (access_flags & ACC_STATIC) == ACC_STATIC; }
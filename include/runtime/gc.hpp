@@ -10,30 +10,261 @@
 
 #include <unordered_map>
 #include <utility>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <ostream>
 #include "utils/lock.hpp"
+#include "utils/work_stealing_queue.hpp"
+#include "runtime/heap.hpp"
+#include "runtime/gc_workers.hpp"
 
 using std::unordered_map;
 using std::pair;
 using std::make_pair;
+using std::vector;
 
 class vm_thread;
 class Oop;
 class Klass;
+class HeapDump;
+
+struct GCWorkerState {		// one for every gc worker.
+	WorkStealingQueue<Oop *> queue;		// the copies to scan (minor gc), or the marked oops to scan (full gc).
+	Tlab survivor_plab;
+	Tlab old_plab;
+	unsigned seed = 1;					// xorshift, to choose whom to steal from.
+	double roots_ms = 0;				// of the last pause. the counters below are of the last minor gc.
+	size_t survived_bytes = 0;
+	long survived_objects = 0;
+	size_t promoted_bytes = 0;
+	long promoted_objects = 0;
+	vector<Oop *> dedup_candidates;		// the Strings this worker promoted. see: `StringDedup`.
+	vector<Oop *> discovered_refs;		// the References this worker discovered. see: `ReferenceProcessor`.
+	vector<pair<void *, size_t>> self_forwarded;		// the objects it found no room for, with their headers. see: `GC::forward()`.
+};
+
+struct GCPause {			// the pause in progress, for the gc log.
+	int id = 0;
+	const wchar_t *cause = L"";
+	std::wstring kind;
+	vector<pair<const wchar_t *, double>> phases;		// name, ms. in order.
+	size_t eden_before = 0, survivor_before = 0, old_before = 0, old_capacity_before = 0;
+	size_t survived_bytes = 0, promoted_bytes = 0;
+	long survived_objects = 0, promoted_objects = 0;
+	long promotion_failed_objects = 0;	// forwarded to themselves: no room to copy them.
+	size_t strings_purged = 0;			// the dead entries of the StringTable.
+	long monitors_deflated = 0;			// the inflated monitors freed: idle, or of a dead object.
+	long dedup_strings = 0;				// the Strings which took an equal char[].
+	size_t dedup_saved_bytes = 0;		// the bytes of the char[]s they dropped.
+	long refs_cleared[4] = { 0 };		// by ReferenceType.
+	long refs_enqueued = 0;				// into their ReferenceQueues.
+};
+
+struct GCStats {			// for -XX:+PrintGC / -Xlog:gc. written under `GC::stats_lock()`.
+	int pauses = 0;
+	int full_pauses = 0;
+	double pause_total_ms = 0;
+	double pause_max_ms = 0;
+	vector<double> pause_ms;					// every pause, for the percentiles.
+	size_t reclaimed_bytes = 0;
+	size_t promoted_bytes = 0;
+	long promoted_objects = 0;
+	int safepoints = 0;
+	double time_to_safepoint_total_ms = 0;		// from arming the polls until the last thread is safe.
+	double time_to_safepoint_max_ms = 0;
+	double last_time_to_safepoint_ms = 0;
+	int concurrent_marks = 0;
+	double concurrent_mark_ms = 0;
+	int concurrent_sweeps = 0;
+	double concurrent_sweep_ms = 0;
+	size_t strings_purged = 0;
+	long monitors_deflated = 0;
+	long dedup_strings = 0;
+	size_t dedup_saved_bytes = 0;
+	long refs_cleared[4] = { 0 };
+	long refs_enqueued = 0;
+};
+
+enum GCRootKind {			// of the root `GC::roots_do()` is visiting. only the heap dump tells them apart.
+	ROOT_VM,				// the basic type mirrors, the String constants of the rt_pools.
+	ROOT_KLASS,				// a static field, the loader or the mirror of a klass.
+	ROOT_THREAD_OBJECT,		// a java.lang.Thread in the ThreadTable.
+	ROOT_THREAD_ARG,
+	ROOT_JAVA_FRAME,		// a reference slot of the lvt or the op_stack of a frame.
+	ROOT_MONITOR,			// the locked object of a synchronized method.
+	ROOT_HANDLE,			// an oop a native or the vm holds in a Handle.
+};
+
+struct GCRootInfo {
+	GCRootKind kind = ROOT_VM;
+	vm_thread *thread = nullptr;		// of the thread roots.
+	int depth = 0;						// of the frame, from the top.
+};
 
 class GC {
+	friend HeapDump;
 private:
 	static pthread_cond_t & gc_cond() {
-		static pthread_cond_t gc_cond;
+		static pthread_cond_t gc_cond = PTHREAD_COND_INITIALIZER;
 		return gc_cond;
 	}
 	static pthread_mutex_t & gc_cond_mutex() {
-		static pthread_mutex_t gc_cond_mutex;
+		static pthread_mutex_t gc_cond_mutex = PTHREAD_MUTEX_INITIALIZER;
 		return gc_cond_mutex;
 	}
-	static void recursive_add_oop_and_its_inner_oops_and_modify_pointers_by_the_way(Oop * const & origin_oop, unordered_map<Oop *, Oop *> & new_oop_map);
-			// return: pair< new oop address, should substitute the origin >.  if `should substitute the origin` == false, that says the oop has been
-			// migrated to the `new_oop_map` already. So we need not substitute the pointer.
-	static void klass_inner_oop_gc(Klass *klass, unordered_map<Oop *, Oop *> & new_oop_map);
+	static void unlock_gc_cond_mutex(void *);		// the gc thread is cancelled in `pthread_cond_wait()` at exit, with the mutex locked again.
+	static bool & gc_signalled() {					// under `gc_cond_mutex()`: `init_gc()` may come before the gc thread waits.
+		static bool gc_signalled = false;
+		return gc_signalled;
+	}
+	static std::atomic<bool> & full_gc_requested() {	// an allocation failed: the next pause collects the whole heap.
+		static std::atomic<bool> full_gc_requested(false);
+		return full_gc_requested;
+	}
+	static std::atomic<size_t> & allocation_request() {	// the bytes of the failed allocation: the old generation grows for them.
+		static std::atomic<size_t> allocation_request(0);
+		return allocation_request;
+	}
+	static std::atomic<int> & collections() {			// the pauses which collected the heap.
+		static std::atomic<int> collections(0);
+		return collections;
+	}
+	static const int KLASSES_PER_TASK = 64;
+	static const size_t CARDS_PER_TASK = 256;
+	static vector<GCWorkerState *> & worker_states() {
+		static vector<GCWorkerState *> worker_states;
+		return worker_states;
+	}
+	static GCWorkerState * & current_worker() {		// of the gc worker running on this pthread.
+		static thread_local GCWorkerState *current_worker = nullptr;
+		return current_worker;
+	}
+	static TaskTerminator & terminator() {
+		static TaskTerminator terminator;
+		return terminator;
+	}
+	static vector<Klass *> & root_klasses() {		// the roots are split into tasks, claimed by the workers. see: `roots_do()`.
+		static vector<Klass *> root_klasses;
+		return root_klasses;
+	}
+	static vector<vm_thread *> & root_threads() {
+		static vector<vm_thread *> root_threads;
+		return root_threads;
+	}
+	static GCRootInfo & current_root() {			// set by `roots_do()` before it calls `f`.
+		static thread_local GCRootInfo current_root;
+		return current_root;
+	}
+	static std::atomic<int> & root_tasks_claimed() {
+		static std::atomic<int> root_tasks_claimed(0);
+		return root_tasks_claimed;
+	}
+	static std::atomic<size_t> & card_tasks_claimed() {
+		static std::atomic<size_t> card_tasks_claimed(0);
+		return card_tasks_claimed;
+	}
+	static size_t & old_cards() {					// the cards of the old generation when the minor gc began.
+		static size_t old_cards = 0;
+		return old_cards;
+	}
+	// the concurrent cycle of the old generation. see: `concurrent_thread()`.
+	enum CycleState { IDLE, MARKING, SWEEPING };
+	static const int MARK_STEP_OOPS = 1024;				// the marker scans at most so many oops a step,
+	static const size_t SWEEP_STEP_BYTES = 256 * 1024;	// and the sweeper sweeps so many bytes.
+	static std::atomic<int> & cycle_state() {			// changed under `cycle_cond_mutex()`, to wake the concurrent thread.
+		static std::atomic<int> cycle_state(IDLE);
+		return cycle_state;
+	}
+	static pthread_cond_t & cycle_cond() {
+		static pthread_cond_t cycle_cond = PTHREAD_COND_INITIALIZER;
+		return cycle_cond;
+	}
+	static pthread_mutex_t & cycle_cond_mutex() {
+		static pthread_mutex_t cycle_cond_mutex = PTHREAD_MUTEX_INITIALIZER;
+		return cycle_cond_mutex;
+	}
+	static pthread_mutex_t & concurrent_lock() {		// held by the concurrent thread for a step, and by the gc thread for a whole pause: no step runs in a pause.
+		static pthread_mutex_t concurrent_lock = PTHREAD_MUTEX_INITIALIZER;
+		return concurrent_lock;
+	}
+	static std::atomic<bool> & remark_requested() {	// the marker has traced all it could see.
+		static std::atomic<bool> remark_requested(false);
+		return remark_requested;
+	}
+	static vector<Oop *> & mark_stack() {				// the marked old oops the marker has not scanned yet.
+		static vector<Oop *> mark_stack;
+		return mark_stack;
+	}
+	static vector<Oop *> & concurrent_discovered() {	// the References the marker discovered, for the remark.
+		static vector<Oop *> concurrent_discovered;
+		return concurrent_discovered;
+	}
+	static std::chrono::steady_clock::time_point & phase_start() {		// of the running concurrent phase.
+		static std::chrono::steady_clock::time_point phase_start;
+		return phase_start;
+	}
+	static GCStats & stats() {
+		static GCStats stats;
+		return stats;
+	}
+	static Lock & stats_lock() {						// the summary may be printed on SIGQUIT, while the gc runs.
+		static Lock stats_lock;
+		return stats_lock;
+	}
+	static GCPause & pause() {
+		static GCPause pause;
+		return pause;
+	}
+	static const wchar_t * & gc_cause() {				// of the requested pause. set with `gc()`, under `gc_lock()`.
+		static const wchar_t *gc_cause = L"";
+		return gc_cause;
+	}
+	static int & cycle_id() {							// the pause which began the running concurrent cycle.
+		static int cycle_id = 0;
+		return cycle_id;
+	}
+	template <typename Func>
+	static void phase(const wchar_t *name, Func func);	// run `func` as a phase of the pause: timed for the log.
+	static void log_pause(double pause_ms);
+	static void set_cycle_state(int state);
+	static void mark_old(Oop *oop);
+	static void initial_mark_root(Oop * & ref);
+	static bool trace(int max_oops);		// true if nothing is left to scan.
+	static void initial_mark();
+	static void remark();
+	static void end_sweep();
+	static void finish_sweep();
+	static void *concurrent_thread(void *);
+	static void concurrent_mark();
+	static void concurrent_sweep();
+	static void forward(Oop * & ref);		// copy young `ref` into the to-survivor space or the old generation if it's not copied yet, and substitute it with the copy.
+	static bool scan(Oop *oop);			// forward all the inner oops of a copy. true if some of them are still young.
+	static void mark(Oop * & ref);
+	static void klass_inner_oop_do(Klass *klass, void (*f)(Oop * &));
+	static Klass * & string_klass() {				// java/lang/String, for the deduplication.
+		static Klass *string_klass = nullptr;
+		return string_klass;
+	}
+	static Oop *young_referent(Oop *oop);		// where a weak referent lives after the copying. nullptr if it's dead.
+	static Oop *marked_referent(Oop *oop);		// the same, after the old generation is marked.
+	static void weak_roots_do(Oop *(*referent)(Oop *));		// purge the dead entries of the StringTable and the dedup table, and deflate the monitors.
+	static void deduplicate_strings();
+	static Oop *live_referent(Oop *oop);		// after a full gc's marking: nullptr if `oop` is not marked.
+	static bool discover_young(Oop *oop);		// true if the referent of `oop` is not to be traced through it.
+	static bool discover_marked(Oop *oop);
+	static bool discover_old(Oop *oop);
+	static void process_references(Oop *(*referent)(Oop *));	// the ones the workers discovered.
+	static void prepare_roots();
+	static void roots_do(void (*f)(Oop * &));		// calls `f` for the gc roots of the tasks this worker claims, until all are claimed.
+	template <typename Func>
+	static void drain(GCWorkerState *self, Func process);		// `process` the oops of the own queue, then the stolen ones, until all the queues are empty.
+	static bool steal(GCWorkerState *self, Oop * & oop);
+	static void dirty_cards_task(int worker_id);
+	static void copy_task(int worker_id);
+	static void mark_task(int worker_id);
+	static void minor_gc();
+	static void full_gc();
 public:
 	static Lock & gc_lock() {
 		static Lock gc_lock;
@@ -44,13 +275,15 @@ public:
 		return gc;
 	}
 public:
-	static bool init_gc();
-	static void detect_ready();
+	static void init_workers();
+	static bool init_gc(const wchar_t *cause);
+	static void request_gc() { init_gc(L"Allocation Failure"); }		// eden is full. see: `Heap::on_eden_full()`.
+	static void collect_for_allocation(vm_thread *thread, size_t size);		// at a safepoint of `thread`: returns after a full gc.
+	static void detect_ready();		// wait until all the threads are at a safepoint.
 	static void *gc_thread(void *);
 	static void system_gc();
-	static void set_safepoint_here(vm_thread *);
-	static void signal_all_patch();
 	static void cancel_gc_thread();
+	static void print_summary(std::wostream & os);		// the totals of the gc log: at exit, or on SIGQUIT.
 };
 
 
@@ -0,0 +1,48 @@
+/*
+ * gc_log.hpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#ifndef INCLUDE_RUNTIME_GC_LOG_HPP_
+#define INCLUDE_RUNTIME_GC_LOG_HPP_
+
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <string>
+#include <mutex>
+#include <chrono>
+
+/**
+ * the gc log (-Xlog:gc[:file], or -XX:+PrintGC to stdout). one line of it: written out whole, at the end of the statement.
+ *   GCLog(L"gc,phases", id) << "...";		==>   [1.234s][gc,phases] GC(7) ...
+ * the uptime is from `open()`, which is called at startup.
+ */
+class GCLog : public std::wostringstream {
+private:
+	static std::mutex & mutex() {
+		static std::mutex mutex;
+		return mutex;
+	}
+	static std::wofstream & file() {
+		static std::wofstream file;
+		return file;
+	}
+	static std::chrono::steady_clock::time_point & start_time() {
+		static std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+		return start_time;
+	}
+	static std::wostream & stream() { return file().is_open() ? (std::wostream &)file() : std::wcout; }
+public:
+	static bool open(const std::string & path);		// "": to stdout.
+	static void close();
+	static double uptime();							// in seconds.
+	static void write(const std::wstring & text);	// as it is, without a prefix. e.g. the summary.
+public:
+	GCLog(const wchar_t *tags, int gc_id = -1);		// -1: no `GC(id)`.
+	~GCLog();
+};
+
+
+#endif /* INCLUDE_RUNTIME_GC_LOG_HPP_ */
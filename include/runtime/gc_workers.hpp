@@ -0,0 +1,81 @@
+/*
+ * gc_workers.hpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#ifndef INCLUDE_RUNTIME_GC_WORKERS_HPP_
+#define INCLUDE_RUNTIME_GC_WORKERS_HPP_
+
+#include <pthread.h>
+#include <sched.h>
+#include <atomic>
+#include <vector>
+
+/**
+ * the gang of gc worker threads. `run()` gives one task to all of them and returns when all have finished it,
+ * so the end of every task is a barrier. the workers sleep between the tasks.
+ */
+class GCWorkers {
+private:
+	static pthread_mutex_t & mutex() {
+		static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+		return mutex;
+	}
+	static pthread_cond_t & task_cond() {		// a new task.
+		static pthread_cond_t task_cond = PTHREAD_COND_INITIALIZER;
+		return task_cond;
+	}
+	static pthread_cond_t & done_cond() {		// all the workers finished the task.
+		static pthread_cond_t done_cond = PTHREAD_COND_INITIALIZER;
+		return done_cond;
+	}
+	static void (* & task())(int) {
+		static void (*task)(int) = nullptr;
+		return task;
+	}
+	static long & task_number() {				// how many tasks have been given. a worker runs the task when it changes.
+		static long task_number = 0;
+		return task_number;
+	}
+	static int & unfinished() {
+		static int unfinished = 0;
+		return unfinished;
+	}
+	static std::vector<pthread_t> & workers() {
+		static std::vector<pthread_t> workers;
+		return workers;
+	}
+	static void *worker_loop(void *arg);
+public:
+	static void init(int worker_num);
+	static int size() { return (int)workers().size(); }
+	static void run(void (*task)(int worker_id));		// `task(0) ... task(size() - 1)`, one on every worker.
+};
+
+/**
+ * when a worker has no work of its own and can steal none, it offers to terminate. the work is over when all of them
+ * have offered: none of them can make new work any more. a worker which sees work in a queue again takes back its offer.
+ */
+class TaskTerminator {
+private:
+	std::atomic<int> offered;
+	int worker_num;
+public:
+	void reset(int worker_num) { offered.store(0); this->worker_num = worker_num; }
+	template <typename HasWork>
+	bool offer_termination(HasWork has_work) {		// true: terminate. false: `has_work()` turned true, go and steal.
+		offered.fetch_add(1);
+		while (true) {
+			if (offered.load() == worker_num)	return true;
+			if (has_work()) {
+				offered.fetch_sub(1);
+				return false;
+			}
+			sched_yield();
+		}
+	}
+};
+
+
+#endif /* INCLUDE_RUNTIME_GC_WORKERS_HPP_ */
@@ -0,0 +1,50 @@
+/*
+ * handles.hpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#ifndef INCLUDE_RUNTIME_HANDLES_HPP_
+#define INCLUDE_RUNTIME_HANDLES_HPP_
+
+#include <vector>
+#include <cstddef>
+#include "wind_jvm.hpp"
+
+class Oop;
+
+/**
+ * an oop a native or the vm keeps in a c++ local across `vm_thread::add_frame_and_execute()`. the java code it runs polls
+ * for safepoints, and a minor gc there moves the young oops: the c++ local would point to the old copy. a Handle is a slot
+ * in the handle area of its thread, which `GC::roots_do()` scans and updates, so the oop is read through it after the call:
+ *
+ *		HandleMark hm(thread);
+ *		Handle prop(thread, oop);
+ *		thread.add_frame_and_execute(method, {prop(), ...});
+ *		_stack.push_back(prop());
+ *
+ * the handles live until the innermost HandleMark goes out of scope.
+ */
+class Handle {
+private:
+	std::vector<Oop *> *area = nullptr;
+	size_t index = 0;
+public:
+	Handle() {}
+	Handle(vm_thread & thread, Oop *oop) : area(&thread.handles), index(thread.handles.size()) { area->push_back(oop); }
+	Oop *operator()() const { return (area == nullptr) ? nullptr : (*area)[index]; }
+};
+
+class HandleMark {
+private:
+	std::vector<Oop *> & area;
+	size_t top;
+public:
+	explicit HandleMark(vm_thread & thread) : area(thread.handles), top(thread.handles.size()) {}
+	HandleMark(const HandleMark &) = delete;
+	HandleMark & operator= (const HandleMark &) = delete;
+	~HandleMark() { area.resize(top); }
+};
+
+
+#endif /* INCLUDE_RUNTIME_HANDLES_HPP_ */
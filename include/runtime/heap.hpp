@@ -0,0 +1,353 @@
+/*
+ * heap.hpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#ifndef INCLUDE_RUNTIME_HEAP_HPP_
+#define INCLUDE_RUNTIME_HEAP_HPP_
+
+#include <atomic>
+#include <map>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cassert>
+#include "utils/lock.hpp"
+
+/**
+ * a thread-local allocation buffer: a piece of eden only one thread bump-allocates in, without any lock.
+ * every vm_thread has one. see: `Heap::attach()`.
+ * the gc workers copy into the same kind of buffers (plabs) in the to-survivor space and in the old generation.
+ */
+class Tlab {
+	friend class Heap;
+private:
+	uint8_t *top = nullptr;
+	uint8_t *end = nullptr;
+public:
+	uint8_t *allocate(size_t block_size) {
+		if ((size_t)(end - top) < block_size)	return nullptr;
+		uint8_t *block = top;
+		top += block_size;
+		return block;
+	}
+	bool undo(uint8_t *block, size_t block_size) {		// give back the last allocation. false if it isn't the last one.
+		if (block + block_size != top)	return false;
+		top = block;
+		return true;
+	}
+	void retire();			// fill the rest with a free block, to keep eden parsable. the next allocation refills it.
+};
+
+/**
+ * the java heap: one contiguous region reserved with mmap at startup (-Xmx), in two generations:
+ *   [eden][survivor 0][survivor 1] [old      |          ]
+ *   |<------- young ------->|           limit      reserved end
+ * the mutators allocate in eden, with tlabs. a minor gc copies the live young objects into the empty survivor space, and
+ * the ones which have survived `MAX_TENURING_THRESHOLD` minor gcs into the old generation. the old generation is marked
+ * concurrently with the mutators and swept into a free list step by step (see: `GC::concurrent_thread()`), or, when it is
+ * too late for that, by a full gc, which marks the whole heap in a pause. the old objects never move.
+ * the young generation has a fixed size (-Xmn). the old generation only uses the part below its limit: it grows on demand
+ * when a block doesn't fit, and after every pause it is resized to keep `MIN_FREE_PERCENT`..`MAX_FREE_PERCENT` of it free,
+ * but never shrinks below the initial size (-Xms). the pages above the limit are given back to the kernel.
+ *
+ * every object is in a block: [size_t header][object]. the header is the block size, with:
+ *   FREE_BIT      : a free block (the rest of a retired tlab, or a hole of the old generation).
+ *   MARK_BIT      : reached by the marking of the old generation. the ones allocated in it during the concurrent marking
+ *                   are marked at once (allocated black): they are not in the snapshot, and the marker never scans them.
+ *   the hash bits : the identity hash, 0 until it's asked for. then it's installed with a CAS (the marker and the sweeper
+ *                   change the header concurrently), and a copy takes it with it. see: `identity_hash()`.
+ *   the top bits  : the age of a young object: how many minor gcs it has survived.
+ * during a minor gc, the header of a copied object holds the address of its copy with the FORWARDED_BIT instead. if there's
+ * no room for the copy anywhere (promotion failure), the object stays where it is, forwarded to itself.
+ *
+ * the old-to-young pointers are remembered by a card table: every store of a reference into an oop dirties the card
+ * (`CARD_SIZE` bytes of the heap) of the oop's header. see: `post_write_barrier()`. a minor gc only scans the old
+ * objects which begin in a dirty card, so its pause is proportional to the survivors, not to the old generation.
+ */
+class Heap {
+public:
+	static const size_t MIN_FREE_PERCENT = 40;			// after a pause, the old generation grows if less is free,
+	static const size_t MAX_FREE_PERCENT = 70;			// and shrinks if more is.
+	static const size_t SURVIVOR_RATIO = 8;				// eden : one survivor space.
+	static const unsigned MAX_TENURING_THRESHOLD = 4;
+	static const size_t TLAB_SIZE = 256 * 1024;
+	static const size_t PLAB_SIZE = 32 * 1024;
+	static const size_t HEADER_SIZE = sizeof(size_t);
+	static const size_t FREE_BIT = 1;
+	static const size_t FORWARDED_BIT = 2;
+	static const size_t MARK_BIT = 4;
+	static const int HASH_SHIFT = 35;					// so a block is smaller than 32G.
+	static const int HASH_BITS = 25;
+	static const size_t HASH_MASK = (((size_t)1 << HASH_BITS) - 1) << HASH_SHIFT;
+	static const int AGE_SHIFT = HASH_SHIFT + HASH_BITS;
+	static const size_t SIZE_MASK = (((size_t)1 << HASH_SHIFT) - 1) & ~(size_t)7;
+	static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+	static const size_t VM_RESERVE = 1024 * 1024;		// of the old generation, only for the vm when the heap is exhausted. see: `allocate_in_reserve()`.
+	static const int CARD_SHIFT = 9;
+	static const size_t CARD_SIZE = (size_t)1 << CARD_SHIFT;
+	static const uint8_t CLEAN_CARD = 0;
+	static const uint8_t DIRTY_CARD = 1;
+	static const uint8_t NO_BLOCK = 0xff;				// in the block start table: no block begins in this card.
+private:
+	struct Space {
+		uint8_t *start = nullptr;
+		uint8_t *end = nullptr;
+		uint8_t *top = nullptr;
+		bool contains(const void *ptr) const { return ptr >= start && ptr < end; }
+		size_t used() const { return top - start; }
+	};
+private:
+	static uint8_t * & reserved() {				// the whole mmapped region, maybe bigger than the heap for the huge page alignment.
+		static uint8_t *reserved = nullptr;
+		return reserved;
+	}
+	static size_t & reserved_size() {
+		static size_t reserved_size = 0;
+		return reserved_size;
+	}
+	static Space & young() {					// eden + the two survivor spaces. only for the bounds.
+		static Space young;
+		return young;
+	}
+	static Space & eden() {						// `top` is unused: see `eden_top()`.
+		static Space eden;
+		return eden;
+	}
+	static std::atomic<uint8_t *> & eden_top() {	// shared: tlabs and big objects are carved out of it with a CAS.
+		static std::atomic<uint8_t *> eden_top(nullptr);
+		return eden_top;
+	}
+	static Space & from_survivor() {			// the survivors of the last minor gc.
+		static Space from_survivor;
+		return from_survivor;
+	}
+	static Space & to_survivor() {				// empty. the gc workers copy into it: `top` is unused, see `to_survivor_top()`.
+		static Space to_survivor;
+		return to_survivor;
+	}
+	static std::atomic<uint8_t *> & to_survivor_top() {		// shared by the gc workers: their plabs are carved out of it with a CAS.
+		static std::atomic<uint8_t *> to_survivor_top(nullptr);
+		return to_survivor_top;
+	}
+	static bool & promotion_failed() {			// the last minor gc left objects in eden and in both survivor spaces. see: `end_minor_gc()`.
+		static bool promotion_failed = false;
+		return promotion_failed;
+	}
+	static Space & old() {
+		static Space old;
+		return old;
+	}
+	static uint8_t * & old_limit() {			// the old generation is only allocated below it. `old().end` is the end of the reservation.
+		static uint8_t *old_limit = nullptr;
+		return old_limit;
+	}
+	static size_t & min_old_capacity() {		// from -Xms.
+		static size_t min_old_capacity = 0;
+		return min_old_capacity;
+	}
+	static Lock & old_lock() {					// the old generation is allocated in by the mutators (when eden is full) and by the gc.
+		static Lock old_lock;
+		return old_lock;
+	}
+	static std::multimap<size_t, uint8_t *> & old_free_list() {		// block size -> free block of the old generation, below its top.
+		static std::multimap<size_t, uint8_t *> old_free_list;
+		return old_free_list;
+	}
+	static size_t & old_free_bytes() {			// in the free list.
+		static size_t old_free_bytes = 0;
+		return old_free_bytes;
+	}
+	static uint8_t * & card_table() {			// one byte for every card of the heap.
+		static uint8_t *card_table = nullptr;
+		return card_table;
+	}
+	static uint8_t * & card_table_base() {		// biased: `card_table_base()[address >> CARD_SHIFT]` is the card of `address`.
+		static uint8_t *card_table_base = nullptr;
+		return card_table_base;
+	}
+	static uint8_t * & block_start_table() {	// one byte for every card of the old generation: the offset (in words) of the first block which begins in it.
+		static uint8_t *block_start_table = nullptr;
+		return block_start_table;
+	}
+	static bool & allocate_black() {			// the concurrent marking is running.
+		static bool allocate_black = false;
+		return allocate_black;
+	}
+	static uint8_t * & sweep_cursor() {			// the next block to sweep.
+		static uint8_t *sweep_cursor = nullptr;
+		return sweep_cursor;
+	}
+	static uint8_t * & sweep_limit() {			// the top of the old generation when the sweep began. the blocks above are allocated later, and never swept.
+		static uint8_t *sweep_limit = nullptr;
+		return sweep_limit;
+	}
+	static size_t & sweep_card() {				// the first card whose block start entry the sweep has not noted again yet.
+		static size_t sweep_card = 0;
+		return sweep_card;
+	}
+	struct HashState {							// the xorshift generator of the identity hashes: Marsaglia's, as `hashCode=5` of hotspot.
+		uint32_t x, y = 842502087, z = 0x8767, w = 273326509;
+		HashState();
+	};
+	static HashState & hash_state() {			// of every pthread.
+		static thread_local HashState hash_state;
+		return hash_state;
+	}
+	static Tlab * & current_tlab() {			// the tlab of the vm_thread running on this pthread. nullptr for the other threads.
+		static thread_local Tlab *current_tlab = nullptr;
+		return current_tlab;
+	}
+	static uint8_t *allocate_eden(size_t size);
+	static uint8_t *allocate_to_survivor(size_t size);
+	static void *allocate_slow(size_t block_size);
+	static void *allocate_old(size_t block_size, bool use_reserve);
+	static uint8_t *allocate_old_block(size_t block_size);		// old_lock must be held.
+	static void add_to_free_list(uint8_t *block, size_t block_size);	// old_lock must be held.
+	static void note_block_start(uint8_t *block);
+	static void free_dead_blocks(uint8_t *start, uint8_t *end, const std::vector<std::pair<void *, size_t>> & kept);
+	static void sweep_enter_cards(size_t last_card);		// old_lock must be held.
+	static void *init_block(uint8_t *block, size_t block_size) {
+		*(size_t *)block = block_size;
+		memset(block + HEADER_SIZE, 0, block_size - HEADER_SIZE);		// default bzero!
+		return block + HEADER_SIZE;
+	}
+	static size_t align_to_page(size_t bytes) { return (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1); }
+	static size_t block_size_at(uint8_t *block) { return *(size_t *)block & SIZE_MASK; }
+	static size_t card_index(const void *ptr) { return (uintptr_t)ptr >> CARD_SHIFT; }
+	static size_t old_card_index(const void *ptr) { return ((uint8_t *)ptr - old().start) >> CARD_SHIFT; }
+public:
+	static size_t block_size_of(size_t size) { return (size + HEADER_SIZE + 7) & ~(size_t)7; }
+	static size_t & header_of(void *obj) { return *(size_t *)((uint8_t *)obj - HEADER_SIZE); }
+	static size_t object_size(void *obj) { return (header_of(obj) & SIZE_MASK) - HEADER_SIZE; }		// with the padding of the block.
+	static unsigned age_of(void *obj) { return (unsigned)(header_of(obj) >> AGE_SHIFT); }
+	static void *forwardee(void *obj) {			// the copy of `obj` in a survivor space or the old generation, or nullptr if not copied yet.
+		size_t header = header_of(obj);
+		return (header & FORWARDED_BIT) ? (void *)(header & ~FORWARDED_BIT) : nullptr;
+	}
+	static void forward_to(void *obj, void *copy) { header_of(obj) = (size_t)copy | FORWARDED_BIT; }
+	static bool is_marked(void *obj) { return (header_of(obj) & MARK_BIT) != 0; }
+	static size_t load_header(void *obj) { return __atomic_load_n(&header_of(obj), __ATOMIC_ACQUIRE); }
+	static void *forwardee_of(size_t header) { return (header & FORWARDED_BIT) ? (void *)(header & ~FORWARDED_BIT) : nullptr; }
+	static void *par_forward_to(void *obj, size_t header, void *copy) {		// returns the copy which won: `copy`, or the one of another gc worker.
+		size_t expected = header;
+		if (__atomic_compare_exchange_n(&header_of(obj), &expected, (size_t)copy | FORWARDED_BIT, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+			return copy;
+		}
+		return forwardee_of(expected);
+	}
+	static void copy_hash(void *copy, size_t header) { header_of(copy) |= header & HASH_MASK; }		// before `copy` is published.
+	static int identity_hash(void *obj);		// generated at the first call, stable ever after.
+	static bool mark(void *obj) {				// true if `obj` was not marked. the gc workers race for it.
+		if (is_marked(obj))	return false;
+		return (__atomic_fetch_or(&header_of(obj), MARK_BIT, __ATOMIC_RELAXED) & MARK_BIT) == 0;
+	}
+	static void post_write_barrier(void *obj) {		// after a reference is stored into `obj`.
+		card_table_base()[card_index((uint8_t *)obj - HEADER_SIZE)] = DIRTY_CARD;
+	}
+public:
+	typedef void (*eden_full_hook_t)();
+	static eden_full_hook_t & on_eden_full() {		// called when a mutator finds eden full, before it falls back to the old generation: time for a minor gc.
+		static eden_full_hook_t on_eden_full = nullptr;
+		return on_eden_full;
+	}
+	static bool init(size_t initial_bytes, size_t max_bytes, size_t young_bytes, bool use_huge_pages);
+	static void attach(Tlab *tlab) { current_tlab() = tlab; }
+	static void detach() {
+		if (current_tlab() != nullptr) current_tlab()->retire();
+		current_tlab() = nullptr;
+	}
+	static void *allocate(size_t size) {		// zeroed memory for an object of `size` bytes. nullptr if the heap is exhausted.
+		assert(reserved() != nullptr);
+		size_t block_size = block_size_of(size);
+		Tlab *tlab = current_tlab();
+		uint8_t *block = (tlab == nullptr) ? nullptr : tlab->allocate(block_size);
+		if (block == nullptr) {
+			return allocate_slow(block_size);
+		}
+		return init_block(block, block_size);
+	}
+	// the mutators leave the last `VM_RESERVE` bytes of the old generation (at -Xmx) free. the vm takes them when `allocate()`
+	// fails out of the allocation bytecodes: it can't collect there, for it holds oops in its c++ locals. see: `MemAlloc::allocate()`.
+	static void *allocate_in_reserve(size_t size);
+	static bool has_reserve() { return old_max_free() >= VM_RESERVE; }
+	static void cleanup();
+public:		// for gc:
+	// the gc workers copy with their own plabs. uninitialized, only the header. nullptr if the space is full.
+	static void *allocate_in_survivor(Tlab & plab, size_t size, unsigned age);
+	static void *allocate_in_old(Tlab & plab, size_t size);
+	static void undo_allocation(Tlab & plab, void *obj);		// another gc worker copied the object first.
+	static void retire_survivor_plab(Tlab & plab) { plab.retire(); }
+	static void retire_old_plab(Tlab & plab);					// the rest goes back to the free list.
+	static size_t old_cards() { return (old().top - old().start + CARD_SIZE - 1) >> CARD_SHIFT; }
+	template <typename Func>
+	static void young_iterate(Func func) {		// calls `func(void *obj)` for every object the last minor gc left in the young generation.
+		blocks_iterate(from_survivor().start, from_survivor().top, func);
+		if (promotion_failed()) {				// eden and the to-survivor space too.
+			blocks_iterate(eden().start, eden_top().load(std::memory_order_relaxed), func);
+			blocks_iterate(to_survivor().start, to_survivor().top, func);
+		}
+	}
+	template <typename Func>
+	static void blocks_iterate(uint8_t *start, uint8_t *end, Func func) {
+		for (uint8_t *block = start; block < end; block += block_size_at(block)) {
+			if ((*(size_t *)block & FREE_BIT) == 0) {
+				func(block + HEADER_SIZE);
+			}
+		}
+	}
+	template <typename Func>
+	static void dirty_cards_iterate(size_t from, size_t to, Func func) {	// calls `func(void *obj)` for every old object which begins in a dirty card of [from, to), and cleans the card.
+		uint8_t *end = old().top;
+		for (size_t i = from; i < to; i ++) {
+			uint8_t *card_start = old().start + (i << CARD_SHIFT);
+			uint8_t & card = card_table_base()[card_index(card_start)];
+			if (card == CLEAN_CARD)	continue;
+			card = CLEAN_CARD;
+			uint8_t offset = block_start_table()[i];
+			if (offset == NO_BLOCK)	continue;
+			for (uint8_t *block = card_start + offset * sizeof(size_t); block < card_start + CARD_SIZE && block < end; block += block_size_at(block)) {
+				if ((*(size_t *)block & FREE_BIT) == 0) {
+					func(block + HEADER_SIZE);
+				}
+			}
+		}
+	}
+	// all the live young objects are copied out: empty eden, and swap the survivor spaces. all tlabs must be retired. `failed`:
+	// the objects forwarded to themselves, with their headers before.
+	static void end_minor_gc(std::vector<std::pair<void *, size_t>> & failed);
+	static void set_allocate_black(bool black) { allocate_black() = black; }		// only in a pause.
+	// after all the live old objects are marked: the unmarked ones become free blocks, and the marks are cleared. the sweep
+	// goes `max_bytes` a step, and the old generation stays parsable and allocatable between the steps. true: the sweep is over.
+	static void begin_sweep();
+	static bool sweep_step(size_t max_bytes);
+	static void sweep_old() {			// all at once, in a pause.
+		begin_sweep();
+		while (!sweep_step(SIZE_MAX));
+	}
+	// at the end of a pause: grow or shrink the old generation by the free ratio, with `min_free` bytes free at least (if -Xmx
+	// leaves room for them). it only shrinks if `may_shrink`: not while the concurrent cycle may be short of free blocks.
+	static void resize_old(size_t min_free, bool may_shrink);
+public:
+	static bool is_in(const void *ptr) { return ptr >= young().start && ptr < old().end; }
+	static bool is_in_young(const void *ptr) { return young().contains(ptr); }
+	static bool is_in_old(const void *ptr) { return old().contains(ptr); }
+	static bool is_in_to_survivor(const void *ptr) { return !promotion_failed() && to_survivor().contains(ptr); }
+	static size_t get_capacity() { return (eden().end - eden().start) + (from_survivor().end - from_survivor().start) + (old_limit() - old().start); }
+	static size_t max_capacity() { return (eden().end - eden().start) + (from_survivor().end - from_survivor().start) + (old().end - old().start); }
+	static size_t eden_used() { return eden_top().load(std::memory_order_relaxed) - eden().start; }
+	static size_t eden_capacity() { return eden().end - eden().start; }
+	static size_t survivor_used() { return from_survivor().used() + (promotion_failed() ? to_survivor().used() : 0); }
+	static size_t young_used() { return (eden_top().load(std::memory_order_relaxed) - eden().start) + survivor_used(); }
+	static size_t survivor_capacity() { return to_survivor().end - to_survivor().start; }
+	static size_t old_capacity() { return old_limit() - old().start; }
+	static size_t old_used() { return old().used() - old_free_bytes(); }
+	static size_t old_free() { return (old_limit() - old().top) + old_free_bytes(); }
+	static size_t old_max_free() { return (old().end - old().top) + old_free_bytes(); }		// if the old generation grows up to -Xmx.
+};
+
+
+#endif /* INCLUDE_RUNTIME_HEAP_HPP_ */
@@ -0,0 +1,123 @@
+/*
+ * heap_dump.hpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#ifndef INCLUDE_RUNTIME_HEAP_DUMP_HPP_
+#define INCLUDE_RUNTIME_HEAP_DUMP_HPP_
+
+#include <pthread.h>
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+class Oop;
+class Klass;
+class InstanceKlass;
+class Field_info;
+class vm_thread;
+
+/**
+ * the heap dump, in the hprof binary format (JAVA PROFILE 1.0.2) which Eclipse MAT and VisualVM read:
+ *
+ *		[header] [STRING]... [LOAD CLASS]... [STACK TRACE]... [HEAP DUMP SEGMENT]... [HEAP DUMP END]
+ *
+ * the segments hold the gc roots, a CLASS DUMP for every klass, and an INSTANCE DUMP, OBJ ARRAY DUMP or PRIM ARRAY DUMP
+ * for every oop reachable from the roots of `GC::roots_do()`. the id of an oop is its address, and the id of a klass is
+ * the address of its mirror, so a reference to a java.lang.Class is a reference to the class.
+ * a dump is written by the gc thread, in a pause. see: `GC::system_gc()`.
+ */
+class HeapDump {
+private:
+	static const size_t SEGMENT_BYTES = 8 * 1024 * 1024;		// a heap dump segment is flushed when it grows beyond.
+	static pthread_mutex_t & request_mutex() {
+		static pthread_mutex_t request_mutex = PTHREAD_MUTEX_INITIALIZER;
+		return request_mutex;
+	}
+	static pthread_cond_t & done_cond() {
+		static pthread_cond_t done_cond = PTHREAD_COND_INITIALIZER;
+		return done_cond;
+	}
+	static bool & requested() {						// under `request_mutex()`. one dump at a time.
+		static bool requested = false;
+		return requested;
+	}
+	static std::string & requested_path() {
+		static std::string requested_path;
+		return requested_path;
+	}
+	static int & dumps() {							// the requests done, whether they succeeded or not.
+		static int dumps = 0;
+		return dumps;
+	}
+	static bool & last_succeeded() {
+		static bool last_succeeded = false;
+		return last_succeeded;
+	}
+	static HeapDump * & current() {					// for `root()`, which `GC::roots_do()` calls.
+		static HeapDump *current = nullptr;
+		return current;
+	}
+private:
+	struct Root {
+		uint8_t tag;
+		uint64_t id;
+		uint32_t thread_serial;
+		int depth;
+	};
+	FILE *file;
+	std::vector<uint8_t> buf;						// the record being written.
+	size_t total_bytes = 0;
+	bool failed = false;
+	std::unordered_map<std::wstring, uint64_t> string_ids;		// the STRING records. their ids are not addresses.
+	std::vector<std::pair<uint64_t, std::wstring>> strings;
+	std::vector<Root> roots;
+	std::vector<Oop *> oops;						// all the reachable oops, in the order they are found.
+	std::unordered_set<Oop *> visited;
+	std::vector<Oop *> pending;						// found, but the references in them are not followed yet.
+	std::vector<Klass *> klasses;					// every klass of the dump, after its parent.
+	std::unordered_map<Klass *, uint32_t> class_serials;
+	std::unordered_map<vm_thread *, uint32_t> thread_serials;
+	std::unordered_map<Klass *, std::vector<Field_info *>> own_fields;		// the non-static fields of the klass itself, by offset.
+	Klass *class_klass = nullptr;					// java/lang/Class.
+	Klass *object_klass = nullptr;
+private:
+	explicit HeapDump(FILE *file) : file(file) {}
+	void put1(uint8_t value) { buf.push_back(value); }
+	void put2(uint16_t value) { put1(value >> 8); put1(value); }
+	void put4(uint32_t value) { put2(value >> 16); put2(value); }
+	void put8(uint64_t value) { put4(value >> 32); put4(value); }
+	void put_id(const void *ptr) { put8((uint64_t)(uintptr_t)ptr); }
+	void flush();
+	void begin_record(uint8_t tag);
+	void end_record();
+	void next_sub_record();							// in a heap dump segment: begins the next segment if this one is big enough.
+	uint64_t string_id(const std::wstring & str);
+	uint64_t class_id(Klass *klass);
+	uint32_t thread_serial(vm_thread *thread);
+	const std::vector<Field_info *> & fields_of(InstanceKlass *klass);
+	static void root(Oop * & ref);
+	void add_klass(Klass *klass);
+	void visit(Oop *oop);
+	void walk();
+	void write_class_dump(Klass *klass);
+	void write_oop(Oop *oop);
+	void write_field_value(wchar_t kind, Oop *boxed);		// of a static field: the primitives are boxed.
+	void write_field_value(wchar_t kind, const uint8_t *addr);
+	bool write();
+public:
+	static std::string default_path();				// -XX:HeapDumpPath, or java_pid<pid>.hprof in the working directory.
+	static bool request(const std::string & path);	// at a safepoint of the caller, or out of the java threads: waits until the dump is written.
+	static bool is_requested();
+	static void dump_requested();					// by the gc thread, in a pause.
+	static bool dump(const std::string & path);		// as above. false if the file can't be written.
+	static void on_out_of_memory();					// -XX:+HeapDumpOnOutOfMemoryError: the first one only.
+};
+
+
+#endif /* INCLUDE_RUNTIME_HEAP_DUMP_HPP_ */
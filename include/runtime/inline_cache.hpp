@@ -0,0 +1,76 @@
+/*
+ * inline_cache.hpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#ifndef INCLUDE_RUNTIME_INLINE_CACHE_HPP_
+#define INCLUDE_RUNTIME_INLINE_CACHE_HPP_
+
+#include <atomic>
+#include <list>
+#include <iostream>
+#include "utils/lock.hpp"
+
+class Method;
+class InstanceKlass;
+
+/**
+ * inline cache of one `invokevirtual`/`invokeinterface` call site.
+ * remembers the first IC_SIZE <receiver klass, target method> pairs. when one more receiver klass comes, the site becomes
+ * megamorphic and always goes to the vtable/itable from then on.
+ * entries are only appended (under `lock`) and published by `size`, so the lookup needs no lock.
+ */
+class InlineCache {
+public:
+	static const int IC_SIZE = 4;
+private:
+	struct Entry {
+		InstanceKlass *klass;
+		Method *target;
+	};
+	Entry entries[IC_SIZE];
+	std::atomic<int> size;
+	std::atomic<bool> megamorphic;
+	// counters. only for diagnostics, so they are not precise when many threads run the same site.
+	std::atomic<long> hits;
+	std::atomic<long> misses;
+	std::atomic<long> megamorphic_calls;
+	Method *caller;
+	int bci;
+	Lock lock;
+private:
+	static Lock & all_caches_lock() {
+		static Lock all_caches_lock;
+		return all_caches_lock;
+	}
+	static std::list<InlineCache *> & all_caches() {
+		static std::list<InlineCache *> all_caches;
+		return all_caches;
+	}
+	static void inc(std::atomic<long> & counter) { counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+	Method *miss(InstanceKlass *klass, Method *resolved_method);
+public:
+	InlineCache(Method *caller, int bci) : size(0), megamorphic(false), hits(0), misses(0), megamorphic_calls(0), caller(caller), bci(bci) {}
+	Method *lookup(InstanceKlass *klass, Method *resolved_method) {
+		if (!megamorphic.load(std::memory_order_relaxed)) {
+			int num = size.load(std::memory_order_acquire);
+			for (int i = 0; i < num; i ++) {
+				if (entries[i].klass == klass) {
+					inc(hits);
+					return entries[i].target;
+				}
+			}
+		}
+		return miss(klass, resolved_method);
+	}
+	void print(std::wostream & os);
+public:
+	static InlineCache *get_inline_cache(Method *caller, int bci);		// make it at the first time.
+	static void dump(std::wostream & os);
+	static void cleanup();
+};
+
+
+
+#endif /* INCLUDE_RUNTIME_INLINE_CACHE_HPP_ */
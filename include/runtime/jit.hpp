@@ -0,0 +1,118 @@
+/*
+ * jit.hpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#ifndef INCLUDE_RUNTIME_JIT_HPP_
+#define INCLUDE_RUNTIME_JIT_HPP_
+
+#include <atomic>
+#include <list>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "runtime/method.hpp"
+#include "utils/vm_options.hpp"
+#include "utils/lock.hpp"
+
+struct StackFrame;
+
+/**
+ * the executable memory of the compiled methods: one mmapped region, bump-allocated and never freed.
+ * only the compiler thread, which holds `Jit::compile_lock()`, allocates in it.
+ */
+class CodeCache {
+public:
+	static const size_t CODE_CACHE_SIZE = 32 * 1024 * 1024;
+private:
+	static uint8_t * & base() {
+		static uint8_t *base = nullptr;
+		return base;
+	}
+	static size_t & used() {
+		static size_t used = 0;
+		return used;
+	}
+public:
+	// copy the code of a method into the code cache, which is never writable and executable at the same time: the code is
+	// written into read-write pages, then they are turned read-execute. a method takes whole pages, so no page of the code
+	// cache is written again once it's executable. nullptr if the code cache is full or can't be mapped.
+	static uint8_t *install(const uint8_t *code, size_t size);
+	static size_t get_used() { return used(); }
+	static void cleanup();
+};
+
+/**
+ * the x86-64 code of one method, made by the baseline template compiler.
+ * the compiled code keeps all the values in the frame's lvt and op_stack slots, exactly the same as the interpreter does,
+ * so it can be entered at the start of every reachable bytecode (`entries`), and comes back to the interpreter at the start
+ * of every bytecode it can't run by itself, e.g. invokes, field accesses, allocations and exceptions, and at the target of
+ * a taken backward branch if the thread's safepoint poll is armed.
+ */
+class JitCode {
+	friend class Jit;
+private:
+	typedef int (*entry_t)(StackFrame *frame, uint8_t *target, const void *poll);		// returns the bci to go on with in the interpreter.
+private:
+	Method *method;
+	uint8_t *code;					// in the CodeCache. starts with the entry stub.
+	size_t code_size;
+	std::vector<int> entries;		// indexed by bci: offset of the bytecode's code in `code`, or -1.
+	int compile_id;
+	bool is_osr;					// compiled because of the back-edge counter.
+public:
+	JitCode(Method *method, uint8_t *code, size_t code_size, std::vector<int> && entries, int compile_id, bool is_osr)
+		: method(method), code(code), code_size(code_size), entries(std::move(entries)), compile_id(compile_id), is_osr(is_osr) {}
+	int run(StackFrame *frame, int bci, const void *poll) {		// run the compiled code of `frame` from `bci`, polling the thread's `poll` word. returns the bci the interpreter should go on with.
+		int offset = entries[bci];
+		if (offset < 0)	return bci;
+		return ((entry_t)code)(frame, code + offset, poll);
+	}
+	size_t get_code_size() { return code_size; }
+	bool is_compiled_by_osr() { return is_osr; }
+};
+
+/**
+ * the baseline template compiler. a method is compiled when its invocation counter or back-edge counter comes up to
+ * the threshold, in the thread which runs it. `-Xint` turns it off, and `-XX:+PrintCompilation` logs every compilation.
+ */
+class Jit {
+public:
+	static const unsigned INVOCATION_THRESHOLD = 1500;
+	static const unsigned BACKEDGE_THRESHOLD = 10000;
+private:
+	static Lock & compile_lock() {
+		static Lock compile_lock;
+		return compile_lock;
+	}
+	static std::list<JitCode *> & all_codes() {
+		static std::list<JitCode *> all_codes;
+		return all_codes;
+	}
+	static JitCode *compile(Method *method, bool is_osr);
+public:
+	static JitCode *on_invocation(Method *method) {		// the compiled code to run `method` with, or nullptr to interpret it.
+		unsigned count = method->inc_invocation_counter();
+		JitCode *jit_code = method->get_jit_code().load(std::memory_order_acquire);
+		if (jit_code == nullptr && count >= INVOCATION_THRESHOLD
+								&& !method->get_not_compilable().load(std::memory_order_relaxed) && !VMOptions::use_interpreter_only()) {
+			jit_code = compile(method, false);
+		}
+		return jit_code;
+	}
+	static JitCode *on_backedge(Method *method) {		// the same as above, for a taken backward branch (on-stack replacement).
+		unsigned count = method->inc_backedge_counter();
+		JitCode *jit_code = method->get_jit_code().load(std::memory_order_acquire);
+		if (jit_code == nullptr && count >= BACKEDGE_THRESHOLD
+								&& !method->get_not_compilable().load(std::memory_order_relaxed) && !VMOptions::use_interpreter_only()) {
+			jit_code = compile(method, true);
+		}
+		return jit_code;
+	}
+	static void cleanup();
+};
+
+
+
+#endif /* INCLUDE_RUNTIME_JIT_HPP_ */
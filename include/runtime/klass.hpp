@@ -51,6 +51,13 @@ enum OopType {
 	_TypeArrayOop,
 };
 
+enum ReferenceType {		// of the subclasses of java/lang/ref/Reference, whose `referent` the gc treats specially. see: `ReferenceProcessor`.
+	REF_NONE,				// not a Reference, or a FinalReference: the referent is traced as any other field.
+	REF_SOFT,
+	REF_WEAK,
+	REF_PHANTOM,
+};
+
 class Oop;
 class MirrorOop;
 class rt_constant_pool;
@@ -126,15 +133,21 @@ private:
 	unordered_map<wstring, InstanceKlass *> interfaces;
 	// should add message to recode whether this field is parent klass's field, for java/lang/Class.getDeclaredFields0()...
 	unordered_map<int, bool> is_this_klass_field;		// don't use vector<bool>...		// use fields_layout.second.first as index.
-	unordered_map<wstring, pair<int, Field_info *>> fields_layout;			// non-static field layout. [values are in oop]. <classname+':'+name+':'+descriptor, <fields' offset, Field_info>>
+	unordered_map<wstring, pair<int, Field_info *>> fields_layout;			// non-static field layout. [values are inline in oop]. <classname+':'+name+':'+descriptor, <fields' byte offset, Field_info>>
 	unordered_map<wstring, pair<int, Field_info *>> static_fields_layout;	// static field layout.	<name+':'+descriptor, <static_fields' offset, Field_info>>
 	int total_non_static_fields_num = 0;
+	int total_non_static_fields_bytes = 0;		// size of the inline fields of an InstanceOop. parent's fields first, then this klass's.
+	vector<int> oop_fields_offsets;				// byte offsets of all the reference fields (with parents'), for gc.
+	ReferenceType reference_type = REF_NONE;	// inherited from the parent.
 	int total_static_fields_num = 0;
 //	Oop **static_fields = nullptr;												// static field values. [non-static field values are in oop].
 	vector<Oop *> static_fields;
 	// static methods + vtable + itable
-	// TODO: miranda Method !!					// I cancelled itable. I think it will copy from parents' itable and all interface's itable, very annoying... And it's efficiency in my spot based on looking up by wstring, maybe lower than directly looking up...
-	unordered_map<wstring, Method *> vtable;		// this vtable save's all father's vtables and override with this class-self. save WITHOUT private/static methods.(including final methods)
+	// TODO: miranda Method !!
+	vector<Method *> vtable;					// indexed by `Method::vtable_index`. copies father's vtable and overrides with this class-self, so a slot keeps its index in all subclasses. save WITHOUT static methods.(including private and final methods)
+	unordered_map<wstring, int> vtable_slots;	// <name+':'+descriptor, vtable slot>. only for linking and searching by name.
+	vector<Method *> itable;					// if this is an interface: its own methods, indexed by `Method::itable_index`. else: for every implemented interface, a block of the implementations.
+	vector<pair<InstanceKlass *, int>> itable_offsets;		// <implemented interface, where its block begins in `itable`>.
 	unordered_map<wstring, pair<int, Method *>> methods;	// all methods. These methods here are only for parsing constant_pool. Because `invokestatic`, `invokespecial` directly go to the constant_pool to get the method. WILL NOT go into the Klass to find !! [the `pair<int, ...>` 's int is the slot number. for: sun/reflect/NativeConstructorAccessorImpl-->newInstance0]
 	// constant pool
 	rt_constant_pool *rt_pool;
@@ -164,6 +177,8 @@ private:
 	void parse_superclass(ClassFile *cf, ClassLoader *loader);
 	void parse_interfaces(ClassFile *cf, ClassLoader *loader);
 	void parse_attributes(ClassFile *cf);
+	void link_itable();
+	void add_itable_block(InstanceKlass *interface);
 public:
 	void parse_constantpool(ClassFile *cf, ClassLoader *loader);	// only initialize.
 public:
@@ -176,7 +191,8 @@ public:
 public:
 	vector<Oop *> & get_static_fields_addr() { return static_fields; }
 private:
-	void initialize_field(unordered_map<wstring, pair<int, Field_info *>> & fields_layout, vector<Oop *> & fields);		// initializer for parse_fields() and InstanceOop's Initialization
+	void initialize_field(unordered_map<wstring, pair<int, Field_info *>> & fields_layout, vector<Oop *> & fields);		// initializer for the static fields in parse_fields(). the non-static ones are zeroed inline.
+	void layout_fields(vector<Field_info *> & this_klass_fields);
 public:
 	InstanceKlass *get_hostklass() { return host_klass; }
 	void set_hostklass(InstanceKlass *hostklass) { host_klass = hostklass; }
@@ -186,11 +202,15 @@ public:
 	Method *get_this_class_method(const wstring & signature);		// [name + ':' + descriptor]		// we should usually use this method. Because when when we find `<clinit>`, the `get_class_method` can get parent's <clinit> !!! if this has a <clinit>, too, Will go wrong.
 	Method *get_interface_method(const wstring & signature);		// [name + ':' + descriptor]
 	int non_static_field_num() { return total_non_static_fields_num; }
+	int non_static_field_bytes() { return total_non_static_fields_bytes; }
+	const vector<int> & get_oop_fields_offsets() { return oop_fields_offsets; }
+	ReferenceType get_reference_type() { return reference_type; }
 	bool get_static_field_value(Field_info *field, Oop **result);		// self-maintain a ptr to pass in...
 	void set_static_field_value(Field_info *field, Oop *value);
 	bool get_static_field_value(const wstring & signature, Oop **result);			// use for forging String Oop at parsing constant_pool. However I don't no static field is of use ?
 	void set_static_field_value(const wstring & signature, Oop *value);		// as above.
 	Method *search_vtable(const wstring & signature);
+	Method *select_method(Method *resolved_method);		// virtual/interface dispatch: find the implementation of `resolved_method` in this klass by the vtable/itable index.
 	rt_constant_pool *get_rtpool() { return rt_pool; }
 	ClassLoader *get_classloader() { return this->loader; }
 	bool check_interfaces(const wstring & signature);		// find signature is `this_klass`'s parent interface.
@@ -207,7 +227,8 @@ public:
 		bool success2 = (parent == nullptr) ? false : ((InstanceKlass *)parent)->check_parent(klass);
 		return success1 || success2;
 	}
-	InstanceOop* new_instance();
+	InstanceOop* new_instance();			// for the vm: see `MemAlloc::allocate()`.
+	InstanceOop* try_new_instance();		// nullptr if the heap is exhausted.
 	Method *search_method_in_slot(int slot);
 private:		// for Unsafe
 	int get_static_field_offset(const wstring & signature);
@@ -219,7 +240,7 @@ public:		// for reflection.
 	vector<pair<int, Method *>> get_constructors();
 	vector<pair<int, Method *>> get_declared_methods();
 public:		// for invokedynamic.
-	bool is_in_vtable(Method *m) { wstring signature = m->get_name() + L":" + m->get_descriptor(); return vtable.find(signature) != vtable.end(); }
+	bool is_in_vtable(Method *m) { wstring signature = m->get_name() + L":" + m->get_descriptor(); return vtable_slots.find(signature) != vtable_slots.end(); }
 	const auto & get_field_layout() { return this->fields_layout; }
 	const auto & get_static_field_layout() { return this->static_fields_layout; }
 	BootstrapMethods_attribute *get_bm() { return this->bm; }
@@ -258,9 +279,11 @@ public:
 	Klass * get_lower_dimension() { return lower_dimension; }
 	void set_lower_dimension(Klass * lower) { lower_dimension = lower; }
 	int get_dimension() { return dimension; }
-	ArrayOop* new_instance(int length);
+	ArrayOop* new_instance(int length);			// for the vm: see `MemAlloc::allocate()`.
+	ArrayOop* try_new_instance(int length);		// nullptr if the heap is exhausted.
 private:
 	ArrayKlass(const ArrayKlass &);
+	ArrayOop* allocate_instance(int length, void *(*alloc)(size_t));
 public:
 	MirrorOop *get_java_loader() { return this->java_loader; }
 	Method *get_class_method(const wstring & signature) {
@@ -276,8 +299,10 @@ public:
 class TypeArrayKlass : public ArrayKlass {
 private:
 	Type type;		// I dont' want to set the MAXLENGTH.
+	int elem_size;	// bytes of an element of the one-dimension array. (1/2/4/8)
 public:
 	Type get_basic_type() { return type; }
+	int get_elem_size() { return elem_size; }
 private:
 	TypeArrayKlass(const TypeArrayKlass &);
 public:
@@ -10,6 +10,7 @@
 #include "annotation.hpp"
 #include "utils/synchronize_wcout.hpp"
 #include <list>
+#include <atomic>
 #include "utils/lock.hpp"
 
 using std::wstring;
@@ -19,6 +20,8 @@ using std::list;
 class MirrorOop;
 class InstanceKlass;
 class Method;
+class InlineCache;
+class JitCode;
 
 class Method_Pool {
 private:
@@ -27,6 +30,7 @@ private:
 	static list<Method *> & method_pool();
 public:
 	static void put(Method *method);
+	static list<Method *> get_all_methods();		// a snapshot.
 	static void cleanup();
 };
 
@@ -43,6 +47,22 @@ private:
 
 	wstring real_descriptor;		// a special patch: for MethodHandle.invoke***(Object...). these methods' descritpor must be [[Ljava/lang/Object;]. the real args are here.
 
+	vector<wchar_t> arg_kinds;		// one descriptor char for each argument: 'Z', 'B', 'C', 'S', 'I', 'F', 'J', 'D', or 'L' for all references. (without `this`)
+	int arg_slot_num = 0;			// interpreter slots the arguments take (without `this`). long and double take 2 slots.
+	wchar_t ret_kind;				// the same as `arg_kinds`, and 'V' for void.
+
+	int vtable_index = -1;			// slot in `InstanceKlass::vtable`. the overriding methods in the subclasses share the same slot. -1: static.
+	int itable_index = -1;			// only for interface methods: index in this interface's block of `InstanceKlass::itable`.
+
+	std::atomic<InlineCache **> inline_caches{nullptr};		// indexed by bci. made at the first virtual call in this method.
+
+	// the profile. always on: the jit and -Xprof both read them. they are not precise when many threads run the same method.
+	std::atomic<unsigned> invocation_counter{0};
+	std::atomic<unsigned> backedge_counter{0};		// taken backward branches, in the interpreter and in the compiled code.
+	std::atomic<unsigned> sample_counter{0};		// SIGPROF samples with this method on the top of the stack. (-Xprof)
+	std::atomic<JitCode *> jit_code{nullptr};		// published once the method has been compiled.
+	std::atomic<bool> not_compilable{false};
+
 	u2 access_flags;
 
 	// constant pool ** use for <code> and so on
@@ -94,8 +114,27 @@ public:
 	static wstring return_type(const wstring & descriptor) { return descriptor.substr(descriptor.find_first_of(L")")+1); }
 	static vector<MirrorOop *> parse_argument_list(const wstring & descriptor);
 	static MirrorOop *parse_return_type(const wstring & return_type);
+	static wchar_t parse_descriptor_kinds(const wstring & descriptor, vector<wchar_t> & arg_kinds, int & arg_slot_num);	// returns the return kind.
 public:
-	void set_real_descriptor (const wstring & real_descriptor) { this->real_descriptor = real_descriptor; }	// for MethodHandle.invoke**(...) only.
+	void set_real_descriptor (const wstring & real_descriptor) { this->real_descriptor = real_descriptor; parse_arg_kinds(real_descriptor); }	// for MethodHandle.invoke**(...) only.
+	void parse_arg_kinds(const wstring & descriptor);
+	const vector<wchar_t> & get_arg_kinds() { return arg_kinds; }
+	int get_arg_slot_num() { return arg_slot_num; }
+	wchar_t get_ret_kind() { return ret_kind; }
+	int get_vtable_index() { return vtable_index; }
+	void set_vtable_index(int index) { vtable_index = index; }
+	int get_itable_index() { return itable_index; }
+	void set_itable_index(int index) { itable_index = index; }
+	std::atomic<InlineCache **> & get_inline_caches() { return inline_caches; }
+	// a relaxed load and store instead of `fetch_add`: no locked instruction on every call. a few counts may be lost.
+	unsigned inc_invocation_counter() { unsigned count = invocation_counter.load(std::memory_order_relaxed) + 1; invocation_counter.store(count, std::memory_order_relaxed); return count; }
+	unsigned inc_backedge_counter() { unsigned count = backedge_counter.load(std::memory_order_relaxed) + 1; backedge_counter.store(count, std::memory_order_relaxed); return count; }
+	void inc_sample_counter() { sample_counter.store(sample_counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+	std::atomic<unsigned> & get_invocation_counter() { return invocation_counter; }
+	std::atomic<unsigned> & get_backedge_counter() { return backedge_counter; }
+	std::atomic<unsigned> & get_sample_counter() { return sample_counter; }
+	std::atomic<JitCode *> & get_jit_code() { return jit_code; }
+	std::atomic<bool> & get_not_compilable() { return not_compilable; }
 	vector<MirrorOop *> if_didnt_parse_exceptions_then_parse();
 	vector<MirrorOop *> parse_argument_list();
 	MirrorOop *parse_return_type();
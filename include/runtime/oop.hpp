@@ -12,9 +12,13 @@
 #include "runtime/field.hpp"
 #include "utils/monitor.hpp"
 #include "utils/lock.hpp"
+#include "runtime/heap.hpp"
+#include "runtime/satb.hpp"
 
 #include <cstdlib>
 #include <cstring>
+#include <cstdint>
+#include <cassert>
 #include <memory>
 #include <list>
 
@@ -23,25 +27,26 @@ using std::list;
 
 class Mempool {
 public:
-	static list<Oop *> & oop_handler_pool() {
-		static list<Oop *> oop_handler_pool;
-		return oop_handler_pool;
-	}
-	static Oop *copy(Oop & oop);
+	static Oop *copy(Oop & oop, void *buf);
 };
 
-class MemAlloc {
-private:
-	static Lock & mem_lock() {
-		static Lock mem_lock;
-		return mem_lock;
-	}
+class MemAlloc {		// all the oops are in the java heap. see: `Heap`.
 public:
-	static void *allocate(size_t size, bool);
-	static void deallocate(void *ptr);
-	static void *operator new(size_t size, bool = false) throw();
+	static void *allocate(size_t size);				// zeroed. out of the vm reserve if the heap is exhausted: then an OutOfMemoryError is pending.
+	static void *try_allocate(size_t size);			// zeroed. nullptr if the heap is exhausted: the caller throws the OutOfMemoryError.
+	[[noreturn]] static void out_of_memory(size_t size);
+	static size_t & failed_size() {					// of the last `try_allocate()` of this thread which returned nullptr.
+		static thread_local size_t failed_size = 0;
+		return failed_size;
+	}
+	static bool & out_of_memory_pending() {			// `allocate()` took the vm reserve. see: `BytecodeEngine::check_pending_out_of_memory()`.
+		static thread_local bool out_of_memory_pending = false;
+		return out_of_memory_pending;
+	}
+	static void deallocate(void *ptr);				// nothing: the gc frees the dead oops. they have no destructor to run.
+	static void *operator new(size_t size) throw();
 	static void *operator new(size_t size, const std::nothrow_t &) throw() { exit(-2); }		// do not use it.
-	static void *operator new[](size_t size, bool = false) throw();
+	static void *operator new[](size_t size) throw();
 	static void *operator new[](size_t size, const std::nothrow_t &) throw() { exit(-2); }		// do not use it.
 	static void operator delete(void *ptr);
 	static void operator delete[](void *ptr);
@@ -56,37 +61,38 @@ protected:
 	// TODO: HashCode .etc
 	OopType ooptype;
 	Klass *klass = nullptr;
-	Monitor m;
+	ThinLock m;		// one word. a monitor is only inflated for contention or wait/notify.
 public:
 	// TODO: HashCode .etc
 	Klass *get_klass() { return klass; }
 	OopType get_ooptype() { return ooptype; }
 public:
-	void enter_monitor() { m.enter(); }
-	void wait() { m.wait(); }
-	void wait(long macro_sec) { m.wait(macro_sec); }
+	void enter_monitor() { m.enter(this); }
+	void wait() { m.wait(this, 0); }
+	void wait(long millis) { m.wait(this, millis); }
 	void notify() { m.notify(); }
 	void notify_all() { m.notify_all(); }
 	void leave_monitor() { m.leave(); }
-	void force_unlock_when_athrow() { m.force_unlock_when_athrow(); }
+	bool is_locked() { return m.is_locked(); }		// by any thread. only for the gc, when the threads are stopped.
+	int identity_hash() { return Heap::identity_hash(this); }		// `Object.hashCode()`: in the block header, so it survives the copies.
 public:
 	explicit Oop(Klass *klass, OopType ooptype) : klass(klass), ooptype(ooptype) {}
-	Oop(const Oop & rhs) : ooptype(rhs.ooptype), klass(rhs.klass) {}		// Monitor don't copy !!
-	virtual ~Oop() {}			// ***VERY, VERY, VERY, VERY IMPORTANT!!!***
-	virtual Oop *copy();			// only use for gc:
+	Oop(const Oop & rhs) : ooptype(rhs.ooptype), klass(rhs.klass) {}		// lock word don't copy !! gc moves it by itself.
+	virtual ~Oop() {}			// never run: every oop must keep all of its data in the heap, so the gc can drop the dead ones without a look.
+	virtual Oop *copy(void *buf);		// only use for gc: copy this oop into `buf`, which has the size of this oop's heap block.
 };
 
 class InstanceOop : public Oop {	// Oop::klass must be an InstanceKlass type.
 	friend GC;
-private:
-	int field_length;
-	vector<Oop *> fields;	// save a lot of mixed datas. int, float, Long, Reference... if it's Reference, it will point to a Oop object.
+protected:
+	int fields_offset;		// the non-static fields are inline after the C++ object: [InstanceOop or MirrorOop][fields]. laid out by `InstanceKlass::layout_fields()`.
+	int field_length;		// bytes of the fields.
 public:
-	InstanceOop(InstanceKlass *klass);
-	InstanceOop(const InstanceOop & rhs);		// shallow copy
+	InstanceOop(InstanceKlass *klass);		// must be placed in `sizeof(InstanceOop) + klass->non_static_field_bytes()` bytes. see: `InstanceKlass::new_instance()`.
+	InstanceOop(const InstanceOop & rhs);		// shallow copy, with the fields.
 public:
-	bool get_field_value(Field_info *field, Oop **result);
-	void set_field_value(Field_info *field, Oop *value);
+	bool get_field_value(Field_info *field, Oop **result);		// boxes the primitive value.
+	void set_field_value(Field_info *field, Oop *value);			// unboxes the primitive value.
 	bool get_field_value(const wstring & BIG_signature, Oop **result);				// use for forging String Oop at parsing constant_pool.
 	void set_field_value(const wstring & BIG_signature, Oop *value);					// BIG_signature is: <classname + ':' + name + ':' + descriptor>...
 	bool get_static_field_value(Field_info *field, Oop **result) { return ((InstanceKlass *)klass)->get_static_field_value(field, result); }
@@ -94,25 +100,31 @@ public:
 	bool get_static_field_value(const wstring & signature, Oop **result) { return ((InstanceKlass *)klass)->get_static_field_value(signature, result); }
 	void set_static_field_value(const wstring & signature, Oop *value) { ((InstanceKlass *)klass)->set_static_field_value(signature, value); }
 public:
+	uint8_t *get_fields_addr() { return (uint8_t *)this + fields_offset; }		// for Unsafe.
+	template <typename T>
+	T & field_at(int offset) {			// the raw value of the field at `offset` (`Field_info::get_offset()`). no boxing.
+		assert(offset >= 0 && offset + sizeof(T) <= field_length);
+		return *(T *)(get_fields_addr() + offset);
+	}
 	int get_all_field_offset(const wstring & BIG_signature);			// for Unsafe.
-	vector<Oop *> & get_fields_addr() { return fields; }				// for Unsafe.
+	InstanceOop *clone();			// for Object.clone(). nullptr if the heap is exhausted.
 private:
 	int get_static_field_offset(const wstring & signature);			// for Unsafe
 //public:	// deprecated.
 //	unsigned long get_value(const wstring & signature);
 //	void set_value(const wstring & signature, unsigned long value);
 public:		// for gc:
-	virtual Oop *copy();
+	virtual Oop *copy(void *buf);
 };
 
 class MirrorOop : public InstanceOop {	// for java_mirror. Because java_mirror->klass must be java.lang.Class...... We'd add a varible: mirrored_who.
 	friend GC;
 private:
 	Klass * mirrored_who = nullptr;		// this Oop being instantiation, must after java.lang.Class loaded !!!
-	wstring extra;						// bad design... if it's basic type like int, long, use the `extra`. this time , mirrored_who == nullptr.
+	wchar_t extra = L'\0';				// bad design... if it's basic type like int, long, use the `extra`: `I`, `J`... this time , mirrored_who == nullptr.
 public:
-	wstring get_extra() { return extra; }
-	void set_extra(const wstring & s) { extra = s; }
+	wstring get_extra() { return extra == L'\0' ? wstring() : wstring(1, extra); }
+	void set_extra(const wstring & s) { assert(s.size() == 1); extra = s[0]; }
 public:
 	MirrorOop(Klass *mirrored_who);
 	MirrorOop(const MirrorOop & rhs);
@@ -132,23 +144,27 @@ public:
 //		return this_static_field_map.find(signature) != this_static_field_map.end();
 //	}
 public:		// for gc:
-	virtual Oop *copy();
+	virtual Oop *copy(void *buf);
 };
 
 class ArrayOop : public Oop {
 	friend GC;
 protected:
-	vector<Oop *> buf;
+	int length;
+	int elem_size;		// the elements are inline, right after the oop: raw values (1/2/4/8 bytes) of a one-dimension TypeArrayOop, else `Oop *`.
+protected:
+	uint8_t *get_elems() { return (uint8_t *)this + sizeof(ArrayOop); }
 public:
-	ArrayOop(ArrayKlass *klass, int length, OopType ooptype) : Oop(klass, ooptype) {
-		buf.resize(length);
-	}
-	ArrayOop(const ArrayOop & rhs);
-	int get_length() { return buf.size(); }
+	ArrayOop(ArrayKlass *klass, int length, OopType ooptype);		// must be placed in `get_size()` bytes. see: `ArrayKlass::new_instance()`.
+	ArrayOop(const ArrayOop & rhs);			// copies the elements, too.
+	int get_length() { return length; }
 	int get_dimension() { return ((ArrayKlass *)klass)->get_dimension(); }
+	int get_elem_size() { return elem_size; }
+	size_t get_size() { return sizeof(ArrayOop) + (size_t)length * elem_size; }		// bytes of the oop with its elements.
+	bool has_ref_elems() { return ooptype == OopType::_ObjArrayOop || get_dimension() > 1; }		// ([[I 's elements are [I.)
 	Oop* & operator[] (int index) {
-		assert(index >= 0 && index < buf.size());	// TODO: please replace with ArrayIndexOutofBound...
-		return buf[index];
+		assert(has_ref_elems() && index >= 0 && index < length);	// TODO: please replace with ArrayIndexOutofBound...
+		return ((Oop **)get_elems())[index];
 	}
 	const Oop* operator[] (int index) const {
 		return this->operator[](index);
@@ -157,23 +173,47 @@ public:
 //		return ((char *)&buf - (char *)this);
 		return 0;
 	}
-public:		// for gc:
-	virtual Oop *copy();
 };
 
 class TypeArrayOop : public ArrayOop {
-public:		// Most inner type of `buf` is BasicTypeOop.
+	friend GC;
+public:
 	TypeArrayOop(TypeArrayKlass *klass, int length) : ArrayOop(klass, length, OopType::_TypeArrayOop) {}
+	TypeArrayOop(const TypeArrayOop & rhs) : ArrayOop(rhs) {}
 public:
-
+	uint8_t *get_base() { assert(get_dimension() == 1); return get_elems(); }
+	template <typename T>
+	T & elem_at(int index) {			// the raw element. T must be the element type, e.g. `uint16_t` for char[], `int8_t` for byte[] and boolean[].
+		assert(sizeof(T) == elem_size && index >= 0 && index < length);		// TODO: please replace with ArrayIndexOutofBound...
+		return ((T *)get_base())[index];
+	}
+	TypeArrayOop *clone();		// for Object.clone(). nullptr if the heap is exhausted.
+public:		// for gc:
+	virtual Oop *copy(void *buf);
 };
 
 class ObjArrayOop : public ArrayOop {
-public:		// Most inner type of `buf` is InstanceOop.
+public:		// Most inner type of the elements is InstanceOop.
 	ObjArrayOop(ObjArrayKlass * klass, int length) : ArrayOop(klass, length, OopType::_ObjArrayOop) {}
+	ObjArrayOop(const ObjArrayOop & rhs) : ArrayOop(rhs) {}
 public:
+	ObjArrayOop *clone();		// for Object.clone(). nullptr if the heap is exhausted.
+public:		// for gc:
+	virtual Oop *copy(void *buf);
 };
 
+/**
+ * every store of a reference into an oop goes through here, after it's allocated: it logs the overwritten oop while the
+ * old generation is concurrently marked (see: `Satb::pre_write_barrier()`), and dirties the card of `obj`, for the
+ * minor gc to find the old-to-young pointers (see: `Heap::post_write_barrier()`).
+ */
+inline void oop_store(Oop *obj, Oop * & slot, Oop *value)
+{
+	Satb::pre_write_barrier(slot);
+	slot = value;
+	Heap::post_write_barrier(obj);
+}
+
 
 // Basic Type...
 
@@ -183,31 +223,31 @@ private:
 public:
 	BasicTypeOop(Type type) : Oop(nullptr, OopType::_BasicTypeOop), type(type) {}
 	Type get_type() { return type; }
-	virtual Oop *copy() override;
+	virtual Oop *copy(void *buf) override;
 };
 
 struct IntOop : public BasicTypeOop {
 	int value;		// data
 	IntOop(int value) : BasicTypeOop(Type::INT), value(value) {}
-	virtual Oop *copy() override;
+	virtual Oop *copy(void *buf) override;
 };
 
 struct FloatOop : public BasicTypeOop {
 	float value;		// data
 	FloatOop(float value) : BasicTypeOop(Type::FLOAT), value(value) {}
-	virtual Oop *copy() override;
+	virtual Oop *copy(void *buf) override;
 };
 
 struct LongOop : public BasicTypeOop {
 	long value;		// data
 	LongOop(long value) : BasicTypeOop(Type::LONG), value(value) {}
-	virtual Oop *copy() override;
+	virtual Oop *copy(void *buf) override;
 };
 
 struct DoubleOop : public BasicTypeOop {
 	double value;		// data
-	DoubleOop(float value) : BasicTypeOop(Type::DOUBLE), value(value) {}
-	virtual Oop *copy() override;
+	DoubleOop(double value) : BasicTypeOop(Type::DOUBLE), value(value) {}
+	virtual Oop *copy(void *buf) override;
 };
 
 #endif /* INCLUDE_RUNTIME_OOP_HPP_ */
@@ -0,0 +1,53 @@
+/*
+ * profiler.hpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#ifndef INCLUDE_RUNTIME_PROFILER_HPP_
+#define INCLUDE_RUNTIME_PROFILER_HPP_
+
+#include <atomic>
+#include <iostream>
+
+class vm_thread;
+
+/**
+ * the method hotness profile (-Xprof).
+ * the invocation and back-edge counters of every Method are always on. -Xprof adds the self time: every SAMPLE_INTERVAL_US
+ * of cpu time, SIGPROF interrupts a running thread, and the method on the top of its java stack gets one sample.
+ * the profile is printed at exit, or on SIGQUIT (`kill -3`, see: `SIGQUIT_thread()` of wind_jvm.cpp).
+ */
+class Profiler {
+public:
+	static const int SAMPLE_INTERVAL_US = 10 * 1000;
+	static const int MAX_PRINT_METHODS = 100;
+private:
+	static vm_thread * & current_thread() {		// the vm_thread running on this pthread. read by the signal handler.
+		static thread_local vm_thread *current_thread = nullptr;
+		return current_thread;
+	}
+	static std::atomic<bool> & sampling() {
+		static std::atomic<bool> sampling(false);
+		return sampling;
+	}
+	static std::atomic<long> & total_samples() {
+		static std::atomic<long> total_samples(0);
+		return total_samples;
+	}
+	static std::atomic<long> & vm_samples() {		// samples without a java frame: the gc thread, or the vm itself.
+		static std::atomic<long> vm_samples(0);
+		return vm_samples;
+	}
+	static void SIGPROF_handler(int signo);
+public:
+	static void start();		// called before any thread is created.
+	static void stop();
+	static void attach(vm_thread *thread) { current_thread() = thread; }
+	static void detach() { current_thread() = nullptr; }
+	static void dump(std::wostream & os);
+};
+
+
+
+#endif /* INCLUDE_RUNTIME_PROFILER_HPP_ */
@@ -0,0 +1,146 @@
+/*
+ * reference_processor.hpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#ifndef INCLUDE_RUNTIME_REFERENCE_PROCESSOR_HPP_
+#define INCLUDE_RUNTIME_REFERENCE_PROCESSOR_HPP_
+
+#include <vector>
+#include <cstddef>
+#include "runtime/klass.hpp"
+#include "runtime/oop.hpp"
+
+class Field_info;
+
+/**
+ * the java.lang.ref.References. a collection "discovers" a Soft/Weak/PhantomReference when it scans one whose referent is
+ * not known to be live yet: the referent is not traced through it. after the tracing, the referent of a discovered one is
+ * either live (reached some other way: kept, at its new address) or dead (cleared), and a cleared Reference registered
+ * with a ReferenceQueue is put on `Reference.pending`, linked through `discovered`, with `next` pointing to itself.
+ *   - minor gc: the References copied into the to-survivor space, with a young referent.
+ *   - full gc: all the References, with an unmarked referent.
+ *   - concurrent marking: the old References, with an unmarked old referent. `Reference.get()` (a getfield of `referent`)
+ *     logs the referent with the SATB barrier while the marking runs, so the one a program takes out is not swept.
+ * a SoftReference is only discovered (so, maybe cleared) if it's not used for `free heap in MB * SoftRefLRUPolicyMSPerMB`
+ * ms, like the LRUMaxHeapPolicy of hotspot, or if the pause is about to throw an OutOfMemoryError. a PhantomReference is
+ * cleared as it's enqueued (`get()` returns null anyway), so its referent is freed at once.
+ * the ReferenceHandler thread is not started here, so the gc does its work at the end of the pause: the pending ones go into
+ * their queues, unless the lock of the queue (or `Reference.lock`) is held by a stopped thread. these wait for the next pause.
+ * a Cleaner is left on the pending list for `JavaLangRefAccess.tryHandlePendingReference()`: its `clean()` is java code.
+ */
+class ReferenceProcessor {
+private:
+	static Field_info * & referent_field() {			// of java/lang/ref/Reference.
+		static Field_info *referent_field = nullptr;
+		return referent_field;
+	}
+	static int & referent_offset() {
+		static int referent_offset = -1;
+		return referent_offset;
+	}
+	static int & queue_offset() {
+		static int queue_offset = -1;
+		return queue_offset;
+	}
+	static int & next_offset() {
+		static int next_offset = -1;
+		return next_offset;
+	}
+	static int & discovered_offset() {
+		static int discovered_offset = -1;
+		return discovered_offset;
+	}
+	static InstanceKlass * & reference_klass() {		// its statics: `pending` and `lock`.
+		static InstanceKlass *reference_klass = nullptr;
+		return reference_klass;
+	}
+	static int & pending_index() {
+		static int pending_index = -1;
+		return pending_index;
+	}
+	static int & reference_lock_index() {
+		static int reference_lock_index = -1;
+		return reference_lock_index;
+	}
+	static InstanceKlass * & soft_reference_klass() {	// its static `clock`, and `timestamp` of every SoftReference: the last `get()`.
+		static InstanceKlass *soft_reference_klass = nullptr;
+		return soft_reference_klass;
+	}
+	static int & clock_index() {
+		static int clock_index = -1;
+		return clock_index;
+	}
+	static int & timestamp_offset() {
+		static int timestamp_offset = -1;
+		return timestamp_offset;
+	}
+	static InstanceKlass * & queue_klass() {			// java/lang/ref/ReferenceQueue: its statics `NULL` and `ENQUEUED`.
+		static InstanceKlass *queue_klass = nullptr;
+		return queue_klass;
+	}
+	static int & null_queue_index() {
+		static int null_queue_index = -1;
+		return null_queue_index;
+	}
+	static int & enqueued_queue_index() {
+		static int enqueued_queue_index = -1;
+		return enqueued_queue_index;
+	}
+	static int & queue_lock_offset() {
+		static int queue_lock_offset = -1;
+		return queue_lock_offset;
+	}
+	static int & queue_head_offset() {
+		static int queue_head_offset = -1;
+		return queue_head_offset;
+	}
+	static int & queue_length_offset() {
+		static int queue_length_offset = -1;
+		return queue_length_offset;
+	}
+	static Klass * & cleaner_klass() {					// sun/misc/Cleaner.
+		static Klass *cleaner_klass = nullptr;
+		return cleaner_klass;
+	}
+	static long & soft_clock() {						// `SoftReference.clock` at the beginning of the pause.
+		static long soft_clock = 0;
+		return soft_clock;
+	}
+	static long & soft_max_interval() {				// ms. a SoftReference not used for longer is discovered.
+		static long soft_max_interval = 0;
+		return soft_max_interval;
+	}
+	static bool & clear_all_soft() {
+		static bool clear_all_soft = false;
+		return clear_all_soft;
+	}
+	static size_t & free_at_last_gc() {
+		static size_t free_at_last_gc = 0;
+		return free_at_last_gc;
+	}
+private:
+	static long now_ms();
+	static Oop * & static_at(InstanceKlass *klass, int index) { return klass->get_static_fields_addr()[index]; }
+	static Oop * & field(Oop *oop, int offset) { return ((InstanceOop *)oop)->field_at<Oop *>(offset); }
+	static Oop * & pending() { return static_at(reference_klass(), pending_index()); }
+	static int enqueue(Oop *ref);			// ReferenceQueue.enqueue(). 1: enqueued, 0: no queue to go, -1: the queue is locked.
+public:
+	static void register_klass(InstanceKlass *klass);		// when `klass` is parsed: the fields of java/lang/ref.
+	static bool is_referent_field(Field_info *field) { return field == referent_field(); }
+	static ReferenceType type_of(Oop *oop) {
+		return (oop->get_ooptype() == OopType::_InstanceOop) ? ((InstanceKlass *)oop->get_klass())->get_reference_type() : REF_NONE;
+	}
+	static int get_referent_offset() { return referent_offset(); }
+	static Oop * & referent_of(Oop *ref) { return field(ref, referent_offset()); }
+	static bool should_discover(Oop *ref);		// false for a SoftReference the policy keeps: its referent is traced as a field.
+	static void begin_pause(bool clear_all_soft);		// the soft policy of the pause, and of the concurrent marking after it.
+	// the discovered ones: `referent(oop)` returns where a live referent is now, or nullptr if it's dead. `cleared` is by ReferenceType.
+	static void process(std::vector<Oop *> & discovered, Oop *(*referent)(Oop *), long *cleared);
+	static long enqueue_pending();		// the work of the ReferenceHandler. returns the ones put into their queues.
+	static void end_pause();
+};
+
+
+#endif /* INCLUDE_RUNTIME_REFERENCE_PROCESSOR_HPP_ */
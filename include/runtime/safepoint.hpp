@@ -0,0 +1,68 @@
+/*
+ * safepoint.hpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#ifndef INCLUDE_RUNTIME_SAFEPOINT_HPP_
+#define INCLUDE_RUNTIME_SAFEPOINT_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <pthread.h>
+
+class vm_thread;
+
+/**
+ * the poll word of one vm_thread. every vm_thread has one. the interpreter checks it at the back-edges, at the method
+ * entries and returns, and the compiled code at the back-edges: a plain load, no lock. see: `Safepoint::begin()`.
+ */
+struct SafepointPoll {
+	std::atomic<int> word;		// != 0: armed, go to `Safepoint::block()`.
+	SafepointPoll() : word(0) {}
+	SafepointPoll(const SafepointPoll &) : word(0) {}		// the vm_threads are copied into `wind_jvm::threads()` before they run.
+	bool is_armed() const { return word.load(std::memory_order_relaxed) != 0; }
+	const void *address() const { return &word; }
+};
+
+/**
+ * stops all the java threads for the gc (or the exit by SIGINT). the vm thread arms the poll words of all the threads,
+ * and waits on a condition variable until every thread is safe: stopped at a poll (`Waiting`), blocked in a monitor,
+ * `Object.wait()` or `Thread.sleep()` (`Blocked`), or dead. a blocked thread doesn't run on until the safepoint is over.
+ * the thread states are only changed under `_all_thread_wait_mutex`, and the vm thread is signalled for every change.
+ */
+class Safepoint {
+private:
+	static std::atomic<bool> & requested() {
+		static std::atomic<bool> requested(false);
+		return requested;
+	}
+	static vm_thread * & current() {		// the vm_thread running on this pthread. nullptr for the other threads.
+		static thread_local vm_thread *current = nullptr;
+		return current;
+	}
+	static pthread_cond_t & safe_cond() {		// a thread became safe: wakes up the vm thread in `synchronize()`.
+		static pthread_cond_t safe_cond = PTHREAD_COND_INITIALIZER;
+		return safe_cond;
+	}
+	static std::chrono::steady_clock::time_point & begin_time() {
+		static std::chrono::steady_clock::time_point begin_time;
+		return begin_time;
+	}
+	static void arm(int value);
+	static bool all_safe();
+public:
+	static bool is_requested() { return requested().load(); }
+	static void attach(vm_thread *thread);		// right after `thread` is put into the ThreadTable, on its own pthread.
+	static void detach() { current() = nullptr; }
+	static void begin();						// with `GC::gc()` set under `GC::gc_lock()`.
+	static double synchronize();				// wait until all the threads are safe. returns the time-to-safepoint in ms.
+	static void end();
+	static void block(vm_thread *thread);		// the slow path of a poll: wait here until the safepoint is over.
+	static void set_dead(vm_thread *thread);		// the thread runs no more java code: safe from now on.
+	static void enter_blocked();				// the current thread is going to block for a while, outside of the heap.
+	static void leave_blocked();				// and it's back: waits if a safepoint is in progress.
+};
+
+
+#endif /* INCLUDE_RUNTIME_SAFEPOINT_HPP_ */
@@ -0,0 +1,81 @@
+/*
+ * satb.hpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#ifndef INCLUDE_RUNTIME_SATB_HPP_
+#define INCLUDE_RUNTIME_SATB_HPP_
+
+#include <atomic>
+#include <vector>
+#include "runtime/heap.hpp"
+#include "utils/lock.hpp"
+
+/**
+ * the snapshot-at-the-beginning log of one mutator thread. every vm_thread has one. see: `Satb::attach()`.
+ */
+class SatbBuffer {
+	friend class Satb;
+private:
+	static const int CAPACITY = 256;
+	void *buf[CAPACITY];
+	int index = 0;
+};
+
+/**
+ * the pre-write barrier of the concurrent marking of the old generation. while the marking runs, every reference store
+ * logs the old oop it overwrites, if it's old and not marked yet: all the oops which were reachable when the marking began
+ * (the snapshot) are marked, even if the mutators cut the path to them before the marker came along.
+ * the full buffers of the threads are handed over to the marker. the remark pause takes the rest. see: `GC::remark()`.
+ */
+class Satb {
+private:
+	static std::atomic<bool> & active() {
+		static std::atomic<bool> active(false);
+		return active;
+	}
+	static SatbBuffer * & current_buffer() {		// of the vm_thread running on this pthread. nullptr for the other threads.
+		static thread_local SatbBuffer *current_buffer = nullptr;
+		return current_buffer;
+	}
+	static Lock & completed_lock() {
+		static Lock completed_lock;
+		return completed_lock;
+	}
+	static std::vector<void *> & completed() {		// the logged oops of the full buffers, for the marker.
+		static std::vector<void *> completed;
+		return completed;
+	}
+	static void enqueue(void *old_value);
+public:
+	static bool is_active() { return active().load(std::memory_order_relaxed); }
+	static void set_active(bool is_active) { active().store(is_active); }
+	static void attach(SatbBuffer *buffer) { current_buffer() = buffer; }
+	static void detach();
+	static void pre_write_barrier(void *old_value) {		// before a reference store overwrites `old_value`.
+		if (is_active() && old_value != nullptr && Heap::is_in_old(old_value) && !Heap::is_marked(old_value)) {
+			enqueue(old_value);
+		}
+	}
+	static void pre_write_barrier(void **slots, int length) {		// before `length` reference slots are overwritten at once.
+		if (!is_active())	return;
+		for (int i = 0; i < length; i ++) {
+			pre_write_barrier(slots[i]);
+		}
+	}
+	static void flush(SatbBuffer & buffer);		// hand over the logged oops of `buffer`. only when its thread is stopped, or by itself.
+	template <typename Func>
+	static void drain(Func func) {				// calls `func(void *obj)` for the logged oops handed over.
+		std::vector<void *> taken;
+		completed_lock().lock();
+		taken.swap(completed());
+		completed_lock().unlock();
+		for (void *obj : taken) {
+			func(obj);
+		}
+	}
+};
+
+
+#endif /* INCLUDE_RUNTIME_SATB_HPP_ */
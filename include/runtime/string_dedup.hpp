@@ -0,0 +1,36 @@
+/*
+ * string_dedup.hpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#ifndef INCLUDE_RUNTIME_STRING_DEDUP_HPP_
+#define INCLUDE_RUNTIME_STRING_DEDUP_HPP_
+
+#include <unordered_map>
+#include <cstddef>
+
+class Oop;
+class InstanceOop;
+class TypeArrayOop;
+
+/**
+ * -XX:+UseStringDeduplication: the java.lang.Strings promoted by a minor gc look up their `value` in a table of the char[]s
+ * seen before, by content. if an equal one is there, the String takes it, and its own char[] is left to the gc. else its
+ * char[] enters the table. the table is weak: it never keeps a char[] alive. see: `GC::weak_roots_do()`.
+ * only the gc thread touches it, in a pause.
+ */
+class StringDedup {
+private:
+	static std::unordered_multimap<int, TypeArrayOop *> & table() {		// String.hashCode() of the chars -> char[].
+		static std::unordered_multimap<int, TypeArrayOop *> table;
+		return table;
+	}
+public:
+	static size_t deduplicate(InstanceOop *stringoop);		// the bytes of the char[] `stringoop` dropped. 0 if none.
+	static size_t purge(Oop *(*referent)(Oop *));			// `referent` returns the address the char[] lives at now, or nullptr if it's dead. returns the purged ones.
+	static size_t size() { return table().size(); }
+};
+
+
+#endif /* INCLUDE_RUNTIME_STRING_DEDUP_HPP_ */
@@ -26,9 +26,11 @@ using std::unordered_map;
 class vm_thread;
 class InstanceOop;
 class GC;
+class Safepoint;
 
 class ThreadTable {
 	friend GC;
+	friend Safepoint;
 private:
 	static Lock & get_lock();
 public:
@@ -10,57 +10,130 @@
 
 #include <boost/noncopyable.hpp>
 #include <pthread.h>
-#include <sys/time.h>
+#include <atomic>
+#include <list>
+#include <cstdint>
+#include "utils/lock.hpp"
 
-// this class object, will be embedded into [Oop's header].
-class Monitor : public boost::noncopyable {
+/**
+ * the heavy-weight monitor of one object. only made when the object's thin lock is contended, or for wait/notify.
+ * the owner is a thread id (`ThinLock::current_thread_id()`), not a pthread mutex owner, so a contending thread can
+ * inflate the monitor on behalf of the thread which holds the thin lock.
+ */
+class ThinLock;
+
+class ObjectMonitor : public boost::noncopyable {
+	friend ThinLock;
 private:
-	pthread_mutex_t _mutex;
-	pthread_mutexattr_t _attr;
-	pthread_cond_t _cond;
+	void *_object;					// whose lock word points here. the gc keeps it up to date: see `ThinLock::deflate_monitors()`.
+	ThinLock *_lock;				// that lock word, in `_object`.
+	pthread_mutex_t _mutex;			// guards the members below.
+	pthread_cond_t _entry_cond;		// the threads blocked in `enter()`.
+	pthread_cond_t _wait_cond;		// the threads in `Object.wait()`.
+	long _owner;					// 0 when not owned.
+	long _recursions;
+	int _entrants;					// the threads in `enter()`: they hold this monitor, though they may be blocked in a safepoint.
+	int _waiters;					// the threads in `wait()`, until they own the monitor again.
 public:
-	Monitor() {
-		pthread_mutexattr_init(&_attr);
-		pthread_mutexattr_settype(&_attr, PTHREAD_MUTEX_RECURSIVE);
-
-		pthread_mutex_init(&_mutex, &_attr);
-		pthread_cond_init(&_cond, nullptr);
-	}
-	void enter() {
-		pthread_mutex_lock(&_mutex);
+	typedef void (*blocking_hook_t)();
+	static blocking_hook_t & before_blocking() {		// called before a thread blocks in `enter()` or `wait()`, without `_mutex`.
+		static blocking_hook_t before_blocking = nullptr;
+		return before_blocking;
 	}
-	void wait() {
-		pthread_cond_wait(&_cond, &_mutex);
+	static blocking_hook_t & after_blocking() {			// and after it's back, without `_mutex` too: the vm may hold it up here for a while.
+		static blocking_hook_t after_blocking = nullptr;
+		return after_blocking;
 	}
-	void wait(long timesec) {
-		struct timeval val;
-		gettimeofday(&val, NULL);
-		val.tv_usec += timesec;
-		// convert:
-		struct timespec spec;
-		spec.tv_sec = val.tv_sec;
-		spec.tv_nsec = val.tv_usec * 1000;
-		pthread_cond_timedwait(&_cond, &_mutex, &spec);
-	}
-	void notify() {
-		pthread_cond_signal(&_cond);
+public:
+	ObjectMonitor(void *object, ThinLock *lock, long owner, long recursions);
+	void enter(long self);
+	void leave(long self);
+	void wait(long self, long millis);		// millis == 0: wait until notified.
+	void notify();
+	void notify_all();
+	bool is_owned();
+	bool is_idle();				// no owner, and no thread in `enter()` or `wait()`: it can be deflated.
+	~ObjectMonitor();
+};
+
+/**
+ * the lock word, embedded into [Oop's header]. one word:
+ *   0                                   : unlocked.
+ *   [owner thread id:32][recursions:31][0] : thin-locked. the owner enters and leaves again only with a CAS on this word.
+ *   [ObjectMonitor *][1]                : inflated. until a pause finds the monitor idle and deflates it to 0 again.
+ */
+class ThinLock : public boost::noncopyable {
+private:
+	static const uintptr_t INFLATED = 1;
+	static const uintptr_t RECURSION_ONE = 2;
+	static const uintptr_t RECURSION_MASK = 0xFFFFFFFEUL;
+	static const int OWNER_SHIFT = 32;
+private:
+	std::atomic<uintptr_t> word;
+private:
+	static Lock & monitor_table_lock() {
+		static Lock monitor_table_lock;
+		return monitor_table_lock;
 	}
-	void notify_all() {
-		pthread_cond_broadcast(&_cond);
+	static std::list<ObjectMonitor *> & monitor_table() {		// all the inflated monitors. they live until a pause deflates them.
+		static std::list<ObjectMonitor *> monitor_table;
+		return monitor_table;
 	}
-	void leave() {
-		pthread_mutex_unlock(&_mutex);
+	static bool is_inflated(uintptr_t w) { return (w & INFLATED) != 0; }
+	static ObjectMonitor *monitor_of(uintptr_t w) { return (ObjectMonitor *)(w & ~INFLATED); }
+	static long owner_of(uintptr_t w) { return (long)(w >> OWNER_SHIFT); }
+	static long recursions_of(uintptr_t w) { return (long)((w & RECURSION_MASK) >> 1); }
+	ObjectMonitor *inflate(void *obj);
+public:
+	static long current_thread_id() {		// 1, 2, 3... one for every pthread.
+		static std::atomic<long> next_id(1);
+		static thread_local long id = next_id.fetch_add(1, std::memory_order_relaxed);
+		return id;
 	}
-	void force_unlock_when_athrow() {
-		pthread_mutex_trylock(&_mutex);
-		pthread_mutex_unlock(&_mutex);
+	/**
+	 * only at a pause: `referent(obj)` is where the object of a monitor is now, or nullptr if it's dead. the monitors of the
+	 * dead objects are freed, and so are the idle ones, whose objects get the unlocked word back. returns how many are freed.
+	 */
+	template <typename Func>
+	static long deflate_monitors(Func referent) {
+		long freed = 0;
+		LockGuard lg(monitor_table_lock());
+		for (auto iter = monitor_table().begin(); iter != monitor_table().end(); ) {
+			ObjectMonitor *monitor = *iter;
+			void *now = referent(monitor->_object);
+			if (now != nullptr) {
+				monitor->_lock = (ThinLock *)((char *)now + ((char *)monitor->_lock - (char *)monitor->_object));		// the same offset in the copy.
+				monitor->_object = now;
+				if (!monitor->is_idle()) {
+					++ iter;
+					continue;
+				}
+				monitor->_lock->word.store(0, std::memory_order_relaxed);		// the threads are stopped: they see it after the pause.
+			}
+			delete monitor;
+			iter = monitor_table().erase(iter);
+			freed ++;
+		}
+		return freed;
 	}
-	~Monitor() {
-		pthread_mutex_destroy(&_mutex);
-		pthread_cond_destroy(&_cond);
+	static void cleanup();
+public:
+	ThinLock() : word(0) {}
+	// `obj`: the object this lock word is in, for the monitor, if it's inflated.
+	void enter(void *obj) {		// the fast path: an unlocked object.
+		uintptr_t expected = 0;
+		if (!word.compare_exchange_strong(expected, ((uintptr_t)current_thread_id() << OWNER_SHIFT) | RECURSION_ONE, std::memory_order_acquire)) {
+			slow_enter(obj);
+		}
 	}
+	void slow_enter(void *obj);
+	void leave();
+	void wait(void *obj, long millis);
+	void notify();
+	void notify_all();
+	bool is_locked();
+	void move_from(ThinLock & rhs) { word.store(rhs.word.load(std::memory_order_relaxed), std::memory_order_relaxed); }		// only for gc: the object moved.
 };
 
 
-
 #endif /* INCLUDE_UTILS_MONITOR_HPP_ */
@@ -0,0 +1,101 @@
+/*
+ * vm_options.hpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#ifndef INCLUDE_UTILS_VM_OPTIONS_HPP_
+#define INCLUDE_UTILS_VM_OPTIONS_HPP_
+
+#include <string>
+#include <cstddef>
+
+/**
+ * command line options of wind_jvm: `wind_jvm [-options] <main class>`.
+ * -XX:+Flag / -XX:-Flag switch a bool flag on or off.
+ * sizes accept a `k`, `m` or `g` suffix, e.g. -Xss2m.
+ */
+class VMOptions {
+public:
+	static bool & print_inline_caches() {		// -XX:+PrintInlineCaches: dump every call site's inline cache at exit.
+		static bool print_inline_caches = false;
+		return print_inline_caches;
+	}
+	static bool & use_interpreter_only() {		// -Xint: never compile, run all the methods in the interpreter.
+		static bool use_interpreter_only = false;
+		return use_interpreter_only;
+	}
+	static bool & print_compilation() {			// -XX:+PrintCompilation: log every method the jit compiles.
+		static bool print_compilation = false;
+		return print_compilation;
+	}
+	static bool & profile() {					// -Xprof: sample the running methods, and print the method profile at exit or on SIGQUIT.
+		static bool profile = false;
+		return profile;
+	}
+	static bool & use_transparent_huge_pages() {	// -XX:+UseTransparentHugePages: madvise the java heap for the transparent huge pages.
+		static bool use_transparent_huge_pages = false;
+		return use_transparent_huge_pages;
+	}
+	static int & parallel_gc_threads() {			// -XX:ParallelGCThreads=<n>: the gc worker threads. 0: decided by the cpus, see `parallel_gc_threads_for()`.
+		static int parallel_gc_threads = 0;
+		return parallel_gc_threads;
+	}
+	static bool & print_gc() {					// -XX:+PrintGC or -Xlog:gc: the gc log, and the summary at exit. see: `GCLog`.
+		static bool print_gc = false;
+		return print_gc;
+	}
+	static std::string & gc_log_file() {		// -Xlog:gc:<file>. "": stdout.
+		static std::string gc_log_file;
+		return gc_log_file;
+	}
+	static bool & heap_dump_on_out_of_memory_error() {	// -XX:+HeapDumpOnOutOfMemoryError: dump the heap when the first OutOfMemoryError is thrown. see: `HeapDump`.
+		static bool heap_dump_on_out_of_memory_error = false;
+		return heap_dump_on_out_of_memory_error;
+	}
+	static bool & heap_dump_on_ctrl_break() {		// -XX:+HeapDumpOnCtrlBreak: dump the heap on SIGQUIT.
+		static bool heap_dump_on_ctrl_break = false;
+		return heap_dump_on_ctrl_break;
+	}
+	static std::string & heap_dump_path() {			// -XX:HeapDumpPath=<path>: a file or a directory. "": java_pid<pid>.hprof in the working directory.
+		static std::string heap_dump_path;
+		return heap_dump_path;
+	}
+	static bool & use_string_deduplication() {		// -XX:+UseStringDeduplication: the promoted Strings share their equal char[]s. see: `StringDedup`.
+		static bool use_string_deduplication = false;
+		return use_string_deduplication;
+	}
+	static int & soft_ref_lru_policy_ms_per_mb() {		// -XX:SoftRefLRUPolicyMSPerMB=<n>: a SoftReference not used for n ms per free MB of the heap may be cleared. see: `ReferenceProcessor`.
+		static int soft_ref_lru_policy_ms_per_mb = 1000;
+		return soft_ref_lru_policy_ms_per_mb;
+	}
+	static int & initiating_heap_occupancy_percent() {	// -XX:InitiatingHeapOccupancyPercent=<n>: start the concurrent marking when the old generation is n% full.
+		static int initiating_heap_occupancy_percent = 45;
+		return initiating_heap_occupancy_percent;
+	}
+	static size_t & thread_stack_size() {		// -Xss: bytes of the java stack of every thread.
+		static size_t thread_stack_size = 1024 * 1024;
+		return thread_stack_size;
+	}
+	static size_t & max_heap_size() {			// -Xmx: the heap never grows beyond it.
+		static size_t max_heap_size = 768 * 1024 * 1024;
+		return max_heap_size;
+	}
+	static size_t & initial_heap_size() {		// -Xms: the heap starts with it, and never shrinks below it. 0: the young generation + 64m.
+		static size_t initial_heap_size = 0;
+		return initial_heap_size;
+	}
+	static size_t & young_size() {				// -Xmn: the young generation, which never resizes. 0: a third of the heap.
+		static size_t young_size = 0;
+		return young_size;
+	}
+public:
+	static bool parse(const std::string & option);		// returns false if `option` is unknown.
+	static int parallel_gc_threads_for(int cpus);
+	static bool heap_sizes(size_t & initial, size_t & max, size_t & young);	// the sizes of the heap. false if -Xms, -Xmx and -Xmn don't fit together.
+	static void print_usage();
+};
+
+
+
+#endif /* INCLUDE_UTILS_VM_OPTIONS_HPP_ */
@@ -0,0 +1,104 @@
+/*
+ * work_stealing_queue.hpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#ifndef INCLUDE_UTILS_WORK_STEALING_QUEUE_HPP_
+#define INCLUDE_UTILS_WORK_STEALING_QUEUE_HPP_
+
+#include <boost/noncopyable.hpp>
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+/**
+ * Chase-Lev work-stealing deque (the C11 version of Lê, Pop, Cohen and Zappa Nardelli, 2013).
+ * only the owner thread pushes and pops, at the bottom, without a CAS unless it takes the last element.
+ * any other thread steals from the top with a CAS. the array grows when full: the old arrays are kept
+ * until `reset()`, because a thief may still read from them.
+ */
+template <typename T>
+class WorkStealingQueue : public boost::noncopyable {
+private:
+	static const size_t INITIAL_CAPACITY = 1024;
+	struct Array {
+		size_t capacity;			// power of 2.
+		std::atomic<T> *elems;
+		explicit Array(size_t capacity) : capacity(capacity), elems(new std::atomic<T>[capacity]) {}
+		~Array() { delete[] elems; }
+		T get(long i) { return elems[i & (capacity - 1)].load(std::memory_order_relaxed); }
+		void put(long i, T x) { elems[i & (capacity - 1)].store(x, std::memory_order_relaxed); }
+	};
+private:
+	std::atomic<long> top;
+	std::atomic<long> bottom;
+	std::atomic<Array *> array;
+	std::vector<Array *> retired;		// only touched by the owner.
+private:
+	Array *grow(Array *a, long b, long t) {
+		Array *bigger = new Array(a->capacity * 2);
+		for (long i = t; i < b; i ++) {
+			bigger->put(i, a->get(i));
+		}
+		retired.push_back(a);
+		array.store(bigger, std::memory_order_release);
+		return bigger;
+	}
+public:
+	WorkStealingQueue() : top(0), bottom(0), array(new Array(INITIAL_CAPACITY)) {}
+	~WorkStealingQueue() {
+		reset();
+		delete array.load(std::memory_order_relaxed);
+	}
+	void push(T x) {			// owner only.
+		long b = bottom.load(std::memory_order_relaxed);
+		long t = top.load(std::memory_order_acquire);
+		Array *a = array.load(std::memory_order_relaxed);
+		if (b - t > (long)a->capacity - 1) {
+			a = grow(a, b, t);
+		}
+		a->put(b, x);
+		std::atomic_thread_fence(std::memory_order_release);
+		bottom.store(b + 1, std::memory_order_relaxed);
+	}
+	bool pop(T & x) {			// owner only. false if empty.
+		long b = bottom.load(std::memory_order_relaxed) - 1;
+		Array *a = array.load(std::memory_order_relaxed);
+		bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		long t = top.load(std::memory_order_relaxed);
+		if (t > b) {			// empty.
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return false;
+		}
+		x = a->get(b);
+		if (t == b) {			// the last one: race against the thieves.
+			bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return won;
+		}
+		return true;
+	}
+	bool steal(T & x) {			// any thread. false if empty, or lost the race.
+		long t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		long b = bottom.load(std::memory_order_acquire);
+		if (t >= b)	return false;
+		Array *a = array.load(std::memory_order_acquire);
+		x = a->get(t);
+		return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+	}
+	bool is_empty() {			// a hint for the other threads.
+		return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+	}
+	void reset() {				// only when no other thread uses the queue. it must be empty.
+		for (Array *a : retired) {
+			delete a;
+		}
+		retired.clear();
+	}
+};
+
+
+#endif /* INCLUDE_UTILS_WORK_STEALING_QUEUE_HPP_ */
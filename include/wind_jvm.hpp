@@ -17,6 +17,9 @@
 #include "runtime/bytecodeEngine.hpp"
 #include "utils/synchronize_wcout.hpp"
 #include "runtime/gc.hpp"
+#include "runtime/heap.hpp"
+#include "runtime/satb.hpp"
+#include "runtime/safepoint.hpp"
 
 class vm_thread;
 class wind_jvm;
@@ -35,16 +38,24 @@ extern int all_thread_num;
 
 enum thread_state {
 	Running,
-	Waiting,
+	Waiting,		// stopped at a safepoint poll.
+	Blocked,		// in a monitor, `Object.wait()` or `Thread.sleep()`. safe for the gc, the same as the two below.
 	Death,
 };
 
 class ThreadTable;
+class Profiler;
+class Handle;
+class HandleMark;
 
 class vm_thread {
 	friend BytecodeEngine;
 	friend GC;
 	friend ThreadTable;
+	friend Profiler;
+	friend Safepoint;
+	friend Handle;
+	friend HandleMark;
 private:
 	temp p;			// pthread aux struct. must be global!!!
 	pthread_t tid;
@@ -53,7 +64,11 @@ private:
 
 	Method *method;
 	std::list<Oop *> arg;
-	list<StackFrame> vm_stack;
+	JavaStack vm_stack;
+	Tlab tlab;			// this thread allocates oops in it.
+	SatbBuffer satb;	// this thread logs the overwritten oops in it, while the old generation is concurrently marked.
+	SafepointPoll safepoint_poll;
+	std::vector<Oop *> handles;		// the oops the natives and the vm hold across a call into java: gc roots. see: `Handle`.
 	uint8_t *pc;		// pc, pointing to the code segment: inside the Method->code.
 	int thread_no;
 public:
@@ -129,9 +144,7 @@ public:
 extern pthread_mutex_t _all_thread_wait_mutex;
 extern pthread_cond_t _all_thread_wait_cond;
 
-void wait_cur_thread(vm_thread *thread);
 void wait_cur_thread_and_set_bit(volatile bool *, vm_thread *);
-void signal_one_thread();
 void signal_all_thread();
 
 
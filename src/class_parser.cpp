@@ -1934,6 +1934,17 @@ std::unordered_map<u1, std::pair<std::string, int>> bccode_map{	// pair<bccode_n
 	{0xc8, {"goto_w", 4}},			// 4.
 	{0xc9, {"jsr_w", 4}},			// 4.
 	{0xca, {"breakpoint", 0}},
+	{0xcb, {"fast_ldc", 1}},			// private quickened bytecodes. see `FastBytecode` in bytecodeEngine.hpp.
+	{0xcc, {"fast_ldc_w", 2}},
+	{0xcd, {"fast_ldc2_w", 2}},
+	{0xce, {"fast_getstatic", 2}},
+	{0xcf, {"fast_putstatic", 2}},
+	{0xd0, {"fast_getfield", 2}},
+	{0xd1, {"fast_putfield", 2}},
+	{0xd2, {"fast_invokevirtual", 2}},
+	{0xd3, {"fast_invokespecial", 2}},
+	{0xd4, {"fast_invokestatic", 2}},
+	{0xd5, {"fast_invokeinterface", 4}},
 	{0xfe, {"impdep1", 0}},
 	{0xff, {"impdep2", 0}},	
 };
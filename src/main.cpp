@@ -6,6 +6,7 @@
  */
 
 #include "wind_jvm.hpp"
+#include "utils/vm_options.hpp"
 #include <iostream>
 #include <vector>
 
@@ -15,12 +16,21 @@ int main(int argc, char *argv[])
 	sync_wcout::set_switch(true);
 //#endif
 
-	if (argc != 2) {
-		std::wcerr << "argc is not 2. please re-run." << std::endl;
+	// [-options] <main class>
+	int i = 1;
+	for (; i < argc && argv[i][0] == '-'; i ++) {
+		if (!VMOptions::parse(argv[i])) {
+			std::wcerr << "unrecognized option: " << utf8_to_wstring(argv[i]) << std::endl;
+			VMOptions::print_usage();
+			exit(-1);
+		}
+	}
+	if (i != argc - 1) {
+		VMOptions::print_usage();
 		exit(-1);
 	}
 
-	wstring program = utf8_to_wstring(std::string(argv[1]));
+	wstring program = utf8_to_wstring(std::string(argv[i]));
 
 	std::ios::sync_with_stdio(true);		// keep thread safe?
 	std::wcout.imbue(std::locale(""));
@@ -88,7 +88,7 @@ void JVM_Open0(list<Oop *> & _stack){
 	sync_wcout{} << "(DEBUG) open a file [" << filename << "], and inject real fd: [" << fd << "] to substitude the old garbage value fd: [" << ((IntOop *)real_fd)->value << "]." << std::endl;
 #endif
 
-	((IntOop *)real_fd)->value = fd;		// inject the real fd into it!
+	((InstanceOop *)result)->set_field_value(FILEDESCRIPTOR L":fd:I", new IntOop(fd));		// inject the real fd into it!
 
 }
 
@@ -107,10 +107,8 @@ void JVM_ReadBytes(list<Oop *> & _stack){
 
 	assert(bytes->get_length() > offset && bytes->get_length() >= (offset + len));		// ArrayIndexOutofBoundException
 
-	char *buf = new char[len];
-
 	int ret;
-	if ((ret = read(fd, buf, len)) == -1) {
+	if ((ret = read(fd, bytes->get_base() + offset, len)) == -1) {		// read into the byte[] directly.
 		assert(false);
 	}
 
@@ -120,18 +118,12 @@ void JVM_ReadBytes(list<Oop *> & _stack){
 	sync_wcout{} << "(DEBUG) meet EOF of fd: [" << fd << "]!" << std::endl;
 #endif
 	} else {				// Not EOF
-		for (int i = offset, j = 0; i < offset + ret; i ++, j ++) {		// I think it should be `offset + ret`, not `offset + len`.
-			((IntOop *)(*bytes)[i])->value = buf[j];
-		}
 		_stack.push_back(new IntOop(ret));
 #ifdef DEBUG
 	sync_wcout{} << "(DEBUG) read fd: [" << fd << "] for [" << ret << "] bytes." << std::endl;
 #endif
 	}
 
-	delete[] buf;
-
-
 }
 
 void JVM_Close0(list<Oop *> & _stack){
@@ -72,24 +72,16 @@ void JVM_WriteBytes(list<Oop *> & _stack){
 				strncpy(buf, RESET, 5);		// for the C++ `int main()`. this is the first thread, which is not created by manually `pthread_create`.
 				break;
 		}
-		int j = 5;
-		for (int i = offset; i < offset + len; i ++, j ++) {
-			buf[j] = (char)((IntOop *)(*bytes)[i])->value;
-		}
-		strncpy(buf+j, RESET, 5);
+		memcpy(buf+5, bytes->get_base() + offset, len);
+		strncpy(buf+5+len, RESET, 5);
 		if (write(fd, buf, 5+len+5) == -1) {
 			assert(false);
 		}
 		delete[] buf;
 	} else {
-		char *buf = new char[len];
-		for (int i = offset, j = 0; i < offset + len; i ++, j ++) {
-			buf[j] = (char)((IntOop *)(*bytes)[i])->value;
-		}
-		if (write(fd, buf, len) == -1) {
+		if (write(fd, bytes->get_base() + offset, len) == -1) {		// write from the byte[] directly.
 			assert(false);
 		}
-		delete[] buf;
 	}
 
 }
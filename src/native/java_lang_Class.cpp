@@ -554,10 +554,8 @@ void JVM_GetClassDeclaredFields(list<Oop *> & _stack){
 			// set Annotation...
 			CodeStub *stub = field->get_rva();		// RuntimeVisibleAnnotations' bytecode
 			if (stub) {
-				ArrayOop *byte_arr = Byte_arr_klass->new_instance(stub->stub.size());
-				for (int i = 0; i < stub->stub.size(); i ++) {
-					(*byte_arr)[i] = new IntOop(stub->stub[i]);
-				}
+				TypeArrayOop *byte_arr = (TypeArrayOop *)Byte_arr_klass->new_instance(stub->stub.size());
+				memcpy(byte_arr->get_base(), stub->stub.data(), stub->stub.size());
 				field_oop->set_field_value(FIELD L":annotations:[B", byte_arr);
 			}
 
@@ -646,28 +644,22 @@ void JVM_GetClassDeclaredMethods(list<Oop *> & _stack){
 		// set RuntimeVisiableAnnotations
 		CodeStub *stub = method->get_rva();		// RuntimeVisibleAnnotations' bytecode
 		if (stub) {
-			ArrayOop *byte_arr = Byte_arr_klass->new_instance(stub->stub.size());
-			for (int i = 0; i < stub->stub.size(); i ++) {
-				(*byte_arr)[i] = new IntOop(stub->stub[i]);
-			}
+			TypeArrayOop *byte_arr = (TypeArrayOop *)Byte_arr_klass->new_instance(stub->stub.size());
+			memcpy(byte_arr->get_base(), stub->stub.data(), stub->stub.size());
 			method_oop->set_field_value(METHOD L":annotations:[B", byte_arr);
 		}
 		// set RuntimeVisiableParameterAnnotations
 		stub = method->get_rvpa();		// RuntimeVisibleParameterAnnotations' bytecode
 		if (stub) {
-			ArrayOop *byte_arr = Byte_arr_klass->new_instance(stub->stub.size());
-			for (int i = 0; i < stub->stub.size(); i ++) {
-				(*byte_arr)[i] = new IntOop(stub->stub[i]);
-			}
+			TypeArrayOop *byte_arr = (TypeArrayOop *)Byte_arr_klass->new_instance(stub->stub.size());
+			memcpy(byte_arr->get_base(), stub->stub.data(), stub->stub.size());
 			method_oop->set_field_value(METHOD L":parameterAnnotations:[B", byte_arr);
 		}
 		// set AnnotationDefault
 		stub = method->get_ad();		// AnnotationDefault' bytecode
 		if (stub) {
-			ArrayOop *byte_arr = Byte_arr_klass->new_instance(stub->stub.size());
-			for (int i = 0; i < stub->stub.size(); i ++) {
-				(*byte_arr)[i] = new IntOop(stub->stub[i]);
-			}
+			TypeArrayOop *byte_arr = (TypeArrayOop *)Byte_arr_klass->new_instance(stub->stub.size());
+			memcpy(byte_arr->get_base(), stub->stub.data(), stub->stub.size());
 			method_oop->set_field_value(METHOD L":annotationDefault:[B", byte_arr);
 		}
 
@@ -749,19 +741,15 @@ void JVM_GetClassDeclaredConstructors(list<Oop *> & _stack){
 		// set RuntimeVisiableAnnotations
 		CodeStub *stub = method->get_rva();		// RuntimeVisibleAnnotations' bytecode
 		if (stub) {
-			ArrayOop *byte_arr = Byte_arr_klass->new_instance(stub->stub.size());
-			for (int i = 0; i < stub->stub.size(); i ++) {
-				(*byte_arr)[i] = new IntOop(stub->stub[i]);
-			}
+			TypeArrayOop *byte_arr = (TypeArrayOop *)Byte_arr_klass->new_instance(stub->stub.size());
+			memcpy(byte_arr->get_base(), stub->stub.data(), stub->stub.size());
 			ctor_oop->set_field_value(CONSTRUCTOR L":annotations:[B", byte_arr);
 		}
 		// set RuntimeVisiableParameterAnnotations
 		stub = method->get_rvpa();		// RuntimeVisibleParameterAnnotations' bytecode
 		if (stub) {
-			ArrayOop *byte_arr = Byte_arr_klass->new_instance(stub->stub.size());
-			for (int i = 0; i < stub->stub.size(); i ++) {
-				(*byte_arr)[i] = new IntOop(stub->stub[i]);
-			}
+			TypeArrayOop *byte_arr = (TypeArrayOop *)Byte_arr_klass->new_instance(stub->stub.size());
+			memcpy(byte_arr->get_base(), stub->stub.data(), stub->stub.size());
 			ctor_oop->set_field_value(CONSTRUCTOR L":parameterAnnotations:[B", byte_arr);
 		}
 
@@ -95,10 +95,7 @@ void JVM_DefineClass1(list<Oop *> & _stack){
 	wstring klass_name = java_lang_string::stringOop_to_wstring(name);
 
 	char *buf = new char[len];
-
-	for (int i = offset, j = 0; i < offset + len; i ++, j ++) {
-		buf[j] = (char)((IntOop *)(*bytes)[i])->value;
-	}
+	memcpy(buf, bytes->get_base() + offset, len);
 
 	ByteStream byte_buf(buf, len);
 
@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <cassert>
 #include "native/native.hpp"
+#include "runtime/handles.hpp"
 
 static unordered_map<wstring, void*> methods = {
     {L"hashCode:()I",				(void *)&JVM_IHashCode},
@@ -22,8 +23,8 @@ static unordered_map<wstring, void*> methods = {
 
 void JVM_IHashCode(list<Oop *> & _stack){
 	InstanceOop *_this = (InstanceOop *)_stack.front();	_stack.pop_front();
-	// hash code: I only use address for it.	// in HotSpot `synchronizer.cpp::get_next_hash()`, condition `hashCode = 4`.
-	_stack.push_back(new IntOop((intptr_t)_this));
+	// hash code: not the address any more, the gc moves the young oops.	// in HotSpot `synchronizer.cpp::get_next_hash()`, condition `hashCode = 5`.
+	_stack.push_back(new IntOop(_this->identity_hash()));
 }
 void JVM_MonitorWait(list<Oop *> & _stack){
 	InstanceOop *_this = (InstanceOop *)_stack.front();	_stack.pop_front();
@@ -33,7 +34,7 @@ void JVM_MonitorWait(list<Oop *> & _stack){
 }
 void JVM_MonitorNotify(list<Oop *> & _stack){
 	InstanceOop *_this = (InstanceOop *)_stack.front();	_stack.pop_front();
-	assert(false);
+	_this->notify();
 }
 void JVM_MonitorNotifyAll(list<Oop *> & _stack){
 	InstanceOop *_this = (InstanceOop *)_stack.front();	_stack.pop_front();
@@ -41,6 +42,9 @@ void JVM_MonitorNotifyAll(list<Oop *> & _stack){
 }
 void JVM_Clone(list<Oop *> & _stack){
 	Oop *_this = _stack.front();	_stack.pop_front();
+	vm_thread *thread = (vm_thread *)_stack.back();
+	HandleMark hm(*thread);
+	Handle self(*thread, _this);		// the gc of `native_try_allocate()` may move it.
 
 	if (_this->get_klass()->get_type() == ClassType::InstanceClass) {
 		// then, it must implemented the Ljava/lang/Cloneable; interface...
@@ -51,10 +55,11 @@ void JVM_Clone(list<Oop *> & _stack){
 		}
 
 		// shallow copy
-		InstanceOop *clone = new InstanceOop(*((InstanceOop *)_this));
+		Oop *clone = native_try_allocate(thread, _stack, [&self]() -> Oop * { return ((InstanceOop *)self())->clone(); });
+		if (clone == nullptr)	return;
 		_stack.push_back(clone);
 #ifdef DEBUG
-	sync_wcout{} << "(DEBUG) cloned from obj [" << _this << "] (InstanceOop) to new cloned obj [" << clone << "]." << std::endl;
+	sync_wcout{} << "(DEBUG) cloned from obj [" << self() << "] (InstanceOop) to new cloned obj [" << clone << "]." << std::endl;
 #endif
 
 	} else if (_this->get_klass()->get_type() == ClassType::TypeArrayClass || _this->get_klass()->get_type() == ClassType::ObjArrayClass) {
@@ -62,11 +67,15 @@ void JVM_Clone(list<Oop *> & _stack){
 		auto array_klass = ((ArrayKlass *)_this->get_klass());
 
 		// shallow copy
-		ArrayOop *clone = new ArrayOop(*((ArrayOop *)_this));
+		Oop *clone = native_try_allocate(thread, _stack, [&self]() -> Oop * {
+			if (self()->get_ooptype() == OopType::_TypeArrayOop)	return ((TypeArrayOop *)self())->clone();
+			else												return ((ObjArrayOop *)self())->clone();
+		});
+		if (clone == nullptr)	return;
 		_stack.push_back(clone);
 
 #ifdef DEBUG
-	sync_wcout{} << "(DEBUG) cloned from obj [" << _this << "] (ArrayOop) to new cloned obj [" << clone << "]." << std::endl;
+	sync_wcout{} << "(DEBUG) cloned from obj [" << self() << "] (ArrayOop) to new cloned obj [" << clone << "]." << std::endl;
 #endif
 	} else {
 		assert(false);
@@ -17,52 +17,63 @@
 // hash func
 size_t java_string_hash::operator()(Oop* const & ptr) const noexcept
 {
-	// if has a hash_val cache, need no calculate.
-	Oop *int_oop_hash;
-	if (((InstanceOop *)ptr)->get_field_value(STRING L":hash:I", &int_oop_hash) == true && ((IntOop *)int_oop_hash)->value != 0) {	// cashed_hash will become a ... IntOop...
-		return ((IntOop *)int_oop_hash)->value;
-	}
+	// the gc rehashes the StringTable in a pause, too: nothing here allocates.
+	return java_lang_string::hash_of((InstanceOop *)ptr);
+}
 
-	// get string oop's `value` field's `TypeArrayOop` and calculate hash value	// using **Openjdk8 string hash algorithm!!**
-	Oop *value_field;
-	((InstanceOop *)ptr)->get_field_value(STRING L":value:[C", &value_field);
-	int length = ((TypeArrayOop *)value_field)->get_length();
+// equalor
+bool java_string_equal_to::operator() (Oop* const & lhs, Oop* const & rhs) const
+{
+	if (lhs == rhs)	return true;		// prevent from alias ptr...
+	return java_lang_string::equals(java_lang_string::value_of((InstanceOop *)lhs), java_lang_string::value_of((InstanceOop *)rhs));
+}
+
+
+/*===---------------- java_lang_string ----------------===*/
+void java_lang_string::init_offsets(InstanceOop *stringoop)
+{
+	const auto & layout = ((InstanceKlass *)stringoop->get_klass())->get_field_layout();
+	auto value = layout.find(STRING L":value:[C");
+	auto hash = layout.find(STRING L":hash:I");
+	assert(value != layout.end() && hash != layout.end());
+	hash_offset() = hash->second.second->get_offset();
+	value_offset() = value->second.second->get_offset();
+}
+
+int java_lang_string::hash_of(TypeArrayOop *value)
+{
+	// using **Openjdk8 string hash algorithm!!**
+	if (value == nullptr)	return 0;
+	int length = value->get_length();
+	uint16_t *chars = (uint16_t *)value->get_base();
 	int hash_val = 0;
 	for (int i = 0; i < length; i ++) {
-		hash_val =  31 * hash_val + ((IntOop *)(*((TypeArrayOop *)value_field))[i])->value;
+		hash_val =  31 * hash_val + chars[i];
 	}
-	// make a hashvalue cache
-	((InstanceOop *)ptr)->set_field_value(STRING L":hash:I", new IntOop(hash_val));
-
 	return hash_val;
 }
 
-// equalor
-bool java_string_equal_to::operator() (Oop* const & lhs, Oop* const & rhs) const
+int java_lang_string::hash_of(InstanceOop *stringoop)
 {
-	if (lhs == rhs)	return true;		// prevent from alias ptr...
-
-	// get `value` field's `char[]` and compare every char.
-	Oop *value_field_lhs;
-	((InstanceOop *)lhs)->get_field_value(STRING L":value:[C", &value_field_lhs);
-	Oop *value_field_rhs;
-	((InstanceOop *)rhs)->get_field_value(STRING L":value:[C", &value_field_rhs);
-
-	int length_lhs = ((TypeArrayOop *)value_field_lhs)->get_length();
-	int length_rhs = ((TypeArrayOop *)value_field_rhs)->get_length();
-	if (length_lhs != length_rhs)	return false;
-	for (int i = 0; i < length_lhs; i ++) {
-		if ( ((IntOop *)(*((TypeArrayOop *)value_field_lhs))[i])->value != ((IntOop *)(*((TypeArrayOop *)value_field_rhs))[i])->value) {
-			return false;
-		}
+	if (hash_offset() == -1)	init_offsets(stringoop);
+	TypeArrayOop *value = value_of(stringoop);
+	int & cached_hash = stringoop->field_at<int>(hash_offset());
+	if (cached_hash == 0) {		// make a hashvalue cache
+		cached_hash = hash_of(value);
 	}
-	return true;
+	return cached_hash;
 }
 
+bool java_lang_string::equals(TypeArrayOop *lhs, TypeArrayOop *rhs)
+{
+	// get `value` field's `char[]` and compare every char.
+	if (lhs == rhs)	return true;
+	if (lhs == nullptr || rhs == nullptr)	return false;
+	if (lhs->get_length() != rhs->get_length())	return false;
+	return memcmp(lhs->get_base(), rhs->get_base(), lhs->get_length() * sizeof(uint16_t)) == 0;
+}
 
-/*===---------------- java_lang_string ----------------===*/
 wstring java_lang_string::stringOop_to_wstring(InstanceOop *stringoop) {
-	wstringstream ss;
 	Oop *result;
 	bool temp = stringoop->get_field_value(STRING L":value:[C", &result);
 	assert(temp == true);
@@ -70,10 +81,8 @@ wstring java_lang_string::stringOop_to_wstring(InstanceOop *stringoop) {
 	if (result == nullptr) {
 		return L"";
 	}
-	for (int pos = 0; pos < ((TypeArrayOop *)result)->get_length(); pos ++) {
-		ss << (wchar_t)((IntOop *)(*(TypeArrayOop *)result)[pos])->value;
-	}
-	return ss.str();
+	uint16_t *chars = (uint16_t *)((TypeArrayOop *)result)->get_base();
+	return wstring(chars, chars + ((TypeArrayOop *)result)->get_length());
 }
 
 wstring java_lang_string::print_stringOop(InstanceOop *stringoop) {
@@ -87,7 +96,7 @@ wstring java_lang_string::print_stringOop(InstanceOop *stringoop) {
 	ss << "string is: --> [\"";
 	if (result != nullptr)		// bug report, 见上！
 		for (int pos = 0; pos < ((TypeArrayOop *)result)->get_length(); pos ++) {
-			ss << (wchar_t)((IntOop *)(*(TypeArrayOop *)result)[pos])->value;
+			ss << (wchar_t)((TypeArrayOop *)result)->elem_at<uint16_t>(pos);
 		}
 	ss << "\"]";
 	// get hash value
@@ -104,8 +113,9 @@ Oop *java_lang_string::intern_to_oop(const wstring & str) {
 	TypeArrayOop * charsequence = (TypeArrayOop *)((TypeArrayKlass *)(*system_classmap.find(L"[C.class")).second)->new_instance(str.size());
 	assert(charsequence->get_klass() != nullptr);
 	// fill in `char[]`
+	uint16_t *chars = (uint16_t *)charsequence->get_base();
 	for (int pos = 0; pos < str.size(); pos ++) {
-		(*charsequence)[pos] = new IntOop((unsigned short)str[pos]);
+		chars[pos] = (uint16_t)str[pos];		// wchar_t is 4 bytes. no memcpy.
 	}
 	// alloc a StringOop.
 	InstanceOop *stringoop = ((InstanceKlass *)BootStrapClassLoader::get_bootstrap().loadClass(L"java/lang/String"))->new_instance();
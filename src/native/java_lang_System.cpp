@@ -18,6 +18,7 @@
 #include "classloader.hpp"
 #include <sys/time.h>
 #include "jarLister.hpp"
+#include "runtime/handles.hpp"
 
 using std::vector;
 
@@ -63,23 +64,34 @@ void JVM_ArrayCopy(list<Oop *> & _stack){				// static
 	int dst_pos = ((IntOop *)_stack.front())->value;	_stack.pop_front();
 	int length = ((IntOop *)_stack.front())->value;	_stack.pop_front();
 
-	if (obj1 == obj2) {
+	if (obj1->get_ooptype() == OopType::_TypeArrayOop && ((TypeArrayOop *)obj1)->get_dimension() == 1) {
+		assert(obj2->get_ooptype() == OopType::_TypeArrayOop && obj1->get_klass() == obj2->get_klass());
+		TypeArrayOop *objarr1 = (TypeArrayOop *)obj1;
+		TypeArrayOop *objarr2 = (TypeArrayOop *)obj2;
+		assert(src_pos >= 0 && dst_pos >= 0 && length >= 0 && src_pos + length <= objarr1->get_length() && dst_pos + length <= objarr2->get_length());	// TODO: ArrayIndexOutofBound
+		int elem_size = objarr1->get_elem_size();
+		// the raw elements: one memmove. (the ranges overlap if obj1 == obj2)
+		memmove(objarr2->get_base() + dst_pos * elem_size, objarr1->get_base() + src_pos * elem_size, (size_t)length * elem_size);
+	} else if (obj1 == obj2) {
 		ArrayOop *objarr = (ArrayOop *)obj1;
-		// memcpy has bugs so, we can't copy directly. => first alloc
-		ArrayOop temp(*objarr);	// copy for one layer. deep copy its member variable for only one layer.
-		for (int i = 0; i < length; i ++) {
-			assert(src_pos + i < objarr->get_length() && dst_pos + i < objarr->get_length());	// TODO: ArrayIndexOutofBound
-			(*objarr)[dst_pos + i] = temp[src_pos + i];
+		assert(src_pos >= 0 && dst_pos >= 0 && length >= 0 && src_pos + length <= objarr->get_length() && dst_pos + length <= objarr->get_length());	// TODO: ArrayIndexOutofBound
+		if (length > 0) {
+			// the elements are inline `Oop *`s: one memmove. (the ranges may overlap)
+			Satb::pre_write_barrier((void **)&(*objarr)[dst_pos], length);
+			memmove(&(*objarr)[dst_pos], &(*objarr)[src_pos], (size_t)length * sizeof(Oop *));
+			Heap::post_write_barrier(objarr);
 		}
 	} else if (obj1->get_ooptype() == OopType::_TypeArrayOop) {
 		assert(obj2->get_ooptype() == OopType::_TypeArrayOop);
-		TypeArrayOop *objarr1 = (TypeArrayOop *)obj1;
-		TypeArrayOop *objarr2 = (TypeArrayOop *)obj2;
+		ArrayOop *objarr1 = (ArrayOop *)obj1;		// more than one dimension: the elements are arrays.
+		ArrayOop *objarr2 = (ArrayOop *)obj2;
 		assert(objarr1->get_dimension() == objarr2->get_dimension());
+		Satb::pre_write_barrier((void **)&(*objarr2)[dst_pos], length);
 		for (int i = 0; i < length; i ++) {
 			assert(src_pos + i < objarr1->get_length() && dst_pos + i < objarr2->get_length());	// TODO: ArrayIndexOutofBound
 			(*objarr2)[dst_pos + i] = (*objarr1)[src_pos + i];
 		}
+		Heap::post_write_barrier(objarr2);
 	} else if (obj1->get_ooptype() == OopType::_ObjArrayOop) {
 		assert(obj2->get_ooptype() == OopType::_ObjArrayOop);
 		ObjArrayOop *objarr1 = (ObjArrayOop *)obj1;
@@ -138,9 +150,11 @@ void JVM_ArrayCopy(list<Oop *> & _stack){				// static
 
 		if (src_klass == dst_klass || src_klass->check_parent(dst_klass) || src_klass->check_interfaces(dst_klass)) {		// 1 or 2
 			// directly copy
+			Satb::pre_write_barrier((void **)&(*objarr2)[dst_pos], length);
 			for (int i = 0; i < length; i ++) {
 				(*objarr2)[dst_pos + i] = (*objarr1)[src_pos + i];
 			}
+			Heap::post_write_barrier(objarr2);		// one for the whole copy: the card of the array's header.
 		} else {
 			bool splice_all_null = true;
 			for (int i = 0; i < length; i ++) {
@@ -150,6 +164,7 @@ void JVM_ArrayCopy(list<Oop *> & _stack){				// static
 				}
 			}
 			if (splice_all_null) {		// 3.
+				Satb::pre_write_barrier((void **)&(*objarr2)[dst_pos], length);
 				for (int i = 0; i < length; i ++) {
 					(*objarr2)[dst_pos + i] = nullptr;
 				}
@@ -166,51 +181,52 @@ void JVM_ArrayCopy(list<Oop *> & _stack){				// static
 }
 void JVM_IdentityHashCode(list<Oop *> & _stack){		// static
 	InstanceOop *obj = (InstanceOop *)_stack.front();	_stack.pop_front();
-	_stack.push_back(new IntOop((intptr_t)obj));
+	_stack.push_back(new IntOop((obj == nullptr) ? 0 : obj->identity_hash()));
 }
 void JVM_InitProperties(list<Oop *> & _stack){		// static
-	InstanceOop *prop = (InstanceOop *)_stack.front();	_stack.pop_front();
 	vm_thread & thread = *(vm_thread *)_stack.back();	_stack.pop_back();
-	Method *hashtable_put = ((InstanceKlass *)prop->get_klass())->get_class_method(L"put:(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
+	HandleMark hm(thread);
+	Handle prop(thread, _stack.front());	_stack.pop_front();		// every `put()` may move it.
+	Method *hashtable_put = ((InstanceKlass *)prop()->get_klass())->get_class_method(L"put:(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
 	assert(hashtable_put != nullptr);
 
 	// get pwd/sun_src
 	wstring sun_src = pwd + L"/sun_src";
 
 	// add properties: 	// this, key, value
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"java.vm.specification.name"), java_lang_string::intern(L"Java Virtual Machine Specification")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"java.vm.specification.version"), java_lang_string::intern(L"1.8")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"java.vm.version"), java_lang_string::intern(L"25.0-b70-debug")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"java.vm.name"), java_lang_string::intern(L"wind_jvm 64-Bit VM")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"java.vm.info"), java_lang_string::intern(L"interpreted mode, sharing")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"java.specification.version"), java_lang_string::intern(L"1.8")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"java.version"), java_lang_string::intern(L"1.8.0-internal-debug")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"java.runtime.name"), java_lang_string::intern(L"windjvm Runtime Environment")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"java.runtime.version"), java_lang_string::intern(L"1.8.0")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"gopherProxySet"), java_lang_string::intern(L"false")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"java.vm.vendor"), java_lang_string::intern(L"wind2412")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"java.vendor.url"), java_lang_string::intern(L"http://wind2412.github.io/")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"path.separator"), java_lang_string::intern(L":")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"file.encoding.pkg"), java_lang_string::intern(L"sun.io")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"user.country"), java_lang_string::intern(L"CN")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"user.language"), java_lang_string::intern(L"zh")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"sun.java.launcher"), java_lang_string::intern(L"WIND_STANDARD")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"sun.os.patch.level"), java_lang_string::intern(L"unknown")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"os.arch"), java_lang_string::intern(L"x86_64")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"sun.arch.data.model"), java_lang_string::intern(L"64")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"line.separator"), java_lang_string::intern(L"\n")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"file.separator"), java_lang_string::intern(L"/")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"sun.jnu.encoding"), java_lang_string::intern(L"UTF-8")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"file.encoding"), java_lang_string::intern(L"UTF-8")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"java.specification.name"), java_lang_string::intern(L"Java Platform API Specification")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"java.class.version"), java_lang_string::intern(L"52.0")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"sun.management.compiler"), java_lang_string::intern(L"nop")});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"sun.io.unicode.encoding"), java_lang_string::intern(L"UnicodeBig")});
-
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"java.home"), java_lang_string::intern(pwd)});
-	thread.add_frame_and_execute(hashtable_put, {prop, java_lang_string::intern(L"java.class.path"), java_lang_string::intern(pwd + L":" + sun_src)});		 // TODO: need modified.
-
-	_stack.push_back(prop);
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"java.vm.specification.name"), java_lang_string::intern(L"Java Virtual Machine Specification")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"java.vm.specification.version"), java_lang_string::intern(L"1.8")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"java.vm.version"), java_lang_string::intern(L"25.0-b70-debug")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"java.vm.name"), java_lang_string::intern(L"wind_jvm 64-Bit VM")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"java.vm.info"), java_lang_string::intern(L"interpreted mode, sharing")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"java.specification.version"), java_lang_string::intern(L"1.8")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"java.version"), java_lang_string::intern(L"1.8.0-internal-debug")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"java.runtime.name"), java_lang_string::intern(L"windjvm Runtime Environment")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"java.runtime.version"), java_lang_string::intern(L"1.8.0")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"gopherProxySet"), java_lang_string::intern(L"false")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"java.vm.vendor"), java_lang_string::intern(L"wind2412")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"java.vendor.url"), java_lang_string::intern(L"http://wind2412.github.io/")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"path.separator"), java_lang_string::intern(L":")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"file.encoding.pkg"), java_lang_string::intern(L"sun.io")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"user.country"), java_lang_string::intern(L"CN")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"user.language"), java_lang_string::intern(L"zh")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"sun.java.launcher"), java_lang_string::intern(L"WIND_STANDARD")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"sun.os.patch.level"), java_lang_string::intern(L"unknown")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"os.arch"), java_lang_string::intern(L"x86_64")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"sun.arch.data.model"), java_lang_string::intern(L"64")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"line.separator"), java_lang_string::intern(L"\n")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"file.separator"), java_lang_string::intern(L"/")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"sun.jnu.encoding"), java_lang_string::intern(L"UTF-8")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"file.encoding"), java_lang_string::intern(L"UTF-8")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"java.specification.name"), java_lang_string::intern(L"Java Platform API Specification")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"java.class.version"), java_lang_string::intern(L"52.0")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"sun.management.compiler"), java_lang_string::intern(L"nop")});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"sun.io.unicode.encoding"), java_lang_string::intern(L"UnicodeBig")});
+
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"java.home"), java_lang_string::intern(pwd)});
+	thread.add_frame_and_execute(hashtable_put, {prop(), java_lang_string::intern(L"java.class.path"), java_lang_string::intern(pwd + L":" + sun_src)});		 // TODO: need modified.
+
+	_stack.push_back(prop());
 }
 void JVM_MapLibraryName(list<Oop *> & _stack){		// static
 	InstanceOop *str = (InstanceOop *)_stack.front();	_stack.pop_front();
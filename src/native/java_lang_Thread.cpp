@@ -8,6 +8,8 @@
 #include "native/java_lang_Thread.hpp"
 #include <algorithm>
 #include <cassert>
+#include <ctime>
+#include <cerrno>
 #include "native/native.hpp"
 #include "runtime/thread.hpp"
 #include "wind_jvm.hpp"
@@ -40,7 +42,7 @@ void JVM_StartThread(list<Oop *> & _stack){
 	LongOop *tid = (LongOop *)result;
 	assert(tid->value == 0);			// must be 0. if not 0, it must be started already.
 
-	// if class is ReferenceHandler, I won't open this thread like openjdk. it is of no use.
+	// if class is ReferenceHandler, I won't open this thread like openjdk. the gc enqueues the cleared References itself. see: `ReferenceProcessor`.
 	if (_this->get_klass()->get_name() == L"java/lang/ref/Reference$ReferenceHandler") {
 		return;
 	}
@@ -147,8 +149,12 @@ void JVM_Yield(list<Oop *> & _stack){			// static
 	}
 }
 void JVM_Sleep(list<Oop *> & _stack){			// static
-	LongOop *l1 = (LongOop *)_stack.front();	_stack.pop_front();
-	assert(false);
+	long millis = ((LongOop *)_stack.front())->value;	_stack.pop_front();
+	if (millis <= 0)	return;		// TODO: IllegalArgumentException for a negative one.
+	struct timespec spec = { millis / 1000, (millis % 1000) * 1000000 };
+	Safepoint::enter_blocked();		// a sleeping thread doesn't hold up the gc.
+	while (nanosleep(&spec, &spec) == -1 && errno == EINTR);
+	Safepoint::leave_blocked();
 }
 void JVM_CurrentThread(list<Oop *> & _stack){		// static
 	InstanceOop *thread_oop;
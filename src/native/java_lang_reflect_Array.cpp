@@ -21,6 +21,7 @@ static unordered_map<wstring, void*> methods = {
 void JVM_NewArray(list<Oop *> & _stack){		// static
 	MirrorOop *mirror = (MirrorOop *)_stack.front();	_stack.pop_front();
 	int length = ((IntOop *)_stack.front())->value;	_stack.pop_front();
+	vm_thread *thread = (vm_thread *)_stack.back();
 
 	assert(length >= 0);
 	auto real_klass = mirror->get_mirrored_who();
@@ -30,7 +31,8 @@ void JVM_NewArray(list<Oop *> & _stack){		// static
 		assert(arr_name != L"[V");		// not void
 		auto arr_klass = ((TypeArrayKlass *)BootStrapClassLoader::get_bootstrap().loadClass(arr_name));
 		assert(arr_klass != nullptr);
-		_stack.push_back(arr_klass->new_instance(length));
+		Oop *array = native_try_allocate(thread, _stack, [arr_klass, length]() -> Oop * { return arr_klass->try_new_instance(length); });
+		if (array != nullptr)	_stack.push_back(array);
 #ifdef DEBUG
 	sync_wcout{} << "(DEBUG) new an primitive type array." << std::endl;
 #endif
@@ -45,7 +47,8 @@ void JVM_NewArray(list<Oop *> & _stack){		// static
 			arr_klass = ((ObjArrayKlass *)loader->loadClass(L"[L" + real_instance_klass->get_name() + L";"));
 		}
 		assert(arr_klass != nullptr);
-		_stack.push_back(arr_klass->new_instance(length));
+		Oop *array = native_try_allocate(thread, _stack, [arr_klass, length]() -> Oop * { return arr_klass->try_new_instance(length); });
+		if (array != nullptr)	_stack.push_back(array);
 #ifdef DEBUG
 	sync_wcout{} << "(DEBUG) new an InstanceKlass array." << std::endl;
 #endif
@@ -53,7 +56,8 @@ void JVM_NewArray(list<Oop *> & _stack){		// static
 	} else if (real_klass->get_type() == ClassType::TypeArrayClass) {
 		auto arr_klass = ((TypeArrayKlass *)BootStrapClassLoader::get_bootstrap().loadClass(L"[" + real_klass->get_name()));	// add one dimension
 		assert(arr_klass != nullptr);
-		_stack.push_back(arr_klass->new_instance(length));
+		Oop *array = native_try_allocate(thread, _stack, [arr_klass, length]() -> Oop * { return arr_klass->try_new_instance(length); });
+		if (array != nullptr)	_stack.push_back(array);
 #ifdef DEBUG
 	sync_wcout{} << "(DEBUG) new a TypeArrayKlass's array." << std::endl;
 #endif
@@ -68,7 +72,8 @@ void JVM_NewArray(list<Oop *> & _stack){		// static
 			arr_klass = ((ObjArrayKlass *)loader->loadClass(L"[" + inner_element_klass->get_name()));
 		}
 		assert(arr_klass != nullptr);
-		_stack.push_back(arr_klass->new_instance(length));
+		Oop *array = native_try_allocate(thread, _stack, [arr_klass, length]() -> Oop * { return arr_klass->try_new_instance(length); });
+		if (array != nullptr)	_stack.push_back(array);
 #ifdef DEBUG
 	sync_wcout{} << "(DEBUG) new a ObjectArrayKlass's array." << std::endl;
 #endif
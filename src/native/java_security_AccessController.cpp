@@ -12,6 +12,7 @@
 #include "wind_jvm.hpp"
 #include "native/native.hpp"
 #include "classloader.hpp"
+#include "runtime/handles.hpp"
 
 static unordered_map<wstring, void*> methods = {
     {L"doPrivileged:(" PA ")" OBJ,				(void *)&JVM_DoPrivileged},
@@ -67,7 +68,10 @@ void JVM_DoPrivileged (list<Oop*>& _stack)
 	}
 	assert(method != nullptr);
 
+	HandleMark hm(thread);
+	Handle pa_handle(thread, pa);		// `run()` may move it.
 	Oop* result = thread.add_frame_and_execute (method, { pa }); // load the `this` obj
+	pa = pa_handle();
 
 	bool substitute = false;
 	if (result != nullptr && result->get_ooptype() != OopType::_BasicTypeOop && result->get_klass()->get_type() == ClassType::InstanceClass) {	// same as `(Bytecode)invokeVirtual` 's exception judge.
@@ -8,6 +8,10 @@
 #include "wind_jvm.hpp"
 
 #include "native/native.hpp"
+#include "runtime/handles.hpp"
+#include "runtime/gc.hpp"
+#include "runtime/heap_dump.hpp"
+#include "classloader.hpp"
 
 #include "native/java_lang_Object.hpp"
 #include "native/java_lang_Thread.hpp"
@@ -38,6 +42,7 @@
 #include "native/java_lang_invoke_MethodHandle.hpp"
 #include "native/sun_reflect_NativeMethodAccessorImpl.hpp"
 #include "native/java_lang_Shutdown.hpp"
+#include "native/sun_management_HotSpotDiagnostic.hpp"
 
 static unordered_map<wstring, function<void*(const wstring &)>> native_map;		// such as: {L"java/lang/Object", search [native method]'s method lambda for java/lang/Object}
 
@@ -72,6 +77,7 @@ void init_native()		// the same as "registerNatives" method.
 	native_map[L"java/lang/invoke/MethodHandle"] = java_lang_invoke_methodHandle_search_method;
 	native_map[L"sun/reflect/NativeMethodAccessorImpl"] = sun_reflect_nativeMethodAccessorImpl_search_method;
 	native_map[L"java/lang/Shutdown"] = java_lang_shutdown_search_method;
+	native_map[L"sun/management/HotSpotDiagnostic"] = sun_management_hotSpotDiagnostic_search_method;
 }
 
 // find a native method <$signature> in a klass <$klass_name>, return the method in (void *). if didn't find, abort().
@@ -88,10 +94,27 @@ void *find_native(const wstring & klass_name, const wstring & signature)	// such
 
 void native_throw_Exception(InstanceKlass *excp_klass, vm_thread *thread, list<Oop *> & _stack, const std::wstring & msg)
 {
-	auto excp_obj = excp_klass->new_instance();
+	HandleMark hm(*thread);
+	Handle excp_obj(*thread, excp_klass->new_instance());		// `<init>` may move it.
 	thread->set_exception_at_last_second_frame();		// set exception.
 	auto init_method = excp_klass->get_this_class_method(L"<init>:(Ljava/lang/String;)V");
 	assert(init_method != nullptr);
-	thread->add_frame_and_execute(init_method, {excp_obj, java_lang_string::intern(msg)});
-	_stack.push_back(excp_obj);
+	thread->add_frame_and_execute(init_method, {excp_obj(), java_lang_string::intern(msg)});
+	_stack.push_back(excp_obj());
+}
+
+Oop *native_try_allocate(vm_thread *thread, list<Oop *> & _stack, const function<Oop *()> & alloc)
+{
+	Oop *oop = alloc();
+	if (oop == nullptr) {
+		GC::collect_for_allocation(thread, MemAlloc::failed_size());		// all the oops of the native are in its frame or in handles.
+		oop = alloc();
+	}
+	if (oop == nullptr) {
+		HeapDump::on_out_of_memory();
+		auto excp_klass = ((InstanceKlass *)BootStrapClassLoader::get_bootstrap().loadClass(L"java/lang/OutOfMemoryError"));
+		BytecodeEngine::initial_clinit(excp_klass, *thread);
+		native_throw_Exception(excp_klass, thread, _stack, L"Java heap space");
+	}
+	return oop;
 }
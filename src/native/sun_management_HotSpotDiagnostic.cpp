@@ -0,0 +1,43 @@
+/*
+ * sun_management_HotSpotDiagnostic.cpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#include "native/sun_management_HotSpotDiagnostic.hpp"
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include "wind_jvm.hpp"
+#include "native/native.hpp"
+#include "native/java_lang_String.hpp"
+#include "runtime/heap_dump.hpp"
+#include "classloader.hpp"
+#include "utils/utils.hpp"
+
+static unordered_map<wstring, void*> methods = {
+    {L"dumpHeap0:(" STR L"Z)V",		(void *)&JVM_DumpHeap},
+};
+
+// the diagnostic command: `HotSpotDiagnosticMXBean.dumpHeap(file, live)`.
+void JVM_DumpHeap(list<Oop *> & _stack){
+	_stack.pop_front();		// this
+	InstanceOop *output_file = (InstanceOop *)_stack.front();	_stack.pop_front();
+	_stack.pop_front();		// `live`: always. only the oops reachable from the roots are dumped.
+	vm_thread *thread = (vm_thread *)_stack.back();	_stack.pop_back();
+	std::string path = wstring_to_utf8(java_lang_string::stringOop_to_wstring(output_file));
+	// the oops may move in the pause: don't touch them after it.
+	if (!HeapDump::request(path)) {
+		auto excp_klass = ((InstanceKlass *)BootStrapClassLoader::get_bootstrap().loadClass(L"java/io/IOException"));
+		native_throw_Exception(excp_klass, thread, _stack, L"could not write the heap dump to " + utf8_to_wstring(path));
+	}
+}
+
+void *sun_management_hotSpotDiagnostic_search_method(const wstring & signature)
+{
+	auto iter = methods.find(signature);
+	if (iter != methods.end()) {
+		return (*iter).second;
+	}
+	return nullptr;
+}
@@ -50,11 +50,17 @@ void JVM_ArrayBaseOffset(list<Oop *> & _stack){
 
 void JVM_ArrayIndexScale(list<Oop *> & _stack){
 	InstanceOop *_this = (InstanceOop *)_stack.front();	_stack.pop_front();
-	ArrayOop *_array = (ArrayOop *)_stack.front();	_stack.pop_front();
+	MirrorOop *_array_mirror = (MirrorOop *)_stack.front();	_stack.pop_front();
+	// a one-dimension basic type array keeps the raw elements. the others keep `Oop *`.
+	Klass *array_klass = _array_mirror->get_mirrored_who();
+	int scale = sizeof(intptr_t);
+	if (array_klass != nullptr && array_klass->get_type() == ClassType::TypeArrayClass && ((TypeArrayKlass *)array_klass)->get_dimension() == 1) {
+		scale = ((TypeArrayKlass *)array_klass)->get_elem_size();
+	}
 #ifdef DEBUG
-	sync_wcout{} << "[arrayScaleOffset] " << sizeof(intptr_t) << std::endl;		// delete
+	sync_wcout{} << "[arrayScaleOffset] " << scale << std::endl;		// delete
 #endif
-	_stack.push_back(new IntOop(sizeof(intptr_t)));
+	_stack.push_back(new IntOop(scale));
 }
 
 void JVM_AddressSize(list<Oop *> & _stack){
@@ -113,6 +119,27 @@ void JVM_ObjectFieldOffset(list<Oop *> & _stack){
 	_stack.push_back(new LongOop(offset));
 }
 
+// the address of a field's value. non-static: the byte offset in the inline fields. static: the value in the boxed static field.
+void *get_field_addr_from_instance_oop(InstanceOop *obj, long offset, wchar_t kind)
+{
+	InstanceKlass *klass = (InstanceKlass *)obj->get_klass();
+	if (klass->non_static_field_bytes() <= offset) {		// it's encoded static field offset.
+		Oop * & target = klass->get_static_fields_addr()[offset - klass->non_static_field_bytes()];	// decode
+		switch (kind) {
+			case L'I':
+				assert(target->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)target)->get_type() == Type::INT);
+				return &((IntOop *)target)->value;
+			case L'J':
+				assert(target->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)target)->get_type() == Type::LONG);
+				return &((LongOop *)target)->value;
+			default:
+				return &target;
+		}
+	} else {		// it's in non-static field.
+		return obj->get_fields_addr() + offset;
+	}
+}
+
 void JVM_GetIntVolatile(list<Oop *> & _stack){
 	InstanceOop *_this = (InstanceOop *)_stack.front();	_stack.pop_front();
 	InstanceOop *obj = (InstanceOop *)_stack.front();	_stack.pop_front();
@@ -125,35 +152,16 @@ void JVM_GetIntVolatile(list<Oop *> & _stack){
 	sync_wcout{} << "(DEBUG) [dangerous] will get an int from obj oop:[" << obj << "], which klass_name is: [" <<
 			((InstanceKlass *)obj->get_klass())->get_name() << "], offset: [" << offset << "]: " << std::endl;
 #endif
-	Oop *target;
-	if (((InstanceKlass *)obj->get_klass())->non_static_field_num() <= offset) {		// it's encoded static field offset.
-		offset -= ((InstanceKlass *)obj->get_klass())->non_static_field_num();	// decode
-		target = ((InstanceKlass *)obj->get_klass())->get_static_fields_addr()[offset];
-	} else {		// it's in non-static field.
-		target = obj->get_fields_addr()[offset];
-	}
-	assert(target->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)target)->get_type() == Type::INT);
+	int *target = (int *)get_field_addr_from_instance_oop(obj, offset, L'I');
 
-	int value = *((volatile int *)&((volatile IntOop *)target)->value);		// volatile
+	int value = *((volatile int *)target);		// volatile
 	_stack.push_back(new IntOop(value));
 #ifdef DEBUG
-	sync_wcout{} << "(DEBUG) ---> int value is [" << ((IntOop *)target)->value << "] " << std::endl;
+	sync_wcout{} << "(DEBUG) ---> int value is [" << value << "] " << std::endl;
 #endif
 
 }
 
-Oop **get_inner_oop_from_instance_oop_of_static_or_non_static_fields(InstanceOop *obj, long offset)
-{
-	Oop **target;
-	if (((InstanceKlass *)obj->get_klass())->non_static_field_num() <= offset) {		// it's encoded static field offset.
-		offset -= ((InstanceKlass *)obj->get_klass())->non_static_field_num();	// decode
-		target = &((InstanceKlass *)obj->get_klass())->get_static_fields_addr()[offset];
-	} else {		// it's in non-static field.
-		target = &obj->get_fields_addr()[offset];
-	}
-	return target;
-}
-
 void JVM_CompareAndSwapInt(list<Oop *> & _stack){
 	InstanceOop *_this = (InstanceOop *)_stack.front();	_stack.pop_front();
 	InstanceOop *obj = (InstanceOop *)_stack.front();	_stack.pop_front();
@@ -161,12 +169,10 @@ void JVM_CompareAndSwapInt(list<Oop *> & _stack){
 	int expected = ((IntOop *)_stack.front())->value;	_stack.pop_front();
 	int x = ((IntOop *)_stack.front())->value;	_stack.pop_front();
 
-	Oop **target = get_inner_oop_from_instance_oop_of_static_or_non_static_fields(obj, offset);
-
-	assert((*target)->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)*target)->get_type() == Type::INT);
+	int *target = (int *)get_field_addr_from_instance_oop(obj, offset, L'I');
 
 	// CAS, from x86 assembly, and openjdk.
-	_stack.push_back(new IntOop(cmpxchg(x, &((IntOop *)*target)->value, expected) == expected));
+	_stack.push_back(new IntOop(cmpxchg(x, target, expected) == expected));
 #ifdef DEBUG
 	sync_wcout{} << "(DEBUG) compare obj + offset with [" << expected << "] and swap to be [" << x << "], success: [" << std::boolalpha << (bool)((IntOop *)_stack.back())->value << "]." << std::endl;
 #endif
@@ -229,17 +235,15 @@ void *get_inner_obj_from_obj_and_offset(Oop *obj, long offset)
 {
 	void *addr;
 
-	if (obj->get_ooptype() == OopType::_TypeArrayOop || obj->get_ooptype() == OopType::_ObjArrayOop) {
+	if (obj->get_ooptype() == OopType::_TypeArrayOop && ((TypeArrayOop *)obj)->get_dimension() == 1) {
+		addr = ((TypeArrayOop *)obj)->get_base() + offset;		// the raw element.
+	} else if (obj->get_ooptype() == OopType::_TypeArrayOop || obj->get_ooptype() == OopType::_ObjArrayOop) {
 		int i_element = offset / sizeof(intptr_t);
 		addr = (void *)&((*(ArrayOop *)obj)[i_element]);		// Oop ** to void *.
 		if (*(Oop **)addr != nullptr)
 			assert((*(Oop **)addr)->get_ooptype() == OopType::_BasicTypeOop || (*(Oop **)addr)->get_ooptype() == OopType::_InstanceOop || (*(Oop **)addr)->get_ooptype() == OopType::_TypeArrayOop || (*(Oop **)addr)->get_ooptype() == OopType::_ObjArrayOop);
 	} else if (obj->get_ooptype() == OopType::_InstanceOop) {
-		Oop **target = get_inner_oop_from_instance_oop_of_static_or_non_static_fields((InstanceOop *)obj, offset);
-		if (*target != nullptr) {
-//			assert((*target)->get_ooptype() == OopType::_InstanceOop);
-		}
-		addr = (void *)target;
+		addr = get_field_addr_from_instance_oop((InstanceOop *)obj, offset, L'L');
 	} else {
 		assert(false);
 	}
@@ -277,7 +281,12 @@ void JVM_CompareAndSwapObject(list<Oop *> & _stack){
 
 
 	// CAS, from x86 assembly, and openjdk.
-	_stack.push_back(new IntOop(cmpxchg((long)x, (volatile long *)addr, (long)expected) == (long)expected));
+	bool success = cmpxchg((long)x, (volatile long *)addr, (long)expected) == (long)expected;
+	if (success) {
+		Satb::pre_write_barrier(expected);		// `expected` was overwritten.
+		Heap::post_write_barrier(obj);
+	}
+	_stack.push_back(new IntOop(success));
 #ifdef DEBUG
 	sync_wcout{} << "(DEBUG) compare obj + offset with [" << expected << "] and swap to be [" << x << "], success: [" << std::boolalpha << (bool)((IntOop *)_stack.back())->value << "]." << std::endl;
 #endif
@@ -290,12 +299,10 @@ void JVM_CompareAndSwapLong(list<Oop *> & _stack){
 	long expected = ((LongOop *)_stack.front())->value;	_stack.pop_front();
 	long x = ((LongOop *)_stack.front())->value;	_stack.pop_front();
 
-	Oop **target = get_inner_oop_from_instance_oop_of_static_or_non_static_fields(obj, offset);
-
-	assert((*target)->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)*target)->get_type() == Type::LONG);
+	long *target = (long *)get_field_addr_from_instance_oop(obj, offset, L'J');
 
 	// CAS, from x86 assembly, and openjdk.
-	_stack.push_back(new IntOop(cmpxchg(x, &((LongOop *)*target)->value, expected) == expected));
+	_stack.push_back(new IntOop(cmpxchg(x, target, expected) == expected));
 
 #ifdef DEBUG
 	sync_wcout{} << "(DEBUG) compare obj + offset with [" << expected << "] and swap to be [" << x << "], success: [" << std::boolalpha << (bool)((IntOop *)_stack.back())->value << "]." << std::endl;
@@ -322,10 +329,7 @@ void JVM_DefineAnonymousClass(list<Oop *> & _stack){	// see: OpenJDK: unsafe.cpp
 	wstring klass_name = L"<unknown>";
 
 	char *buf = new char[len];
-
-	for (int i = 0; i < len; i ++) {
-		buf[i] = (char)((IntOop *)(*bytes)[i])->value;
-	}
+	memcpy(buf, bytes->get_base(), len);
 
 	ByteStream byte_buf(buf, len);
 
@@ -371,10 +375,7 @@ void JVM_DefineClass(list<Oop *> & _stack){
 	wstring klass_name = java_lang_string::stringOop_to_wstring(name);
 
 	char *buf = new char[len];
-
-	for (int i = offset, j = 0; i < offset + len; i ++, j ++) {
-		buf[j] = (char)((IntOop *)(*bytes)[i])->value;
-	}
+	memcpy(buf, bytes->get_base() + offset, len);
 
 	ByteStream byte_buf(buf, len);
 
@@ -407,7 +408,7 @@ void JVM_PutObjectVolatile(list<Oop *> & _stack){		// put `target` at obj[offset
 	release();
 
 	Oop *temp = *(Oop **)addr;
-	*(Oop **)addr = target;
+	oop_store(obj, *(Oop **)addr, target);
 
 	fence();
 
@@ -453,7 +454,7 @@ void JVM_PutObject(list<Oop *> & _stack){			// (no volatile!!)
 	void *addr = get_inner_obj_from_obj_and_offset(obj, offset);		// really Oop **.
 
 	Oop *temp = *(Oop **)addr;
-	*(Oop **)addr = target;
+	oop_store(obj, *(Oop **)addr, target);
 
 #ifdef DEBUG
 	wstring target_name = (target != nullptr) ? target->get_klass()->get_name() : L"null";
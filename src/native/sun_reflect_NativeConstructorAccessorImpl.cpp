@@ -10,6 +10,7 @@
 #include <cassert>
 #include "wind_jvm.hpp"
 #include "native/native.hpp"
+#include "runtime/handles.hpp"
 
 static unordered_map<wstring, void*> methods = {
     {L"newInstance0:(" CTR "[" OBJ ")" OBJ,				(void *)&JVM_NewInstanceFromConstructor},
@@ -24,8 +25,9 @@ void JVM_NewInstanceFromConstructor(list<Oop *> & _stack){		// static
 	// get target InstanceKlass
 	ctor->get_field_value(CONSTRUCTOR L":clazz:Ljava/lang/Class;", &result);
 	InstanceKlass *target_klass = ((InstanceKlass *)((MirrorOop *)result)->get_mirrored_who());
-	// new an empty object
-	Oop *init = target_klass->new_instance();
+	// new an empty object. `<init>` runs java: it's read again through the handle after.
+	HandleMark hm(thread);
+	Handle init(thread, target_klass->new_instance());
 	// get Method *of <init>
 	ctor->get_field_value(CONSTRUCTOR L":slot:I", &result);
 	Method *target_method = target_klass->search_method_in_slot(((IntOop *)result)->value);
@@ -33,7 +35,7 @@ void JVM_NewInstanceFromConstructor(list<Oop *> & _stack){		// static
 	// get arg lists types
 	// parse objs to list<Oop *>
 	list<Oop *> arg_list;
-	arg_list.push_back(init);		// push `this` first
+	arg_list.push_back(init());		// push `this` first
 	if (objs != nullptr)				// pitfall: if objs == nullptr, it must be <init>:()V. no args.
 		for (int i = 0; i < objs->get_length(); i ++) {
 			arg_list.push_back((*objs)[i]);
@@ -41,7 +43,7 @@ void JVM_NewInstanceFromConstructor(list<Oop *> & _stack){		// static
 	// launch and construct, no return val.
 	thread.add_frame_and_execute(target_method, arg_list);
 	// save.
-	_stack.push_back(init);
+	_stack.push_back(init());
 #ifdef DEBUG
 	sync_wcout{} << "(DEBUG) use Constructor:[<init>:" << target_method->get_descriptor() << "] to initialize a new obj of type [" << target_klass->get_name() << "]." << std::endl;
 #endif
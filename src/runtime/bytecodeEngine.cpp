@@ -21,7 +21,16 @@
 #include <utility>
 #include "utils/synchronize_wcout.hpp"
 #include "runtime/thread.hpp"
+#include "runtime/inline_cache.hpp"
+#include "runtime/jit.hpp"
+#include "runtime/heap_dump.hpp"
+#include "runtime/reference_processor.hpp"
+#include "runtime/handles.hpp"
 #include <deque>
+#include <cmath>
+#include <algorithm>
+#include <sys/mman.h>
+#include <unistd.h>
 #include "utils/utils.hpp"
 #include "native/java_lang_invoke_MethodHandle.hpp"
 
@@ -33,22 +42,126 @@ using std::map;
 using std::pair;
 using std::make_pair;
 
-/*===----------- StackFrame --------------===*/
-StackFrame::StackFrame(Method *method, uint8_t *return_pc, StackFrame *prev, const list<Oop *> & args, vm_thread *thread, bool is_native) : method(method), return_pc(return_pc), prev(prev) {	// va_args is: Method's argument. 所有的变长参数的类型全是有类型的 Oop。因此，在**执行 code**的时候就会有类型检查～
-	if (is_native) {
-		return;
+/*===----------- JavaStack --------------===*/
+static const int FRAME_HEADER_SLOTS = (sizeof(StackFrame) + sizeof(Slot) - 1) / sizeof(Slot);	// the StackFrame between the lvt and the op_stack.
+
+static void *map_with_guard_page(size_t & bytes)		// aux. the guard page is at the high end, because the JavaStack grows up.
+{
+	size_t page_size = sysconf(_SC_PAGESIZE);
+	bytes = (bytes + page_size - 1) / page_size * page_size + page_size;
+	void *addr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (addr == MAP_FAILED) {
+		std::wcerr << "can't map the java stack of " << bytes << " bytes!" << std::endl;
+		assert(false);
+	}
+	mprotect((char *)addr + bytes - page_size, page_size, PROT_NONE);
+	return addr;
+}
+
+void JavaStack::init(size_t stack_size)
+{
+	assert(slots == nullptr);
+	capacity = stack_size / sizeof(Slot);
+	assert(capacity > RESERVED_SLOTS);
+	slots_bytes = capacity * sizeof(Slot);
+	slots = (Slot *)map_with_guard_page(slots_bytes);
+	tags_bytes = capacity * sizeof(uint8_t);
+	tags = (uint8_t *)map_with_guard_page(tags_bytes);
+}
+
+void JavaStack::destroy()
+{
+	assert(last == nullptr);
+	munmap(slots, slots_bytes);
+	munmap(tags, tags_bytes);
+	slots = nullptr;
+	tags = nullptr;
+	capacity = 0;
+}
+
+StackFrame *JavaStack::new_frame(Method *method, uint8_t *return_pc, StackFrame *prev, Slot *base, int max_locals, int max_stack, int limit)
+{
+	assert(base >= slots);
+	if (base + max_locals + FRAME_HEADER_SLOTS + max_stack > slots + limit) {
+		return nullptr;
+	}
+	StackFrame *frame = new (base + max_locals) StackFrame(method, return_pc, prev);
+	frame->localVariableTable.slots = base;
+	frame->localVariableTable.tags = tag_of(base);
+	frame->localVariableTable.length = max_locals;
+	frame->op_stack.slots = base + max_locals + FRAME_HEADER_SLOTS;
+	frame->op_stack.tags = tag_of(frame->op_stack.slots);
+	frame->op_stack.capacity = max_stack;
+	frame->link = last;
+	last = frame;
+	frame_num ++;
+	return frame;
+}
+
+StackFrame & JavaStack::push_frame(Method *method, uint8_t *return_pc, StackFrame *prev, const list<Oop *> & args)
+{
+	assert(!method->is_native());
+	// the vm calls into java here, e.g. <clinit>, so it may use the reserved zone. its callees will get the StackOverflowError.
+	StackFrame *frame = new_frame(method, return_pc, prev, top(), method->get_code()->max_locals, method->get_code()->max_stack, capacity);
+	if (frame == nullptr) {
+		std::wcerr << "java stack overflow at: <class>: " << method->get_klass()->get_name() << "-->" << method->get_name() << ":" << method->get_descriptor() << ". please use a bigger -Xss." << std::endl;
+		assert(false);
 	}
-	localVariableTable.resize(method->get_code()->max_locals);
+	LocalVariableTable & localVariableTable = frame->localVariableTable;
+	std::fill(localVariableTable.tags, localVariableTable.tags + localVariableTable.length, SLOT_PRIMITIVE);	// stale slots must not look like gc roots.
 	int i = 0;
-	for (Oop * value : args) {
-		localVariableTable.at(i++) = value;
-		if (value != nullptr && value->get_ooptype() == OopType::_BasicTypeOop
-				&& ((((BasicTypeOop *)value)->get_type() == Type::LONG) || (((BasicTypeOop *)value)->get_type() == Type::DOUBLE))) {
-			localVariableTable.at(i++) = nullptr;
+	for (Oop * value : args) {		// unbox the args on the boundary.
+		if (value != nullptr && value->get_ooptype() == OopType::_BasicTypeOop) {
+			switch (((BasicTypeOop *)value)->get_type()) {
+				case Type::LONG:
+					localVariableTable.set_long(i, ((LongOop *)value)->value);	i += 2;
+					break;
+				case Type::DOUBLE:
+					localVariableTable.set_double(i, ((DoubleOop *)value)->value);	i += 2;
+					break;
+				case Type::FLOAT:
+					localVariableTable.set_float(i++, ((FloatOop *)value)->value);
+					break;
+				default:
+					localVariableTable.set_int(i++, ((IntOop *)value)->value);
+			}
+		} else {
+			localVariableTable.set_ref(i++, value);
 		}
 	}
+	return *frame;
 }
 
+StackFrame *JavaStack::push_frame(Method *method, uint8_t *return_pc, StackFrame *prev, OperandStack & caller_stack, int arg_slot_num)
+{
+	assert(caller_stack.size() >= arg_slot_num);
+	Slot *base = caller_stack.slots + caller_stack.size() - arg_slot_num;
+	StackFrame *frame;
+	if (method->is_native()) {
+		frame = new_frame(method, return_pc, prev, base, arg_slot_num, 0, limit());		// a native frame only holds its args, which keeps them as gc roots during the call.
+	} else {
+		frame = new_frame(method, return_pc, prev, base, method->get_code()->max_locals, method->get_code()->max_stack, limit());
+		if (frame != nullptr) {
+			assert(frame->localVariableTable.size() >= arg_slot_num);
+			std::fill(frame->localVariableTable.tags + arg_slot_num, frame->localVariableTable.tags + frame->localVariableTable.length, SLOT_PRIMITIVE);	// the args are in place already.
+		}
+	}
+	if (frame != nullptr) {
+		caller_stack.sp -= arg_slot_num;		// the args now belong to the callee.
+	}
+	return frame;
+}
+
+void JavaStack::pop_frame()
+{
+	assert(last != nullptr);
+	StackFrame *frame = last;
+	last = frame->link;
+	frame_num --;
+	frame->~StackFrame();
+}
+
+/*===----------- StackFrame --------------===*/
 wstring StackFrame::print_arg_msg(Oop *value, vm_thread *thread)
 {
 	std::wstringstream ss;
@@ -106,8 +219,8 @@ wstring StackFrame::print_arg_msg(Oop *value, vm_thread *thread)
 
 void StackFrame::clear_all() {					// used with `is_valid()`. if invalid, clear all to reuse this frame.
 	this->valid_frame = true;
-	stack<Oop *>().swap(op_stack);				// empty. [Effective STL]
-	vector<Oop *>().swap(localVariableTable);
+	op_stack.clear();
+	std::fill(localVariableTable.tags, localVariableTable.tags + localVariableTable.length, SLOT_PRIMITIVE);
 	method = nullptr;
 	return_pc = nullptr;
 	// prev not change.
@@ -240,37 +353,23 @@ wstring BytecodeEngine::get_real_value(Oop *oop)
 	return ss.str();
 }
 
-Oop* copy_BasicOop_value(Oop *oop)		// aux
+void dup_slots(OperandStack & op_stack, int count, int depth)		// aux: duplicate the top `count` slots and insert them under the next `depth` slots. `dup_x2` is (1, 2), `dup2` is (2, 0)...
 {
-	if (oop->get_ooptype() == OopType::_BasicTypeOop) {
-		BasicTypeOop *basic = (BasicTypeOop *)oop;
-		switch(basic->get_type()) {
-			case Type::BOOLEAN:
-			case Type::BYTE:
-			case Type::SHORT:
-			case Type::CHAR:
-			case Type::INT:
-				return new IntOop(((IntOop *)basic)->value);
-			case Type::DOUBLE:
-				return new DoubleOop(((DoubleOop *)basic)->value);
-			case Type::FLOAT:
-				return new FloatOop(((DoubleOop *)basic)->value);
-			case Type::LONG:
-				return new LongOop(((DoubleOop *)basic)->value);
-			default:
-				assert(false);
-		}
-	} else {
-		assert(false);
+	assert(op_stack.size() >= count + depth);
+	Slot slots[4];
+	uint8_t tags[4];
+	for (int i = count + depth - 1; i >= 0; i --) {		// slots[0] is the deepest one.
+		slots[count + depth - 1 - i] = op_stack.peek(i);
+		tags[count + depth - 1 - i] = op_stack.peek_tag(i);
 	}
-}
-
-Oop *if_BasicType_then_copy_else_return_only(Oop *oop)
-{
-	if (oop != nullptr && oop->get_ooptype() == OopType::_BasicTypeOop) {
-		return copy_BasicOop_value(oop);
-	} else {
-		return oop;
+	for (int i = 0; i < count + depth; i ++) {
+		op_stack.pop();
+	}
+	for (int i = depth; i < count + depth; i ++) {		// the duplicated ones.
+		op_stack.push_slot(slots[i], tags[i]);
+	}
+	for (int i = 0; i < count + depth; i ++) {
+		op_stack.push_slot(slots[i], tags[i]);
 	}
 }
 
@@ -413,109 +512,333 @@ void BytecodeEngine::initial_clinit(InstanceKlass *new_klass, vm_thread & thread
 	}
 }
 
-void BytecodeEngine::getField(Field_info *new_field, stack<Oop *> & op_stack)
+wchar_t BytecodeEngine::type_to_kind(Type type)
+{
+	switch (type) {
+		case Type::BOOLEAN:	return L'Z';
+		case Type::BYTE:		return L'B';
+		case Type::CHAR:		return L'C';
+		case Type::SHORT:		return L'S';
+		case Type::INT:		return L'I';
+		case Type::FLOAT:		return L'F';
+		case Type::LONG:		return L'J';
+		case Type::DOUBLE:	return L'D';
+		case Type::OBJECT:
+		case Type::ARRAY:		return L'L';
+		default:{
+			std::cerr << "can't get here!" << std::endl;
+			assert(false);
+		}
+	}
+}
+
+Oop *BytecodeEngine::box_slot(OperandStack & op_stack, wchar_t kind)
+{
+	switch (kind) {
+		case L'Z':
+		case L'B':
+		case L'C':
+		case L'S':
+		case L'I':
+			return new IntOop(op_stack.pop_int());
+		case L'F':
+			return new FloatOop(op_stack.pop_float());
+		case L'J':
+			return new LongOop(op_stack.pop_long());
+		case L'D':
+			return new DoubleOop(op_stack.pop_double());
+		default:
+			return op_stack.pop_ref();
+	}
+}
+
+void BytecodeEngine::unbox_to_slot(OperandStack & op_stack, Oop *value, wchar_t kind)
+{
+	switch (kind) {
+		case L'Z':
+		case L'B':
+		case L'C':
+		case L'S':
+		case L'I':
+			assert(value != nullptr && value->get_ooptype() == OopType::_BasicTypeOop);
+			op_stack.push_int(((IntOop *)value)->value);
+			break;
+		case L'F':
+			assert(value != nullptr && value->get_ooptype() == OopType::_BasicTypeOop);
+			op_stack.push_float(((FloatOop *)value)->value);
+			break;
+		case L'J':
+			assert(value != nullptr && value->get_ooptype() == OopType::_BasicTypeOop);
+			op_stack.push_long(((LongOop *)value)->value);
+			break;
+		case L'D':
+			assert(value != nullptr && value->get_ooptype() == OopType::_BasicTypeOop);
+			op_stack.push_double(((DoubleOop *)value)->value);
+			break;
+		default:
+			op_stack.push(value);
+	}
+}
+
+void BytecodeEngine::pop_args_boxed(OperandStack & op_stack, const vector<wchar_t> & kinds, list<Oop *> & arg_list)
+{
+	for (auto iter = kinds.rbegin(); iter != kinds.rend(); ++iter) {
+		arg_list.push_front(box_slot(op_stack, *iter));
+	}
+}
+
+void BytecodeEngine::box_args(LocalVariableTable & lvt, const vector<wchar_t> & kinds, bool has_this, list<Oop *> & arg_list)
+{
+	int i = 0;
+	if (has_this) {
+		arg_list.push_back(lvt.get_ref(i++));
+	}
+	for (wchar_t kind : kinds) {
+		switch (kind) {
+			case L'Z':
+			case L'B':
+			case L'C':
+			case L'S':
+			case L'I':
+				arg_list.push_back(new IntOop(lvt.get_int(i++)));
+				break;
+			case L'F':
+				arg_list.push_back(new FloatOop(lvt.get_float(i++)));
+				break;
+			case L'J':
+				arg_list.push_back(new LongOop(lvt.get_long(i)));	i += 2;
+				break;
+			case L'D':
+				arg_list.push_back(new DoubleOop(lvt.get_double(i)));	i += 2;
+				break;
+			default:
+				arg_list.push_back(lvt.get_ref(i++));
+		}
+	}
+}
+
+void push_default_value(OperandStack & op_stack, wchar_t kind)		// aux
+{
+	switch (kind) {
+		case L'V':
+			break;
+		case L'F':
+			op_stack.push_float(0);
+			break;
+		case L'J':
+			op_stack.push_long(0);
+			break;
+		case L'D':
+			op_stack.push_double(0);
+			break;
+		case L'L':
+			op_stack.push(nullptr);
+			break;
+		default:
+			op_stack.push_int(0);
+	}
+}
+
+void BytecodeEngine::getField(Field_info *new_field, OperandStack & op_stack)
 {
 	// TODO: FP_strict
-	Oop *ref = op_stack.top();	op_stack.pop();
-//	std::wcout << ref->get_klass()->get_name() << " " << new_field->get_name() << " " << new_field->get_descriptor() << std::endl;		// delete
+	Oop *ref = op_stack.pop_ref();
 	assert(ref->get_klass()->get_type() == ClassType::InstanceClass);
-//	std::wcout << ref->get_klass()->get_name() << " " << new_field->get_klass()->get_name() << std::endl;
 //	assert(ref->get_klass() == new_field->get_klass());	// not right. because the left one may be the right one's child。
-	Oop *new_value;
-	((InstanceOop *)ref)->get_field_value(new_field, &new_value);
-	op_stack.push(new_value);
+	// the field has the same offset in the declaring klass and all its children. read the raw value, no boxing.
+	InstanceOop *obj = (InstanceOop *)ref;
+	int offset = new_field->get_offset();
+	switch (type_to_kind(new_field->get_type())) {
+		case L'Z':	op_stack.push_int(obj->field_at<uint8_t>(offset));		break;
+		case L'B':	op_stack.push_int(obj->field_at<int8_t>(offset));		break;
+		case L'C':	op_stack.push_int(obj->field_at<uint16_t>(offset));		break;
+		case L'S':	op_stack.push_int(obj->field_at<int16_t>(offset));		break;
+		case L'I':	op_stack.push_int(obj->field_at<int>(offset));			break;
+		case L'F':	op_stack.push_float(obj->field_at<float>(offset));		break;
+		case L'J':	op_stack.push_long(obj->field_at<long>(offset));			break;
+		case L'D':	op_stack.push_double(obj->field_at<double>(offset));		break;
+		default: {
+			Oop *value = obj->field_at<Oop *>(offset);
+			// `Reference.get()`: the referent is strongly reachable from now on, though the marking may have passed the Reference over.
+			if (ReferenceProcessor::is_referent_field(new_field))	Satb::pre_write_barrier(value);
+			op_stack.push(value);
+		}
+	}
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) get a non-static value : " << get_real_value(new_value) << " from <class>: " << ref->get_klass()->get_name() << "-->" << new_field->get_name() << ":"<< new_field->get_descriptor() << ", to the stack." << std::endl;
+	sync_wcout{} << "(DEBUG) get a non-static value from <class>: " << ref->get_klass()->get_name() << "-->" << new_field->get_name() << ":"<< new_field->get_descriptor() << " (offset: " << offset << "), to the stack." << std::endl;
 #endif
 }
 
-void BytecodeEngine::putField(Field_info *new_field, stack<Oop *> & op_stack)
+void BytecodeEngine::putField(Field_info *new_field, OperandStack & op_stack)
 {
-	Oop *new_value = op_stack.top();	op_stack.pop();
-	Oop *ref = op_stack.top();	op_stack.pop();
+	wchar_t kind = type_to_kind(new_field->get_type());
+	int offset = new_field->get_offset();
+	// the object ref is under the value: 2 slots under a `long`/`double`, else 1.
+	Oop *ref = op_stack.peek((kind == L'J' || kind == L'D') ? 2 : 1).ref;
 	assert(ref->get_klass()->get_type() == ClassType::InstanceClass);
-	((InstanceOop *)ref)->set_field_value(new_field, new_value);
+	InstanceOop *obj = (InstanceOop *)ref;
+	switch (kind) {
+		case L'Z':	obj->field_at<uint8_t>(offset) = op_stack.pop_int();		break;
+		case L'B':	obj->field_at<int8_t>(offset) = op_stack.pop_int();		break;
+		case L'C':	obj->field_at<uint16_t>(offset) = op_stack.pop_int();		break;
+		case L'S':	obj->field_at<int16_t>(offset) = op_stack.pop_int();		break;
+		case L'I':	obj->field_at<int>(offset) = op_stack.pop_int();			break;
+		case L'F':	obj->field_at<float>(offset) = op_stack.pop_float();		break;
+		case L'J':	obj->field_at<long>(offset) = op_stack.pop_long();		break;
+		case L'D':	obj->field_at<double>(offset) = op_stack.pop_double();		break;
+		default:		oop_store(obj, obj->field_at<Oop *>(offset), op_stack.pop_ref());
+	}
+	op_stack.pop_ref();
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) put a non-static value (unknown value type): " << get_real_value(new_value) << " from stack, to <class>: " << new_field->get_klass()->get_name() << "-->" << new_field->get_name() << ":"<< new_field->get_descriptor() << " and override." << std::endl;
+	sync_wcout{} << "(DEBUG) put a non-static value from stack, to <class>: " << new_field->get_klass()->get_name() << "-->" << new_field->get_name() << ":"<< new_field->get_descriptor() << " (offset: " << offset << ") and override." << std::endl;
 #endif
 }
 
-void BytecodeEngine::getStatic(Field_info *new_field, stack<Oop *> & op_stack, vm_thread & thread)
+void BytecodeEngine::getStatic(Field_info *new_field, OperandStack & op_stack, vm_thread & thread, bool check_clinit)
 {
-	// initialize the new_class... <clinit>
 	InstanceKlass *new_klass = new_field->get_klass();
-	initial_clinit(new_klass, thread);
-	// parse the field to RUNTIME!!
-	if (new_field->get_type() == Type::OBJECT) {
-		assert(new_field->get_type_klass() != nullptr);
-		initial_clinit(((InstanceKlass *)new_field->get_type_klass()), thread);
+	if (check_clinit) {
+		// initialize the new_class... <clinit>
+		initial_clinit(new_klass, thread);
+		// parse the field to RUNTIME!!
+		if (new_field->get_type() == Type::OBJECT) {
+			assert(new_field->get_type_klass() != nullptr);
+			initial_clinit(((InstanceKlass *)new_field->get_type_klass()), thread);
+		}
 	}
 	// get the [static Field] value and save to the stack top
 	Oop *new_top;
 	bool temp = new_klass->get_static_field_value(new_field, &new_top);
 	assert(temp == true);
-	op_stack.push(new_top);
+	unbox_to_slot(op_stack, new_top, type_to_kind(new_field->get_type()));
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) get a static value : " << get_real_value(new_top) << " from <class>: " << new_klass->get_name() << "-->" << new_field->get_name() << ":"<< new_field->get_descriptor() << " on to the stack." << std::endl;
 #endif
 }
 
-void BytecodeEngine::putStatic(Field_info *new_field, stack<Oop *> & op_stack, vm_thread & thread)
+void BytecodeEngine::putStatic(Field_info *new_field, OperandStack & op_stack, vm_thread & thread, bool check_clinit)
 {
-	// initialize the new_class... <clinit>
 	InstanceKlass *new_klass = new_field->get_klass();
-	initial_clinit(new_klass, thread);
-	// parse the field to RUNTIME!!
-	if (new_field->get_type() == Type::OBJECT) {
-		assert(new_field->get_type_klass() != nullptr);
-		initial_clinit(((InstanceKlass *)new_field->get_type_klass()), thread);
+	if (check_clinit) {
+		// initialize the new_class... <clinit>
+		initial_clinit(new_klass, thread);
+		// parse the field to RUNTIME!!
+		if (new_field->get_type() == Type::OBJECT) {
+			assert(new_field->get_type_klass() != nullptr);
+			initial_clinit(((InstanceKlass *)new_field->get_type_klass()), thread);
+		}
 	}
 	// get the stack top and save to the [static Field]
-	Oop *top = op_stack.top();	op_stack.pop();
+	Oop *top = box_slot(op_stack, type_to_kind(new_field->get_type()));
 	new_klass->set_static_field_value(new_field, top);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) put a static value (unknown value type): " << get_real_value(top) << " from stack, to <class>: " << new_klass->get_name() << "-->" << new_field->get_name() << ":"<< new_field->get_descriptor() << " and override." << std::endl;
 #endif
 }
 
-void BytecodeEngine::invokeVirtual(Method *new_method, stack<Oop *> & op_stack, vm_thread & thread, StackFrame & cur_frame, uint8_t * & pc)
+bool BytecodeEngine::is_static_initialized(Field_info *new_field)
+{
+	if (new_field->get_klass()->get_state() != Klass::KlassState::Initialized)	return false;
+	if (new_field->get_type() == Type::OBJECT && ((InstanceKlass *)new_field->get_type_klass())->get_state() != Klass::KlassState::Initialized)	return false;
+	return true;
+}
+
+void BytecodeEngine::throw_stack_overflow(OperandStack & op_stack, vm_thread & thread, StackFrame & cur_frame, int arg_slot_num, Oop *locked)
+{
+	JavaStack & java_stack = thread.vm_stack;
+	if (java_stack.is_in_reserved_zone()) {
+		std::wcerr << "java stack overflow while building the StackOverflowError. please use a bigger -Xss." << std::endl;
+		assert(false);
+	}
+	// the callee never runs: unlock it now, while `locked` is still where the gc left it. the constructor of the error runs java.
+	if (locked != nullptr) {
+		thread.monitor_dec();
+		locked->leave_monitor();
+	}
+	for (int i = 0; i < arg_slot_num; i ++)	op_stack.pop();
+	if (op_stack.size() == op_stack.capacity) {		// no room for the exception. the exception handler will clear the op_stack anyway.
+		op_stack.clear();
+	}
+	// build the StackOverflowError in the reserved zone. the error is pushed first: it's a gc root while its constructor runs.
+	java_stack.set_in_reserved_zone(true);
+	auto excp_klass = ((InstanceKlass *)BootStrapClassLoader::get_bootstrap().loadClass(L"java/lang/StackOverflowError"));
+	initial_clinit(excp_klass, thread);
+	op_stack.push(excp_klass->new_instance());
+	auto init_method = excp_klass->get_this_class_method(L"<init>:()V");
+	assert(init_method != nullptr);
+	thread.add_frame_and_execute(init_method, {op_stack.top()});
+	java_stack.set_in_reserved_zone(false);
+#ifdef BYTECODE_DEBUG
+	sync_wcout{} << "(DEBUG) java stack overflow: [" << java_stack.size() << "] frames. throw a StackOverflowError." << std::endl;
+#endif
+	cur_frame.has_exception = true;
+}
+
+void BytecodeEngine::throw_out_of_memory(OperandStack & op_stack, vm_thread & thread)
+{
+	// the heap is still full after a full gc. the error is pushed first: it's a gc root while its constructor runs.
+	HeapDump::on_out_of_memory();
+	throwing_out_of_memory() = true;
+	auto excp_klass = ((InstanceKlass *)BootStrapClassLoader::get_bootstrap().loadClass(L"java/lang/OutOfMemoryError"));
+	initial_clinit(excp_klass, thread);
+	op_stack.push(excp_klass->new_instance());
+	auto init_method = excp_klass->get_this_class_method(L"<init>:(Ljava/lang/String;)V");
+	assert(init_method != nullptr);
+	thread.add_frame_and_execute(init_method, {op_stack.top(), java_lang_string::intern(L"Java heap space")});
+	throwing_out_of_memory() = false;
+	MemAlloc::out_of_memory_pending() = false;		// this error is the one of the vm reserve too.
+#ifdef BYTECODE_DEBUG
+	sync_wcout{} << "(DEBUG) java heap space exhausted: [" << MemAlloc::failed_size() << "] bytes. throw an OutOfMemoryError." << std::endl;
+#endif
+}
+
+bool BytecodeEngine::check_pending_out_of_memory(OperandStack & op_stack, vm_thread & thread)
+{
+	// a vm allocation has taken the vm reserve, and this thread is back in java: collect the whole heap at this safepoint.
+	// if the reserve is still not free, the heap is exhausted.
+	if (throwing_out_of_memory())	return false;
+	MemAlloc::out_of_memory_pending() = false;
+	GC::collect_for_allocation(&thread, Heap::VM_RESERVE);
+	if (Heap::has_reserve())	return false;
+	throw_out_of_memory(op_stack, thread);
+	return true;
+}
+
+StackFrame *BytecodeEngine::invokeInterpreted(Method *target_method, OperandStack & op_stack, vm_thread & thread, StackFrame & cur_frame, uint8_t * & pc, bool has_this, Oop *locked)
 {
-	wstring signature = new_method->get_name() + L":" + new_method->get_descriptor();
+	// the new frame's lvt starts at the args on `op_stack`. no boxing, no copying.
+	int arg_slot_num = target_method->get_arg_slot_num() + (has_this ? 1 : 0);
+	assert(op_stack.size() >= arg_slot_num);
+	StackFrame *new_frame = thread.vm_stack.push_frame(target_method, pc, &cur_frame, op_stack, arg_slot_num);
+	if (new_frame == nullptr) {
+		throw_stack_overflow(op_stack, thread, cur_frame, arg_slot_num, locked);
+	}
+	// `execute()` switches to the new frame in the same loop. the return value will be pushed onto `op_stack` by the callee.
+	return new_frame;
+}
 
-	int size = new_method->parse_argument_list().size() + 1;		// don't forget `this`!!!
+StackFrame *BytecodeEngine::invokeVirtual(Method *new_method, OperandStack & op_stack, vm_thread & thread, StackFrame & cur_frame, uint8_t * & pc, uint8_t bytecode)
+{
+	int size = new_method->get_arg_slot_num() + 1;		// don't forget `this`!!!
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "arg size: " << size << "; op_stack size: " << op_stack.size() << std::endl;	// delete
 #endif
-	Oop *ref;		// get ref. (this)	// same as invokespecial. but invokespecial didn't use `this` ref to get Klass.
-	list<Oop *> arg_list;
 	assert(op_stack.size() >= size);
-	while (size > 0) {
-		if (size == 1) {
-			ref = op_stack.top();
-		}
-		arg_list.push_front(op_stack.top());
-		op_stack.pop();
-		size --;
-	}
+	assert(op_stack.peek_tag(size - 1) == SLOT_REFERENCE);
+	Oop *ref = op_stack.peek(size - 1).ref;		// get ref. (this)	// same as invokespecial. but invokespecial didn't use `this` ref to get Klass.
 
 	// modify: close the `Perf` class (LOL)
 	if (new_method->get_klass()->get_name() == L"sun/misc/Perf" || new_method->get_klass()->get_name() == L"sun/misc/PerfCounter") {
-		if (new_method->is_void()) {
-			return;
-		} else if (new_method->is_return_primitive()){
-			op_stack.push(new IntOop(0));
-			return;
-		} else {
-			op_stack.push(nullptr);
-			return;
-		}
+		for (int i = 0; i < size; i ++)	op_stack.pop();
+		push_default_value(op_stack, new_method->get_ret_kind());
+		return nullptr;
 	}
 
 
 	// 2. get ref.
 	if (ref == nullptr) {
 		thread.get_stack_trace();			// delete, for debug
-		std::wcout << new_method->get_klass()->get_name() << " " << signature << std::endl;
+		std::wcout << new_method->get_klass()->get_name() << " " << new_method->get_name() << ":" << new_method->get_descriptor() << std::endl;
 	}
 	assert(ref != nullptr);			// `this` must not be nullptr!!!!
 #ifdef BYTECODE_DEBUG
@@ -529,25 +852,22 @@ void BytecodeEngine::invokeVirtual(Method *new_method, stack<Oop *> & op_stack,
 	if (new_method->is_synchronized()) {
 		sync_wcout{} << " [synchronized]";
 	}
-	sync_wcout{} << " " << ref->get_klass()->get_name() << "::" << signature << std::endl;
+	sync_wcout{} << " " << ref->get_klass()->get_name() << "::" << new_method->get_name() << ":" << new_method->get_descriptor() << std::endl;
 #endif
+	// dispatch by this call site's inline cache, or by the vtable/itable index. no name lookup.
 	Method *target_method;
-	if (*pc == 0xb6){
-		if (ref->get_klass()->get_type() == ClassType::InstanceClass) {
-			target_method = ((InstanceKlass *)ref->get_klass())->search_vtable(signature);
-		} else if (ref->get_klass()->get_type() == ClassType::TypeArrayClass || ref->get_klass()->get_type() == ClassType::ObjArrayClass) {
-			target_method = new_method;
-		} else {
-			std::wcout << ref->get_klass()->get_type() << std::endl;
-			assert(false);
-		}
+	if (ref->get_klass()->get_type() == ClassType::InstanceClass) {
+		InlineCache *ic = InlineCache::get_inline_cache(cur_frame.method, pc - cur_frame.method->get_code()->code);
+		target_method = ic->lookup((InstanceKlass *)ref->get_klass(), new_method);
+	} else if (bytecode == 0xb6 && (ref->get_klass()->get_type() == ClassType::TypeArrayClass || ref->get_klass()->get_type() == ClassType::ObjArrayClass)) {
+		target_method = new_method;
 	} else {
-		assert(ref->get_klass()->get_type() == ClassType::InstanceClass);
-		target_method = ((InstanceKlass *)ref->get_klass())->get_class_method(signature);
+		std::wcout << ref->get_klass()->get_type() << std::endl;
+		assert(false);
 	}
 
 	if (target_method == nullptr) {
-		std::wcerr << "didn't find: [" << signature << "] in klass: [" << ref->get_klass()->get_name() << "]!" << std::endl;
+		std::wcerr << "didn't find: [" << new_method->get_name() << ":" << new_method->get_descriptor() << "] in klass: [" << ref->get_klass()->get_name() << "]!" << std::endl;
 	}
 	assert(target_method != nullptr);
 
@@ -556,6 +876,7 @@ void BytecodeEngine::invokeVirtual(Method *new_method, stack<Oop *> & op_stack,
 	if (target_method->is_synchronized()) {
 		thread.monitor_inc();
 		ref->enter_monitor();
+		ref = op_stack.peek(size - 1).ref;		// the gc may have moved it while this thread was blocked.
 #ifdef BYTECODE_DEBUG
 		sync_wcout{} << "(DEBUG) synchronize obj: [" << ref << "]." << std::endl;
 #endif
@@ -565,8 +886,10 @@ void BytecodeEngine::invokeVirtual(Method *new_method, stack<Oop *> & op_stack,
 #ifdef BYTECODE_DEBUG
 			sync_wcout{} << "jump off `registerNatives`." << std::endl;
 #endif
+			op_stack.pop();		// `this`
 		} else {
 			InstanceKlass *new_klass = new_method->get_klass();
+			wstring signature = new_method->get_name() + L":" + new_method->get_descriptor();
 			void *native_method = find_native(new_klass->get_name(), signature);
 			// no need to add a stack frame!
 			if (native_method == nullptr) {
@@ -580,14 +903,23 @@ void BytecodeEngine::invokeVirtual(Method *new_method, stack<Oop *> & op_stack,
 #ifdef BYTECODE_DEBUG
 sync_wcout{} << "(DEBUG) invoke a [native] method: <class>: " << new_klass->get_name() << "-->" << new_method->get_name() << ":(this)"<< new_method->get_descriptor() << std::endl;
 #endif
+			uint8_t *backup_pc = pc;
+			StackFrame *native_frame = thread.vm_stack.push_frame(new_method, pc, nullptr, op_stack, size);
+			if (native_frame == nullptr) {
+				throw_stack_overflow(op_stack, thread, cur_frame, size, target_method->is_synchronized() ? ref : nullptr);
+				return nullptr;
+			}
+			new_method->inc_invocation_counter();
+			// natives still use boxed args: box them on the boundary.
+			list<Oop *> arg_list;
+			box_args(native_frame->localVariableTable, new_method->get_arg_kinds(), true, arg_list);
 			arg_list.push_back(ref->get_klass()->get_mirror());
 			arg_list.push_back((Oop *)&thread);
-			uint8_t *backup_pc = pc;
-			thread.vm_stack.push_back(StackFrame(new_method, pc, nullptr, arg_list, &thread, true));
 			pc = 0;
 			// execute !!
 			((void (*)(list<Oop *> &))native_method)(arg_list);
-			thread.vm_stack.pop_back();
+			ref = native_frame->localVariableTable.get_ref(0);		// the native may have run java or blocked: the gc may have moved `this`.
+			thread.vm_stack.pop_frame();
 			pc = backup_pc;
 
 			if (cur_frame.has_exception) {
@@ -595,9 +927,9 @@ sync_wcout{} << "(DEBUG) invoke a [native] method: <class>: " << new_klass->get_
 				op_stack.push(arg_list.back());
 			} else if (!new_method->is_void()) {	// return value.
 				assert(arg_list.size() >= 1);
-				op_stack.push(arg_list.back());
+				unbox_to_slot(op_stack, arg_list.back(), new_method->get_ret_kind());
 #ifdef BYTECODE_DEBUG
-sync_wcout{} << "then push invoke [native] method's return value " << op_stack.top() << " on the stack~" << std::endl;
+sync_wcout{} << "then push invoke [native] method's return value " << get_real_value(arg_list.back()) << " on the stack~" << std::endl;
 #endif
 			}
 		}
@@ -605,16 +937,11 @@ sync_wcout{} << "then push invoke [native] method's return value " << op_stack.t
 #ifdef BYTECODE_DEBUG
 sync_wcout{} << "(DEBUG) invoke a method: <class>: " << ref->get_klass()->get_name() << "-->" << new_method->get_name() << ":(this)"<< new_method->get_descriptor() << std::endl;
 #endif
-		Oop *result = thread.add_frame_and_execute(target_method, arg_list);
-
-		if (cur_frame.has_exception) {
-			op_stack.push(result);
-		} else if (!target_method->is_void()) {
-			op_stack.push(result);
-#ifdef BYTECODE_DEBUG
-sync_wcout{} << "then push invoke method's return value " << op_stack.top() << " on the stack~" << std::endl;
-#endif
+		StackFrame *new_frame = invokeInterpreted(target_method, op_stack, thread, cur_frame, pc, true, target_method->is_synchronized() ? ref : nullptr);
+		if (new_frame != nullptr && target_method->is_synchronized()) {
+			new_frame->monitor_obj = ref;		// unsynchronized when the new frame returns or unwinds.
 		}
+		return new_frame;		// nullptr: a StackOverflowError, unsynchronized already.
 	}
 
 	// unsynchronize
@@ -625,21 +952,22 @@ sync_wcout{} << "then push invoke method's return value " << op_stack.top() << "
 		sync_wcout{} << "(DEBUG) unsynchronize obj: [" << ref << "]." << std::endl;
 #endif
 	}
-
+	return nullptr;
 }
 
-void BytecodeEngine::invokeStatic(Method *new_method, stack<Oop *> & op_stack, vm_thread & thread, StackFrame & cur_frame, uint8_t * & pc)
+StackFrame *BytecodeEngine::invokeStatic(Method *new_method, OperandStack & op_stack, vm_thread & thread, StackFrame & cur_frame, uint8_t * & pc, uint8_t bytecode, bool check_clinit)
 {
-	wstring signature = new_method->get_name() + L":" + new_method->get_descriptor();
-	if (*pc == 0xb8) {
+	if (bytecode == 0xb8) {
 		assert(new_method->is_static() && !new_method->is_abstract());
-	} else if (*pc == 0xb7) {
+	} else if (bytecode == 0xb7) {
 		// TODO: limits.
 		// do nothing is okay.
 	}
 	// initialize the new_class... <clinit>
 	InstanceKlass *new_klass = new_method->get_klass();
-	initial_clinit(new_klass, thread);
+	if (check_clinit) {
+		initial_clinit(new_klass, thread);
+	}
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG)";
 	if (new_method->is_private()) {
@@ -651,46 +979,37 @@ void BytecodeEngine::invokeStatic(Method *new_method, stack<Oop *> & op_stack, v
 	if (new_method->is_synchronized()) {
 		sync_wcout{} << " [synchronized]";
 	}
-	sync_wcout{} << " " << new_klass->get_name() << "::" << signature << std::endl;
+	sync_wcout{} << " " << new_klass->get_name() << "::" << new_method->get_name() << ":" << new_method->get_descriptor() << std::endl;
 #endif
-	// parse arg list and push args into stack: arg_list !
-	int size = new_method->parse_argument_list().size();
-	if (*pc == 0xb7) {
+	// the args are still on op_stack now!
+	int size = new_method->get_arg_slot_num();
+	if (bytecode == 0xb7) {
 		size ++;		// add `this`.
 	}
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "arg size: " << size << "; op_stack size: " << op_stack.size() << std::endl;	// delete
 #endif
-	list<Oop *> arg_list;
 	assert(op_stack.size() >= size);
 	Oop *ref = nullptr;
-	while (size > 0) {
-		if (size == 1 && *pc == 0xb7) {
-			ref = op_stack.top();
-		}
-		arg_list.push_front(op_stack.top());
-		op_stack.pop();
-		size --;
+	if (bytecode == 0xb7) {
+		assert(op_stack.peek_tag(size - 1) == SLOT_REFERENCE);
+		ref = op_stack.peek(size - 1).ref;
 	}
 
 	// ban the `System.loadLibrary` method.
-	if (new_method->get_klass()->get_name() == L"java/lang/System" && new_method->get_name() == L"loadLibrary")
-		return;
+	if (new_method->get_klass()->get_name() == L"java/lang/System" && new_method->get_name() == L"loadLibrary") {
+		for (int i = 0; i < size; i ++)	op_stack.pop();
+		return nullptr;
+	}
 	// ban the `Perf` class.
 	if (new_method->get_klass()->get_name() == L"sun/misc/Perf" || new_method->get_klass()->get_name() == L"sun/misc/PerfCounter") {
-		if (new_method->is_void()) {
-			return;
-		} else if (new_method->is_return_primitive()){
-			op_stack.push(new IntOop(0));
-			return;
-		} else {
-			op_stack.push(nullptr);
-			return;
-		}
+		for (int i = 0; i < size; i ++)	op_stack.pop();
+		push_default_value(op_stack, new_method->get_ret_kind());
+		return nullptr;
 	}
 
 	// synchronized:
-	Oop *this_obj;
+	Oop *this_obj = nullptr;
 	if (new_method->is_synchronized()) {
 		thread.monitor_inc();
 		if (new_method->is_static()) {	// if static, lock the `mirror` of this klass.	// for 0xb8: invokeStatic
@@ -700,8 +1019,9 @@ void BytecodeEngine::invokeStatic(Method *new_method, stack<Oop *> & op_stack, v
 #endif
 		} else {							// if not-static, lock this obj.					// for 0xb7: invokeSpecial
 			// get the `obj` from op_stack!
-			this_obj = arg_list.front();
-			this_obj->enter_monitor();
+			ref->enter_monitor();
+			ref = op_stack.peek(size - 1).ref;		// the gc may have moved it while this thread was blocked.
+			this_obj = ref;
 #ifdef BYTECODE_DEBUG
 		sync_wcout{} << "(DEBUG) synchronize obj: [" << this_obj << "]." << std::endl;
 #endif
@@ -712,13 +1032,15 @@ void BytecodeEngine::invokeStatic(Method *new_method, stack<Oop *> & op_stack, v
 #ifdef BYTECODE_DEBUG
 			sync_wcout{} << "jump off `registerNatives`." << std::endl;
 #endif
+			for (int i = 0; i < size; i ++)	op_stack.pop();
 		} else {
 #ifdef BYTECODE_DEBUG
-if (*pc == 0xb7)
+if (bytecode == 0xb7)
 sync_wcout{} << "(DEBUG) invoke a [native] method: <class>: " << new_klass->get_name() << "-->" << new_method->get_name() << ":(this)"<< new_method->get_descriptor() << std::endl;
-else if (*pc == 0xb8)
+else if (bytecode == 0xb8)
 sync_wcout{} << "(DEBUG) invoke a [native] method: <class>: " << new_klass->get_name() << "-->" << new_method->get_name() << ":"<< new_method->get_descriptor() << std::endl;
 #endif
+			wstring signature = new_method->get_name() + L":" + new_method->get_descriptor();
 			void *native_method = find_native(new_klass->get_name(), signature);
 			// no need to add a stack frame!
 			if (native_method == nullptr) {
@@ -729,18 +1051,29 @@ sync_wcout{} << "(DEBUG) invoke a [native] method: <class>: " << new_klass->get_
 				std::wcout << "method!" << std::endl;
 			}
 			assert(native_method != nullptr);
-			if (*pc == 0xb7)
+			uint8_t *backup_pc = pc;
+			StackFrame *native_frame = thread.vm_stack.push_frame(new_method, pc, nullptr, op_stack, size);
+			if (native_frame == nullptr) {
+				throw_stack_overflow(op_stack, thread, cur_frame, size, !new_method->is_synchronized() ? nullptr : new_method->is_static() ? new_method->get_klass()->get_mirror() : this_obj);
+				return nullptr;
+			}
+			new_method->inc_invocation_counter();
+			// natives still use boxed args: box them on the boundary.
+			list<Oop *> arg_list;
+			box_args(native_frame->localVariableTable, new_method->get_arg_kinds(), bytecode == 0xb7, arg_list);
+			if (bytecode == 0xb7) {
 				arg_list.push_back(ref->get_klass()->get_mirror());
-			else
+			} else
 				arg_list.push_back(new_method->get_klass()->get_mirror());
 			arg_list.push_back((Oop *)&thread);
 
-			uint8_t *backup_pc = pc;
-			thread.vm_stack.push_back(StackFrame(new_method, pc, nullptr, arg_list, &thread, true));
 			pc = nullptr;
 			// execute !!
 			((void (*)(list<Oop *> &))native_method)(arg_list);
-			thread.vm_stack.pop_back();
+			if (bytecode == 0xb7) {
+				this_obj = native_frame->localVariableTable.get_ref(0);		// the native may have run java or blocked: the gc may have moved `this`.
+			}
+			thread.vm_stack.pop_frame();
 			pc = backup_pc;
 
 			if (cur_frame.has_exception) {
@@ -748,29 +1081,25 @@ sync_wcout{} << "(DEBUG) invoke a [native] method: <class>: " << new_klass->get_
 				op_stack.push(arg_list.back());
 			} else if (!new_method->is_void()) {	// return value.
 				assert(arg_list.size() >= 1);
-				op_stack.push(arg_list.back());
+				unbox_to_slot(op_stack, arg_list.back(), new_method->get_ret_kind());
 #ifdef BYTECODE_DEBUG
-sync_wcout{} << "then push invoke [native] method's return value " << op_stack.top() << " on the stack~" << std::endl;
+sync_wcout{} << "then push invoke [native] method's return value " << get_real_value(arg_list.back()) << " on the stack~" << std::endl;
 #endif
 			}
 		}
 	} else {
 #ifdef BYTECODE_DEBUG
-if (*pc == 0xb7)
+if (bytecode == 0xb7)
 sync_wcout{} << "(DEBUG) invoke a method: <class>: " << new_klass->get_name() << "-->" << new_method->get_name() << ":(this)"<< new_method->get_descriptor() << std::endl;
-else if (*pc == 0xb8)
+else if (bytecode == 0xb8)
 sync_wcout{} << "(DEBUG) invoke a method: <class>: " << new_klass->get_name() << "-->" << new_method->get_name() << ":"<< new_method->get_descriptor() << std::endl;
 #endif
-		Oop *result = thread.add_frame_and_execute(new_method, arg_list);
-
-		if (cur_frame.has_exception) {
-			op_stack.push(result);
-		} else if (!new_method->is_void()) {
-			op_stack.push(result);
-#ifdef BYTECODE_DEBUG
-sync_wcout{} << "then push invoke method's return value " << op_stack.top() << " on the stack~" << std::endl;
-#endif
+		Oop *locked = !new_method->is_synchronized() ? nullptr : new_method->is_static() ? new_method->get_klass()->get_mirror() : this_obj;
+		StackFrame *new_frame = invokeInterpreted(new_method, op_stack, thread, cur_frame, pc, bytecode == 0xb7, locked);
+		if (new_frame != nullptr && locked != nullptr) {
+			new_frame->monitor_obj = locked;		// unsynchronized when the new frame returns or unwinds.
 		}
+		return new_frame;		// nullptr: a StackOverflowError, unsynchronized already.
 	}
 	// unsynchronize
 	if (new_method->is_synchronized()) {
@@ -787,6 +1116,7 @@ sync_wcout{} << "then push invoke method's return value " << op_stack.top() << "
 #endif
 		}
 	}
+	return nullptr;
 }
 
 InstanceOop *BytecodeEngine::MethodType_make(Method *target_method, vm_thread & thread)
@@ -839,8 +1169,9 @@ InstanceOop *BytecodeEngine::MethodHandles_Lookup_make(vm_thread & thread)
 
 InstanceOop *BytecodeEngine::MethodHandle_make(rt_constant_pool & rt_pool, int method_handle_real_index, vm_thread & thread, bool is_bootStrap_method)
 {
-	// first, get the `MethodHandles.lookup()`.
-	auto lookup_obj = MethodHandles_Lookup_make(thread);
+	// first, get the `MethodHandles.lookup()`. held in a handle: the MethodType below is made by java, too.
+	HandleMark hm(thread);
+	Handle lookup_obj(thread, MethodHandles_Lookup_make(thread));
 
 	assert(rt_pool[method_handle_real_index].first == CONSTANT_MethodHandle);
 	pair<int, int> fake_methodhandle_pair = boost::any_cast<pair<int, int>>(rt_pool[method_handle_real_index].second);
@@ -853,37 +1184,37 @@ InstanceOop *BytecodeEngine::MethodHandle_make(rt_constant_pool & rt_pool, int m
 		case 1:{		// REF_getField
 			assert(rt_pool[ref_index-1].first == CONSTANT_Fieldref);
 			auto field = boost::any_cast<Field_info *>(rt_pool[ref_index-1].second);
-			auto findGetter_method = ((InstanceKlass *)lookup_obj->get_klass())->get_this_class_method(L"findGetter:(" CLS STR CLS ")" MH);
+			auto findGetter_method = ((InstanceKlass *)lookup_obj()->get_klass())->get_this_class_method(L"findGetter:(" CLS STR CLS ")" MH);
 			InstanceOop *result = (InstanceOop *)thread.add_frame_and_execute(findGetter_method,
-						{lookup_obj, field->get_klass()->get_mirror(), java_lang_string::intern(field->get_name()), field->get_type_klass()->get_mirror()});
+						{lookup_obj(), field->get_klass()->get_mirror(), java_lang_string::intern(field->get_name()), field->get_type_klass()->get_mirror()});
 			assert(result != nullptr);
 			return result;
 		}
 		case 2:{		// REF_getStatic
 			assert(rt_pool[ref_index-1].first == CONSTANT_Fieldref);
 			auto field = boost::any_cast<Field_info *>(rt_pool[ref_index-1].second);
-			auto findStaticGetter_method = ((InstanceKlass *)lookup_obj->get_klass())->get_this_class_method(L"findStaticGetter:(" CLS STR CLS ")" MH);
+			auto findStaticGetter_method = ((InstanceKlass *)lookup_obj()->get_klass())->get_this_class_method(L"findStaticGetter:(" CLS STR CLS ")" MH);
 			InstanceOop *result = (InstanceOop *)thread.add_frame_and_execute(findStaticGetter_method,
-						{lookup_obj, field->get_klass()->get_mirror(), java_lang_string::intern(field->get_name()), field->get_type_klass()->get_mirror()});
+						{lookup_obj(), field->get_klass()->get_mirror(), java_lang_string::intern(field->get_name()), field->get_type_klass()->get_mirror()});
 			assert(result != nullptr);
 			return result;
 		}
 		case 3:{		// REF_puttField
 			assert(rt_pool[ref_index-1].first == CONSTANT_Fieldref);
 			auto field = boost::any_cast<Field_info *>(rt_pool[ref_index-1].second);
-			auto findSetter_method = ((InstanceKlass *)lookup_obj->get_klass())->get_this_class_method(L"findSetter:(" CLS STR CLS ")" MH);
+			auto findSetter_method = ((InstanceKlass *)lookup_obj()->get_klass())->get_this_class_method(L"findSetter:(" CLS STR CLS ")" MH);
 			InstanceOop *result = (InstanceOop *)thread.add_frame_and_execute(findSetter_method,
-						{lookup_obj, field->get_klass()->get_mirror(), java_lang_string::intern(field->get_name()), field->get_type_klass()->get_mirror()});
+						{lookup_obj(), field->get_klass()->get_mirror(), java_lang_string::intern(field->get_name()), field->get_type_klass()->get_mirror()});
 			assert(result != nullptr);
 			return result;
 		}
 		case 4:{		// REF_putStatic
 			assert(rt_pool[ref_index-1].first == CONSTANT_Fieldref);
 			auto field = boost::any_cast<Field_info *>(rt_pool[ref_index-1].second);
-			auto findStaticSetter_method = ((InstanceKlass *)lookup_obj->get_klass())->get_this_class_method(L"findStaticSetter:(" CLS STR CLS ")" MH);
+			auto findStaticSetter_method = ((InstanceKlass *)lookup_obj()->get_klass())->get_this_class_method(L"findStaticSetter:(" CLS STR CLS ")" MH);
 			assert(findStaticSetter_method != nullptr);
 			InstanceOop *result = (InstanceOop *)thread.add_frame_and_execute(findStaticSetter_method,
-						{lookup_obj, field->get_klass()->get_mirror(), java_lang_string::intern(field->get_name()), field->get_type_klass()->get_mirror()});
+						{lookup_obj(), field->get_klass()->get_mirror(), java_lang_string::intern(field->get_name()), field->get_type_klass()->get_mirror()});
 			assert(result != nullptr);
 			return result;
 		}
@@ -891,10 +1222,11 @@ InstanceOop *BytecodeEngine::MethodHandle_make(rt_constant_pool & rt_pool, int m
 			assert(rt_pool[ref_index-1].first == CONSTANT_Methodref);
 			auto method = boost::any_cast<Method *>(rt_pool[ref_index-1].second);
 			assert(method->get_name() != L"<init>" && method->get_name() != L"<clinit>");
-			auto findVirtual_method = ((InstanceKlass *)lookup_obj->get_klass())->search_vtable(L"findVirtual:(" CLS STR MT ")" MH);
+			auto findVirtual_method = ((InstanceKlass *)lookup_obj()->get_klass())->search_vtable(L"findVirtual:(" CLS STR MT ")" MH);
 			assert(findVirtual_method != nullptr);
+			Oop *method_type = MethodType_make(method, thread);		// before the others are read: it runs java.
 			InstanceOop *result = (InstanceOop *)thread.add_frame_and_execute(findVirtual_method,
-						{lookup_obj, method->get_klass()->get_mirror(), java_lang_string::intern(method->get_name()), MethodType_make(method, thread)});
+						{lookup_obj(), method->get_klass()->get_mirror(), java_lang_string::intern(method->get_name()), method_type});
 			assert(result != nullptr);
 			return result;
 		}
@@ -902,11 +1234,12 @@ InstanceOop *BytecodeEngine::MethodHandle_make(rt_constant_pool & rt_pool, int m
 			assert(rt_pool[ref_index-1].first == CONSTANT_Methodref || rt_pool[ref_index-1].first == CONSTANT_InterfaceMethodref);
 			auto method = boost::any_cast<Method *>(rt_pool[ref_index-1].second);
 			assert(method->get_name() != L"<init>" && method->get_name() != L"<clinit>");
-//			std::wcout << ((InstanceKlass *)lookup_obj->get_klass())->get_name() << std::endl;
-			auto findStatic_method = ((InstanceKlass *)lookup_obj->get_klass())->get_this_class_method(L"findStatic:(" CLS STR MT ")" MH);
+//			std::wcout << ((InstanceKlass *)lookup_obj()->get_klass())->get_name() << std::endl;
+			auto findStatic_method = ((InstanceKlass *)lookup_obj()->get_klass())->get_this_class_method(L"findStatic:(" CLS STR MT ")" MH);
 			assert(findStatic_method != nullptr);
+			Oop *method_type = MethodType_make(method, thread);		// before the others are read: it runs java.
 			InstanceOop *result = (InstanceOop *)thread.add_frame_and_execute(findStatic_method,
-						{lookup_obj, method->get_klass()->get_mirror(), java_lang_string::intern(method->get_name()), MethodType_make(method, thread)});
+						{lookup_obj(), method->get_klass()->get_mirror(), java_lang_string::intern(method->get_name()), method_type});
 			assert(result != nullptr);
 			return result;
 		}
@@ -915,9 +1248,10 @@ InstanceOop *BytecodeEngine::MethodHandle_make(rt_constant_pool & rt_pool, int m
 			auto method = boost::any_cast<Method *>(rt_pool[ref_index-1].second);
 			assert(method->get_name() != L"<init>" && method->get_name() != L"<clinit>");
 			assert(false);		// TODO: argument is fault.
-			auto findSpecial_method = ((InstanceKlass *)lookup_obj->get_klass())->get_class_method(L"findSpecial:(" CLS STR MT ")" MH);
+			auto findSpecial_method = ((InstanceKlass *)lookup_obj()->get_klass())->get_class_method(L"findSpecial:(" CLS STR MT ")" MH);
+			Oop *method_type = MethodType_make(method, thread);		// before the others are read: it runs java.
 			InstanceOop *result = (InstanceOop *)thread.add_frame_and_execute(findSpecial_method,
-						{lookup_obj, method->get_klass()->get_mirror(), java_lang_string::intern(method->get_name()), MethodType_make(method, thread)});
+						{lookup_obj(), method->get_klass()->get_mirror(), java_lang_string::intern(method->get_name()), method_type});
 			assert(result != nullptr);
 			return result;
 		}
@@ -926,9 +1260,10 @@ InstanceOop *BytecodeEngine::MethodHandle_make(rt_constant_pool & rt_pool, int m
 			auto method = boost::any_cast<Method *>(rt_pool[ref_index-1].second);
 			assert(method->get_name() == L"<init>");		// special inner klass!!
 			assert(false);		// TODO: augument is fault. close it.
-			auto findSpecial_method = ((InstanceKlass *)lookup_obj->get_klass())->get_this_class_method(L"findSpecial:(" CLS STR MT ")" MH);
+			auto findSpecial_method = ((InstanceKlass *)lookup_obj()->get_klass())->get_this_class_method(L"findSpecial:(" CLS STR MT ")" MH);
+			Oop *method_type = MethodType_make(method, thread);		// before the others are read: it runs java.
 			InstanceOop *result = (InstanceOop *)thread.add_frame_and_execute(findSpecial_method,
-						{lookup_obj, method->get_klass()->get_mirror(), java_lang_string::intern(method->get_name()), MethodType_make(method, thread)});
+						{lookup_obj(), method->get_klass()->get_mirror(), java_lang_string::intern(method->get_name()), method_type});
 			assert(result != nullptr);
 			return result;
 		}
@@ -936,9 +1271,10 @@ InstanceOop *BytecodeEngine::MethodHandle_make(rt_constant_pool & rt_pool, int m
 			assert(rt_pool[ref_index-1].first == CONSTANT_InterfaceMethodref);
 			auto method = boost::any_cast<Method *>(rt_pool[ref_index-1].second);
 			assert(method->get_name() != L"<init>" && method->get_name() != L"<clinit>");
-			auto findVirtual_method = ((InstanceKlass *)lookup_obj->get_klass())->get_class_method(L"findVirtual:(" CLS STR MT ")" MH);
+			auto findVirtual_method = ((InstanceKlass *)lookup_obj()->get_klass())->get_class_method(L"findVirtual:(" CLS STR MT ")" MH);
+			Oop *method_type = MethodType_make(method, thread);		// before the others are read: it runs java.
 			InstanceOop *result = (InstanceOop *)thread.add_frame_and_execute(findVirtual_method,
-						{lookup_obj, method->get_klass()->get_mirror(), java_lang_string::intern(method->get_name()), MethodType_make(method, thread)});
+						{lookup_obj(), method->get_klass()->get_mirror(), java_lang_string::intern(method->get_name()), method_type});
 			assert(result != nullptr);
 			return result;
 		}
@@ -992,45 +1328,146 @@ void BytecodeEngine::main_thread_exception(int exitcode)		// dummy is use for By
 }
 
 
-	Lock init_lock;		// delete
-
-Oop * BytecodeEngine::execute(vm_thread & thread, StackFrame & cur_frame, int thread_no) {		// do not use vector because of construction and destruction will copy all objects inside once again. list will not do this.
+/**
+ * bytecode dispatch. by default (GCC/Clang) the interpreter uses computed goto (labels as values) and each handler jumps
+ * to the next handler directly, so the branch predictor can learn the bytecode pairs. compile with `-DSWITCH_DISPATCH`
+ * (cmake -DSWITCH_DISPATCH=ON) to use the portable `switch` loop instead.
+ */
+#if defined(__GNUC__) && !defined(SWITCH_DISPATCH)
+#define COMPUTED_GOTO_DISPATCH
+#endif
+
+#ifdef BYTECODE_DEBUG
+#define TRACE_BYTECODE()	sync_wcout{} << L"(DEBUG) [thread " << thread_no << "] <bytecode> $" << std::dec <<  (pc - code_begin) << " of "<< code_klass->get_name() << "::" << code_method->get_name() << ":" << code_method->get_descriptor() << " --> " << utf8_to_wstring(bccode_map[*pc].first) << std::endl
+#else
+#define TRACE_BYTECODE()
+#endif
+
+// the bytecode may be quickened by another thread at the same time: load it only once, and with acquire, so that
+// a fast bytecode always sees its resolved `rt_cache_entry` (see `rt_constant_pool::quicken`).
+#define LOAD_BYTECODE(pc)	__atomic_load_n(pc, __ATOMIC_ACQUIRE)
+
+#ifdef COMPUTED_GOTO_DISPATCH
+#define OPCODE(bc)		case bc: op_##bc
+#define NEXT_BYTECODE	do {															\
+							pc += occupied;											\
+							if (pc >= code_begin + code_length)	goto execute_end;	\
+							TRACE_BYTECODE();										\
+							bytecode = LOAD_BYTECODE(pc);							\
+							occupied = bccode_length[bytecode] + 1;					\
+							goto *dispatch_table[bytecode];							\
+						} while (0)
+#else
+#define OPCODE(bc)		case bc
+#define NEXT_BYTECODE	break
+#endif
+
+// load the interpreter's registers from `cur_frame`.
+#define LOAD_FRAME()	do {																	\
+							code_method = cur_frame->method;								\
+							code_length = code_method->get_code()->code_length;				\
+							op_stack = &cur_frame->op_stack;								\
+							localVariableTable = &cur_frame->localVariableTable;			\
+							code_begin = code_method->get_code()->code;						\
+							code_klass = code_method->get_klass();							\
+							rt_pool = code_klass->get_rtpool();								\
+						} while (0)
+
+// stop here while a safepoint is in progress: only a load of the thread's poll word if not. the frames are consistent between two bytecodes.
+#define SAFEPOINT_POLL()	do {																\
+							if (thread.safepoint_poll.is_armed()) {							\
+								Safepoint::block(&thread);									\
+							}																\
+						} while (0)
+
+// an allocation bytecode found the heap full, and has put the operand stack back as it was before it: collect the whole heap
+// at this safepoint and run the bytecode again. if it has failed after a gc already, throw the OutOfMemoryError instead.
+// not in a `do {} while (0)`: NEXT_BYTECODE may be a `break` out of the switch.
+#define ALLOCATION_FAILED()	if (!allocation_retried) {											\
+								allocation_retried = true;										\
+								GC::collect_for_allocation(&thread, MemAlloc::failed_size());	\
+								occupied = 0;													\
+								NEXT_BYTECODE;													\
+							} else {															\
+								allocation_retried = false;										\
+								throw_out_of_memory(*op_stack, thread);							\
+								goto exception_handler;											\
+							}
 
-	assert(&cur_frame == &thread.vm_stack.back());
-	Method *code_method = cur_frame.method;
-	uint32_t code_length = code_method->get_code()->code_length;
-	stack<Oop *> & op_stack = cur_frame.op_stack;
-	vector<Oop *> & localVariableTable = cur_frame.localVariableTable;
-	uint8_t *code_begin = code_method->get_code()->code;
-	InstanceKlass *code_klass = code_method->get_klass();
-	rt_constant_pool & rt_pool = *code_klass->get_rtpool();
+// switch to the pushed callee frame, and run its first bytecode.
+#define ENTER_FRAME(new_frame)	do {															\
+							cur_frame = (new_frame);										\
+							LOAD_FRAME();													\
+							SAFEPOINT_POLL();												\
+							cur_frame->backup_switch = sync_wcout::_switch();				\
+							if (DebugTool::is_open() && DebugTool::match(code_method->get_name(), code_method->get_descriptor(), code_klass->get_name())) {	\
+								sync_wcout::set_switch(true);								\
+							}																\
+							pc = code_begin;												\
+							occupied = 0;													\
+							JitCode *entry_code = Jit::on_invocation(code_method);			\
+							if (entry_code != nullptr) {									\
+								pc = code_begin + entry_code->run(cur_frame, 0, thread.safepoint_poll.address());	\
+								SAFEPOINT_POLL();											\
+							}																\
+						} while (0)
+
+// pop `cur_frame`, which was entered by ENTER_FRAME, and go back to the invoke bytecode of its caller.
+#define LEAVE_FRAME()	do {																	\
+							StackFrame *callee = cur_frame;									\
+							if (callee->monitor_obj != nullptr) {							\
+								thread.monitor_dec();										\
+								callee->monitor_obj->leave_monitor();						\
+							}																\
+							sync_wcout::set_switch(callee->backup_switch);					\
+							pc = callee->return_pc;											\
+							cur_frame = callee->prev;										\
+							thread.vm_stack.pop_frame();									\
+							LOAD_FRAME();													\
+							occupied = bccode_length[LOAD_BYTECODE(pc)] + 1;				\
+						} while (0)
+
+// go on after the invoke bytecode in the compiled code of the caller, if it has been compiled.
+#define RESUME_COMPILED()	do {																\
+							JitCode *resume_code = code_method->get_jit_code().load(std::memory_order_acquire);	\
+							if (resume_code != nullptr) {									\
+								pc += occupied;												\
+								occupied = 0;												\
+								pc = code_begin + resume_code->run(cur_frame, pc - code_begin, thread.safepoint_poll.address());	\
+								SAFEPOINT_POLL();											\
+							}																\
+						} while (0)
+
+// a taken backward branch to `pc + occupied`: poll, count it, and go on in the compiled code from the branch target (on-stack replacement) if the method is hot.
+#define BACKEDGE()	do {																		\
+							pc += occupied;													\
+							occupied = 0;													\
+							SAFEPOINT_POLL();												\
+							JitCode *osr_code = Jit::on_backedge(code_method);				\
+							if (osr_code != nullptr) {										\
+								pc = code_begin + osr_code->run(cur_frame, pc - code_begin, thread.safepoint_poll.address());	\
+								SAFEPOINT_POLL();											\
+							}																\
+						} while (0)
+
+Oop * BytecodeEngine::execute(vm_thread & thread, StackFrame & entry_frame, int thread_no) {		// do not use vector because of construction and destruction will copy all objects inside once again. list will not do this.
+
+	assert(&entry_frame == &thread.vm_stack.back());
+	// the interpreter's registers. java-to-java calls and returns switch them to another frame in this loop, without recursion.
+	StackFrame *cur_frame = &entry_frame;
+	Method *code_method;
+	uint32_t code_length;
+	OperandStack *op_stack;
+	LocalVariableTable *localVariableTable;
+	uint8_t *code_begin;
+	InstanceKlass *code_klass;
+	rt_constant_pool *rt_pool;
+	LOAD_FRAME();
 	uint8_t *backup_pc = thread.pc;
 	uint8_t * & pc = thread.pc;
 	pc = code_begin;
 
-	// self-destruction test
-//	init_lock.lock();
-//	static bool iii = false;
-//	if (!iii && ThreadTable::size() > 5) {
-//		iii = true;
-//	init_lock.unlock();
-//		kill(getpid(), SIGINT);
-//	} else {
-//	init_lock.unlock();
-//
-//	}
-
-	static bool inited = false;
-	init_lock.lock();
-	if (!inited && ThreadTable::size() >= 3) {	// delete
-//		sync_wcout{} << pthread_self() << " triggered gc!!" << std::endl;
-		inited = GC::init_gc();
-	}
-	init_lock.unlock();
-
-	if (thread.get_monitor_num() == 0) {		// set safe point and stop this thread.
-		GC::set_safepoint_here(&thread);
-	}
+	SAFEPOINT_POLL();
 
 	bool backup_switch = sync_wcout::_switch();
 
@@ -1039,791 +1476,895 @@ Oop * BytecodeEngine::execute(vm_thread & thread, StackFrame & cur_frame, int th
 		sync_wcout::set_switch(true);
 	}
 
+	JitCode *entry_code = Jit::on_invocation(code_method);
+	if (entry_code != nullptr) {
+		pc = code_begin + entry_code->run(cur_frame, 0, thread.safepoint_poll.address());
+		SAFEPOINT_POLL();
+	}
+
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "[Now, it's StackFrame #" << thread.vm_stack.size() - 1 << "]." << std::endl;
 #endif
 
-	while (pc < code_begin + code_length) {
-#ifdef BYTECODE_DEBUG
-		sync_wcout{} << L"(DEBUG) [thread " << thread_no << "] <bytecode> $" << std::dec <<  (pc - code_begin) << " of "<< code_klass->get_name() << "::" << code_method->get_name() << ":" << code_method->get_descriptor() << " --> " << utf8_to_wstring(bccode_map[*pc].first) << std::endl;
+	int occupied;
+	uint8_t bytecode;		// `*pc` when it was dispatched.
+	bool allocation_retried = false;		// see: ALLOCATION_FAILED.
+#ifdef COMPUTED_GOTO_DISPATCH
+	// threaded code: every handler jumps to the next handler directly through this table. the `switch` below is only used to enter the first bytecode.
+	static void * const dispatch_table[256] = {
+		&&op_0x00, &&op_0x01, &&op_0x02, &&op_0x03, &&op_0x04, &&op_0x05, &&op_0x06, &&op_0x07, &&op_0x08, &&op_0x09, &&op_0x0a, &&op_0x0b, &&op_0x0c, &&op_0x0d, &&op_0x0e, &&op_0x0f,
+		&&op_0x10, &&op_0x11, &&op_0x12, &&op_0x13, &&op_0x14, &&op_0x15, &&op_0x16, &&op_0x17, &&op_0x18, &&op_0x19, &&op_0x1a, &&op_0x1b, &&op_0x1c, &&op_0x1d, &&op_0x1e, &&op_0x1f,
+		&&op_0x20, &&op_0x21, &&op_0x22, &&op_0x23, &&op_0x24, &&op_0x25, &&op_0x26, &&op_0x27, &&op_0x28, &&op_0x29, &&op_0x2a, &&op_0x2b, &&op_0x2c, &&op_0x2d, &&op_0x2e, &&op_0x2f,
+		&&op_0x30, &&op_0x31, &&op_0x32, &&op_0x33, &&op_0x34, &&op_0x35, &&op_0x36, &&op_0x37, &&op_0x38, &&op_0x39, &&op_0x3a, &&op_0x3b, &&op_0x3c, &&op_0x3d, &&op_0x3e, &&op_0x3f,
+		&&op_0x40, &&op_0x41, &&op_0x42, &&op_0x43, &&op_0x44, &&op_0x45, &&op_0x46, &&op_0x47, &&op_0x48, &&op_0x49, &&op_0x4a, &&op_0x4b, &&op_0x4c, &&op_0x4d, &&op_0x4e, &&op_0x4f,
+		&&op_0x50, &&op_0x51, &&op_0x52, &&op_0x53, &&op_0x54, &&op_0x55, &&op_0x56, &&op_0x57, &&op_0x58, &&op_0x59, &&op_0x5a, &&op_0x5b, &&op_0x5c, &&op_0x5d, &&op_0x5e, &&op_0x5f,
+		&&op_0x60, &&op_0x61, &&op_0x62, &&op_0x63, &&op_0x64, &&op_0x65, &&op_default, &&op_0x67, &&op_0x68, &&op_0x69, &&op_0x6a, &&op_0x6b, &&op_0x6c, &&op_0x6d, &&op_0x6e, &&op_0x6f,
+		&&op_0x70, &&op_0x71, &&op_default, &&op_default, &&op_0x74, &&op_0x75, &&op_default, &&op_default, &&op_0x78, &&op_0x79, &&op_0x7a, &&op_0x7b, &&op_0x7c, &&op_0x7d, &&op_0x7e, &&op_0x7f,
+		&&op_0x80, &&op_0x81, &&op_0x82, &&op_0x83, &&op_0x84, &&op_0x85, &&op_0x86, &&op_0x87, &&op_0x88, &&op_0x89, &&op_default, &&op_0x8b, &&op_default, &&op_0x8d, &&op_0x8e, &&op_0x8f,
+		&&op_default, &&op_0x91, &&op_0x92, &&op_0x93, &&op_0x94, &&op_0x95, &&op_0x96, &&op_0x97, &&op_0x98, &&op_0x99, &&op_0x9a, &&op_0x9b, &&op_0x9c, &&op_0x9d, &&op_0x9e, &&op_0x9f,
+		&&op_0xa0, &&op_0xa1, &&op_0xa2, &&op_0xa3, &&op_0xa4, &&op_0xa5, &&op_0xa6, &&op_0xa7, &&op_default, &&op_default, &&op_0xaa, &&op_0xab, &&op_0xac, &&op_0xad, &&op_0xae, &&op_0xaf,
+		&&op_0xb0, &&op_0xb1, &&op_0xb2, &&op_0xb3, &&op_0xb4, &&op_0xb5, &&op_0xb6, &&op_0xb7, &&op_0xb8, &&op_0xb9, &&op_0xba, &&op_0xbb, &&op_0xbc, &&op_0xbd, &&op_0xbe, &&op_0xbf,
+		&&op_0xc0, &&op_0xc1, &&op_0xc2, &&op_0xc3, &&op_default, &&op_0xc5, &&op_0xc6, &&op_0xc7, &&op_default, &&op_default, &&op_default, &&op_0xcb, &&op_0xcc, &&op_0xcd, &&op_0xce, &&op_0xcf,
+		&&op_0xd0, &&op_0xd1, &&op_0xd2, &&op_0xd3, &&op_0xd4, &&op_0xd5, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+		&&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+	};
 #endif
-		int occupied = bccode_map[*pc].second + 1;
-		switch(*pc) {
-			case 0x00:{		// nop
+
+	while (pc < code_begin + code_length) {
+		TRACE_BYTECODE();
+		bytecode = LOAD_BYTECODE(pc);
+		occupied = bccode_length[bytecode] + 1;
+		switch(bytecode) {
+			OPCODE(0x00):{		// nop
 				// do nothing.
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x01:{		// aconst_null
-				op_stack.push(nullptr);
+			OPCODE(0x01):{		// aconst_null
+				op_stack->push(nullptr);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) push null on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x02:{		// iconst_m1
-				op_stack.push(new IntOop(-1));
+			OPCODE(0x02):{		// iconst_m1
+				op_stack->push_int(-1);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) push int -1 on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x03:{		// iconst_0
-				op_stack.push(new IntOop(0));
+			OPCODE(0x03):{		// iconst_0
+				op_stack->push_int(0);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) push int 0 on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x04:{		// iconst_1
-				op_stack.push(new IntOop(1));
+			OPCODE(0x04):{		// iconst_1
+				op_stack->push_int(1);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) push int 1 on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x05:{		// iconst_2
-				op_stack.push(new IntOop(2));
+			OPCODE(0x05):{		// iconst_2
+				op_stack->push_int(2);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) push int 2 on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x06:{		// iconst_3
-				op_stack.push(new IntOop(3));
+			OPCODE(0x06):{		// iconst_3
+				op_stack->push_int(3);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) push int 3 on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x07:{		// iconst_4
-				op_stack.push(new IntOop(4));
+			OPCODE(0x07):{		// iconst_4
+				op_stack->push_int(4);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) push int 4 on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x08:{		// iconst_5
-				op_stack.push(new IntOop(5));
+			OPCODE(0x08):{		// iconst_5
+				op_stack->push_int(5);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) push int 5 on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x09:{		// lconst_0
-				op_stack.push(new LongOop(0));
+			OPCODE(0x09):{		// lconst_0
+				op_stack->push_long(0);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) push long 0 on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x0a:{		// lconst_1
-				op_stack.push(new LongOop(1));
+			OPCODE(0x0a):{		// lconst_1
+				op_stack->push_long(1);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) push long 1 on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x0b:{		// fconst_0
-				op_stack.push(new FloatOop((float)0));
+			OPCODE(0x0b):{		// fconst_0
+				op_stack->push_float((float)0);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) push float 0.0f on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x0c:{		// fconst_1
-				op_stack.push(new FloatOop((float)1));
+			OPCODE(0x0c):{		// fconst_1
+				op_stack->push_float((float)1);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) push float 1.0f on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x0d:{		// fconst_2
-				op_stack.push(new FloatOop((float)2));
+			OPCODE(0x0d):{		// fconst_2
+				op_stack->push_float((float)2);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) push float 2.0f on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x0e:{		// dconst_1
-				op_stack.push(new DoubleOop((double)1));
+			OPCODE(0x0e):{		// dconst_0
+				op_stack->push_double((double)0);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push double 1.0ld on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push double 0.0ld on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x0f:{		// dconst_2
-				op_stack.push(new DoubleOop((double)2));
+			OPCODE(0x0f):{		// dconst_1
+				op_stack->push_double((double)1);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push double 2.0ld on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push double 1.0ld on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x10: {		// bipush
-				op_stack.push(new IntOop((int8_t)pc[1]));
+			OPCODE(0x10): {		// bipush
+				op_stack->push_int((int8_t)pc[1]);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push byte " << ((IntOop *)op_stack.top())->value << " on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push byte " << op_stack->top_int() << " on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x11:{		// sipush
+			OPCODE(0x11):{		// sipush
 				short val = ((pc[1] << 8) | pc[2]);
-				op_stack.push(new IntOop(val));
+				op_stack->push_int(val);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push short " << ((IntOop *)op_stack.top())->value << " on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push short " << op_stack->top_int() << " on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x12:		// ldc
-			case 0x13:{		// ldc_w
+			OPCODE(0x12):		// ldc
+			OPCODE(0x13):{		// ldc_w
 				int rtpool_index;
-				if (*pc == 0x12) {
+				if (bytecode == 0x12) {
 					rtpool_index = pc[1];
 				} else {
 					rtpool_index = ((pc[1] << 8) | pc[2]);
 				}
-				if (rt_pool[rtpool_index-1].first == CONSTANT_Integer) {
-					int value = boost::any_cast<int>(rt_pool[rtpool_index-1].second);
-					op_stack.push(new IntOop(value));
+				rt_cache_entry entry;
+				entry.tag = (*rt_pool)[rtpool_index-1].first;
+				if (entry.tag == CONSTANT_Integer) {
+					entry.i = boost::any_cast<int>((*rt_pool)[rtpool_index-1].second);
+					op_stack->push_int(entry.i);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push int: "<< value << " on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push int: "<< entry.i << " on stack." << std::endl;
 #endif
-				} else if (rt_pool[rtpool_index-1].first == CONSTANT_Float) {
-					float value = boost::any_cast<float>(rt_pool[rtpool_index-1].second);
-					op_stack.push(new FloatOop(value));
+				} else if (entry.tag == CONSTANT_Float) {
+					entry.f = boost::any_cast<float>((*rt_pool)[rtpool_index-1].second);
+					op_stack->push_float(entry.f);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push float: "<< ((FloatOop *)op_stack.top())->value << "f on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push float: "<< op_stack->top_float() << "f on stack." << std::endl;
 #endif
-				} else if (rt_pool[rtpool_index-1].first == CONSTANT_String) {
-					InstanceOop *stringoop = (InstanceOop *)boost::any_cast<Oop *>(rt_pool[rtpool_index-1].second);
-					op_stack.push(stringoop);
+				} else if (entry.tag == CONSTANT_String) {
+					entry.oop = boost::any_cast<Oop *>((*rt_pool)[rtpool_index-1].second);
+					op_stack->push(entry.oop);
 #ifdef BYTECODE_DEBUG
 	// for string:
-	sync_wcout{} << java_lang_string::print_stringOop(stringoop) << std::endl;
+	sync_wcout{} << java_lang_string::print_stringOop((InstanceOop *)entry.oop) << std::endl;
 #endif
-				} else if (rt_pool[rtpool_index-1].first == CONSTANT_Class) {
-					auto klass = boost::any_cast<Klass *>(rt_pool[rtpool_index-1].second);
-					assert(klass->get_mirror() != nullptr);
-					op_stack.push(klass->get_mirror());		// push into [Oop*] type.
+				} else if (entry.tag == CONSTANT_Class) {
+					entry.klass = boost::any_cast<Klass *>((*rt_pool)[rtpool_index-1].second);
+					assert(entry.klass->get_mirror() != nullptr);
+					op_stack->push(entry.klass->get_mirror());		// push into [Oop*] type.
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push class: "<< klass->get_name() << "'s mirror "<< "on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push class: "<< entry.klass->get_name() << "'s mirror "<< "on stack." << std::endl;
 #endif
 				} else {
 					// TODO: Constant_MethodHandle and Constant_MethodType
 					std::cerr << "doesn't support Constant_MethodHandle and Constant_MethodType now..." << std::endl;
 					assert(false);
 				}
-				break;
+				rt_pool->quicken(pc, (bytecode == 0x12) ? FAST_LDC : FAST_LDC_W, rtpool_index-1, entry);
+				NEXT_BYTECODE;
 			}
-			case 0x14:{		// ldc2_w
+			OPCODE(0xcb):		// fast_ldc
+			OPCODE(0xcc):{		// fast_ldc_w
+				int rtpool_index;
+				if (bytecode == FAST_LDC) {
+					rtpool_index = pc[1];
+				} else {
+					rtpool_index = ((pc[1] << 8) | pc[2]);
+				}
+				const rt_cache_entry & entry = rt_pool->cache_at(rtpool_index-1);
+				switch (entry.tag) {
+					case CONSTANT_Integer:
+						op_stack->push_int(entry.i);
+						break;
+					case CONSTANT_Float:
+						op_stack->push_float(entry.f);
+						break;
+					case CONSTANT_String:
+						op_stack->push(entry.oop);
+						break;
+					case CONSTANT_Class:
+						op_stack->push(entry.klass->get_mirror());		// the mirror may be moved by gc. so don't cache it.
+						break;
+					default:
+						assert(false);
+				}
+#ifdef BYTECODE_DEBUG
+	sync_wcout{} << "(DEBUG) [fast] push constant pool #" << rtpool_index << " on stack." << std::endl;
+#endif
+				NEXT_BYTECODE;
+			}
+			OPCODE(0x14):{		// ldc2_w
 				int rtpool_index = ((pc[1] << 8) | pc[2]);
-				if (rt_pool[rtpool_index-1].first == CONSTANT_Double) {
-					double value = boost::any_cast<double>(rt_pool[rtpool_index-1].second);
-					op_stack.push(new DoubleOop(value));
+				rt_cache_entry entry;
+				entry.tag = (*rt_pool)[rtpool_index-1].first;
+				if (entry.tag == CONSTANT_Double) {
+					entry.d = boost::any_cast<double>((*rt_pool)[rtpool_index-1].second);
+					op_stack->push_double(entry.d);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push double: "<< value << "ld on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push double: "<< entry.d << "ld on stack." << std::endl;
 #endif
-				} else if (rt_pool[rtpool_index-1].first == CONSTANT_Long) {
-					long value = boost::any_cast<long>(rt_pool[rtpool_index-1].second);
-					op_stack.push(new LongOop(value));
+				} else if (entry.tag == CONSTANT_Long) {
+					entry.l = boost::any_cast<long>((*rt_pool)[rtpool_index-1].second);
+					op_stack->push_long(entry.l);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push long: "<< value << "l on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push long: "<< entry.l << "l on stack." << std::endl;
 #endif
 				} else {
 					assert(false);
 				}
-				break;
+				rt_pool->quicken(pc, FAST_LDC2_W, rtpool_index-1, entry);
+				NEXT_BYTECODE;
+			}
+			OPCODE(0xcd):{		// fast_ldc2_w
+				int rtpool_index = ((pc[1] << 8) | pc[2]);
+				const rt_cache_entry & entry = rt_pool->cache_at(rtpool_index-1);
+				if (entry.tag == CONSTANT_Double) {
+					op_stack->push_double(entry.d);
+				} else {
+					assert(entry.tag == CONSTANT_Long);
+					op_stack->push_long(entry.l);
+				}
+#ifdef BYTECODE_DEBUG
+	sync_wcout{} << "(DEBUG) [fast] push constant pool #" << rtpool_index << " on stack." << std::endl;
+#endif
+				NEXT_BYTECODE;
 			}
-			case 0x15:{		// iload
+			OPCODE(0x15):{		// iload
 				int index = pc[1];
-				assert(localVariableTable.size() > index && index > 3);
-				assert(localVariableTable[index]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[index])->get_type() == Type::INT);
-				op_stack.push(new IntOop(((IntOop *)localVariableTable[index])->value));
+				assert(localVariableTable->size() > index && index > 3);
+				op_stack->push_int(localVariableTable->get_int(index));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push localVariableTable[" << index << "] int: "<< ((IntOop *)op_stack.top())->value << " on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push localVariableTable[" << index << "] int: "<< op_stack->top_int() << " on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x16:{		// lload
+			OPCODE(0x16):{		// lload
 				int index = pc[1];
-				assert(localVariableTable.size() > index && index > 3);
-				assert(localVariableTable[index]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[index])->get_type() == Type::LONG);
-				op_stack.push(new LongOop(((LongOop *)localVariableTable[index])->value));
+				assert(localVariableTable->size() > index && index > 3);
+				op_stack->push_long(localVariableTable->get_long(index));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push localVariableTable[" << index << "] long: "<< ((LongOop *)op_stack.top())->value << " on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push localVariableTable[" << index << "] long: "<< op_stack->top_long() << " on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x17:{		// fload
+			OPCODE(0x17):{		// fload
 				int index = pc[1];
-				assert(localVariableTable.size() > index && index > 3);
-				assert(localVariableTable[index]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[index])->get_type() == Type::FLOAT);
-				op_stack.push(new FloatOop(((FloatOop *)localVariableTable[index])->value));
+				assert(localVariableTable->size() > index && index > 3);
+				op_stack->push_float(localVariableTable->get_float(index));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push localVariableTable[" << index << "] float: "<< ((FloatOop *)op_stack.top())->value << " on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push localVariableTable[" << index << "] float: "<< op_stack->top_float() << " on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x18:{		// dload
+			OPCODE(0x18):{		// dload
 				int index = pc[1];
-				assert(localVariableTable.size() > index && index > 3);
-				assert(localVariableTable[index]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[index])->get_type() == Type::DOUBLE);
-				op_stack.push(new DoubleOop(((DoubleOop *)localVariableTable[index])->value));
+				assert(localVariableTable->size() > index && index > 3);
+				op_stack->push_double(localVariableTable->get_double(index));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push localVariableTable[" << index << "] double: "<< ((DoubleOop *)op_stack.top())->value << " on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push localVariableTable[" << index << "] double: "<< op_stack->top_double() << " on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x19:{		// aload
+			OPCODE(0x19):{		// aload
 				int index = pc[1];
-				assert(localVariableTable.size() > index && index > 3);
-				if (localVariableTable[index] != nullptr)	assert(localVariableTable[index]->get_ooptype() != OopType::_BasicTypeOop);
-				op_stack.push(localVariableTable[index]);
+				assert(localVariableTable->size() > index && index > 3);
+				op_stack->push(localVariableTable->get_ref(index));
 #ifdef BYTECODE_DEBUG
-	if (localVariableTable[index] != nullptr)
-		sync_wcout{} << "(DEBUG) push localVariableTable[" << index << "] ref: "<< (localVariableTable[index])->get_klass()->get_name() << "'s Oop: address: " << std::hex << localVariableTable[index] << " on stack." << std::endl;
+	if (localVariableTable->get_ref(index) != nullptr)
+		sync_wcout{} << "(DEBUG) push localVariableTable[" << index << "] ref: "<< (localVariableTable->get_ref(index))->get_klass()->get_name() << "'s Oop: address: " << std::hex << localVariableTable->get_ref(index) << " on stack." << std::endl;
 	else
 		sync_wcout{} << "(DEBUG) push <null> ref from localVariableTable[" << index << "], to stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x1a:{		// iload_0
-				assert(localVariableTable[0]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[0])->get_type() == Type::INT);
-				op_stack.push(new IntOop(((IntOop *)localVariableTable[0])->value));
+			OPCODE(0x1a):{		// iload_0
+				op_stack->push_int(localVariableTable->get_int(0));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push localVariableTable[0] int: "<< ((IntOop *)op_stack.top())->value << " on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push localVariableTable[0] int: "<< op_stack->top_int() << " on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x1b:{		// iload_1
-				assert(localVariableTable[1]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[1])->get_type() == Type::INT);
-				op_stack.push(new IntOop(((IntOop *)localVariableTable[1])->value));
+			OPCODE(0x1b):{		// iload_1
+				op_stack->push_int(localVariableTable->get_int(1));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push localVariableTable[1] int: "<< ((IntOop *)op_stack.top())->value << " on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push localVariableTable[1] int: "<< op_stack->top_int() << " on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x1c:{		// iload_2
-				assert(localVariableTable[2]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[2])->get_type() == Type::INT);
-				op_stack.push(new IntOop(((IntOop *)localVariableTable[2])->value));
+			OPCODE(0x1c):{		// iload_2
+				op_stack->push_int(localVariableTable->get_int(2));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push localVariableTable[2] int: "<< ((IntOop *)op_stack.top())->value << " on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push localVariableTable[2] int: "<< op_stack->top_int() << " on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x1d:{		// iload_3
-				assert(localVariableTable[3]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[3])->get_type() == Type::INT);
-				op_stack.push(new IntOop(((IntOop *)localVariableTable[3])->value));
+			OPCODE(0x1d):{		// iload_3
+				op_stack->push_int(localVariableTable->get_int(3));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push localVariableTable[3] int: "<< ((IntOop *)op_stack.top())->value << " on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push localVariableTable[3] int: "<< op_stack->top_int() << " on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x1e:{		// lload_0
-				assert(localVariableTable[0]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[0])->get_type() == Type::LONG);
-				op_stack.push(new LongOop(((LongOop *)localVariableTable[0])->value));
+			OPCODE(0x1e):{		// lload_0
+				op_stack->push_long(localVariableTable->get_long(0));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push localVariableTable[0] long: "<< ((LongOop *)op_stack.top())->value << "l on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push localVariableTable[0] long: "<< op_stack->top_long() << "l on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x1f:{		// lload_1
-				assert(localVariableTable[1]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[1])->get_type() == Type::LONG);
-				op_stack.push(new LongOop(((LongOop *)localVariableTable[1])->value));
+			OPCODE(0x1f):{		// lload_1
+				op_stack->push_long(localVariableTable->get_long(1));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push localVariableTable[1] long: "<< ((LongOop *)op_stack.top())->value << "l on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push localVariableTable[1] long: "<< op_stack->top_long() << "l on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x20:{		// lload_2
-				assert(localVariableTable[2]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[2])->get_type() == Type::LONG);
-				op_stack.push(new LongOop(((LongOop *)localVariableTable[2])->value));
+			OPCODE(0x20):{		// lload_2
+				op_stack->push_long(localVariableTable->get_long(2));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push localVariableTable[2] long: "<< ((LongOop *)op_stack.top())->value << "l on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push localVariableTable[2] long: "<< op_stack->top_long() << "l on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x21:{		// lload_3
-				assert(localVariableTable[3]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[3])->get_type() == Type::LONG);
-				op_stack.push(new LongOop(((LongOop *)localVariableTable[3])->value));
+			OPCODE(0x21):{		// lload_3
+				op_stack->push_long(localVariableTable->get_long(3));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push localVariableTable[3] long: "<< ((LongOop *)op_stack.top())->value << "l on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push localVariableTable[3] long: "<< op_stack->top_long() << "l on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x22:{		// fload_0
-				assert(localVariableTable[0]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[0])->get_type() == Type::FLOAT);
-				op_stack.push(new FloatOop(((FloatOop *)localVariableTable[0])->value));
+			OPCODE(0x22):{		// fload_0
+				op_stack->push_float(localVariableTable->get_float(0));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push localVariableTable[0] float: "<< ((FloatOop *)op_stack.top())->value << "f on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push localVariableTable[0] float: "<< op_stack->top_float() << "f on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x23:{		// fload_1
-				assert(localVariableTable[1]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[1])->get_type() == Type::FLOAT);
-				op_stack.push(new FloatOop(((FloatOop *)localVariableTable[1])->value));
+			OPCODE(0x23):{		// fload_1
+				op_stack->push_float(localVariableTable->get_float(1));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push localVariableTable[1] float: "<< ((FloatOop *)op_stack.top())->value << "f on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push localVariableTable[1] float: "<< op_stack->top_float() << "f on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x24:{		// fload_2
-				assert(localVariableTable[2]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[2])->get_type() == Type::FLOAT);
-				op_stack.push(new FloatOop(((FloatOop *)localVariableTable[2])->value));
+			OPCODE(0x24):{		// fload_2
+				op_stack->push_float(localVariableTable->get_float(2));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push localVariableTable[2] float: "<< ((FloatOop *)op_stack.top())->value << "f on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push localVariableTable[2] float: "<< op_stack->top_float() << "f on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x25:{		// fload_3
-				assert(localVariableTable[3]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[3])->get_type() == Type::FLOAT);
-				op_stack.push(new FloatOop(((FloatOop *)localVariableTable[3])->value));
+			OPCODE(0x25):{		// fload_3
+				op_stack->push_float(localVariableTable->get_float(3));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push localVariableTable[3] float: "<< ((FloatOop *)op_stack.top())->value << "f on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push localVariableTable[3] float: "<< op_stack->top_float() << "f on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x26:{		// dload_0
-				assert(localVariableTable[0]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[0])->get_type() == Type::DOUBLE);
-				op_stack.push(new DoubleOop(((DoubleOop *)localVariableTable[0])->value));
+			OPCODE(0x26):{		// dload_0
+				op_stack->push_double(localVariableTable->get_double(0));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push localVariableTable[0] double: "<< ((DoubleOop *)op_stack.top())->value << "ld on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push localVariableTable[0] double: "<< op_stack->top_double() << "ld on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x27:{		// dload_1
-				assert(localVariableTable[1]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[1])->get_type() == Type::DOUBLE);
-				op_stack.push(new DoubleOop(((DoubleOop *)localVariableTable[1])->value));
+			OPCODE(0x27):{		// dload_1
+				op_stack->push_double(localVariableTable->get_double(1));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push localVariableTable[1] double: "<< ((DoubleOop *)op_stack.top())->value << "ld on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push localVariableTable[1] double: "<< op_stack->top_double() << "ld on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x28:{		// dload_2
-				assert(localVariableTable[2]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[2])->get_type() == Type::DOUBLE);
-				op_stack.push(new DoubleOop(((DoubleOop *)localVariableTable[2])->value));
+			OPCODE(0x28):{		// dload_2
+				op_stack->push_double(localVariableTable->get_double(2));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push localVariableTable[2] double: "<< ((DoubleOop *)op_stack.top())->value << "ld on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push localVariableTable[2] double: "<< op_stack->top_double() << "ld on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x29:{		// dload_3
-				assert(localVariableTable[3]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[3])->get_type() == Type::DOUBLE);
-				op_stack.push(new DoubleOop(((DoubleOop *)localVariableTable[3])->value));
+			OPCODE(0x29):{		// dload_3
+				op_stack->push_double(localVariableTable->get_double(3));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) push localVariableTable[3] double: "<< ((DoubleOop *)op_stack.top())->value << "ld on stack." << std::endl;
+	sync_wcout{} << "(DEBUG) push localVariableTable[3] double: "<< op_stack->top_double() << "ld on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
 
 
 
-			case 0x2a:{		// aload_0
-				if (localVariableTable[0] != nullptr)	assert(localVariableTable[0]->get_ooptype() != OopType::_BasicTypeOop);
-				op_stack.push(localVariableTable[0]);
+			OPCODE(0x2a):{		// aload_0
+				op_stack->push(localVariableTable->get_ref(0));
 #ifdef BYTECODE_DEBUG
-	if (localVariableTable[0] != nullptr)
-		sync_wcout{} << "(DEBUG) push localVariableTable[0] ref: "<< (localVariableTable[0])->get_klass()->get_name() << "'s Oop: address: " << std::hex << localVariableTable[0] << " on stack." << std::endl;
+	if (localVariableTable->get_ref(0) != nullptr)
+		sync_wcout{} << "(DEBUG) push localVariableTable[0] ref: "<< (localVariableTable->get_ref(0))->get_klass()->get_name() << "'s Oop: address: " << std::hex << localVariableTable->get_ref(0) << " on stack." << std::endl;
 	else
 		sync_wcout{} << "(DEBUG) push <null> ref from localVariableTable[0], to stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x2b:{		// aload_1
-				if (localVariableTable[1] != nullptr)	assert(localVariableTable[1]->get_ooptype() != OopType::_BasicTypeOop);
-				op_stack.push(localVariableTable[1]);
+			OPCODE(0x2b):{		// aload_1
+				op_stack->push(localVariableTable->get_ref(1));
 #ifdef BYTECODE_DEBUG
-	if (localVariableTable[1] != nullptr)
-		sync_wcout{} << "(DEBUG) push localVariableTable[1] ref: "<< (localVariableTable[1])->get_klass()->get_name() << "'s Oop: address: " << std::hex << localVariableTable[1] << " on stack." << std::endl;
+	if (localVariableTable->get_ref(1) != nullptr)
+		sync_wcout{} << "(DEBUG) push localVariableTable[1] ref: "<< (localVariableTable->get_ref(1))->get_klass()->get_name() << "'s Oop: address: " << std::hex << localVariableTable->get_ref(1) << " on stack." << std::endl;
 	else
 		sync_wcout{} << "(DEBUG) push <null> ref from localVariableTable[1], to stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x2c:{		// aload_2
-				if (localVariableTable[2] != nullptr)	assert(localVariableTable[2]->get_ooptype() != OopType::_BasicTypeOop);
-				op_stack.push(localVariableTable[2]);
+			OPCODE(0x2c):{		// aload_2
+				op_stack->push(localVariableTable->get_ref(2));
 #ifdef BYTECODE_DEBUG
-	if (localVariableTable[2] != nullptr)
-		sync_wcout{} << "(DEBUG) push localVariableTable[2] ref: "<< (localVariableTable[2])->get_klass()->get_name() << "'s Oop: address: " << std::hex << localVariableTable[2] << " on stack." << std::endl;
+	if (localVariableTable->get_ref(2) != nullptr)
+		sync_wcout{} << "(DEBUG) push localVariableTable[2] ref: "<< (localVariableTable->get_ref(2))->get_klass()->get_name() << "'s Oop: address: " << std::hex << localVariableTable->get_ref(2) << " on stack." << std::endl;
 	else
 		sync_wcout{} << "(DEBUG) push <null> ref from localVariableTable[2], to stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x2d:{		// aload_3
-				if (localVariableTable[3] != nullptr)	assert(localVariableTable[3]->get_ooptype() != OopType::_BasicTypeOop);
-				op_stack.push(localVariableTable[3]);
+			OPCODE(0x2d):{		// aload_3
+				op_stack->push(localVariableTable->get_ref(3));
 #ifdef BYTECODE_DEBUG
-	if (localVariableTable[3] != nullptr)
-		sync_wcout{} << "(DEBUG) push localVariableTable[3] ref: "<< (localVariableTable[3])->get_klass()->get_name() << "'s Oop: address: " << std::hex << localVariableTable[3] << " on stack." << std::endl;
+	if (localVariableTable->get_ref(3) != nullptr)
+		sync_wcout{} << "(DEBUG) push localVariableTable[3] ref: "<< (localVariableTable->get_ref(3))->get_klass()->get_name() << "'s Oop: address: " << std::hex << localVariableTable->get_ref(3) << " on stack." << std::endl;
 	else
 		sync_wcout{} << "(DEBUG) push <null> ref from localVariableTable[3], to stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x2e:{		// iaload
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int index = ((IntOop *)op_stack.top())->value;	op_stack.pop();
-				if (op_stack.top() == nullptr) {
+			OPCODE(0x2e):{		// iaload
+				int index = op_stack->pop_int();
+				if (op_stack->top() == nullptr) {
 					// TODO: should throw NullpointerException
 					assert(false);
 				}
-				assert(op_stack.top()->get_ooptype() == OopType::_TypeArrayOop && op_stack.top()->get_klass()->get_name() == L"[I");		// assert int[] array
-				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack.top();	op_stack.pop();
+				assert(op_stack->top()->get_ooptype() == OopType::_TypeArrayOop && op_stack->top()->get_klass()->get_name() == L"[I");		// assert int[] array
+				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack->top();	op_stack->pop();
 				assert(charsequence->get_length() > index && index >= 0);	// TODO: should throw ArrayIndexOutofBoundException
-				op_stack.push(new IntOop(((IntOop *)((*charsequence)[index]))->value));
+				op_stack->push_int(charsequence->elem_at<int>(index));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) get int[" << index << "] which is the int: [" << ((IntOop *)op_stack.top())->value << "]" << std::endl;
+	sync_wcout{} << "(DEBUG) get int[" << index << "] which is the int: [" << op_stack->top_int() << "]" << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x2f:{		// laload
-				int index = ((IntOop *)op_stack.top())->value;	op_stack.pop();
-				if (op_stack.top() == nullptr) {
+			OPCODE(0x2f):{		// laload
+				int index = op_stack->pop_int();
+				if (op_stack->top() == nullptr) {
 					// TODO: should throw NullpointerException
 					assert(false);
 				}
-				assert(op_stack.top()->get_ooptype() == OopType::_TypeArrayOop && op_stack.top()->get_klass()->get_name() == L"[J");		// assert long[] array
-				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack.top();	op_stack.pop();
+				assert(op_stack->top()->get_ooptype() == OopType::_TypeArrayOop && op_stack->top()->get_klass()->get_name() == L"[J");		// assert long[] array
+				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack->top();	op_stack->pop();
 				assert(charsequence->get_length() > index && index >= 0);	// TODO: should throw ArrayIndexOutofBoundException
-				op_stack.push(new LongOop(((LongOop *)((*charsequence)[index]))->value));
+				op_stack->push_long(charsequence->elem_at<long>(index));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) get long[" << index << "] which is the long: [" << ((LongOop *)op_stack.top())->value << "]." << std::endl;
+	sync_wcout{} << "(DEBUG) get long[" << index << "] which is the long: [" << op_stack->top_long() << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-
-
-
-			case 0x32:{		// aaload
-				int index = ((IntOop *)op_stack.top())->value;	op_stack.pop();
-				if (op_stack.top() == nullptr) {
+			OPCODE(0x30):{		// faload
+				int index = op_stack->pop_int();
+				if (op_stack->top() == nullptr) {
 					// TODO: should throw NullpointerException
 					assert(false);
 				}
-				assert((op_stack.top()->get_ooptype() == OopType::_TypeArrayOop && ((TypeArrayOop *)op_stack.top())->get_dimension() >= 2)
-					   || op_stack.top()->get_ooptype() == OopType::_ObjArrayOop);
-				ObjArrayOop * objarray = (ObjArrayOop *)op_stack.top();	op_stack.pop();
+				assert(op_stack->top()->get_ooptype() == OopType::_TypeArrayOop && op_stack->top()->get_klass()->get_name() == L"[F");		// assert float[] array
+				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack->top();	op_stack->pop();
+				assert(charsequence->get_length() > index && index >= 0);	// TODO: should throw ArrayIndexOutofBoundException
+				op_stack->push_float(charsequence->elem_at<float>(index));
+#ifdef BYTECODE_DEBUG
+	sync_wcout{} << "(DEBUG) get float[" << index << "] which is the float: [" << op_stack->top_float() << "]." << std::endl;
+#endif
+				NEXT_BYTECODE;
+			}
+			OPCODE(0x31):{		// daload
+				int index = op_stack->pop_int();
+				if (op_stack->top() == nullptr) {
+					// TODO: should throw NullpointerException
+					assert(false);
+				}
+				assert(op_stack->top()->get_ooptype() == OopType::_TypeArrayOop && op_stack->top()->get_klass()->get_name() == L"[D");		// assert double[] array
+				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack->top();	op_stack->pop();
+				assert(charsequence->get_length() > index && index >= 0);	// TODO: should throw ArrayIndexOutofBoundException
+				op_stack->push_double(charsequence->elem_at<double>(index));
+#ifdef BYTECODE_DEBUG
+	sync_wcout{} << "(DEBUG) get double[" << index << "] which is the double: [" << op_stack->top_double() << "]." << std::endl;
+#endif
+				NEXT_BYTECODE;
+			}
+			OPCODE(0x32):{		// aaload
+				int index = op_stack->pop_int();
+				if (op_stack->top() == nullptr) {
+					// TODO: should throw NullpointerException
+					assert(false);
+				}
+				assert((op_stack->top()->get_ooptype() == OopType::_TypeArrayOop && ((TypeArrayOop *)op_stack->top())->get_dimension() >= 2)
+					   || op_stack->top()->get_ooptype() == OopType::_ObjArrayOop);
+				ObjArrayOop * objarray = (ObjArrayOop *)op_stack->top();	op_stack->pop();
 				assert(objarray->get_length() > index && index >= 0);	// TODO: should throw ArrayIndexOutofBoundException
-				op_stack.push((*objarray)[index]);
+				op_stack->push((*objarray)[index]);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) get ObjArray[" << index << "] which type is <class>" << ((ObjArrayKlass *)objarray->get_klass())->get_element_klass()->get_name()
-			   << ", and the element address is "<< op_stack.top() << "." << std::endl;
+			   << ", and the element address is "<< op_stack->top() << "." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x33:{		// baload
-				int index = ((IntOop *)op_stack.top())->value;	op_stack.pop();
-				if (op_stack.top() == nullptr) {
+			OPCODE(0x33):{		// baload
+				int index = op_stack->pop_int();
+				if (op_stack->top() == nullptr) {
 					// TODO: should throw NullpointerException
 					assert(false);
 				}
-				assert(op_stack.top()->get_ooptype() == OopType::_TypeArrayOop && (op_stack.top()->get_klass()->get_name() == L"[B" || op_stack.top()->get_klass()->get_name() == L"[Z"));		// assert byte[]/boolean[] array
-				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack.top();	op_stack.pop();
+				assert(op_stack->top()->get_ooptype() == OopType::_TypeArrayOop && (op_stack->top()->get_klass()->get_name() == L"[B" || op_stack->top()->get_klass()->get_name() == L"[Z"));		// assert byte[]/boolean[] array
+				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack->top();	op_stack->pop();
 				assert(charsequence->get_length() > index && index >= 0);	// TODO: should throw ArrayIndexOutofBoundException
-				op_stack.push(new IntOop((int8_t)((IntOop *)((*charsequence)[index]))->value));
+				op_stack->push_int(charsequence->elem_at<int8_t>(index));		// boolean[] is 1 byte per element, too.
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) get byte/boolean[" << index << "] which is the byte/boolean: [" << ((IntOop *)op_stack.top())->value << "]" << std::endl;
+	sync_wcout{} << "(DEBUG) get byte/boolean[" << index << "] which is the byte/boolean: [" << op_stack->top_int() << "]" << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x34:{		// caload
-				int index = ((IntOop *)op_stack.top())->value;	op_stack.pop();
-				if (op_stack.top() == nullptr) {
+			OPCODE(0x34):{		// caload
+				int index = op_stack->pop_int();
+				if (op_stack->top() == nullptr) {
 					// TODO: should throw NullpointerException
 					assert(false);
 				}
-				assert(op_stack.top()->get_ooptype() == OopType::_TypeArrayOop && op_stack.top()->get_klass()->get_name() == L"[C");		// assert char[] array
-				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack.top();	op_stack.pop();
+				assert(op_stack->top()->get_ooptype() == OopType::_TypeArrayOop && op_stack->top()->get_klass()->get_name() == L"[C");		// assert char[] array
+				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack->top();	op_stack->pop();
 #ifdef BYTECODE_DEBUG
 				sync_wcout{} << charsequence->get_length() << " " << index << std::endl;		// delete
 #endif
 				assert(charsequence->get_length() > index && index >= 0);	// TODO: should throw ArrayIndexOutofBoundException
-				op_stack.push(new IntOop(((IntOop *)((*charsequence)[index]))->value));
+				op_stack->push_int(charsequence->elem_at<uint16_t>(index));
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) get char[" << index << "] which is the wchar_t: [" << (wchar_t)((IntOop *)op_stack.top())->value << "]" << std::endl;
+	sync_wcout{} << "(DEBUG) get char[" << index << "] which is the wchar_t: [" << (wchar_t)op_stack->top_int() << "]" << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
+			}
+			OPCODE(0x35):{		// saload
+				int index = op_stack->pop_int();
+				if (op_stack->top() == nullptr) {
+					// TODO: should throw NullpointerException
+					assert(false);
+				}
+				assert(op_stack->top()->get_ooptype() == OopType::_TypeArrayOop && op_stack->top()->get_klass()->get_name() == L"[S");		// assert short[] array
+				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack->top();	op_stack->pop();
+				assert(charsequence->get_length() > index && index >= 0);	// TODO: should throw ArrayIndexOutofBoundException
+				op_stack->push_int(charsequence->elem_at<int16_t>(index));
+#ifdef BYTECODE_DEBUG
+	sync_wcout{} << "(DEBUG) get short[" << index << "] which is the short: [" << op_stack->top_int() << "]." << std::endl;
+#endif
+				NEXT_BYTECODE;
 			}
 
-			case 0x36:{		// istore
+			OPCODE(0x36):{		// istore
 				int index = pc[1];
 				assert(index > 3);
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				IntOop *ref = (IntOop *)op_stack.top();
-				localVariableTable[index] = new IntOop(ref->value);	op_stack.pop();
+				int value = op_stack->pop_int();
+				localVariableTable->set_int(index, value);
 #ifdef BYTECODE_DEBUG
-		sync_wcout{} << "(DEBUG) pop int [" << ref->value << "] from stack, to localVariableTable[" << index << "]." << std::endl;
+		sync_wcout{} << "(DEBUG) pop int [" << value << "] from stack, to localVariableTable[" << index << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x37:{		// lstore
+			OPCODE(0x37):{		// lstore
 				int index = pc[1];
 				assert(index > 3);
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				LongOop *ref = (LongOop *)op_stack.top();
-				localVariableTable[index] = new LongOop(ref->value);	op_stack.pop();
+				long value = op_stack->pop_long();
+				localVariableTable->set_long(index, value);
 #ifdef BYTECODE_DEBUG
-		sync_wcout{} << "(DEBUG) pop long [" << ref->value << "] from stack, to localVariableTable[" << index << "]." << std::endl;
+		sync_wcout{} << "(DEBUG) pop long [" << value << "] from stack, to localVariableTable[" << index << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x38:{		// fstore
+			OPCODE(0x38):{		// fstore
 				int index = pc[1];
 				assert(index > 3);
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::FLOAT);
-				FloatOop *ref = (FloatOop *)op_stack.top();
-				localVariableTable[index] = new FloatOop(ref->value);	op_stack.pop();
+				float value = op_stack->pop_float();
+				localVariableTable->set_float(index, value);
 #ifdef BYTECODE_DEBUG
-		sync_wcout{} << "(DEBUG) pop float [" << ref->value << "] from stack, to localVariableTable[" << index << "]." << std::endl;
+		sync_wcout{} << "(DEBUG) pop float [" << value << "] from stack, to localVariableTable[" << index << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x39:{		// dstore
+			OPCODE(0x39):{		// dstore
 				int index = pc[1];
 				assert(index > 3);
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::DOUBLE);
-				DoubleOop *ref = (DoubleOop *)op_stack.top();
-				localVariableTable[index] = new DoubleOop(ref->value);	op_stack.pop();
+				double value = op_stack->pop_double();
+				localVariableTable->set_double(index, value);
 #ifdef BYTECODE_DEBUG
-		sync_wcout{} << "(DEBUG) pop double [" << ref->value << "] from stack, to localVariableTable[" << index << "]." << std::endl;
+		sync_wcout{} << "(DEBUG) pop double [" << value << "] from stack, to localVariableTable[" << index << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
 
 
-			case 0x3a:{		// astore
+			OPCODE(0x3a):{		// astore
 				int index = pc[1];
 				assert(index > 3);
-				if (op_stack.top() != nullptr)	assert(op_stack.top()->get_ooptype() != OopType::_BasicTypeOop);
-				Oop *ref = op_stack.top();
-				localVariableTable[index] = ref;	op_stack.pop();
+				Oop *ref = op_stack->pop_ref();
+				localVariableTable->set_ref(index, ref);
 #ifdef BYTECODE_DEBUG
 	if (ref != nullptr)	// ref == null
 		sync_wcout{} << "(DEBUG) pop ref from stack, "<< ref->get_klass()->get_name() << "'s Oop: address: " << std::hex << ref << " to localVariableTable[" << index << "]." << std::endl;
 	else
 		sync_wcout{} << "(DEBUG) pop <null> ref from stack, to localVariableTable[" << index << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x3b:{		// istore_0
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				localVariableTable[0] = new IntOop(((IntOop *)op_stack.top())->value);	op_stack.pop();
+			OPCODE(0x3b):{		// istore_0
+				localVariableTable->set_int(0, op_stack->pop_int());
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) pop stack top int: "<< ((IntOop *)localVariableTable[0])->value << " to localVariableTable[0] and rewrite." << std::endl;
+	sync_wcout{} << "(DEBUG) pop stack top int: "<< localVariableTable->get_int(0) << " to localVariableTable[0] and rewrite." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x3c:{		// istore_1
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				localVariableTable[1] = new IntOop(((IntOop *)op_stack.top())->value);	op_stack.pop();
+			OPCODE(0x3c):{		// istore_1
+				localVariableTable->set_int(1, op_stack->pop_int());
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) pop stack top int: "<< ((IntOop *)localVariableTable[1])->value << " to localVariableTable[1] and rewrite." << std::endl;
+	sync_wcout{} << "(DEBUG) pop stack top int: "<< localVariableTable->get_int(1) << " to localVariableTable[1] and rewrite." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x3d:{		// istore_2
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				localVariableTable[2] = new IntOop(((IntOop *)op_stack.top())->value);	op_stack.pop();
+			OPCODE(0x3d):{		// istore_2
+				localVariableTable->set_int(2, op_stack->pop_int());
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) pop stack top int: "<< ((IntOop *)localVariableTable[2])->value << " to localVariableTable[2] and rewrite." << std::endl;
+	sync_wcout{} << "(DEBUG) pop stack top int: "<< localVariableTable->get_int(2) << " to localVariableTable[2] and rewrite." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x3e:{		// istore_3
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				localVariableTable[3] = new IntOop(((IntOop *)op_stack.top())->value);	op_stack.pop();
+			OPCODE(0x3e):{		// istore_3
+				localVariableTable->set_int(3, op_stack->pop_int());
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) pop stack top int: "<< ((IntOop *)localVariableTable[3])->value << " to localVariableTable[3] and rewrite." << std::endl;
+	sync_wcout{} << "(DEBUG) pop stack top int: "<< localVariableTable->get_int(3) << " to localVariableTable[3] and rewrite." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x3f:{		// lstore_0
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				localVariableTable[0] = new LongOop(((LongOop *)op_stack.top())->value);	op_stack.pop();
+			OPCODE(0x3f):{		// lstore_0
+				localVariableTable->set_long(0, op_stack->pop_long());
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) pop stack top long: "<< ((LongOop *)localVariableTable[0])->value << " to localVariableTable[0] and rewrite." << std::endl;
+	sync_wcout{} << "(DEBUG) pop stack top long: "<< localVariableTable->get_long(0) << " to localVariableTable[0] and rewrite." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x40:{		// lstore_1
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				localVariableTable[1] = new LongOop(((LongOop *)op_stack.top())->value);	op_stack.pop();
+			OPCODE(0x40):{		// lstore_1
+				localVariableTable->set_long(1, op_stack->pop_long());
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) pop stack top long: "<< ((LongOop *)localVariableTable[1])->value << " to localVariableTable[1] and rewrite." << std::endl;
+	sync_wcout{} << "(DEBUG) pop stack top long: "<< localVariableTable->get_long(1) << " to localVariableTable[1] and rewrite." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x41:{		// lstore_2
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				localVariableTable[2] = new LongOop(((LongOop *)op_stack.top())->value);	op_stack.pop();
+			OPCODE(0x41):{		// lstore_2
+				localVariableTable->set_long(2, op_stack->pop_long());
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) pop stack top long: "<< ((LongOop *)localVariableTable[2])->value << " to localVariableTable[2] and rewrite." << std::endl;
+	sync_wcout{} << "(DEBUG) pop stack top long: "<< localVariableTable->get_long(2) << " to localVariableTable[2] and rewrite." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x42:{		// lstore_3
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				localVariableTable[3] = new LongOop(((LongOop *)op_stack.top())->value);	op_stack.pop();
+			OPCODE(0x42):{		// lstore_3
+				localVariableTable->set_long(3, op_stack->pop_long());
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) pop stack top long: "<< ((LongOop *)localVariableTable[3])->value << " to localVariableTable[3] and rewrite." << std::endl;
+	sync_wcout{} << "(DEBUG) pop stack top long: "<< localVariableTable->get_long(3) << " to localVariableTable[3] and rewrite." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x43:{		// fstore_0
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::FLOAT);
-				localVariableTable[0] = new FloatOop(((FloatOop *)op_stack.top())->value);	op_stack.pop();
+			OPCODE(0x43):{		// fstore_0
+				localVariableTable->set_float(0, op_stack->pop_float());
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) pop stack top float: "<< ((FloatOop *)localVariableTable[0])->value << " to localVariableTable[0] and rewrite." << std::endl;
+	sync_wcout{} << "(DEBUG) pop stack top float: "<< localVariableTable->get_float(0) << " to localVariableTable[0] and rewrite." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x44:{		// fstore_1
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::FLOAT);
-				localVariableTable[1] = new FloatOop(((FloatOop *)op_stack.top())->value);	op_stack.pop();
+			OPCODE(0x44):{		// fstore_1
+				localVariableTable->set_float(1, op_stack->pop_float());
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) pop stack top float: "<< ((FloatOop *)localVariableTable[1])->value << " to localVariableTable[1] and rewrite." << std::endl;
+	sync_wcout{} << "(DEBUG) pop stack top float: "<< localVariableTable->get_float(1) << " to localVariableTable[1] and rewrite." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x45:{		// fstore_2
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::FLOAT);
-				localVariableTable[2] = new FloatOop(((FloatOop *)op_stack.top())->value);	op_stack.pop();
+			OPCODE(0x45):{		// fstore_2
+				localVariableTable->set_float(2, op_stack->pop_float());
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) pop stack top float: "<< ((FloatOop *)localVariableTable[2])->value << " to localVariableTable[2] and rewrite." << std::endl;
+	sync_wcout{} << "(DEBUG) pop stack top float: "<< localVariableTable->get_float(2) << " to localVariableTable[2] and rewrite." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x46:{		// fstore_3
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::FLOAT);
-				localVariableTable[3] = new FloatOop(((FloatOop *)op_stack.top())->value);	op_stack.pop();
+			OPCODE(0x46):{		// fstore_3
+				localVariableTable->set_float(3, op_stack->pop_float());
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) pop stack top float: "<< ((FloatOop *)localVariableTable[3])->value << " to localVariableTable[3] and rewrite." << std::endl;
+	sync_wcout{} << "(DEBUG) pop stack top float: "<< localVariableTable->get_float(3) << " to localVariableTable[3] and rewrite." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x47:{		// dstore_0
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::DOUBLE);
-				localVariableTable[0] = new DoubleOop(((DoubleOop *)op_stack.top())->value);	op_stack.pop();
+			OPCODE(0x47):{		// dstore_0
+				localVariableTable->set_double(0, op_stack->pop_double());
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) pop stack top double: "<< ((DoubleOop *)localVariableTable[0])->value << " to localVariableTable[0] and rewrite." << std::endl;
+	sync_wcout{} << "(DEBUG) pop stack top double: "<< localVariableTable->get_double(0) << " to localVariableTable[0] and rewrite." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x48:{		// dstore_1
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::DOUBLE);
-				localVariableTable[1] = new DoubleOop(((DoubleOop *)op_stack.top())->value);	op_stack.pop();
+			OPCODE(0x48):{		// dstore_1
+				localVariableTable->set_double(1, op_stack->pop_double());
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) pop stack top double: "<< ((DoubleOop *)localVariableTable[1])->value << " to localVariableTable[1] and rewrite." << std::endl;
+	sync_wcout{} << "(DEBUG) pop stack top double: "<< localVariableTable->get_double(1) << " to localVariableTable[1] and rewrite." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x49:{		// dstore_2
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::DOUBLE);
-				localVariableTable[2] = new DoubleOop(((DoubleOop *)op_stack.top())->value);	op_stack.pop();
+			OPCODE(0x49):{		// dstore_2
+				localVariableTable->set_double(2, op_stack->pop_double());
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) pop stack top double: "<< ((DoubleOop *)localVariableTable[2])->value << " to localVariableTable[2] and rewrite." << std::endl;
+	sync_wcout{} << "(DEBUG) pop stack top double: "<< localVariableTable->get_double(2) << " to localVariableTable[2] and rewrite." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x4a:{		// dstore_3
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::DOUBLE);
-				localVariableTable[3] = new DoubleOop(((DoubleOop *)op_stack.top())->value);	op_stack.pop();
+			OPCODE(0x4a):{		// dstore_3
+				localVariableTable->set_double(3, op_stack->pop_double());
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) pop stack top double: "<< ((DoubleOop *)localVariableTable[3])->value << " to localVariableTable[3] and rewrite." << std::endl;
+	sync_wcout{} << "(DEBUG) pop stack top double: "<< localVariableTable->get_double(3) << " to localVariableTable[3] and rewrite." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x4b:{		// astore_0
-				if (op_stack.top() != nullptr)	assert(op_stack.top()->get_ooptype() != OopType::_BasicTypeOop);
-				Oop *ref = op_stack.top();
-				localVariableTable[0] = op_stack.top();	op_stack.pop();
+			OPCODE(0x4b):{		// astore_0
+				Oop *ref = op_stack->pop_ref();
+				localVariableTable->set_ref(0, ref);
 #ifdef BYTECODE_DEBUG
 	if (ref != nullptr)	// ref == null
 		sync_wcout{} << "(DEBUG) pop ref from stack, "<< ref->get_klass()->get_name() << "'s Oop: address: " << std::hex << ref << " to localVariableTable[0]." << std::endl;
 	else
 		sync_wcout{} << "(DEBUG) pop <null> ref from stack, to localVariableTable[0]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x4c:{		// astore_1
-				if (op_stack.top() != nullptr)	assert(op_stack.top()->get_ooptype() != OopType::_BasicTypeOop);
-				Oop *ref = op_stack.top();
-				localVariableTable[1] = op_stack.top();	op_stack.pop();
+			OPCODE(0x4c):{		// astore_1
+				Oop *ref = op_stack->pop_ref();
+				localVariableTable->set_ref(1, ref);
 #ifdef BYTECODE_DEBUG
 	if (ref != nullptr)	// ref == null
 		sync_wcout{} << "(DEBUG) pop ref from stack, "<< ref->get_klass()->get_name() << "'s Oop: address: " << std::hex << ref << " to localVariableTable[1]." << std::endl;
 	else
 		sync_wcout{} << "(DEBUG) pop <null> ref from stack, to localVariableTable[1]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x4d:{		// astore_2
-				if (op_stack.top() != nullptr)	assert(op_stack.top()->get_ooptype() != OopType::_BasicTypeOop);
-				Oop *ref = op_stack.top();
-				localVariableTable[2] = op_stack.top();	op_stack.pop();
+			OPCODE(0x4d):{		// astore_2
+				Oop *ref = op_stack->pop_ref();
+				localVariableTable->set_ref(2, ref);
 #ifdef BYTECODE_DEBUG
 	if (ref != nullptr)	// ref == null
 		sync_wcout{} << "(DEBUG) pop ref from stack, "<< ref->get_klass()->get_name() << "'s Oop: address: " << std::hex << ref << " to localVariableTable[2]." << std::endl;
 	else
 		sync_wcout{} << "(DEBUG) pop <null> ref from stack, to localVariableTable[2]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x4e:{		// astore_3
-				if (op_stack.top() != nullptr)	assert(op_stack.top()->get_ooptype() != OopType::_BasicTypeOop);
-				Oop *ref = op_stack.top();
-				localVariableTable[3] = op_stack.top();	op_stack.pop();
+			OPCODE(0x4e):{		// astore_3
+				Oop *ref = op_stack->pop_ref();
+				localVariableTable->set_ref(3, ref);
 #ifdef BYTECODE_DEBUG
 	if (ref != nullptr)	// ref == null
 		sync_wcout{} << "(DEBUG) pop ref from stack, "<< ref->get_klass()->get_name() << "'s Oop: address: " << std::hex << ref << " to localVariableTable[3]." << std::endl;
 	else
 		sync_wcout{} << "(DEBUG) pop <null> ref from stack, to localVariableTable[3]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x4f:{		// iastore
-				IntOop *value = (IntOop *)op_stack.top();	op_stack.pop();
-				int index = ((IntOop *)op_stack.top())->value;	op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_ObjArrayOop || op_stack.top()->get_ooptype() == OopType::_TypeArrayOop);
-				ArrayOop *arr = (ArrayOop *)op_stack.top();	op_stack.pop();
-				assert(index < arr->get_length());
-				(*arr)[index] = new IntOop(value->value);
+			OPCODE(0x4f):{		// iastore
+				int value = op_stack->pop_int();
+				int index = op_stack->pop_int();
+				if (op_stack->top() == nullptr) {
+					// TODO: should throw NullpointerException
+					assert(false);
+				}
+				assert(op_stack->top()->get_ooptype() == OopType::_TypeArrayOop && op_stack->top()->get_klass()->get_name() == L"[I");		// assert int[] array
+				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack->top();	op_stack->pop();
+				assert(charsequence->get_length() > index && index >= 0);	// TODO: should throw ArrayIndexOutofBoundException
+				charsequence->elem_at<int>(index) = value;
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) put an int value: [" << value->value << "] into the IntArray[" << index << "]." << std::endl;
+	sync_wcout{} << "(DEBUG) put int ['" << value << "'] from the stack to int[]'s position of [" << index << "]" << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-
-
-			case 0x50:{		// lastore
-				LongOop *value = (LongOop *)op_stack.top();	op_stack.pop();
-				int index = ((IntOop *)op_stack.top())->value;	op_stack.pop();
-				if (op_stack.top() == nullptr) {
+			OPCODE(0x50):{		// lastore
+				long value = op_stack->pop_long();
+				int index = op_stack->pop_int();
+				if (op_stack->top() == nullptr) {
 					// TODO: should throw NullpointerException
 					assert(false);
 				}
-				assert(op_stack.top()->get_ooptype() == OopType::_TypeArrayOop && op_stack.top()->get_klass()->get_name() == L"[J");		// assert char[] array
-				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack.top();	op_stack.pop();
+				assert(op_stack->top()->get_ooptype() == OopType::_TypeArrayOop && op_stack->top()->get_klass()->get_name() == L"[J");		// assert long[] array
+				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack->top();	op_stack->pop();
 				assert(charsequence->get_length() > index && index >= 0);	// TODO: should throw ArrayIndexOutofBoundException
-				(*charsequence)[index] = new LongOop(value->value);
+				charsequence->elem_at<long>(index) = value;
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) get long ['" << value->value << "'] from the stack to long[]'s position of [" << index << "]" << std::endl;
+	sync_wcout{} << "(DEBUG) put long ['" << value << "'] from the stack to long[]'s position of [" << index << "]" << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-
-			case 0x53:{		// aastore
-				Oop *value = op_stack.top();	op_stack.pop();
-				int index = ((IntOop *)op_stack.top())->value;	op_stack.pop();
-				Oop *array_ref = op_stack.top();	op_stack.pop();
+			OPCODE(0x51):{		// fastore
+				float value = op_stack->pop_float();
+				int index = op_stack->pop_int();
+				if (op_stack->top() == nullptr) {
+					// TODO: should throw NullpointerException
+					assert(false);
+				}
+				assert(op_stack->top()->get_ooptype() == OopType::_TypeArrayOop && op_stack->top()->get_klass()->get_name() == L"[F");		// assert float[] array
+				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack->top();	op_stack->pop();
+				assert(charsequence->get_length() > index && index >= 0);	// TODO: should throw ArrayIndexOutofBoundException
+				charsequence->elem_at<float>(index) = value;
+#ifdef BYTECODE_DEBUG
+	sync_wcout{} << "(DEBUG) put float ['" << value << "'] from the stack to float[]'s position of [" << index << "]" << std::endl;
+#endif
+				NEXT_BYTECODE;
+			}
+			OPCODE(0x52):{		// dastore
+				double value = op_stack->pop_double();
+				int index = op_stack->pop_int();
+				if (op_stack->top() == nullptr) {
+					// TODO: should throw NullpointerException
+					assert(false);
+				}
+				assert(op_stack->top()->get_ooptype() == OopType::_TypeArrayOop && op_stack->top()->get_klass()->get_name() == L"[D");		// assert double[] array
+				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack->top();	op_stack->pop();
+				assert(charsequence->get_length() > index && index >= 0);	// TODO: should throw ArrayIndexOutofBoundException
+				charsequence->elem_at<double>(index) = value;
+#ifdef BYTECODE_DEBUG
+	sync_wcout{} << "(DEBUG) put double ['" << value << "'] from the stack to double[]'s position of [" << index << "]" << std::endl;
+#endif
+				NEXT_BYTECODE;
+			}
+			OPCODE(0x53):{		// aastore
+				Oop *value = op_stack->pop_ref();
+				int index = op_stack->pop_int();
+				Oop *array_ref = op_stack->pop_ref();
 				assert(array_ref != nullptr && (array_ref->get_ooptype() == OopType::_ObjArrayOop ||
 						(array_ref->get_ooptype() == OopType::_TypeArrayOop && ((TypeArrayOop *)array_ref)->get_dimension() >= 2)));
 				InstanceOop *real_value = (InstanceOop *)value;
 				ObjArrayOop *real_array = (ObjArrayOop *)array_ref;
 				assert(real_array->get_length() > index);
 				// overwrite
-				(*real_array)[index] = value;
+				oop_store(real_array, (*real_array)[index], value);
 #ifdef BYTECODE_DEBUG
 	if (real_value == nullptr) {
 		sync_wcout{} << "(DEBUG) put <null> into the index [" << index << "] of the ObjArray of type: ["
@@ -1833,223 +2374,150 @@ Oop * BytecodeEngine::execute(vm_thread & thread, StackFrame & cur_frame, int th
 				   << "] of the ObjArray of type: [" << ((ObjArrayKlass *)real_array->get_klass())->get_element_klass() << "]" << std::endl;
 	}
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x54:{		// bastore
-				IntOop *byte = (IntOop *)op_stack.top();	op_stack.pop();
-				int index = ((IntOop *)op_stack.top())->value;	op_stack.pop();
-				if (op_stack.top() == nullptr) {
+			OPCODE(0x54):{		// bastore
+				int value = op_stack->pop_int();
+				int index = op_stack->pop_int();
+				if (op_stack->top() == nullptr) {
 					// TODO: should throw NullpointerException
 					assert(false);
 				}
-				assert(op_stack.top()->get_ooptype() == OopType::_TypeArrayOop &&
-					   (op_stack.top()->get_klass()->get_name() == L"[B" || op_stack.top()->get_klass()->get_name() == L"[Z"));	// assert byte[]/boolean[] array
-				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack.top();	op_stack.pop();
+				assert(op_stack->top()->get_ooptype() == OopType::_TypeArrayOop && (op_stack->top()->get_klass()->get_name() == L"[B" || op_stack->top()->get_klass()->get_name() == L"[Z"));		// assert byte/boolean[] array
+				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack->top();	op_stack->pop();
 				assert(charsequence->get_length() > index && index >= 0);	// TODO: should throw ArrayIndexOutofBoundException
-				(*charsequence)[index] = new IntOop((int)((char)(byte->value)));
+				charsequence->elem_at<int8_t>(index) = value;
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) get byte/boolean ['" << (int)((char)byte->value) << "'] from the stack to byte/boolean[]'s position of [" << index << "]" << std::endl;
+	sync_wcout{} << "(DEBUG) put byte/boolean ['" << value << "'] from the stack to byte/boolean[]'s position of [" << index << "]" << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x55:{		// castore
-				IntOop *ch = (IntOop *)op_stack.top();	op_stack.pop();
-				int index = ((IntOop *)op_stack.top())->value;	op_stack.pop();
-				if (op_stack.top() == nullptr) {
+			OPCODE(0x55):{		// castore
+				int value = op_stack->pop_int();
+				int index = op_stack->pop_int();
+				if (op_stack->top() == nullptr) {
 					// TODO: should throw NullpointerException
 					assert(false);
 				}
-				assert(op_stack.top()->get_ooptype() == OopType::_TypeArrayOop && op_stack.top()->get_klass()->get_name() == L"[C");		// assert char[] array
-				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack.top();	op_stack.pop();
+				assert(op_stack->top()->get_ooptype() == OopType::_TypeArrayOop && op_stack->top()->get_klass()->get_name() == L"[C");		// assert char[] array
+				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack->top();	op_stack->pop();
 				assert(charsequence->get_length() > index && index >= 0);	// TODO: should throw ArrayIndexOutofBoundException
-				(*charsequence)[index] = new IntOop((unsigned short)ch->value);
+				charsequence->elem_at<uint16_t>(index) = value;
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) get wchar_t ['" << ch->value << "'] from the stack to char[]'s position of [" << index << "]" << std::endl;
+	sync_wcout{} << "(DEBUG) put char ['" << value << "'] from the stack to char[]'s position of [" << index << "]" << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
+			}
+			OPCODE(0x56):{		// sastore
+				int value = op_stack->pop_int();
+				int index = op_stack->pop_int();
+				if (op_stack->top() == nullptr) {
+					// TODO: should throw NullpointerException
+					assert(false);
+				}
+				assert(op_stack->top()->get_ooptype() == OopType::_TypeArrayOop && op_stack->top()->get_klass()->get_name() == L"[S");		// assert short[] array
+				TypeArrayOop * charsequence = (TypeArrayOop *)op_stack->top();	op_stack->pop();
+				assert(charsequence->get_length() > index && index >= 0);	// TODO: should throw ArrayIndexOutofBoundException
+				charsequence->elem_at<int16_t>(index) = value;
+#ifdef BYTECODE_DEBUG
+	sync_wcout{} << "(DEBUG) put short ['" << value << "'] from the stack to short[]'s position of [" << index << "]" << std::endl;
+#endif
+				NEXT_BYTECODE;
 			}
 
 
-			case 0x57:{		// pop
-				op_stack.pop();
+			OPCODE(0x57):{		// pop
+				op_stack->pop();
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) only pop from stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x58:{		// pop2
-				Oop *val1 = op_stack.top();	op_stack.pop();
-				if (val1->get_ooptype() == OopType::_BasicTypeOop &&		// the second type on spec
-						(((BasicTypeOop *)val1)->get_type() == Type::LONG || ((BasicTypeOop *)val1)->get_type() == Type::DOUBLE)) {
-					// do nothing
-				} else {
-					op_stack.pop();		// pop another.
-				}
+			OPCODE(0x58):{		// pop2
+				op_stack->pop();		// long and double take two slots. so pop2 is always two slots.
+				op_stack->pop();
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) pop2 from stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x59:{		// dup
-				op_stack.push(if_BasicType_then_copy_else_return_only(op_stack.top()));
+			OPCODE(0x59):{		// dup
+				dup_slots(*op_stack, 1, 0);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) only dup from stack." << std::endl;
+	sync_wcout{} << "(DEBUG) dup from stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x5a:{		// dup_x1
-				Oop *val1 = op_stack.top();	op_stack.pop();
-				Oop *val2 = op_stack.top();	op_stack.pop();
-				op_stack.push(if_BasicType_then_copy_else_return_only(val1));
-				op_stack.push(val2);
-				op_stack.push(val1);
+			OPCODE(0x5a):{		// dup_x1
+				dup_slots(*op_stack, 1, 1);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) only dup_x1 from stack." << std::endl;
+	sync_wcout{} << "(DEBUG) dup_x1 from stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x5b:{		// dup_x2
-				Oop *val1 = op_stack.top();	op_stack.pop();
-				Oop *val2 = op_stack.top();	op_stack.pop();
-				if (val2->get_ooptype() == OopType::_BasicTypeOop &&
-						(((BasicTypeOop *)val2)->get_type() == Type::LONG || ((BasicTypeOop *)val2)->get_type() == Type::DOUBLE)) {
-					// case 2
-					op_stack.push(if_BasicType_then_copy_else_return_only(val1));
-					op_stack.push(val2);
-					op_stack.push(val1);
+			OPCODE(0x5b):{		// dup_x2
+				dup_slots(*op_stack, 1, 2);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) dup_x2[2] from stack." << std::endl;
+	sync_wcout{} << "(DEBUG) dup_x2 from stack." << std::endl;
 #endif
-				} else {
-					// case 1
-					Oop *val3 = op_stack.top();	op_stack.pop();
-					op_stack.push(if_BasicType_then_copy_else_return_only(val1));
-					op_stack.push(val3);
-					op_stack.push(val2);
-					op_stack.push(val1);
-#ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) dup_x2[1] from stack." << std::endl;
-#endif
-				}
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x5c:{		// dup2
-				Oop *val1 = op_stack.top();	op_stack.pop();
-				if (val1->get_ooptype() == OopType::_BasicTypeOop &&
-						(((BasicTypeOop *)val1)->get_type() == Type::LONG || ((BasicTypeOop *)val1)->get_type() == Type::DOUBLE)) {
-					op_stack.push(if_BasicType_then_copy_else_return_only(val1));
-					op_stack.push(val1);
+			OPCODE(0x5c):{		// dup2
+				dup_slots(*op_stack, 2, 0);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) dup_2[1] from stack." << std::endl;
+	sync_wcout{} << "(DEBUG) dup2 from stack." << std::endl;
 #endif
-				} else {
-					Oop *val2 = op_stack.top();	op_stack.pop();
-					op_stack.push(if_BasicType_then_copy_else_return_only(val2));
-					op_stack.push(if_BasicType_then_copy_else_return_only(val1));
-					op_stack.push(val2);
-					op_stack.push(val1);
+				NEXT_BYTECODE;
+			}
+			OPCODE(0x5d):{		// dup2_x1
+				dup_slots(*op_stack, 2, 1);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) dup_2[2] from stack." << std::endl;
+	sync_wcout{} << "(DEBUG) dup2_x1 from stack." << std::endl;
 #endif
-				}
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x5d:{		// dup2_x1
-				Oop *val1 = op_stack.top();	op_stack.pop();
-				Oop *val2 = op_stack.top();	op_stack.pop();
-				if (val1->get_ooptype() == OopType::_BasicTypeOop &&
-						(((BasicTypeOop *)val1)->get_type() == Type::LONG || ((BasicTypeOop *)val1)->get_type() == Type::DOUBLE)) {
-					op_stack.push(if_BasicType_then_copy_else_return_only(val1));
-					op_stack.push(val2);
-					op_stack.push(val1);
+			OPCODE(0x5e):{		// dup2_x2
+				dup_slots(*op_stack, 2, 2);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) dup2_x1[1] from stack." << std::endl;
+	sync_wcout{} << "(DEBUG) dup2_x2 from stack." << std::endl;
 #endif
-				} else {
-					Oop *val3 = op_stack.top();	op_stack.pop();
-					op_stack.push(if_BasicType_then_copy_else_return_only(val2));
-					op_stack.push(if_BasicType_then_copy_else_return_only(val1));
-					op_stack.push(val3);
-					op_stack.push(val2);
-					op_stack.push(val1);
+				NEXT_BYTECODE;
+			}
+			OPCODE(0x5f):{		// swap
+				Slot val1 = op_stack->peek(0);	uint8_t tag1 = op_stack->peek_tag(0);
+				Slot val2 = op_stack->peek(1);	uint8_t tag2 = op_stack->peek_tag(1);
+				op_stack->pop();	op_stack->pop();
+				op_stack->push_slot(val1, tag1);
+				op_stack->push_slot(val2, tag2);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) dup2_x1[2] from stack." << std::endl;
+	sync_wcout{} << "(DEBUG) swap the top two slots of stack." << std::endl;
 #endif
-				}
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x5e:{		// dup2_x2
-				Oop *val1 = op_stack.top();	op_stack.pop();
-				Oop *val2 = op_stack.top();	op_stack.pop();
-				if (val1->get_ooptype() == OopType::_BasicTypeOop &&
-						(((BasicTypeOop *)val1)->get_type() == Type::LONG || ((BasicTypeOop *)val1)->get_type() == Type::DOUBLE)) {
-					if (val2->get_ooptype() == OopType::_BasicTypeOop &&
-						(((BasicTypeOop *)val2)->get_type() == Type::LONG || ((BasicTypeOop *)val2)->get_type() == Type::DOUBLE)) {
-						// case 4
-						op_stack.push(if_BasicType_then_copy_else_return_only(val1));
-						op_stack.push(val2);
-						op_stack.push(val1);
-					} else {		// 1-b.
-						// case 2
-						Oop *val3 = op_stack.top();	op_stack.pop();
-						op_stack.push(if_BasicType_then_copy_else_return_only(val1));
-						op_stack.push(val3);
-						op_stack.push(val2);
-						op_stack.push(val1);
-					}
-				} else {
-					Oop *val3 = op_stack.top();	op_stack.pop();
-					if (val3->get_ooptype() == OopType::_BasicTypeOop &&
-							(((BasicTypeOop *)val3)->get_type() == Type::LONG || ((BasicTypeOop *)val3)->get_type() == Type::DOUBLE)) {
-						// case 3
-						op_stack.push(if_BasicType_then_copy_else_return_only(val2));
-						op_stack.push(if_BasicType_then_copy_else_return_only(val1));
-						op_stack.push(val3);
-						op_stack.push(val2);
-						op_stack.push(val1);
-					} else {
-						// case 1
-						Oop *val4 = op_stack.top();	op_stack.pop();
-						op_stack.push(if_BasicType_then_copy_else_return_only(val2));
-						op_stack.push(if_BasicType_then_copy_else_return_only(val1));
-						op_stack.push(val4);
-						op_stack.push(val3);
-						op_stack.push(val2);
-						op_stack.push(val1);
-					}
-				}
 
-				break;
-			}
 
 
-			case 0x60:{		// iadd
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val2 = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val1 = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new IntOop(val2 + val1));
+			OPCODE(0x60):{		// iadd
+				int val2 = op_stack->pop_int();
+				int val1 = op_stack->pop_int();
+				op_stack->push_int(val2 + val1);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) add int value from stack: "<< val2 << " + " << val1 << " and put " << (val2+val1) << " on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x61:{		// ladd
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val2 = ((LongOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val1 = ((LongOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new LongOop(val2 + val1));
+			OPCODE(0x61):{		// ladd
+				long val2 = op_stack->pop_long();
+				long val1 = op_stack->pop_long();
+				op_stack->push_long(val2 + val1);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) add long value from stack: "<< val2 << " + " << val1 << " and put " << (val2+val1) << " on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x62:{		// fadd
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::FLOAT);
-				float val2 = ((FloatOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::FLOAT);
-				float val1 = ((FloatOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x62):{		// fadd
+				float val2 = op_stack->pop_float();
+				float val1 = op_stack->pop_float();
 
 #ifdef BYTECODE_DEBUG
 	auto print_float = [](float val) {
@@ -2065,37 +2533,35 @@ Oop * BytecodeEngine::execute(vm_thread & thread, StackFrame & cur_frame, int th
 	sync_wcout{} << "], result is: [";
 #endif
 				if (val2 == FLOAT_NAN || val1 == FLOAT_NAN) {
-					op_stack.push(new FloatOop(NAN));
+					op_stack->push_float(NAN);
 				} else if ((val2 == FLOAT_INFINITY && val1 == FLOAT_NEGATIVE_INFINITY) || (val1 == FLOAT_INFINITY && val2 == FLOAT_NEGATIVE_INFINITY)) {
-					op_stack.push(new FloatOop(NAN));
+					op_stack->push_float(NAN);
 				} else if (val2 == FLOAT_INFINITY && val1 == FLOAT_INFINITY) {
-					op_stack.push(new FloatOop(FLOAT_INFINITY));
+					op_stack->push_float(FLOAT_INFINITY);
 				} else if (val2 == FLOAT_NEGATIVE_INFINITY && val1 == FLOAT_NEGATIVE_INFINITY) {
-					op_stack.push(new FloatOop(FLOAT_NEGATIVE_INFINITY));
+					op_stack->push_float(FLOAT_NEGATIVE_INFINITY);
 				} else if (val2 == FLOAT_INFINITY && (val1 != FLOAT_INFINITY && val1 != FLOAT_NAN && val1 != FLOAT_NEGATIVE_INFINITY)) {
-					op_stack.push(new FloatOop(FLOAT_INFINITY));
+					op_stack->push_float(FLOAT_INFINITY);
 				} else if (val2 == FLOAT_NEGATIVE_INFINITY && (val1 != FLOAT_INFINITY && val1 != FLOAT_NAN && val1 != FLOAT_NEGATIVE_INFINITY)) {
-					op_stack.push(new FloatOop(FLOAT_NEGATIVE_INFINITY));
+					op_stack->push_float(FLOAT_NEGATIVE_INFINITY);
 				} else if (val1 == FLOAT_INFINITY && (val2 != FLOAT_INFINITY && val2 != FLOAT_NAN && val2 != FLOAT_NEGATIVE_INFINITY)) {
-					op_stack.push(new FloatOop(FLOAT_INFINITY));
+					op_stack->push_float(FLOAT_INFINITY);
 				} else if (val1 == FLOAT_NEGATIVE_INFINITY && (val2 != FLOAT_INFINITY && val2 != FLOAT_NAN && val2 != FLOAT_NEGATIVE_INFINITY)) {
-					op_stack.push(new FloatOop(FLOAT_NEGATIVE_INFINITY));
+					op_stack->push_float(FLOAT_NEGATIVE_INFINITY);
 				} else {
 					float result = val2 + val1;
-					op_stack.push(new FloatOop(result));
+					op_stack->push_float(result);
 				}
 #ifdef BYTECODE_DEBUG
-	print_float(((FloatOop *)op_stack.top())->value);
+	print_float(op_stack->top_float());
 	sync_wcout{} << "]." << std::endl;
 #endif
 
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x63:{		// dadd
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::DOUBLE);
-				double val2 = ((DoubleOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::DOUBLE);
-				double val1 = ((DoubleOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x63):{		// dadd
+				double val2 = op_stack->pop_double();
+				double val1 = op_stack->pop_double();
 
 #ifdef BYTECODE_DEBUG
 	auto print_double = [](double val) {
@@ -2111,99 +2577,87 @@ Oop * BytecodeEngine::execute(vm_thread & thread, StackFrame & cur_frame, int th
 	sync_wcout{} << "], result is: [";
 #endif
 				if (val2 == DOUBLE_NAN || val1 == DOUBLE_NAN) {
-					op_stack.push(new DoubleOop(NAN));
+					op_stack->push_double(NAN);
 				} else if ((val2 == DOUBLE_INFINITY && val1 == DOUBLE_NEGATIVE_INFINITY) || (val1 == DOUBLE_INFINITY && val2 == DOUBLE_NEGATIVE_INFINITY)) {
-					op_stack.push(new DoubleOop(NAN));
+					op_stack->push_double(NAN);
 				} else if (val2 == DOUBLE_INFINITY && val1 == DOUBLE_INFINITY) {
-					op_stack.push(new DoubleOop(DOUBLE_INFINITY));
+					op_stack->push_double(DOUBLE_INFINITY);
 				} else if (val2 == DOUBLE_NEGATIVE_INFINITY && val1 == DOUBLE_NEGATIVE_INFINITY) {
-					op_stack.push(new DoubleOop(DOUBLE_NEGATIVE_INFINITY));
+					op_stack->push_double(DOUBLE_NEGATIVE_INFINITY);
 				} else if (val2 == DOUBLE_INFINITY && (val1 != DOUBLE_INFINITY && val1 != DOUBLE_NAN && val1 != DOUBLE_NEGATIVE_INFINITY)) {
-					op_stack.push(new DoubleOop(DOUBLE_INFINITY));
+					op_stack->push_double(DOUBLE_INFINITY);
 				} else if (val2 == DOUBLE_NEGATIVE_INFINITY && (val1 != DOUBLE_INFINITY && val1 != DOUBLE_NAN && val1 != DOUBLE_NEGATIVE_INFINITY)) {
-					op_stack.push(new DoubleOop(DOUBLE_NEGATIVE_INFINITY));
+					op_stack->push_double(DOUBLE_NEGATIVE_INFINITY);
 				} else if (val1 == DOUBLE_INFINITY && (val2 != DOUBLE_INFINITY && val2 != DOUBLE_NAN && val2 != DOUBLE_NEGATIVE_INFINITY)) {
-					op_stack.push(new DoubleOop(DOUBLE_INFINITY));
+					op_stack->push_double(DOUBLE_INFINITY);
 				} else if (val1 == DOUBLE_NEGATIVE_INFINITY && (val2 != DOUBLE_INFINITY && val2 != DOUBLE_NAN && val2 != DOUBLE_NEGATIVE_INFINITY)) {
-					op_stack.push(new DoubleOop(DOUBLE_NEGATIVE_INFINITY));
+					op_stack->push_double(DOUBLE_NEGATIVE_INFINITY);
 				} else {
 					double result = val2 + val1;
-					op_stack.push(new DoubleOop(result));
+					op_stack->push_double(result);
 				}
 
 #ifdef BYTECODE_DEBUG
-	print_double(((DoubleOop *)op_stack.top())->value);
+	print_double(op_stack->top_double());
 	sync_wcout{} << "]." << std::endl;
 #endif
 
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x64:{		// isub
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val2 = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val1 = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new IntOop(val1 - val2));
+			OPCODE(0x64):{		// isub
+				int val2 = op_stack->pop_int();
+				int val1 = op_stack->pop_int();
+				op_stack->push_int(val1 - val2);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) sub int value from stack: "<< val1 << " - " << val2 << "(on top) and put " << (val1-val2) << " on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x65:{		// lsub
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val2 = ((LongOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val1 = ((LongOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new LongOop(val1 - val2));
+			OPCODE(0x65):{		// lsub
+				long val2 = op_stack->pop_long();
+				long val1 = op_stack->pop_long();
+				op_stack->push_long(val1 - val2);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) sub long value from stack: "<< val1 << " - " << val2 << "(on top) and put " << (val1-val2) << " on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
 
 
 
-			case 0x67:{		// dsub
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::DOUBLE);
-				double val2 = ((DoubleOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::DOUBLE);
-				double val1 = ((DoubleOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new DoubleOop(val1 - val2));
+			OPCODE(0x67):{		// dsub
+				double val2 = op_stack->pop_double();
+				double val1 = op_stack->pop_double();
+				op_stack->push_double(val1 - val2);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) sub double value from stack: "<< val1 << " - " << val2 << "(on top) and put " << (val1-val2) << " on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x68:{		// imul
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val2 = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val1 = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new IntOop(val1 * val2));
+			OPCODE(0x68):{		// imul
+				int val2 = op_stack->pop_int();
+				int val1 = op_stack->pop_int();
+				op_stack->push_int(val1 * val2);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) mul int value from stack: "<< val1 << " * " << val2 << "(on top) and put " << (val1 * val2) << " on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x69:{		// lmul
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val2 = ((LongOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val1 = ((LongOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new LongOop(val1 * val2));
+			OPCODE(0x69):{		// lmul
+				long val2 = op_stack->pop_long();
+				long val1 = op_stack->pop_long();
+				op_stack->push_long(val1 * val2);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) mul long value from stack: "<< val1 << " * " << val2 << "(on top) and put " << (val1 * val2) << " on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
 
 
 
-			case 0x6a:{		// fmul
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::FLOAT);
-				float val2 = ((FloatOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::FLOAT);
-				float val1 = ((FloatOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x6a):{		// fmul
+				float val2 = op_stack->pop_float();
+				float val1 = op_stack->pop_float();
 #ifdef BYTECODE_DEBUG
 	auto print_float = [](float val) {
 		if (val == FLOAT_NAN)	sync_wcout{} << "NAN";
@@ -2218,30 +2672,28 @@ Oop * BytecodeEngine::execute(vm_thread & thread, StackFrame & cur_frame, int th
 	sync_wcout{} << "], result is: [";
 #endif
 				if (val2 == FLOAT_NAN || val1 == FLOAT_NAN) {		// NAN * (any other)
-					op_stack.push(new FloatOop(FLOAT_NAN));
+					op_stack->push_float(FLOAT_NAN);
 				} else if (((val2 == FLOAT_INFINITY || val2 == FLOAT_NEGATIVE_INFINITY) && val1 == 0.0f) || ((val1 == FLOAT_INFINITY || val1 == FLOAT_NEGATIVE_INFINITY) && val2 == 0.0f)) {
-					op_stack.push(new FloatOop(FLOAT_NAN));			// INFINITY * 0
+					op_stack->push_float(FLOAT_NAN);			// INFINITY * 0
 				} else if ((val2 == FLOAT_INFINITY || val2 == FLOAT_NEGATIVE_INFINITY) && (val1 == FLOAT_INFINITY || val2 == FLOAT_NEGATIVE_INFINITY)) {
 					if ((val1 == FLOAT_INFINITY && val2 == FLOAT_INFINITY) || (val1 == FLOAT_NEGATIVE_INFINITY && val2 == FLOAT_NEGATIVE_INFINITY)) {
-						op_stack.push(new FloatOop(FLOAT_INFINITY));
+						op_stack->push_float(FLOAT_INFINITY);
 					} else {											// INFINITY * INFINITY
-						op_stack.push(new FloatOop(FLOAT_NEGATIVE_INFINITY));
+						op_stack->push_float(FLOAT_NEGATIVE_INFINITY);
 					}
 				} else {
 					float result = val2 * val1;
-					op_stack.push(new FloatOop(result));
+					op_stack->push_float(result);
 				}
 #ifdef BYTECODE_DEBUG
-	print_float(((FloatOop *)op_stack.top())	->value);
+	print_float(op_stack->top_float());
 	sync_wcout{} << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x6b:{		// dmul
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::DOUBLE);
-				double val2 = ((DoubleOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::DOUBLE);
-				double val1 = ((DoubleOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x6b):{		// dmul
+				double val2 = op_stack->pop_double();
+				double val1 = op_stack->pop_double();
 
 #ifdef BYTECODE_DEBUG
 	auto print_double = [](double val) {
@@ -2257,60 +2709,54 @@ Oop * BytecodeEngine::execute(vm_thread & thread, StackFrame & cur_frame, int th
 	sync_wcout{} << "], result is: [";
 #endif
 				if (val2 == DOUBLE_NAN || val1 == DOUBLE_NAN) {		// NAN * (any other)
-					op_stack.push(new DoubleOop(DOUBLE_NAN));
+					op_stack->push_double(DOUBLE_NAN);
 				} else if (((val2 == DOUBLE_INFINITY || val2 == DOUBLE_NEGATIVE_INFINITY) && val1 == 0.0) || ((val1 == DOUBLE_INFINITY || val1 == DOUBLE_NEGATIVE_INFINITY) && val2 == 0.0)) {
-					op_stack.push(new DoubleOop(DOUBLE_NAN));			// INFINITY * 0
+					op_stack->push_double(DOUBLE_NAN);			// INFINITY * 0
 				} else if ((val2 == DOUBLE_INFINITY || val2 == DOUBLE_NEGATIVE_INFINITY) && (val1 == DOUBLE_INFINITY || val2 == DOUBLE_NEGATIVE_INFINITY)) {
 					if ((val1 == DOUBLE_INFINITY && val2 == DOUBLE_INFINITY) || (val1 == DOUBLE_NEGATIVE_INFINITY && val2 == DOUBLE_NEGATIVE_INFINITY)) {
-						op_stack.push(new DoubleOop(DOUBLE_INFINITY));
+						op_stack->push_double(DOUBLE_INFINITY);
 					} else {											// INFINITY * INFINITY
-						op_stack.push(new DoubleOop(DOUBLE_NEGATIVE_INFINITY));
+						op_stack->push_double(DOUBLE_NEGATIVE_INFINITY);
 					}
 				} else {
 					double result = val2 * val1;
-					op_stack.push(new DoubleOop(result));
+					op_stack->push_double(result);
 				}
 #ifdef BYTECODE_DEBUG
-	print_double(((DoubleOop *)op_stack.top())->value);
+	print_double(op_stack->top_double());
 	sync_wcout{} << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x6c:{		// idiv
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val2 = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val1 = ((IntOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x6c):{		// idiv
+				int val2 = op_stack->pop_int();
+				int val1 = op_stack->pop_int();
 				if (val1 == INT_MIN && val2 == -1) {
-					op_stack.push(new IntOop(val1));
+					op_stack->push_int(val1);
 				} else {
-					op_stack.push(new IntOop(val1 / val2));
+					op_stack->push_int(val1 / val2);
 				}
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) div int value from stack: "<< val1 << " / " << val2 << "(on top) and put " << (val1 / val2) << " on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x6d:{		// ldiv
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val2 = ((LongOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val1 = ((LongOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x6d):{		// ldiv
+				long val2 = op_stack->pop_long();
+				long val1 = op_stack->pop_long();
 				if (val1 == LONG_MIN && val2 == -1) {
-					op_stack.push(new LongOop(val1));
+					op_stack->push_long(val1);
 				} else {
-					op_stack.push(new LongOop(val1 / val2));
+					op_stack->push_long(val1 / val2);
 				}
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) div long value from stack: "<< val1 << " / " << val2 << "(on top) and put " << (val1 / val2) << " on stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x6e:{		// fdiv
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::FLOAT);
-				float val2 = ((FloatOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::FLOAT);
-				float val1 = ((FloatOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x6e):{		// fdiv
+				float val2 = op_stack->pop_float();
+				float val1 = op_stack->pop_float();
 
 #ifdef BYTECODE_DEBUG
 	auto print_float = [](float val) {
@@ -2326,43 +2772,41 @@ Oop * BytecodeEngine::execute(vm_thread & thread, StackFrame & cur_frame, int th
 	sync_wcout{} << "], result is: [";
 #endif
 				if (val2 == FLOAT_NAN || val1 == FLOAT_NAN) {		// NAN / (any other)
-					op_stack.push(new FloatOop(FLOAT_NAN));
+					op_stack->push_float(FLOAT_NAN);
 				} else if ((val2 == FLOAT_INFINITY || val2 == FLOAT_NEGATIVE_INFINITY) && (val1 == FLOAT_INFINITY || val2 == FLOAT_NEGATIVE_INFINITY)) {
-					op_stack.push(new FloatOop(FLOAT_NAN));			// INFINITY / INFINITY
+					op_stack->push_float(FLOAT_NAN);			// INFINITY / INFINITY
 				} else if ((val2 == FLOAT_INFINITY || val2 == FLOAT_NEGATIVE_INFINITY) && (val1 != FLOAT_NAN && val1 != FLOAT_INFINITY && val1 != FLOAT_NEGATIVE_INFINITY)) {
 					if ((val2 < 0 && val1 < 0) || (val2 > 0 && val1 > 0)) {
-						op_stack.push(new FloatOop(FLOAT_INFINITY));			// INFINITY / non-INFINITY
+						op_stack->push_float(FLOAT_INFINITY);			// INFINITY / non-INFINITY
 					} else {
-						op_stack.push(new FloatOop(FLOAT_NEGATIVE_INFINITY));			// INFINITY / non-INFINITY
+						op_stack->push_float(FLOAT_NEGATIVE_INFINITY);			// INFINITY / non-INFINITY
 					}
 				} else if ((val2 != FLOAT_NAN && val2 != FLOAT_INFINITY && val2 != FLOAT_NEGATIVE_INFINITY) && (val1 == FLOAT_INFINITY || val1 == FLOAT_NEGATIVE_INFINITY)) {
-					op_stack.push(new FloatOop(0.0f));					// non-INFINITY / INFINITY
+					op_stack->push_float(0.0f);					// non-INFINITY / INFINITY
 				} else if (val1 == 0.0 && val2 == 0.0) {
-					op_stack.push(new FloatOop(FLOAT_NAN));
+					op_stack->push_float(FLOAT_NAN);
 				} else if (val2 == 0.0 && (val1 != FLOAT_NAN && val1 != FLOAT_INFINITY && val1 != FLOAT_NEGATIVE_INFINITY && val1 != 0.0)) {
 					if (val1 > 0)
-						op_stack.push(new FloatOop(FLOAT_INFINITY));
+						op_stack->push_float(FLOAT_INFINITY);
 					else
-						op_stack.push(new FloatOop(FLOAT_NEGATIVE_INFINITY));
+						op_stack->push_float(FLOAT_NEGATIVE_INFINITY);
 				} else if ((val2 != FLOAT_NAN && val2 != FLOAT_INFINITY && val2 != FLOAT_NEGATIVE_INFINITY && val2 != 0.0) && val1 == 0.0) {
 					if (val2 > 0)
-						op_stack.push(new FloatOop(FLOAT_INFINITY));
+						op_stack->push_float(FLOAT_INFINITY);
 					else
-						op_stack.push(new FloatOop(FLOAT_NEGATIVE_INFINITY));
+						op_stack->push_float(FLOAT_NEGATIVE_INFINITY);
 				} else {
-					op_stack.push(new FloatOop(val2 / val1));
+					op_stack->push_float(val2 / val1);
 				}
 #ifdef BYTECODE_DEBUG
-	print_float(((FloatOop *)op_stack.top())	->value);
+	print_float(op_stack->top_float());
 	sync_wcout{} << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x6f:{		// ddiv
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::DOUBLE);
-				double val2 = ((DoubleOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::DOUBLE);
-				double val1 = ((DoubleOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x6f):{		// ddiv
+				double val2 = op_stack->pop_double();
+				double val1 = op_stack->pop_double();
 
 #ifdef BYTECODE_DEBUG
 	auto print_double = [](double val) {
@@ -2378,511 +2822,461 @@ Oop * BytecodeEngine::execute(vm_thread & thread, StackFrame & cur_frame, int th
 	sync_wcout{} << "], result is: [";
 #endif
 				if (val2 == DOUBLE_NAN || val1 == DOUBLE_NAN) {		// NAN / (any other)
-					op_stack.push(new DoubleOop(DOUBLE_NAN));
+					op_stack->push_double(DOUBLE_NAN);
 				} else if ((val2 == DOUBLE_INFINITY || val2 == DOUBLE_NEGATIVE_INFINITY) && (val1 == DOUBLE_INFINITY || val2 == DOUBLE_NEGATIVE_INFINITY)) {
-					op_stack.push(new DoubleOop(DOUBLE_NAN));			// INFINITY / INFINITY
+					op_stack->push_double(DOUBLE_NAN);			// INFINITY / INFINITY
 				} else if ((val2 == DOUBLE_INFINITY || val2 == DOUBLE_NEGATIVE_INFINITY) && (val1 != DOUBLE_NAN && val1 != DOUBLE_INFINITY && val1 != DOUBLE_NEGATIVE_INFINITY)) {
 					if ((val2 < 0 && val1 < 0) || (val2 > 0 && val1 > 0)) {
-						op_stack.push(new DoubleOop(DOUBLE_INFINITY));			// INFINITY / non-INFINITY
+						op_stack->push_double(DOUBLE_INFINITY);			// INFINITY / non-INFINITY
 					} else {
-						op_stack.push(new DoubleOop(DOUBLE_NEGATIVE_INFINITY));			// INFINITY / non-INFINITY
+						op_stack->push_double(DOUBLE_NEGATIVE_INFINITY);			// INFINITY / non-INFINITY
 					}
 				} else if ((val2 != DOUBLE_NAN && val2 != DOUBLE_INFINITY && val2 != DOUBLE_NEGATIVE_INFINITY) && (val1 == DOUBLE_INFINITY || val1 == DOUBLE_NEGATIVE_INFINITY)) {
-					op_stack.push(new DoubleOop(0.0f));					// non-INFINITY / INFINITY
+					op_stack->push_double(0.0f);					// non-INFINITY / INFINITY
 				} else if (val1 == 0.0 && val2 == 0.0) {
-					op_stack.push(new DoubleOop(DOUBLE_NAN));
+					op_stack->push_double(DOUBLE_NAN);
 				} else if (val2 == 0.0 && (val1 != DOUBLE_NAN && val1 != DOUBLE_INFINITY && val1 != DOUBLE_NEGATIVE_INFINITY && val1 != 0.0)) {
 					if (val1 > 0)
-						op_stack.push(new DoubleOop(DOUBLE_INFINITY));
+						op_stack->push_double(DOUBLE_INFINITY);
 					else
-						op_stack.push(new DoubleOop(DOUBLE_NEGATIVE_INFINITY));
+						op_stack->push_double(DOUBLE_NEGATIVE_INFINITY);
 				} else if ((val2 != DOUBLE_NAN && val2 != DOUBLE_INFINITY && val2 != DOUBLE_NEGATIVE_INFINITY && val2 != 0.0) && val1 == 0.0) {
 					if (val2 > 0)
-						op_stack.push(new DoubleOop(DOUBLE_INFINITY));
+						op_stack->push_double(DOUBLE_INFINITY);
 					else
-						op_stack.push(new DoubleOop(DOUBLE_NEGATIVE_INFINITY));
+						op_stack->push_double(DOUBLE_NEGATIVE_INFINITY);
 				} else {
-					op_stack.push(new DoubleOop(val2 / val1));
+					op_stack->push_double(val2 / val1);
 				}
 #ifdef BYTECODE_DEBUG
-	print_double(((DoubleOop *)op_stack.top())	->value);
+	print_double(op_stack->top_double());
 	sync_wcout{} << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x70:{		// irem
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val2 = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val1 = ((IntOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x70):{		// irem
+				int val2 = op_stack->pop_int();
+				int val1 = op_stack->pop_int();
 
 				assert(val2 != 0);
 				assert((val1 / val2) * val2 + (val1 % val2) == val1);
 				assert(val1 % val2 == (val1 - (val1 / val2) * val2));
 
-				op_stack.push(new IntOop(val1 % val2));
+				op_stack->push_int(val1 % val2);
 
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) do [" << val1 << " % " << val2 << "], result is " << ((IntOop *)op_stack.top())->value << "." << std::endl;
+	sync_wcout{} << "(DEBUG) do [" << val1 << " % " << val2 << "], result is " << op_stack->top_int() << "." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x71:{		// lrem
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val2 = ((LongOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val1 = ((LongOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x71):{		// lrem
+				long val2 = op_stack->pop_long();
+				long val1 = op_stack->pop_long();
 
 				assert(val2 != 0);
 				assert((val1 / val2) * val2 + (val1 % val2) == val1);
 				assert(val1 % val2 == (val1 - (val1 / val2) * val2));
 
-				op_stack.push(new LongOop(val1 % val2));
+				op_stack->push_long(val1 % val2);
 
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) do [" << val1 << " % " << val2 << "], result is " << ((LongOop *)op_stack.top())->value << "." << std::endl;
+	sync_wcout{} << "(DEBUG) do [" << val1 << " % " << val2 << "], result is " << op_stack->top_long() << "." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
 
 
 
-			case 0x74:{		// ineg
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new IntOop(-val));
+			OPCODE(0x74):{		// ineg
+				int val = op_stack->pop_int();
+				op_stack->push_int(-val);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) do [ -" << val << "], result is " << ((IntOop *)op_stack.top())->value << "." << std::endl;
+	sync_wcout{} << "(DEBUG) do [ -" << val << "], result is " << op_stack->top_int() << "." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x75:{		// lneg
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val = ((LongOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new LongOop(-val));
+			OPCODE(0x75):{		// lneg
+				long val = op_stack->pop_long();
+				op_stack->push_long(-val);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) do [ -" << val << "], result is " << ((LongOop *)op_stack.top())->value << "." << std::endl;
+	sync_wcout{} << "(DEBUG) do [ -" << val << "], result is " << op_stack->top_long() << "." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
 
 
 
-			case 0x78:{		// ishl
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val2 = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val1 = ((IntOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x78):{		// ishl
+				int val2 = op_stack->pop_int();
+				int val1 = op_stack->pop_int();
 				int s = (val2 & 0x1F);
-				op_stack.push(new IntOop(val1 << s));
+				op_stack->push_int(val1 << s);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) do [" << val1 << " << " << s << "], result is " << ((IntOop *)op_stack.top())->value << "." << std::endl;
+	sync_wcout{} << "(DEBUG) do [" << val1 << " << " << s << "], result is " << op_stack->top_int() << "." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x79:{		// lshl
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val2 = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val1 = ((LongOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x79):{		// lshl
+				int val2 = op_stack->pop_int();
+				long val1 = op_stack->pop_long();
 				int s = (val2 & 0x3F);
-				op_stack.push(new LongOop(val1 << s));
+				op_stack->push_long(val1 << s);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) do [" << val1 << " << " << s << "], result is " << ((LongOop *)op_stack.top())->value << "." << std::endl;
+	sync_wcout{} << "(DEBUG) do [" << val1 << " << " << s << "], result is " << op_stack->top_long() << "." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
 
 
-			case 0x7a:{		// ishr
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val2 = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val1 = ((IntOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x7a):{		// ishr
+				int val2 = op_stack->pop_int();
+				int val1 = op_stack->pop_int();
 				int s = (val2 & 0x1F);
-				op_stack.push(new IntOop(val1 >> s));
+				op_stack->push_int(val1 >> s);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) do [" << val1 << " >> " << s << "], result is " << ((IntOop *)op_stack.top())->value << "." << std::endl;
+	sync_wcout{} << "(DEBUG) do [" << val1 << " >> " << s << "], result is " << op_stack->top_int() << "." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x7b:{		// lshr
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val2 = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val1 = ((LongOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x7b):{		// lshr
+				int val2 = op_stack->pop_int();
+				long val1 = op_stack->pop_long();
 				int s = (val2 & 0x3F);
-				op_stack.push(new LongOop(val1 >> s));
+				op_stack->push_long(val1 >> s);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) do [" << val1 << " >> " << s << "], result is " << ((LongOop *)op_stack.top())->value << "." << std::endl;
+	sync_wcout{} << "(DEBUG) do [" << val1 << " >> " << s << "], result is " << op_stack->top_long() << "." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x7c:{		// iushr
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val2 = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val1 = ((IntOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x7c):{		// iushr
+				int val2 = op_stack->pop_int();
+				int val1 = op_stack->pop_int();
 
 				int s = (val2 & 0x1F);
 				if (val1 >= 0) {
-					op_stack.push(new IntOop(val1 >> s));
+					op_stack->push_int(val1 >> s);
 				} else {
-					op_stack.push(new IntOop((val1 >> s)+(2 << ~s)));
+					op_stack->push_int((val1 >> s)+(2 << ~s));
 				}
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) do [" << val1 << " >> " << s << "], result is " << ((IntOop *)op_stack.top())->value << "." << std::endl;
+	sync_wcout{} << "(DEBUG) do [" << val1 << " >> " << s << "], result is " << op_stack->top_int() << "." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x7d:{		// lushr
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val2 = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val1 = ((LongOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x7d):{		// lushr
+				int val2 = op_stack->pop_int();
+				long val1 = op_stack->pop_long();
 
 				int s = (val2 & 0x3F);
 				if (val1 >= 0) {
-					op_stack.push(new LongOop(val1 >> s));
+					op_stack->push_long(val1 >> s);
 				} else {
-					op_stack.push(new LongOop((val1 >> s)+(2l << ~s)));
+					op_stack->push_long((val1 >> s)+(2l << ~s));
 				}
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) do [" << val1 << " >> " << s << "], result is " << ((LongOop *)op_stack.top())->value << "." << std::endl;
+	sync_wcout{} << "(DEBUG) do [" << val1 << " >> " << s << "], result is " << op_stack->top_long() << "." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x7e:{		// iand
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val2 = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val1 = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new IntOop(val2 & val1));
+			OPCODE(0x7e):{		// iand
+				int val2 = op_stack->pop_int();
+				int val1 = op_stack->pop_int();
+				op_stack->push_int(val2 & val1);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) do [" << val2 << " & " << val1 << "], result is " << ((IntOop *)op_stack.top())->value << "." << std::endl;
+	sync_wcout{} << "(DEBUG) do [" << val2 << " & " << val1 << "], result is " << op_stack->top_int() << "." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x7f:{		// land
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val2 = ((LongOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val1 = ((LongOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new LongOop(val2 & val1));
+			OPCODE(0x7f):{		// land
+				long val2 = op_stack->pop_long();
+				long val1 = op_stack->pop_long();
+				op_stack->push_long(val2 & val1);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) do [" << val2 << " & " << val1 << "], result is " << ((LongOop *)op_stack.top())->value << "." << std::endl;
+	sync_wcout{} << "(DEBUG) do [" << val2 << " & " << val1 << "], result is " << op_stack->top_long() << "." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x80:{		// ior
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val2 = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val1 = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new IntOop(val2 | val1));
+			OPCODE(0x80):{		// ior
+				int val2 = op_stack->pop_int();
+				int val1 = op_stack->pop_int();
+				op_stack->push_int(val2 | val1);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) do [" << val2 << " | " << val1 << "], result is " << ((IntOop *)op_stack.top())->value << "." << std::endl;
+	sync_wcout{} << "(DEBUG) do [" << val2 << " | " << val1 << "], result is " << op_stack->top_int() << "." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x81:{		// lor
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val2 = ((LongOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val1 = ((LongOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new LongOop(val2 | val1));
+			OPCODE(0x81):{		// lor
+				long val2 = op_stack->pop_long();
+				long val1 = op_stack->pop_long();
+				op_stack->push_long(val2 | val1);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) do [" << val2 << " | " << val1 << "], result is " << ((LongOop *)op_stack.top())->value << "." << std::endl;
+	sync_wcout{} << "(DEBUG) do [" << val2 << " | " << val1 << "], result is " << op_stack->top_long() << "." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x82:{		// ixor
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val2 = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val1 = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new IntOop(val2 ^ val1));
+			OPCODE(0x82):{		// ixor
+				int val2 = op_stack->pop_int();
+				int val1 = op_stack->pop_int();
+				op_stack->push_int(val2 ^ val1);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) do [" << val2 << " ^ " << val1 << "], result is " << ((IntOop *)op_stack.top())->value << "." << std::endl;
+	sync_wcout{} << "(DEBUG) do [" << val2 << " ^ " << val1 << "], result is " << op_stack->top_int() << "." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x83:{		// lxor
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val2 = ((LongOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val1 = ((LongOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new LongOop(val2 ^ val1));
+			OPCODE(0x83):{		// lxor
+				long val2 = op_stack->pop_long();
+				long val1 = op_stack->pop_long();
+				op_stack->push_long(val2 ^ val1);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) do [" << val2 << " ^ " << val1 << "], result is " << ((LongOop *)op_stack.top())->value << "." << std::endl;
+	sync_wcout{} << "(DEBUG) do [" << val2 << " ^ " << val1 << "], result is " << op_stack->top_long() << "." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x84:{		// iinc
+			OPCODE(0x84):{		// iinc
 				int index = pc[1];
 				int _const = (int8_t)pc[2];
-				assert(localVariableTable[index]->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)localVariableTable[index])->get_type() == Type::INT);
-				((IntOop *)localVariableTable[index])->value += _const;
+				localVariableTable->set_int(index, localVariableTable->get_int(index) + _const);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) localVariableTable[" << index << "] += " << _const << ", now value is [" << ((IntOop *)localVariableTable[index])->value << "]." << std::endl;
+	sync_wcout{} << "(DEBUG) localVariableTable[" << index << "] += " << _const << ", now value is [" << localVariableTable->get_int(index) << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x85:{		// i2l
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new LongOop((long)val));
+			OPCODE(0x85):{		// i2l
+				int val = op_stack->pop_int();
+				op_stack->push_long((long)val);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) convert int: [" << val << "] to long: [" << ((LongOop *)op_stack.top())->value << "]." << std::endl;
+	sync_wcout{} << "(DEBUG) convert int: [" << val << "] to long: [" << op_stack->top_long() << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x86:{		// i2f
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new FloatOop((float)val));
+			OPCODE(0x86):{		// i2f
+				int val = op_stack->pop_int();
+				op_stack->push_float((float)val);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) convert int: [" << val << "] to float: [" << ((FloatOop *)op_stack.top())->value << "]." << std::endl;
+	sync_wcout{} << "(DEBUG) convert int: [" << val << "] to float: [" << op_stack->top_float() << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x87:{		// i2d
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new DoubleOop((double)val));
+			OPCODE(0x87):{		// i2d
+				int val = op_stack->pop_int();
+				op_stack->push_double((double)val);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) convert int: [" << val << "] to double: [" << ((DoubleOop *)op_stack.top())->value << "]." << std::endl;
+	sync_wcout{} << "(DEBUG) convert int: [" << val << "] to double: [" << op_stack->top_double() << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x88:{		// l2i
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val = ((LongOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new IntOop((int)val));
+			OPCODE(0x88):{		// l2i
+				long val = op_stack->pop_long();
+				op_stack->push_int((int)val);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) convert long: [" << val << "] to int: [" << ((IntOop *)op_stack.top())->value << "]." << std::endl;
+	sync_wcout{} << "(DEBUG) convert long: [" << val << "] to int: [" << op_stack->top_int() << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x89:{		// l2f
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val = ((LongOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new FloatOop((float)val));
+			OPCODE(0x89):{		// l2f
+				long val = op_stack->pop_long();
+				op_stack->push_float((float)val);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) convert long: [" << val << "] to float: [" << ((FloatOop *)op_stack.top())->value << "]." << std::endl;
+	sync_wcout{} << "(DEBUG) convert long: [" << val << "] to float: [" << op_stack->top_float() << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
 
 
-			case 0x8b:{		// f2i
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::FLOAT);
-				float val = ((FloatOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x8b):{		// f2i
+				float val = op_stack->pop_float();
 
 				if (val == FLOAT_NAN) {
-					op_stack.push(new IntOop(0));
+					op_stack->push_int(0);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) convert float: [FLOAT_NAN] to int: [0]." << std::endl;
 #endif
 				} else if (val == FLOAT_INFINITY) {
-					op_stack.push(new IntOop(INT_MAX));
+					op_stack->push_int(INT_MAX);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) convert float: [FLOAT_INFINITY] to int: [INT_MAX]." << std::endl;
 #endif
 				} else if (val == FLOAT_NEGATIVE_INFINITY) {
-					op_stack.push(new IntOop(INT_MIN));
+					op_stack->push_int(INT_MIN);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) convert float: [FLOAT_NEGATIVE_INFINITY] to int: [INT_MIN]." << std::endl;
 #endif
 				} else {
-					op_stack.push(new IntOop((int)val));
+					op_stack->push_int((int)val);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) convert float: [" << val << "f] to int: [" << ((IntOop *)op_stack.top())->value << "]." << std::endl;
+	sync_wcout{} << "(DEBUG) convert float: [" << val << "f] to int: [" << op_stack->top_int() << "]." << std::endl;
 #endif
 				}
 
-				break;
+				NEXT_BYTECODE;
 			}
 
-			case 0x8d:{		// f2d
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::FLOAT);
-				float val = ((FloatOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new DoubleOop((double)val));
+			OPCODE(0x8d):{		// f2d
+				float val = op_stack->pop_float();
+				op_stack->push_double((double)val);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) convert float: [" << val << "f] to double: [" << ((DoubleOop *)op_stack.top())->value << "]." << std::endl;
+	sync_wcout{} << "(DEBUG) convert float: [" << val << "f] to double: [" << op_stack->top_double() << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x8e:{		// d2i
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::DOUBLE);
-				double val = ((DoubleOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x8e):{		// d2i
+				double val = op_stack->pop_double();
 
 				if (val == DOUBLE_NAN) {
-					op_stack.push(new IntOop(0));
+					op_stack->push_int(0);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) convert double: [DOUBLE_NAN] to int: [0]." << std::endl;
 #endif
 				} else if (val == DOUBLE_INFINITY) {
-					op_stack.push(new IntOop(INT_MAX));
+					op_stack->push_int(INT_MAX);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) convert double: [DOUBLE_INFINITY] to int: [INT_MAX]." << std::endl;
 #endif
 				} else if (val == DOUBLE_NEGATIVE_INFINITY) {
-					op_stack.push(new IntOop(INT_MIN));
+					op_stack->push_int(INT_MIN);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) convert double: [DOUBLE_NEGATIVE_INFINITY] to int: [INT_MIN]." << std::endl;
 #endif
 				} else {
-					op_stack.push(new IntOop((int)val));
+					op_stack->push_int((int)val);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) convert double: [" << val << "ld] to int: [" << ((IntOop *)op_stack.top())->value << "]." << std::endl;
+	sync_wcout{} << "(DEBUG) convert double: [" << val << "ld] to int: [" << op_stack->top_int() << "]." << std::endl;
 #endif
 				}
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x8f:{		// d2l
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::DOUBLE);
-				double val = ((DoubleOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x8f):{		// d2l
+				double val = op_stack->pop_double();
 
 				if (val == DOUBLE_NAN) {
-					op_stack.push(new LongOop(0));
+					op_stack->push_long(0);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) convert double: [DOUBLE_NAN] to long: [0]." << std::endl;
 #endif
 				} else if (val == DOUBLE_INFINITY) {
-					op_stack.push(new LongOop(LONG_MAX));
+					op_stack->push_long(LONG_MAX);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) convert double: [DOUBLE_INFINITY] to long: [LONG_MAX]." << std::endl;
 #endif
 				} else if (val == DOUBLE_NEGATIVE_INFINITY) {
-					op_stack.push(new LongOop(LONG_MIN));
+					op_stack->push_long(LONG_MIN);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) convert double: [DOUBLE_NEGATIVE_INFINITY] to long: [LONG_MIN]." << std::endl;
 #endif
 				} else {
-					op_stack.push(new LongOop((long)val));
+					op_stack->push_long((long)val);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) convert double: [" << val << "ld] to long: [" << ((LongOop *)op_stack.top())->value << "]." << std::endl;
+	sync_wcout{} << "(DEBUG) convert double: [" << val << "ld] to long: [" << op_stack->top_long() << "]." << std::endl;
 #endif
 				}
-				break;
+				NEXT_BYTECODE;
 			}
 
-			case 0x91:{		// i2b
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new IntOop((int8_t)val));		// (signed_extended)
+			OPCODE(0x91):{		// i2b
+				int val = op_stack->pop_int();
+				op_stack->push_int((int8_t)val);		// (signed_extended)
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) convert int: [" << val << "] to byte: [" << std::dec << ((IntOop *)op_stack.top())->value << "]." << std::endl;
+	sync_wcout{} << "(DEBUG) convert int: [" << val << "] to byte: [" << std::dec << op_stack->top_int() << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x92:{		// i2c
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new IntOop((unsigned short)val));	// (zero-extended)
+			OPCODE(0x92):{		// i2c
+				int val = op_stack->pop_int();
+				op_stack->push_int((unsigned short)val);	// (zero-extended)
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) convert int: [" << val << "] to char: [" << (wchar_t)((IntOop *)op_stack.top())->value << "]." << std::endl;
+	sync_wcout{} << "(DEBUG) convert int: [" << val << "] to char: [" << (wchar_t)op_stack->top_int() << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x93:{		// i2s
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int val = ((IntOop*)op_stack.top())->value; op_stack.pop();
-				op_stack.push(new IntOop((short)val));
+			OPCODE(0x93):{		// i2s
+				int val = op_stack->pop_int();
+				op_stack->push_int((short)val);
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) convert int: [" << val << "] to short: [" << ((IntOop *)op_stack.top())->value << "]." << std::endl;
+	sync_wcout{} << "(DEBUG) convert int: [" << val << "] to short: [" << op_stack->top_int() << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x94:{		// lcmp
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val2 = ((LongOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
-				long val1 = ((LongOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x94):{		// lcmp
+				long val2 = op_stack->pop_long();
+				long val1 = op_stack->pop_long();
 				if (val2 > val1) {
-					op_stack.push(new IntOop(-1));
+					op_stack->push_int(-1);
 				} else if (val2 < val1) {
-					op_stack.push(new IntOop(1));
+					op_stack->push_int(1);
 				} else {
-					op_stack.push(new IntOop(0));
+					op_stack->push_int(0);
 				}
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) compare longs: [" << val1 << " and " << val2 << "], result is " << ((IntOop *)op_stack.top())->value << "." << std::endl;
+	sync_wcout{} << "(DEBUG) compare longs: [" << val1 << " and " << val2 << "], result is " << op_stack->top_int() << "." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x95:		// fcmp_l
-			case 0x96:{		// fcmp_g
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::FLOAT);
-				float val2 = ((FloatOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::FLOAT);
-				float val1 = ((FloatOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x95):		// fcmp_l
+			OPCODE(0x96):{		// fcmp_g
+				float val2 = op_stack->pop_float();
+				float val1 = op_stack->pop_float();
 
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) ";
 #endif
 				if (val1 == FLOAT_NAN || val2 == FLOAT_NAN) {
 					if (*pc == 0x95) {
-						op_stack.push(new IntOop(-1));
+						op_stack->push_int(-1);
 					} else {
-						op_stack.push(new IntOop(1));
+						op_stack->push_int(1);
 					}
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "meet FLOAT_NAN. then ";
 #endif
 				} else if (val1 < val2) {
-					op_stack.push(new IntOop(-1));
+					op_stack->push_int(-1);
 				} else if (val1 > val2) {
-					op_stack.push(new IntOop(1));
+					op_stack->push_int(1);
 				} else {
-					op_stack.push(new IntOop(0));
+					op_stack->push_int(0);
 				}
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "push [" << ((IntOop *)op_stack.top())->value << "] onto the stack." << std::endl;
+	sync_wcout{} << "push [" << op_stack->top_int() << "] onto the stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x97:		// dcmpl
-			case 0x98:{		// dcmpg
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::DOUBLE);
-				double val2 = ((DoubleOop*)op_stack.top())->value; op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::DOUBLE);
-				double val1 = ((DoubleOop*)op_stack.top())->value; op_stack.pop();
+			OPCODE(0x97):		// dcmpl
+			OPCODE(0x98):{		// dcmpg
+				double val2 = op_stack->pop_double();
+				double val1 = op_stack->pop_double();
 
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) ";
 #endif
 				if (val1 == DOUBLE_NAN || val2 == DOUBLE_NAN) {
 					if (*pc == 0x97) {
-						op_stack.push(new IntOop(-1));
+						op_stack->push_int(-1);
 					} else {
-						op_stack.push(new IntOop(1));
+						op_stack->push_int(1);
 					}
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "meet DOUBLE_NAN. then ";
 #endif
 				} else if (val1 < val2) {
-					op_stack.push(new IntOop(-1));
+					op_stack->push_int(-1);
 				} else if (val1 > val2) {
-					op_stack.push(new IntOop(1));
+					op_stack->push_int(1);
 				} else {
-					op_stack.push(new IntOop(0));
+					op_stack->push_int(0);
 				}
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "push [" << ((IntOop *)op_stack.top())->value << "] onto the stack." << std::endl;
+	sync_wcout{} << "push [" << op_stack->top_int() << "] onto the stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0x99:		// ifeq
-			case 0x9a:		// ifne
-			case 0x9b:		// iflt
-			case 0x9c:		// ifge
-			case 0x9d:		// ifgt
-			case 0x9e:{		// ifle
+			OPCODE(0x99):		// ifeq
+			OPCODE(0x9a):		// ifne
+			OPCODE(0x9b):		// iflt
+			OPCODE(0x9c):		// ifge
+			OPCODE(0x9d):		// ifgt
+			OPCODE(0x9e):{		// ifle
 				short branch_pc = ((pc[1] << 8) | pc[2]);
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int int_value = ((IntOop*)op_stack.top())->value;	op_stack.pop();
+				int int_value = op_stack->pop_int();
 				bool judge;
 				if (*pc == 0x99) {
 					judge = (int_value == 0);
@@ -2904,25 +3298,24 @@ Oop * BytecodeEngine::execute(vm_thread & thread, StackFrame & cur_frame, int th
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) int value is " << int_value << ", so will jump to: <bytecode>: $" << std::dec << (pc - code_begin + occupied) << std::endl;
 #endif
+					if (branch_pc <= 0)	BACKEDGE();
 				} else {		// if false, go next.
 					// do nothing
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) int value is " << int_value << ", so will go next." << std::endl;
 #endif
 				}
-				break;
-			}
-			case 0x9f:		// if_icmpeq
-			case 0xa0:		// if_icmpne
-			case 0xa1:		// if_icmplt
-			case 0xa2:		// if_icmpge
-			case 0xa3:		// if_icmpgt
-			case 0xa4:{		// if_icmple
+				NEXT_BYTECODE;
+			}
+			OPCODE(0x9f):		// if_icmpeq
+			OPCODE(0xa0):		// if_icmpne
+			OPCODE(0xa1):		// if_icmplt
+			OPCODE(0xa2):		// if_icmpge
+			OPCODE(0xa3):		// if_icmpgt
+			OPCODE(0xa4):{		// if_icmple
 				short branch_pc = ((pc[1] << 8) | pc[2]);
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int value2 = ((IntOop*)op_stack.top())->value;	op_stack.pop();
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int value1 = ((IntOop*)op_stack.top())->value;	op_stack.pop();
+				int value2 = op_stack->pop_int();
+				int value1 = op_stack->pop_int();
 				bool judge;
 				if (*pc == 0x9f) {
 					judge = (value1 == value2);
@@ -2944,19 +3337,20 @@ Oop * BytecodeEngine::execute(vm_thread & thread, StackFrame & cur_frame, int th
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) int value compare from stack is " << value2 << " and " << value1 << ", so will jump to: <bytecode>: $" << std::dec << (pc - code_begin + occupied) << std::endl;
 #endif
+					if (branch_pc <= 0)	BACKEDGE();
 				} else {		// if false, go next.
 					// do nothing
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) int value compare from stack is " << value2 << " and " << value1 << ", so will go next." << std::endl;
 #endif
 				}
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0xa5:		// if_acmpeq		// compare the address
-			case 0xa6:{		// if_acmpne
+			OPCODE(0xa5):		// if_acmpeq		// compare the address
+			OPCODE(0xa6):{		// if_acmpne
 				short branch_pc = ((pc[1] << 8) | pc[2]);
-				Oop *value2 = op_stack.top();	op_stack.pop();
-				Oop *value1 = op_stack.top();	op_stack.pop();
+				Oop *value2 = op_stack->top();	op_stack->pop();
+				Oop *value1 = op_stack->top();	op_stack->pop();
 				bool judge;
 				if (*pc == 0xa5) {
 					judge = (value1 == value2);
@@ -2970,26 +3364,28 @@ Oop * BytecodeEngine::execute(vm_thread & thread, StackFrame & cur_frame, int th
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) ref value compare from stack is " << value2 << " and " << value1 << ", so will jump to: <bytecode>: $" << std::dec << (pc - code_begin + occupied) << std::endl;
 #endif
+					if (branch_pc <= 0)	BACKEDGE();
 				} else {		// if false, go next.
 					// do nothing
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) ref value compare from stack is " << value2 << " and " << value1 << ", so will go next." << std::endl;
 #endif
 				}
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0xa7:{		// goto
+			OPCODE(0xa7):{		// goto
 				short branch_pc = ((pc[1] << 8) | pc[2]);
 				pc += branch_pc;
 				pc -= occupied;
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) will [goto]: <bytecode>: $" << std::dec << (pc - code_begin + occupied) << std::endl;
 #endif
-				break;
+				if (branch_pc <= 0)	BACKEDGE();
+				NEXT_BYTECODE;
 			}
 
 
-			case 0xaa:{		// tableswitch
+			OPCODE(0xaa):{		// tableswitch
 				int bc_num = pc - code_begin;
 				uint8_t *code = code_begin;
 				int origin_bc_num = bc_num;
@@ -3016,8 +3412,7 @@ Oop * BytecodeEngine::execute(vm_thread & thread, StackFrame & cur_frame, int th
 				}
 				jump_tbl.push_back(defaultbyte + origin_bc_num);		// `default`
 				// jump begin~
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int key = ((IntOop *)op_stack.top())->value;
+				int key = op_stack->pop_int();
 				if (key > (int)jump_tbl.size() - 1 + lowbyte || key < lowbyte) {
 //					std::wcout << jump_tbl.size() - 1 + lowbyte << " " << lowbyte << " " << key << std::endl;		// delete
 //					std::wcout << std::boolalpha << (key > jump_tbl.size() - 1 + lowbyte) << " " << (key < lowbyte) << std::endl;		// delete
@@ -3034,9 +3429,9 @@ Oop * BytecodeEngine::execute(vm_thread & thread, StackFrame & cur_frame, int th
 	sync_wcout{} << "(DEBUG) it is [tableswitch] switch(" << key << ") {...}, so will jump to: <bytecode>: $" << std::dec << (pc - code_begin + occupied) << std::endl;
 #endif
 				}
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0xab:{		// lookupswitch
+			OPCODE(0xab):{		// lookupswitch
 				int bc_num = pc - code_begin;
 				uint8_t *code = code_begin;
 				int origin_bc_num = bc_num;
@@ -3060,8 +3455,7 @@ Oop * BytecodeEngine::execute(vm_thread & thread, StackFrame & cur_frame, int th
 				}
 				jump_tbl.insert(make_pair(INT_MAX, defaultbyte + origin_bc_num));
 				// jump begin~
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
-				int key = ((IntOop *)op_stack.top())->value;
+				int key = op_stack->pop_int();
 				auto iter = jump_tbl.find(key);
 				if (iter == jump_tbl.end()) {
 					pc = (code_begin + jump_tbl[INT_MAX]);
@@ -3076,56 +3470,82 @@ Oop * BytecodeEngine::execute(vm_thread & thread, StackFrame & cur_frame, int th
 	sync_wcout{} << "(DEBUG) it is [lookupswitch] switch(" << key << ") {...}, so will jump to: <bytecode>: $" << std::dec << (pc - code_begin + occupied) << std::endl;
 #endif
 				}
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0xac:{		// ireturn
-				thread.pc = backup_pc;
-				sync_wcout::set_switch(backup_switch);
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::INT);
+			OPCODE(0xac):{		// ireturn
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) return an int value from stack: "<< ((IntOop*)op_stack.top())->value << std::endl;
+	sync_wcout{} << "(DEBUG) return an int value from stack: "<< op_stack->top_int() << std::endl;
 	sync_wcout{} << "[Now, get out of StackFrame #" << std::dec << thread.vm_stack.size() - 1 << "]..." << std::endl;
 #endif
-				return new IntOop(((IntOop *)op_stack.top())->value);	// boolean, short, char, int
+				SAFEPOINT_POLL();		// before the return value is popped.
+				int value = op_stack->pop_int();
+				if (cur_frame == &entry_frame) {		// return to the vm: box it.
+					thread.pc = backup_pc;
+					sync_wcout::set_switch(backup_switch);
+					return new IntOop(value);	// boolean, short, char, int
+				}
+				LEAVE_FRAME();		// leave first: the return value may overwrite the callee's frame.
+				op_stack->push_int(value);
+				RESUME_COMPILED();
+				NEXT_BYTECODE;
 			}
-			case 0xad:{		// lreturn
-				thread.pc = backup_pc;
-				sync_wcout::set_switch(backup_switch);
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::LONG);
+			OPCODE(0xad):{		// lreturn
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) return an long value from stack: "<< ((LongOop*)op_stack.top())->value << std::endl;
+	sync_wcout{} << "(DEBUG) return an long value from stack: "<< op_stack->top_long() << std::endl;
 	sync_wcout{} << "[Now, get out of StackFrame #" << std::dec << thread.vm_stack.size() - 1 << "]..." << std::endl;
 #endif
-				return new LongOop(((LongOop *)op_stack.top())->value);	// long
+				SAFEPOINT_POLL();
+				long value = op_stack->pop_long();
+				if (cur_frame == &entry_frame) {		// return to the vm: box it.
+					thread.pc = backup_pc;
+					sync_wcout::set_switch(backup_switch);
+					return new LongOop(value);	// long
+				}
+				LEAVE_FRAME();		// leave first: the return value may overwrite the callee's frame.
+				op_stack->push_long(value);
+				RESUME_COMPILED();
+				NEXT_BYTECODE;
 			}
 
 
-			case 0xae:{		// freturn
-				thread.pc = backup_pc;
-				sync_wcout::set_switch(backup_switch);
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::FLOAT);
+			OPCODE(0xae):{		// freturn
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) return an float value from stack: "<< ((FloatOop*)op_stack.top())->value << "f" << std::endl;
+	sync_wcout{} << "(DEBUG) return an float value from stack: "<< op_stack->top_float() << "f" << std::endl;
 	sync_wcout{} << "[Now, get out of StackFrame #" << std::dec << thread.vm_stack.size() - 1 << "]..." << std::endl;
 #endif
-				return new FloatOop(((FloatOop *)op_stack.top())->value);	// float
+				SAFEPOINT_POLL();
+				float value = op_stack->pop_float();
+				if (cur_frame == &entry_frame) {		// return to the vm: box it.
+					thread.pc = backup_pc;
+					sync_wcout::set_switch(backup_switch);
+					return new FloatOop(value);	// float
+				}
+				LEAVE_FRAME();		// leave first: the return value may overwrite the callee's frame.
+				op_stack->push_float(value);
+				RESUME_COMPILED();
+				NEXT_BYTECODE;
 			}
-			case 0xaf:{		// dreturn
-				thread.pc = backup_pc;
-				sync_wcout::set_switch(backup_switch);
-				assert(op_stack.top()->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)op_stack.top())->get_type() == Type::DOUBLE);
+			OPCODE(0xaf):{		// dreturn
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) return an double value from stack: "<< ((DoubleOop*)op_stack.top())->value << "ld"<< std::endl;
+	sync_wcout{} << "(DEBUG) return an double value from stack: "<< op_stack->top_double() << "ld"<< std::endl;
 	sync_wcout{} << "[Now, get out of StackFrame #" << std::dec << thread.vm_stack.size() - 1 << "]..." << std::endl;
 #endif
-				return new DoubleOop(((DoubleOop *)op_stack.top())->value);	// double
+				SAFEPOINT_POLL();
+				double value = op_stack->pop_double();
+				if (cur_frame == &entry_frame) {		// return to the vm: box it.
+					thread.pc = backup_pc;
+					sync_wcout::set_switch(backup_switch);
+					return new DoubleOop(value);	// double
+				}
+				LEAVE_FRAME();		// leave first: the return value may overwrite the callee's frame.
+				op_stack->push_double(value);
+				RESUME_COMPILED();
+				NEXT_BYTECODE;
 			}
 
 
-			case 0xb0:{		// areturn
-				thread.pc = backup_pc;
-				sync_wcout::set_switch(backup_switch);
-				Oop *oop = op_stack.top();	op_stack.pop();
+			OPCODE(0xb0):{		// areturn
+				Oop *oop = op_stack->top();	op_stack->pop();
 #ifdef BYTECODE_DEBUG
 	if (oop != 0) {
 		sync_wcout{} << "(DEBUG) return an ref from stack: <class>:" << oop->get_klass()->get_name() <<  ", address: "<< std::hex << oop << std::endl;
@@ -3135,75 +3555,146 @@ Oop * BytecodeEngine::execute(vm_thread & thread, StackFrame & cur_frame, int th
 		sync_wcout{} << "(DEBUG) return an ref null from stack: <class>:" << code_method->return_type() <<  std::endl;
 	sync_wcout{} << "[Now, get out of StackFrame #" << std::dec << thread.vm_stack.size() - 1 << "]..." << std::endl;
 #endif
+				SAFEPOINT_POLL();
 //				assert(method->return_type() == oop->get_klass()->get_name());
-				return oop;	// boolean, short, char, int
+				if (cur_frame == &entry_frame) {
+					thread.pc = backup_pc;
+					sync_wcout::set_switch(backup_switch);
+					return oop;
+				}
+				LEAVE_FRAME();
+				op_stack->push(oop);
+				RESUME_COMPILED();
+				NEXT_BYTECODE;
 			}
-			case 0xb1:{		// return
-				// TODO: monitor...
-				thread.pc = backup_pc;
-				sync_wcout::set_switch(backup_switch);
+			OPCODE(0xb1):{		// return
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) only return." << std::endl;
 	sync_wcout{} << "[Now, get out of StackFrame #" << std::dec << thread.vm_stack.size() - 1 << "]..." << std::endl;
 #endif
-				return nullptr;
+				SAFEPOINT_POLL();
+				if (cur_frame == &entry_frame) {
+					thread.pc = backup_pc;
+					sync_wcout::set_switch(backup_switch);
+					return nullptr;
+				}
+				LEAVE_FRAME();
+				RESUME_COMPILED();
+				NEXT_BYTECODE;
 			}
-			case 0xb2:{		// getStatic
+			OPCODE(0xb2):{		// getStatic
 				int rtpool_index = ((pc[1] << 8) | pc[2]);
-				assert(rt_pool[rtpool_index-1].first == CONSTANT_Fieldref);
-				auto new_field = boost::any_cast<Field_info *>(rt_pool[rtpool_index-1].second);
+				assert((*rt_pool)[rtpool_index-1].first == CONSTANT_Fieldref);
+				rt_cache_entry entry;
+				entry.tag = CONSTANT_Fieldref;
+				entry.field = boost::any_cast<Field_info *>((*rt_pool)[rtpool_index-1].second);
 
-				getStatic(new_field, op_stack, thread);
+				getStatic(entry.field, *op_stack, thread);
 
-				break;
+				if (is_static_initialized(entry.field)) {		// then <clinit> needn't be checked any more.
+					rt_pool->quicken(pc, FAST_GETSTATIC, rtpool_index-1, entry);
+				}
+				NEXT_BYTECODE;
+			}
+			OPCODE(0xce):{		// fast_getstatic
+				int rtpool_index = ((pc[1] << 8) | pc[2]);
+				getStatic(rt_pool->cache_at(rtpool_index-1).field, *op_stack, thread, false);
+				NEXT_BYTECODE;
 			}
-			case 0xb3:{		// putStatic
+			OPCODE(0xb3):{		// putStatic
 				int rtpool_index = ((pc[1] << 8) | pc[2]);
-				assert(rt_pool[rtpool_index-1].first == CONSTANT_Fieldref);
-				auto new_field = boost::any_cast<Field_info *>(rt_pool[rtpool_index-1].second);
+				assert((*rt_pool)[rtpool_index-1].first == CONSTANT_Fieldref);
+				rt_cache_entry entry;
+				entry.tag = CONSTANT_Fieldref;
+				entry.field = boost::any_cast<Field_info *>((*rt_pool)[rtpool_index-1].second);
 
-				putStatic(new_field, op_stack, thread);
+				putStatic(entry.field, *op_stack, thread);
 
-				break;
+				if (is_static_initialized(entry.field)) {
+					rt_pool->quicken(pc, FAST_PUTSTATIC, rtpool_index-1, entry);
+				}
+				NEXT_BYTECODE;
+			}
+			OPCODE(0xcf):{		// fast_putstatic
+				int rtpool_index = ((pc[1] << 8) | pc[2]);
+				putStatic(rt_pool->cache_at(rtpool_index-1).field, *op_stack, thread, false);
+				NEXT_BYTECODE;
 			}
-			case 0xb4:{		// getField
+			OPCODE(0xb4):{		// getField
 				int rtpool_index = ((pc[1] << 8) | pc[2]);
-				assert(rt_pool[rtpool_index-1].first == CONSTANT_Fieldref);
-				auto new_field = boost::any_cast<Field_info *>(rt_pool[rtpool_index-1].second);
+				assert((*rt_pool)[rtpool_index-1].first == CONSTANT_Fieldref);
+				rt_cache_entry entry;
+				entry.tag = CONSTANT_Fieldref;
+				entry.field = boost::any_cast<Field_info *>((*rt_pool)[rtpool_index-1].second);
 
-				getField(new_field, op_stack);
+				getField(entry.field, *op_stack);
 
-				break;
+				rt_pool->quicken(pc, FAST_GETFIELD, rtpool_index-1, entry);
+				NEXT_BYTECODE;
+			}
+			OPCODE(0xd0):{		// fast_getfield
+				int rtpool_index = ((pc[1] << 8) | pc[2]);
+				getField(rt_pool->cache_at(rtpool_index-1).field, *op_stack);
+				NEXT_BYTECODE;
 			}
-			case 0xb5:{		// putField
+			OPCODE(0xb5):{		// putField
 				int rtpool_index = ((pc[1] << 8) | pc[2]);
-				assert(rt_pool[rtpool_index-1].first == CONSTANT_Fieldref);
-				auto new_field = boost::any_cast<Field_info *>(rt_pool[rtpool_index-1].second);
+				assert((*rt_pool)[rtpool_index-1].first == CONSTANT_Fieldref);
+				rt_cache_entry entry;
+				entry.tag = CONSTANT_Fieldref;
+				entry.field = boost::any_cast<Field_info *>((*rt_pool)[rtpool_index-1].second);
 
-				putField(new_field, op_stack);
+				putField(entry.field, *op_stack);
 
-				break;
+				rt_pool->quicken(pc, FAST_PUTFIELD, rtpool_index-1, entry);
+				NEXT_BYTECODE;
+			}
+			OPCODE(0xd1):{		// fast_putfield
+				int rtpool_index = ((pc[1] << 8) | pc[2]);
+				putField(rt_pool->cache_at(rtpool_index-1).field, *op_stack);
+				NEXT_BYTECODE;
 			}
-			case 0xb6:		// invokeVirtual
-			case 0xb9:{		// invokeInterface
+			OPCODE(0xb6):		// invokeVirtual
+			OPCODE(0xb9):		// invokeInterface
+			OPCODE(0xd2):		// fast_invokevirtual
+			OPCODE(0xd5):{		// fast_invokeinterface
 				int rtpool_index = ((pc[1] << 8) | pc[2]);	// if is `invokeInterface`: pc[3] && pc[4] deprecated.
-				if (*pc == 0xb6) {
-					assert(rt_pool[rtpool_index-1].first == CONSTANT_Methodref);
+				uint8_t java_bytecode = (bytecode == 0xb6 || bytecode == FAST_INVOKEVIRTUAL) ? 0xb6 : 0xb9;
+				Method *new_method;
+				if (bytecode == FAST_INVOKEVIRTUAL || bytecode == FAST_INVOKEINTERFACE) {
+					new_method = rt_pool->cache_at(rtpool_index-1).method;
 				} else {
-					assert(rt_pool[rtpool_index-1].first == CONSTANT_InterfaceMethodref);
+					rt_cache_entry entry;
+					entry.tag = (*rt_pool)[rtpool_index-1].first;
+					if (bytecode == 0xb6) {
+						assert(entry.tag == CONSTANT_Methodref);
+					} else {
+						assert(entry.tag == CONSTANT_InterfaceMethodref);
+					}
+					new_method = entry.method = boost::any_cast<Method *>((*rt_pool)[rtpool_index-1].second);
+					// the Method is resolved. quicken before invoking, so that the recursive calls can use it too.
+					rt_pool->quicken(pc, (bytecode == 0xb6) ? FAST_INVOKEVIRTUAL : FAST_INVOKEINTERFACE, rtpool_index-1, entry);
+				}
+
+				StackFrame *new_frame = invokeVirtual(new_method, *op_stack, thread, *cur_frame, pc, java_bytecode);
+				if (new_frame != nullptr) {		// an interpreted callee: run it in this loop.
+					ENTER_FRAME(new_frame);
+					NEXT_BYTECODE;
 				}
-				auto new_method = boost::any_cast<Method *>(rt_pool[rtpool_index-1].second);
 
-				invokeVirtual(new_method, op_stack, thread, cur_frame, pc);
+				// a native callee may have taken the vm reserve. its return value is on the stack, so this is a safepoint.
+				if (MemAlloc::out_of_memory_pending() && !cur_frame->has_exception && check_pending_out_of_memory(*op_stack, thread)) {
+					goto exception_handler;
+				}
 
 				// **IMPORTANT** judge whether returns an Exception!!!
-				if (cur_frame.has_exception/* && !new_method->is_void()*/) {
-					Oop *top = op_stack.top();
+				if (cur_frame->has_exception/* && !new_method->is_void()*/) {
+					Oop *top = op_stack->top();
 					if (top != nullptr && top->get_ooptype() != OopType::_BasicTypeOop && top->get_klass()->get_type() == ClassType::InstanceClass) {
 						auto klass = ((InstanceKlass *)top->get_klass());
 						auto throwable_klass = ((InstanceKlass *)BootStrapClassLoader::get_bootstrap().loadClass(L"java/lang/Throwable"));
 						if (klass == throwable_klass || klass->check_parent(throwable_klass)) {
-							cur_frame.has_exception = false;		// clear the mark because finding the catcher~
+							cur_frame->has_exception = false;		// clear the mark because finding the catcher~
 #ifdef BYTECODE_DEBUG
 sync_wcout{} << "(DEBUG) find the last frame's exception: [" << klass->get_name() << "]. will goto exception_handler!" << std::endl;
 #endif
@@ -3215,26 +3706,47 @@ sync_wcout{} << "(DEBUG) find the last frame's exception: [" << klass->get_name(
 						assert(false);
 					}
 				}
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0xb7:		// invokeSpecial
-			case 0xb8:{		// invokeStatic
+			OPCODE(0xb7):		// invokeSpecial
+			OPCODE(0xb8):		// invokeStatic
+			OPCODE(0xd3):		// fast_invokespecial
+			OPCODE(0xd4):{		// fast_invokestatic
 				int rtpool_index = ((pc[1] << 8) | pc[2]);
-				assert(rt_pool[rtpool_index-1].first == CONSTANT_Methodref);
-				auto new_method = boost::any_cast<Method *>(rt_pool[rtpool_index-1].second);
+				StackFrame *new_frame;
+				if (bytecode == FAST_INVOKESPECIAL || bytecode == FAST_INVOKESTATIC) {
+					new_frame = invokeStatic(rt_pool->cache_at(rtpool_index-1).method, *op_stack, thread, *cur_frame, pc, (bytecode == FAST_INVOKESPECIAL) ? 0xb7 : 0xb8, false);
+				} else {
+					assert((*rt_pool)[rtpool_index-1].first == CONSTANT_Methodref);
+					rt_cache_entry entry;
+					entry.tag = CONSTANT_Methodref;
+					entry.method = boost::any_cast<Method *>((*rt_pool)[rtpool_index-1].second);
+					// `invokeStatic` will run the <clinit> first. after that, if the class is initialized, quicken it.
+					new_frame = invokeStatic(entry.method, *op_stack, thread, *cur_frame, pc, bytecode);
+					if (entry.method->get_klass()->get_state() == Klass::KlassState::Initialized) {
+						rt_pool->quicken(pc, (bytecode == 0xb7) ? FAST_INVOKESPECIAL : FAST_INVOKESTATIC, rtpool_index-1, entry);
+					}
+				}
+				if (new_frame != nullptr) {		// an interpreted callee: run it in this loop.
+					ENTER_FRAME(new_frame);
+					NEXT_BYTECODE;
+				}
 
-				invokeStatic(new_method, op_stack, thread, cur_frame, pc);
+				// a native callee may have taken the vm reserve. its return value is on the stack, so this is a safepoint.
+				if (MemAlloc::out_of_memory_pending() && !cur_frame->has_exception && check_pending_out_of_memory(*op_stack, thread)) {
+					goto exception_handler;
+				}
 
 				// **IMPORTANT** judge whether returns an Exception!!!
-				if (cur_frame.has_exception/* && !new_method->is_void()*/) {
-					Oop *top = op_stack.top();
+				if (cur_frame->has_exception/* && !new_method->is_void()*/) {
+					Oop *top = op_stack->top();
 					if (top != nullptr && top->get_ooptype() != OopType::_BasicTypeOop && top->get_klass()->get_type() == ClassType::InstanceClass) {
 						auto klass = ((InstanceKlass *)top->get_klass());
 						auto throwable_klass = ((InstanceKlass *)BootStrapClassLoader::get_bootstrap().loadClass(L"java/lang/Throwable"));
 						if (klass == throwable_klass || klass->check_parent(throwable_klass)) {
-							cur_frame.has_exception = false;
+							cur_frame->has_exception = false;		// clear the mark because finding the catcher~
 #ifdef BYTECODE_DEBUG
-	sync_wcout{} << "(DEBUG) find the last frame's exception: [" << klass->get_name() << "]. will goto exception_handler!" << std::endl;
+sync_wcout{} << "(DEBUG) find the last frame's exception: [" << klass->get_name() << "]. will goto exception_handler!" << std::endl;
 #endif
 							goto exception_handler;
 						} else {
@@ -3245,14 +3757,14 @@ sync_wcout{} << "(DEBUG) find the last frame's exception: [" << klass->get_name(
 					}
 				}
 
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0xba:{		// invokeDynamic
+			OPCODE(0xba):{		// invokeDynamic
 				int rtpool_index = ((pc[1] << 8) | pc[2]);
 				assert(pc[3] == 0 && pc[4] == 0);		// default.
-				assert(rt_pool[rtpool_index-1].first == CONSTANT_InvokeDynamic);
+				assert((*rt_pool)[rtpool_index-1].first == CONSTANT_InvokeDynamic);
 				// 1. get CONSTANT_InvokeDynamic_info:
-				pair<int, int> invokedynamic_pair = boost::any_cast<pair<int, int>>(rt_pool[rtpool_index-1].second);
+				pair<int, int> invokedynamic_pair = boost::any_cast<pair<int, int>>((*rt_pool)[rtpool_index-1].second);
 				// 2. get BootStrapMethod table from `code_klass`!!
 				auto bm = code_klass->get_bm();
 				assert(bm != nullptr);		// in invokeDynamic already, `bm` must not be nullptr!!
@@ -3262,113 +3774,117 @@ sync_wcout{} << "(DEBUG) find the last frame's exception: [" << klass->get_name(
 				auto & fake_method_struct = bm->bootstrap_methods[bootstrap_method_index];	// struct BootstrapMethods_attribute::bootstrap_methods_t
 				// 4. using `CONSTANT_invokeDynamic_info` to get target NameAndType index and Name && Type
 				int name_and_type_index = invokedynamic_pair.second;
-				assert(rt_pool[name_and_type_index-1].first == CONSTANT_NameAndType);
-				pair<int, int> nameAndType_pair = boost::any_cast<pair<int, int>>(rt_pool[name_and_type_index-1].second);
-				assert(rt_pool[nameAndType_pair.first-1].first == CONSTANT_Utf8);
-				assert(rt_pool[nameAndType_pair.second-1].first == CONSTANT_Utf8);
-				wstring name = boost::any_cast<wstring>(rt_pool[nameAndType_pair.first-1].second);					// run
-				wstring type_descriptor = boost::any_cast<wstring>(rt_pool[nameAndType_pair.second-1].second);		// ()Ljava/lang/Runnable;
+				assert((*rt_pool)[name_and_type_index-1].first == CONSTANT_NameAndType);
+				pair<int, int> nameAndType_pair = boost::any_cast<pair<int, int>>((*rt_pool)[name_and_type_index-1].second);
+				assert((*rt_pool)[nameAndType_pair.first-1].first == CONSTANT_Utf8);
+				assert((*rt_pool)[nameAndType_pair.second-1].first == CONSTANT_Utf8);
+				wstring name = boost::any_cast<wstring>((*rt_pool)[nameAndType_pair.first-1].second);					// run
+				wstring type_descriptor = boost::any_cast<wstring>((*rt_pool)[nameAndType_pair.second-1].second);		// ()Ljava/lang/Runnable;
 //				std::wcout << name << " " << type_descriptor << std::endl;	// delete
 				// 5. get CONSTANT_MethodHandle_info and arguments from the struct above:
 				// 5-[0] MethodHandle(real)	// 这个 MethodHandle 包含了一个 `java/lang/invoke/LambdaMetafactory.metafactory(...)` 方法。
-				assert(rt_pool[fake_method_struct.bootstrap_method_ref-1].first == CONSTANT_MethodHandle);
-				InstanceOop *method_handle_obj = MethodHandle_make(rt_pool, fake_method_struct.bootstrap_method_ref-1, thread, true);
-				// 5-[1] Arguments
-				list<Oop *> callsite_args;
-				// 5-[1]-[0] make the $0: MethodHandles.Lookup(caller) and add it to the callsite_args
-				InstanceOop *lookup_obj = MethodHandles_Lookup_make(thread);
-				callsite_args.push_back(lookup_obj);
-				// 5-[1]-[1] make the $1: String: get the `invokedynamic` real target method name. like: `run`, and add it to the callsite_args
-				callsite_args.push_back(java_lang_string::intern(name));
-				// 5-[1]-[2] make the $2: MethodType: get the `invokedynamic` real target method descripor like: `:()java/lang/Runnable`, and add it to the callsite_args
-				callsite_args.push_back(MethodType_make(type_descriptor, thread));
-				// 5-[1]-[3] make the remain [4~n) arguments
-				for (int i = 0; i < fake_method_struct.num_bootstrap_arguments; i ++) {
-					int arg_index = fake_method_struct.bootstrap_arguments[i];
-					pair<int, boost::any> _pair = rt_pool[arg_index-1];
+				// all the oops of the bootstrap are held in handles: every step runs java, and a gc there moves them.
+				InstanceOop *final_invoker_MethodHandle;
+				{
+					HandleMark hm(thread);
+					assert((*rt_pool)[fake_method_struct.bootstrap_method_ref-1].first == CONSTANT_MethodHandle);
+					Handle method_handle_obj(thread, MethodHandle_make(*rt_pool, fake_method_struct.bootstrap_method_ref-1, thread, true));
+					// 5-[1] Arguments
+					vector<Handle> callsite_args;
+					// 5-[1]-[0] make the $0: MethodHandles.Lookup(caller) and add it to the callsite_args
+					callsite_args.push_back(Handle(thread, MethodHandles_Lookup_make(thread)));
+					// 5-[1]-[1] make the $1: String: get the `invokedynamic` real target method name. like: `run`, and add it to the callsite_args
+					callsite_args.push_back(Handle(thread, java_lang_string::intern(name)));
+					// 5-[1]-[2] make the $2: MethodType: get the `invokedynamic` real target method descripor like: `:()java/lang/Runnable`, and add it to the callsite_args
+					callsite_args.push_back(Handle(thread, MethodType_make(type_descriptor, thread)));
+					// 5-[1]-[3] make the remain [4~n) arguments
+					for (int i = 0; i < fake_method_struct.num_bootstrap_arguments; i ++) {
+						int arg_index = fake_method_struct.bootstrap_arguments[i];
+						pair<int, boost::any> _pair = (*rt_pool)[arg_index-1];
 //					std::wcout << _pair.first << std::endl;		// delete
-					switch(_pair.first) {
-						case CONSTANT_String:{
-							callsite_args.push_back(boost::any_cast<Oop *>(_pair.second));
-							break;
-						}
-						case CONSTANT_Class:{
-							callsite_args.push_back(boost::any_cast<Klass *>(_pair.second)->get_mirror());
-							break;
-						}
-						case CONSTANT_Integer:{
-							callsite_args.push_back(new IntOop(boost::any_cast<int>(_pair.second)));
-							break;
-						}
-						case CONSTANT_Float:{
-							callsite_args.push_back(new FloatOop(boost::any_cast<float>(_pair.second)));
-							break;
-						}
-						case CONSTANT_Long:{
-							callsite_args.push_back(new LongOop(boost::any_cast<long>(_pair.second)));
-							break;
-						}
-						case CONSTANT_Double:{
-							callsite_args.push_back(new DoubleOop(boost::any_cast<double>(_pair.second)));
-							break;
-						}
-						case CONSTANT_MethodHandle:{
-							callsite_args.push_back(MethodHandle_make(rt_pool, arg_index-1, thread));
+						switch(_pair.first) {
+							case CONSTANT_String:{
+								callsite_args.push_back(Handle(thread, boost::any_cast<Oop *>(_pair.second)));
+								break;
+							}
+							case CONSTANT_Class:{
+								callsite_args.push_back(Handle(thread, boost::any_cast<Klass *>(_pair.second)->get_mirror()));
+								break;
+							}
+							case CONSTANT_Integer:{
+								callsite_args.push_back(Handle(thread, new IntOop(boost::any_cast<int>(_pair.second))));
+								break;
+							}
+							case CONSTANT_Float:{
+								callsite_args.push_back(Handle(thread, new FloatOop(boost::any_cast<float>(_pair.second))));
+								break;
+							}
+							case CONSTANT_Long:{
+								callsite_args.push_back(Handle(thread, new LongOop(boost::any_cast<long>(_pair.second))));
+								break;
+							}
+							case CONSTANT_Double:{
+								callsite_args.push_back(Handle(thread, new DoubleOop(boost::any_cast<double>(_pair.second))));
+								break;
+							}
+							case CONSTANT_MethodHandle:{
+								callsite_args.push_back(Handle(thread, MethodHandle_make(*rt_pool, arg_index-1, thread)));
 //							Oop *temp;																	// delete
 //							((InstanceOop *)callsite_args.back())->get_field_value(DIRECTMETHODHANDLE ":member:" MN, &temp);	// delete
 //							std::wcout << toString((InstanceOop *)temp, &thread) << std::endl;			// delete
-							break;
-						}
-						case CONSTANT_MethodType:{
-							wstring method_type_descriptor = boost::any_cast<wstring>(_pair.second);
-							callsite_args.push_back(MethodType_make(method_type_descriptor, thread));
-							break;
-						}
-						default:{
-							assert(false);
+								break;
+							}
+							case CONSTANT_MethodType:{
+								wstring method_type_descriptor = boost::any_cast<wstring>(_pair.second);
+								callsite_args.push_back(Handle(thread, MethodType_make(method_type_descriptor, thread)));
+								break;
+							}
+							default:{
+								assert(false);
+							}
 						}
 					}
-				}
-				// 6. make all arguments into a Java List<T>!!
-				auto arrayList_klass = ((InstanceKlass *)BootStrapClassLoader::get_bootstrap().loadClass(L"java/util/ArrayList"));
-				assert(arrayList_klass != nullptr);
-				auto arrayList_init_method = arrayList_klass->get_this_class_method(L"<init>:()V");
-				auto arrayList_add_method = arrayList_klass->get_this_class_method(L"add:(" OBJ ")Z");
-				assert(arrayList_init_method != nullptr && arrayList_add_method != nullptr);
-				auto arrayList_obj = arrayList_klass->new_instance();
-				// 6-0. do ArrayList.<init>:()V!
-				thread.add_frame_and_execute(arrayList_init_method, {arrayList_obj});
-				// 6-1. do ArrayList.add() for all oop in callsite_args!
-				for (Oop *oop : callsite_args) {
-					Oop *result = thread.add_frame_and_execute(arrayList_add_method, {arrayList_obj, oop});
-					assert((bool)((IntOop *)result)->value == true);		// return success.
-				}
-				// 7. get the CallSite obj using `MethodHanle.invokeArguments(List<T>)!!
-				// 7-1. get method `invokeArguments`
-				auto invokeArguments_method = ((InstanceKlass *)method_handle_obj->get_klass())
-						->search_vtable(L"invokeWithArguments:(" LST ")" OBJ);		// `method_handle_obj` may be a child of klass `MethodHandle`. so should `search_vtable()`.
-				assert(invokeArguments_method != nullptr);
-				// 8. get the CallSite !!
-				InstanceOop *callsite = (InstanceOop *)thread.add_frame_and_execute(invokeArguments_method, {method_handle_obj, arrayList_obj});
-				assert(callsite != nullptr);
+					// 6. make all arguments into a Java List<T>!!
+					auto arrayList_klass = ((InstanceKlass *)BootStrapClassLoader::get_bootstrap().loadClass(L"java/util/ArrayList"));
+					assert(arrayList_klass != nullptr);
+					auto arrayList_init_method = arrayList_klass->get_this_class_method(L"<init>:()V");
+					auto arrayList_add_method = arrayList_klass->get_this_class_method(L"add:(" OBJ ")Z");
+					assert(arrayList_init_method != nullptr && arrayList_add_method != nullptr);
+					Handle arrayList_obj(thread, arrayList_klass->new_instance());
+					// 6-0. do ArrayList.<init>:()V!
+					thread.add_frame_and_execute(arrayList_init_method, {arrayList_obj()});
+					// 6-1. do ArrayList.add() for all oop in callsite_args!
+					for (const Handle & arg : callsite_args) {
+						Oop *result = thread.add_frame_and_execute(arrayList_add_method, {arrayList_obj(), arg()});
+						assert((bool)((IntOop *)result)->value == true);		// return success.
+					}
+					// 7. get the CallSite obj using `MethodHanle.invokeArguments(List<T>)!!
+					// 7-1. get method `invokeArguments`
+					auto invokeArguments_method = ((InstanceKlass *)method_handle_obj()->get_klass())
+							->search_vtable(L"invokeWithArguments:(" LST ")" OBJ);		// `method_handle_obj` may be a child of klass `MethodHandle`. so should `search_vtable()`.
+					assert(invokeArguments_method != nullptr);
+					// 8. get the CallSite !!
+					InstanceOop *callsite = (InstanceOop *)thread.add_frame_and_execute(invokeArguments_method, {method_handle_obj(), arrayList_obj()});
+					assert(callsite != nullptr);
 //				std::wcout << toString(callsite, &thread) << std::endl;		// delete
+					// 9-3. change CallSite to a MethodHandle invoker! using `CallSite.dynamicInvoker()`.
+					auto callsite_dynamicInvoker_method = ((InstanceKlass *)callsite->get_klass())
+							->search_vtable(L"dynamicInvoker:()" MH);		// It is an abstract Method.
+					assert(callsite_dynamicInvoker_method != nullptr);
+					final_invoker_MethodHandle = (InstanceOop *)thread.add_frame_and_execute(callsite_dynamicInvoker_method, {callsite});
+					assert(final_invoker_MethodHandle != nullptr);
+				}
 				// 9. get the `invokedynamic` real target method arguments size.
 				// 9-1. get other argument size.
 				int size = Method::parse_argument_list(type_descriptor).size();		// **ATTENTION** no need to add `this` !!
-				// 9-3. change CallSite to a MethodHandle invoker! using `CallSite.dynamicInvoker()`.
-				auto callsite_dynamicInvoker_method = ((InstanceKlass *)callsite->get_klass())
-						->search_vtable(L"dynamicInvoker:()" MH);		// It is an abstract Method.
-				assert(callsite_dynamicInvoker_method != nullptr);
-				auto final_invoker_MethodHandle = (InstanceOop *)thread.add_frame_and_execute(callsite_dynamicInvoker_method, {callsite});
-				assert(final_invoker_MethodHandle != nullptr);
 				// 10. fill in the arguments.		// TODO: call natives, throw exceptions
+				vector<wchar_t> arg_kinds;
+				int arg_slot_num;
+				wchar_t ret_kind = Method::parse_descriptor_kinds(type_descriptor, arg_kinds, arg_slot_num);
+				assert(arg_kinds.size() == size);
 				list<Oop *> arg_list;
-				assert(op_stack.size() >= size);
-				while (size > 0) {
-					arg_list.push_front(op_stack.top());
-					op_stack.pop();
-					size --;
-				}
+				assert(op_stack->size() >= arg_slot_num);
+				pop_args_boxed(*op_stack, arg_kinds, arg_list);
 				// 12. get the invokeExact Method in MH.
 				auto invokeExact_method = ((InstanceKlass *)final_invoker_MethodHandle->get_klass())
 										->search_vtable(L"invokeExact:([" OBJ ")" OBJ);
@@ -3379,11 +3895,13 @@ sync_wcout{} << "(DEBUG) find the last frame's exception: [" << klass->get_name(
 				JVM_InvokeExact(arg_list);
 				InstanceOop *ret_oop = (InstanceOop *)arg_list.back();
 
-				// 14. put it into op_stack.
-				op_stack.push(ret_oop);
+				// 14. put it into op_stack->
+				if (ret_kind != L'V') {
+					unbox_to_slot(*op_stack, ret_oop, ret_kind);
+				}
 
 				// 15. check return type....
-				if (ret_oop != nullptr) {
+				if (ret_oop != nullptr && ret_kind == L'L') {
 					InstanceKlass *ret_klass = ((InstanceKlass *)ret_oop->get_klass());
 					MirrorOop *ret_mirror = Method::parse_return_type(Method::return_type(type_descriptor));
 					InstanceKlass *ret_klass_should_be = ((InstanceKlass *)ret_mirror->get_mirrored_who());
@@ -3392,157 +3910,187 @@ sync_wcout{} << "(DEBUG) find the last frame's exception: [" << klass->get_name(
 					}
 				}
 
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0xbb:{		// new // only malloc
+			OPCODE(0xbb):{		// new // only malloc
 				int rtpool_index = ((pc[1] << 8) | pc[2]);
-				assert(rt_pool[rtpool_index-1].first == CONSTANT_Class);
-				auto klass = boost::any_cast<Klass *>(rt_pool[rtpool_index-1].second);
+				assert((*rt_pool)[rtpool_index-1].first == CONSTANT_Class);
+				auto klass = boost::any_cast<Klass *>((*rt_pool)[rtpool_index-1].second);
 				assert(klass->get_type() == ClassType::InstanceClass);
 				auto real_klass = ((InstanceKlass *)klass);
+				SAFEPOINT_POLL();
 				// if didnt init then init
 				initial_clinit(real_klass, thread);
-				auto oop = real_klass->new_instance();
-				op_stack.push(oop);
+				auto oop = real_klass->try_new_instance();
+				if (oop == nullptr) {
+					ALLOCATION_FAILED();
+				}
+				allocation_retried = false;
+				op_stack->push(oop);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) new an object (only alloc memory): <class>: [" << klass->get_name() <<"], at address: [" << oop << "]." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0xbc:{		// newarray
+			OPCODE(0xbc):{		// newarray
+				SAFEPOINT_POLL();
 				int arr_type = pc[1];
-				int length = ((IntOop *)op_stack.top())->value;	op_stack.pop();
+				int length = op_stack->pop_int();
 				if (length < 0) {
 					std::cerr << "array length can't be negative!!" << std::endl;
 					assert(false);
 				}
 				wstring for_debug;
+				ArrayOop *array = nullptr;
 				switch (arr_type) {
 					case T_BOOLEAN:
 						assert(system_classmap.find(L"[Z.class") != system_classmap.end());
-						op_stack.push(((TypeArrayKlass *)system_classmap[L"[Z.class"])->new_instance(length));
+						array = ((TypeArrayKlass *)system_classmap[L"[Z.class"])->try_new_instance(length);
 						for_debug = L"[Z";
 						break;
 					case T_CHAR:
 						assert(system_classmap.find(L"[C.class") != system_classmap.end());
-						op_stack.push(((TypeArrayKlass *)system_classmap[L"[C.class"])->new_instance(length));
+						array = ((TypeArrayKlass *)system_classmap[L"[C.class"])->try_new_instance(length);
 						for_debug = L"[C";
 						break;
 					case T_FLOAT:
 						assert(system_classmap.find(L"[F.class") != system_classmap.end());
-						op_stack.push(((TypeArrayKlass *)system_classmap[L"[F.class"])->new_instance(length));
+						array = ((TypeArrayKlass *)system_classmap[L"[F.class"])->try_new_instance(length);
 						for_debug = L"[F";
 						break;
 					case T_DOUBLE:
 						assert(system_classmap.find(L"[D.class") != system_classmap.end());
-						op_stack.push(((TypeArrayKlass *)system_classmap[L"[D.class"])->new_instance(length));
+						array = ((TypeArrayKlass *)system_classmap[L"[D.class"])->try_new_instance(length);
 						for_debug = L"[D";
 						break;
 					case T_BYTE:
 						assert(system_classmap.find(L"[B.class") != system_classmap.end());
-						op_stack.push(((TypeArrayKlass *)system_classmap[L"[B.class"])->new_instance(length));
+						array = ((TypeArrayKlass *)system_classmap[L"[B.class"])->try_new_instance(length);
 						for_debug = L"[B";
 						break;
 					case T_SHORT:
 						assert(system_classmap.find(L"[S.class") != system_classmap.end());
-						op_stack.push(((TypeArrayKlass *)system_classmap[L"[S.class"])->new_instance(length));
+						array = ((TypeArrayKlass *)system_classmap[L"[S.class"])->try_new_instance(length);
 						for_debug = L"[S";
 						break;
 					case T_INT:
 						assert(system_classmap.find(L"[I.class") != system_classmap.end());
-						op_stack.push(((TypeArrayKlass *)system_classmap[L"[I.class"])->new_instance(length));
+						array = ((TypeArrayKlass *)system_classmap[L"[I.class"])->try_new_instance(length);
 						for_debug = L"[I";
 						break;
 					case T_LONG:
 						assert(system_classmap.find(L"[J.class") != system_classmap.end());
-						op_stack.push(((TypeArrayKlass *)system_classmap[L"[J.class"])->new_instance(length));
+						array = ((TypeArrayKlass *)system_classmap[L"[J.class"])->try_new_instance(length);
 						for_debug = L"[J";
 						break;
 					default:{
 						assert(false);
 					}
 				}
+				if (array == nullptr) {
+					op_stack->push_int(length);
+					ALLOCATION_FAILED();
+				}
+				allocation_retried = false;
+				op_stack->push(array);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) new a basic type array ---> " << for_debug << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0xbd:{		// anewarray		// one dimemsion
+			OPCODE(0xbd):{		// anewarray		// one dimemsion
+				SAFEPOINT_POLL();
 				int rtpool_index = ((pc[1] << 8) | pc[2]);
-				int length = ((IntOop *)op_stack.top())->value;	op_stack.pop();
+				int length = op_stack->pop_int();
 				if (length < 0) {
 					std::cerr << "array length can't be negative!!" << std::endl;
 					assert(false);
 				}
-				assert(rt_pool[rtpool_index-1].first == CONSTANT_Class);
-				auto klass = boost::any_cast<Klass *>(rt_pool[rtpool_index-1].second);
+				assert((*rt_pool)[rtpool_index-1].first == CONSTANT_Class);
+				auto klass = boost::any_cast<Klass *>((*rt_pool)[rtpool_index-1].second);
+				ArrayOop *array = nullptr;
 				if (klass->get_type() == ClassType::InstanceClass) {			// java/lang/Class
 					auto real_klass = ((InstanceKlass *)klass);
 					if (real_klass->get_classloader() == nullptr) {
 						auto arr_klass = ((ObjArrayKlass *)BootStrapClassLoader::get_bootstrap().loadClass(L"[L" + real_klass->get_name() + L";"));
 						assert(arr_klass->get_type() == ClassType::ObjArrayClass);
-						op_stack.push(arr_klass->new_instance(length));
+						array = arr_klass->try_new_instance(length);
 					} else {
 						auto arr_klass = ((ObjArrayKlass *)real_klass->get_classloader()->loadClass(L"[L" + real_klass->get_name() + L";"));
 						assert(arr_klass->get_type() == ClassType::ObjArrayClass);
-						op_stack.push(arr_klass->new_instance(length));
+						array = arr_klass->try_new_instance(length);
 					}
 				} else if (klass->get_type() == ClassType::ObjArrayClass) {	// [Ljava/lang/Class
 					auto real_klass = ((ObjArrayKlass *)klass);
 					if (real_klass->get_element_klass()->get_classloader() == nullptr) {
 						auto arr_klass = ((ObjArrayKlass *)BootStrapClassLoader::get_bootstrap().loadClass(L"[" + real_klass->get_name()));
 						assert(arr_klass->get_type() == ClassType::ObjArrayClass);
-						op_stack.push(arr_klass->new_instance(length));
+						array = arr_klass->try_new_instance(length);
 					} else {
 						auto arr_klass = ((ObjArrayKlass *)real_klass->get_element_klass()->get_classloader()->loadClass(L"[" + real_klass->get_name()));
 						assert(arr_klass->get_type() == ClassType::ObjArrayClass);
-						op_stack.push(arr_klass->new_instance(length));
+						array = arr_klass->try_new_instance(length);
 					}
 				} else if (klass->get_type() == ClassType::TypeArrayClass) {	// [[I --> will new an [[[I. e.g.: int[][][] = { {{1,2,3},{4,5}}, {{1},{2}}, {{1},{2}} };
 					auto real_klass = ((TypeArrayKlass *)klass);
 					auto arr_klass = ((ObjArrayKlass *)BootStrapClassLoader::get_bootstrap().loadClass(L"[" + real_klass->get_name()));
 					assert(arr_klass->get_type() == ClassType::TypeArrayClass);
-					op_stack.push(arr_klass->new_instance(length));
+					array = arr_klass->try_new_instance(length);
 				} else {
 					assert(false);
 				}
+				if (array == nullptr) {
+					op_stack->push_int(length);
+					ALLOCATION_FAILED();
+				}
+				allocation_retried = false;
+				op_stack->push(array);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) new an array[] of class: <class>: " << klass->get_name() << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0xbe:{		// arraylength
-				ArrayOop *array = (ArrayOop *)op_stack.top();	op_stack.pop();
+			OPCODE(0xbe):{		// arraylength
+				ArrayOop *array = (ArrayOop *)op_stack->top();	op_stack->pop();
 				assert(array->get_ooptype() == OopType::_ObjArrayOop || array->get_ooptype() == OopType::_TypeArrayOop);
-				op_stack.push(new IntOop(array->get_length()));
+				op_stack->push_int(array->get_length());
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) put array: (element type) " << array->get_klass()->get_name() << " (dimension) " << array->get_dimension() << " 's length: [" << array->get_length() << "] onto the stack." << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0xbf:{		// athrow
+			OPCODE(0xbf):{		// athrow
 	exception_handler:
-				InstanceOop *exception_obj = (InstanceOop *)op_stack.top();	op_stack.pop();
+				InstanceOop *exception_obj = (InstanceOop *)op_stack->top();	op_stack->pop();
 				auto excp_klass = ((InstanceKlass *)exception_obj->get_klass());
 
 				// backtrace ONLY this stack.
-				int jump_pc = cur_frame.method->where_is_catch(pc - code_begin, excp_klass);
+				int jump_pc = cur_frame->method->where_is_catch(pc - code_begin, excp_klass);
 				if (jump_pc != 0) {	// this frame has the handler, what ever the `catch_handler` or `finally handler`.
 					pc = code_begin + jump_pc - occupied;		// jump to this handler pc!
 					// then clean up all the op_stack, and push `exception_obj` on it !!!
-					stack<Oop *>().swap(op_stack);
+					op_stack->clear();
 					// add it on!
-					op_stack.push(exception_obj);
+					op_stack->push(exception_obj);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) [athrow] this frame has the catcher, and the pc is [" << jump_pc << "]!" << std::endl;
 #endif
-					break;	// go to the handler~
+					NEXT_BYTECODE;	// go to the handler~
 				} else {				// this frame cannot handle the exception!
 					// make `cur_frame` lose effectiveness!
 					// I think only should take this method: return an `Exception` oop, and judge at the last StackFrame's `invokeVirtual`.etc.
 					// then If the last frame find an `Exception` oop has been pushed, then it will directly `GOTO` the `athrow` instruct.
+					if (cur_frame != &entry_frame) {		// the caller runs in this loop: unwind to it, and look for the catcher at its invoke bytecode.
+#ifdef BYTECODE_DEBUG
+	sync_wcout{} << "(DEBUG) [athrow] this frame doesn't has the catcher. unwind to the caller frame." << std::endl;
+	sync_wcout{} << "[Now, get out of StackFrame #" << std::dec << thread.vm_stack.size() - 1 << "]..." << std::endl;
+#endif
+						LEAVE_FRAME();
+						op_stack->push(exception_obj);
+						goto exception_handler;
+					}
 					thread.pc = backup_pc;
-					assert(&cur_frame == &thread.vm_stack.back());
+					assert(cur_frame == &thread.vm_stack.back());
 					if (thread.vm_stack.size() == 1) {	// if cur_frame is the last...
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) [athrow] TERMINALED because of exception!!!" << std::endl;
@@ -3563,9 +4111,7 @@ sync_wcout{} << "(DEBUG) find the last frame's exception: [" << klass->get_name(
 							}
 							wind_jvm::num_lock().unlock();
 
-//							pthread_mutex_lock(&_all_thread_wait_mutex);
-							thread.state = Death;
-//							pthread_mutex_unlock(&_all_thread_wait_mutex);
+							Safepoint::set_dead(&thread);
 
 							pthread_exit(nullptr);		// Spec points out only exit this exception-thread is okay.
 
@@ -3576,9 +4122,7 @@ sync_wcout{} << "(DEBUG) find the last frame's exception: [" << klass->get_name(
 						}
 
 					} else {
-						auto iter = thread.vm_stack.rbegin();
-						++iter;							// get cur_frame's prev...
-						iter->has_exception = true;
+						cur_frame->link->has_exception = true;		// get cur_frame's prev...
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) [athrow] this frame doesn't has the catcher, or it's native method. so we should go to the last frame!" << std::endl;
 	sync_wcout{} << "[Now, get out of StackFrame #" << std::dec << thread.vm_stack.size() - 1 << "]..." << std::endl;
@@ -3587,35 +4131,35 @@ sync_wcout{} << "(DEBUG) find the last frame's exception: [" << klass->get_name(
 					return exception_obj;
 				}
 
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0xc0:		// checkcast
-			case 0xc1:{		// instanceof
+			OPCODE(0xc0):		// checkcast
+			OPCODE(0xc1):{		// instanceof
 				// TODO: paper...
 				int rtpool_index = ((pc[1] << 8) | pc[2]);
-				assert(rt_pool[rtpool_index-1].first == CONSTANT_Class);
-				auto klass = boost::any_cast<Klass *>(rt_pool[rtpool_index-1].second);		// constant_pool index
+				assert((*rt_pool)[rtpool_index-1].first == CONSTANT_Class);
+				auto klass = boost::any_cast<Klass *>((*rt_pool)[rtpool_index-1].second);		// constant_pool index
 				// 1. first get the ref and find if it is null
-				Oop *ref = op_stack.top();
+				Oop *ref = op_stack->top();
 				if (*pc == 0xc1) {
-					op_stack.pop();
+					op_stack->pop();
 				}
 				if (ref == 0) {
 					// if this is 0xc0, re-push and break.
 					if (*pc == 0xc1) {
-						op_stack.push(new IntOop(0));
+						op_stack->push_int(0);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) So push 1 onto the stack." << std::endl;
 #endif
 					}
 //					else							// bug...
-//						op_stack.push(ref);		// re-push.		// "op_stack will not change if op_stack's top is null."
+//						op_stack->push(ref);		// re-push.		// "op_stack will not change if op_stack's top is null."
 					else {
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) ref is null. So checkcast do nothing." << std::endl;
 #endif
 					}
-					break;
+					NEXT_BYTECODE;
 				}
 				// 2. if ref is not null, judge its type
 				auto ref_klass = ref->get_klass();													// op_stack top ref's klass
@@ -3623,7 +4167,7 @@ sync_wcout{} << "(DEBUG) find the last frame's exception: [" << klass->get_name(
 				// 3. push result
 				if (result == true) {
 					if (*pc == 0xc1) {
-						op_stack.push(new IntOop(1));
+						op_stack->push_int(1);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) So push 1 onto the stack." << std::endl;
 #endif
@@ -3631,7 +4175,7 @@ sync_wcout{} << "(DEBUG) find the last frame's exception: [" << klass->get_name(
 					// else `checkcast` do nothing.
 				} else {
 					if (*pc == 0xc1) {
-						op_stack.push(new IntOop(0));
+						op_stack->push_int(0);
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) So push 0 onto the stack." << std::endl;
 #endif
@@ -3641,20 +4185,20 @@ sync_wcout{} << "(DEBUG) find the last frame's exception: [" << klass->get_name(
 						assert(false);
 					}
 				}
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0xc2:{		// monitorenter
-				Oop *ref_value = op_stack.top();	op_stack.pop();
-				assert(ref_value != nullptr);		// TODO: NullptrException
+			OPCODE(0xc2):{		// monitorenter
+				assert(op_stack->top() != nullptr);		// TODO: NullptrException
 				thread.monitor_inc();
-				ref_value->enter_monitor();
+				op_stack->top()->enter_monitor();		// still on the stack: the gc may move it while this thread is blocked.
+				Oop *ref_value = op_stack->top();	op_stack->pop();
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) Monitor enter into obj of class:[" << ref_value->get_klass()->get_name() << "], address: [" << ref_value << "]" << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0xc3:{		// monitorexit
-				Oop *ref_value = op_stack.top();	op_stack.pop();
+			OPCODE(0xc3):{		// monitorexit
+				Oop *ref_value = op_stack->top();	op_stack->pop();
 				assert(ref_value != nullptr);		// TODO: NullptrException
 				// TODO: IllegalMonitorStateException...
 				thread.monitor_dec();
@@ -3662,29 +4206,30 @@ sync_wcout{} << "(DEBUG) find the last frame's exception: [" << klass->get_name(
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) Monitor exit from obj of class:[" << ref_value->get_klass()->get_name() << "], address: [" << ref_value << "]" << std::endl;
 #endif
-				break;
+				NEXT_BYTECODE;
 			}
 
 
-			case 0xc5:{		// multianewarray
+			OPCODE(0xc5):{		// multianewarray
+				SAFEPOINT_POLL();
 				int rtpool_index = ((pc[1] << 8) | pc[2]);
 				int dimensions = pc[3];
 				assert(dimensions > 0);
 				std::deque<int> counts;
 				for (int i = 0; i < dimensions; i ++) {
-					Oop *count = op_stack.top();	op_stack.pop();
-					assert(count->get_ooptype() == OopType::_BasicTypeOop && ((BasicTypeOop *)count)->get_type() == Type::INT);
-					if (((IntOop *)count)->value < 0) {
+					int count = op_stack->pop_int();
+					if (count < 0) {
 						std::wcerr << "array length can't be negative!!" << std::endl;
 						assert(false);
 					}
-					counts.push_front(((IntOop *)count)->value);
+					counts.push_front(count);
 				}
 
-				// lambda to recursively create a multianewarray::
+				// lambda to recursively create a multianewarray:: nullptr if the heap is full.
 				function<Oop *(ArrayKlass *, int)> recursive_create_multianewarray = [&counts, &recursive_create_multianewarray](ArrayKlass *arr_klass, int index) -> Oop *{
 					// 1. new an multianewarray, which length is counts[index]!! ( counts[0] first )
-					auto arr_obj = arr_klass->new_instance(counts[index]);
+					auto arr_obj = arr_klass->try_new_instance(counts[index]);
+					if (arr_obj == nullptr)	return nullptr;
 					// 2-a. if this is the last dimension(1), then return.
 					if (index == counts.size() - 1) {
 						assert(arr_klass->get_dimension() == 1);		// or judge with this is okay.
@@ -3695,14 +4240,17 @@ sync_wcout{} << "(DEBUG) find the last frame's exception: [" << klass->get_name(
 					assert(inner_arr_klass != nullptr);
 					// 3. fill in every element in this `fake multiarray`, which is really one dimension..
 					for (int i = 0; i < arr_obj->get_length(); i ++) {
-						(*arr_obj)[i] = recursive_create_multianewarray(inner_arr_klass, index + 1);
+						Oop *inner_arr_obj = recursive_create_multianewarray(inner_arr_klass, index + 1);
+						if (inner_arr_obj == nullptr)	return nullptr;		// the outer ones are garbage.
+						(*arr_obj)[i] = inner_arr_obj;
 					}
 					return arr_obj;
 				};
 
 
-				assert(rt_pool[rtpool_index-1].first == CONSTANT_Class);
-				auto klass = boost::any_cast<Klass *>(rt_pool[rtpool_index-1].second);
+				assert((*rt_pool)[rtpool_index-1].first == CONSTANT_Class);
+				auto klass = boost::any_cast<Klass *>((*rt_pool)[rtpool_index-1].second);
+				Oop *array = nullptr;
 
 				if (klass->get_type() == ClassType::InstanceClass) {			// e.g.: java/lang/Class
 					assert(false);		// TODO: I think here, spec is wrong. can't be InstanceKlass really.
@@ -3711,7 +4259,7 @@ sync_wcout{} << "(DEBUG) find the last frame's exception: [" << klass->get_name(
 					assert(arr_klass->get_type() == ClassType::ObjArrayClass);
 					assert(arr_klass->get_dimension() == dimensions);	// I think must be equal here!
 
-					op_stack.push(recursive_create_multianewarray(arr_klass, 0));
+					array = recursive_create_multianewarray(arr_klass, 0);
 
 #ifdef BYTECODE_DEBUG
 	sync_wcout{} << "(DEBUG) new an multianewarray: [" << arr_klass->get_name() << "]." << std::endl;
@@ -3721,17 +4269,23 @@ sync_wcout{} << "(DEBUG) find the last frame's exception: [" << klass->get_name(
 					assert(arr_klass->get_type() == ClassType::TypeArrayClass);
 					assert(arr_klass->get_dimension() == dimensions);	// I think must be equal here!
 
-					op_stack.push(recursive_create_multianewarray(arr_klass, 0));
+					array = recursive_create_multianewarray(arr_klass, 0);
 				} else {
 					assert(false);
 				}
+				if (array == nullptr) {
+					for (int count : counts)	op_stack->push_int(count);
+					ALLOCATION_FAILED();
+				}
+				allocation_retried = false;
+				op_stack->push(array);
 
-				break;
+				NEXT_BYTECODE;
 			}
-			case 0xc6:		// ifnull
-			case 0xc7:{		// ifnonnull
+			OPCODE(0xc6):		// ifnull
+			OPCODE(0xc7):{		// ifnonnull
 				short branch_pc = ((pc[1] << 8) | pc[2]);
-				Oop *ref_value = op_stack.top();	op_stack.pop();
+				Oop *ref_value = op_stack->top();	op_stack->pop();
 				bool result;
 				if (*pc == 0xc6) {
 					result = (ref_value == nullptr) ? true : false;
@@ -3748,6 +4302,7 @@ sync_wcout{} << "(DEBUG) find the last frame's exception: [" << klass->get_name(
 	if (*pc == 0xc7)	sync_wcout{} << "not ";
 	sync_wcout{} << "null. will jump to: <bytecode>: $" << std::dec << (pc - code_begin + occupied) << std::endl;
 #endif
+					if (branch_pc <= 0)	BACKEDGE();
 				} else {		// if null, go next.
 					// do nothing
 #ifdef BYTECODE_DEBUG
@@ -3759,16 +4314,22 @@ sync_wcout{} << "(DEBUG) find the last frame's exception: [" << klass->get_name(
 	sync_wcout{} << "null. will go next." << std::endl;
 #endif
 				}
-				break;
+				NEXT_BYTECODE;
 			}
 
 
 			default:
+#ifdef COMPUTED_GOTO_DISPATCH
+			op_default:
+#endif
 				std::cerr << "doesn't support bytecode " << bccode_map[*pc].first << " now..." << std::endl;
 				assert(false);
 		}
 		pc += occupied;
 	}
+#ifdef COMPUTED_GOTO_DISPATCH
+execute_end:
+#endif
 
 	return nullptr;
 }
@@ -13,6 +13,7 @@
 #include "runtime/bytecodeEngine.hpp"
 #include <string>
 #include "utils/synchronize_wcout.hpp"
+#include "utils/utils.hpp"
 
 using std::make_pair;
 using std::wstring;
@@ -190,3 +191,31 @@ const pair<int, boost::any> & rt_constant_pool::if_didnt_parse_then_parse(int i)
 	}
 	return this->pool[i];
 }
+
+wstring rt_constant_pool::symbolic_descriptor(int index)
+{
+	int name_and_type_index;
+	if (bufs[index]->tag == CONSTANT_InvokeDynamic) {
+		name_and_type_index = ((CONSTANT_InvokeDynamic_info *)bufs[index])->name_and_type_index;
+	} else {
+		assert(bufs[index]->tag == CONSTANT_Fieldref || bufs[index]->tag == CONSTANT_Methodref || bufs[index]->tag == CONSTANT_InterfaceMethodref);
+		name_and_type_index = ((CONSTANT_FMI_info *)bufs[index])->name_and_type_index;
+	}
+	auto name_type_ptr = (CONSTANT_NameAndType_info *)bufs[name_and_type_index-1];
+	return ((CONSTANT_Utf8_info *)bufs[name_type_ptr->descriptor_index-1])->convert_to_Unicode();
+}
+
+void rt_constant_pool::quicken(uint8_t *pc, uint8_t fast_bytecode, int index, const rt_cache_entry & entry)
+{
+	assert(index >= 0 && index < cache.size() && entry.tag != 0);
+	LockGuard lg(quicken_lock);
+	// the same entry may be shared by many bytecodes. only the first one fills it, so a reader never sees it being written.
+	if (cache[index].tag == 0) {
+		cache[index] = entry;
+	}
+	// publish: a thread which reads the fast bytecode (with acquire) must see the entry above.
+	__atomic_store_n(pc, fast_bytecode, __ATOMIC_RELEASE);
+#ifdef DEBUG
+	sync_wcout{} << "quicken bytecode to [" << utf8_to_wstring(bccode_map[fast_bytecode].first) << "] with constant pool #" << index + 1 << std::endl;
+#endif
+}
@@ -9,15 +9,27 @@
 #include "runtime/oop.hpp"
 #include "runtime/klass.hpp"
 #include "runtime/thread.hpp"
+#include "runtime/safepoint.hpp"
+#include "runtime/gc_log.hpp"
+#include "runtime/heap_dump.hpp"
+#include "runtime/string_dedup.hpp"
+#include "runtime/reference_processor.hpp"
 #include "wind_jvm.hpp"
 #include "classloader.hpp"
 #include "native/java_lang_Class.hpp"
 #include "native/java_lang_String.hpp"
 #include "utils/utils.hpp"
+#include "utils/vm_options.hpp"
 #include <sched.h>
+#include <unistd.h>
+#include <signal.h>
+#include <climits>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
 
 
-bool GC::init_gc()
+bool GC::init_gc(const wchar_t *cause)
 {
 	LockGuard lg(gc_lock());
 	// 1. set gc bit
@@ -25,70 +37,84 @@ bool GC::init_gc()
 		return false;
 	}
 	gc() = true;
+	gc_cause() = cause;
+	Safepoint::begin();			// arm the polls of all the threads.
 	// 2. [x] snapshot canceled.
 	// 3. signal gc thread:
-	std::wcout << "signal gc..." << std::endl;			// delete
+	pthread_mutex_lock(&gc_cond_mutex());
+	gc_signalled() = true;
 	pthread_cond_signal(&gc_cond());
-	// 4. print some message...
-	ThreadTable::print_table();							// delete
-	sync_wcout{} << "init_gc() over." << std::endl;		// delete
+	pthread_mutex_unlock(&gc_cond_mutex());
 	return true;
 }
 
-void GC::detect_ready()
+void GC::collect_for_allocation(vm_thread *thread, size_t size)
 {
-//	int i = 0;		// delete
-	while (true) {
-		LockGuard lg(gc_lock());
-
-		int total_ready_num = 0;
-		int total_size;
-
-//		i ++;		// delete
-
-		ThreadTable::get_lock().lock();
-		{
-			total_size = ThreadTable::get_thread_table().size();
-			for (auto & iter : ThreadTable::get_thread_table()) {
-
-//				pthread_mutex_lock(&_all_thread_wait_mutex);		// bug report: dead lock bug from: wind_jvm.cpp::wait_cur_thread().
-				thread_state state = std::get<2>(iter.second)->state;
-//				pthread_mutex_unlock(&_all_thread_wait_mutex);
-
-				if (state == Waiting || state == Death/*iter.second == false && iter.first->vm_stack.size() == 0*/) {
-					total_ready_num ++;
-				} else {
-					break;
-				}
-			}
-		}
-		ThreadTable::get_lock().unlock();
-
-		ThreadTable::print_table();		// delete
+	// the caller has no oop in its c++ locals: it is at a safepoint as at a poll.
+	int count = collections().load();
+	allocation_request() = std::max(allocation_request().load(), size);
+	full_gc_requested() = true;
+	while (collections().load() == count) {
+		init_gc(L"Heap Exhausted");		// false: a pause is on the way already, and it will see the request.
+		Safepoint::block(thread);
+	}
+}
 
-		if (total_ready_num == total_size) {		// over!
-			return;
-		}
+void GC::detect_ready()
+{
+	double time_to_safepoint = Safepoint::synchronize();
+	LockGuard lg(stats_lock());
+	stats().safepoints ++;
+	stats().time_to_safepoint_total_ms += time_to_safepoint;
+	stats().time_to_safepoint_max_ms = std::max(stats().time_to_safepoint_max_ms, time_to_safepoint);
+	stats().last_time_to_safepoint_ms = time_to_safepoint;
+}
 
-//		if (i == 1000) {		// delete
-//			assert(false);
-//		}
+template <typename Func>
+void GC::phase(const wchar_t *name, Func func)
+{
+	auto start = std::chrono::steady_clock::now();
+	func();
+	std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+	pause().phases.push_back(make_pair(name, time.count()));
+}
 
-		sched_yield();
+void GC::init_workers()
+{
+	int worker_num = VMOptions::parallel_gc_threads_for((int)sysconf(_SC_NPROCESSORS_ONLN));
+	for (int i = 0; i < worker_num; i ++) {
+		worker_states().push_back(new GCWorkerState);
+		worker_states().back()->seed = i + 1;
 	}
+	GCWorkers::init(worker_num);
+}
+
+void GC::unlock_gc_cond_mutex(void *)
+{
+	pthread_mutex_unlock(&gc_cond_mutex());
 }
 
 void *GC::gc_thread(void *)
 {
-	// init `cond` and `mutex` first:
-	pthread_cond_init(&gc_cond(), nullptr);
-	pthread_mutex_init(&gc_cond_mutex(), nullptr);
+	init_workers();
+	// the concurrent thread doesn't take the signals of the vm either.
+	sigset_t set, old_set;
+	sigfillset(&set);
+	pthread_sigmask(SIG_BLOCK, &set, &old_set);
+	pthread_t concurrent_tid;
+	pthread_create(&concurrent_tid, nullptr, concurrent_thread, nullptr);
+	pthread_detach(concurrent_tid);
+	pthread_sigmask(SIG_SETMASK, &old_set, nullptr);
 
 	while (true) {
 
 		pthread_mutex_lock(&gc_cond_mutex());
-		pthread_cond_wait(&gc_cond(), &gc_cond_mutex());
-		pthread_mutex_unlock(&gc_cond_mutex());
+		pthread_cleanup_push(unlock_gc_cond_mutex, nullptr);
+		while (!gc_signalled()) {
+			pthread_cond_wait(&gc_cond(), &gc_cond_mutex());
+		}
+		gc_signalled() = false;
+		pthread_cleanup_pop(1);
 
 		detect_ready();
 
@@ -97,45 +123,33 @@ void *GC::gc_thread(void *)
 
 }
 
-void GC::recursive_add_oop_and_its_inner_oops_and_modify_pointers_by_the_way(Oop * const & origin_oop, unordered_map<Oop *, Oop *> & new_oop_map)
+/**
+ * calls `func(Oop * & ref)` for every reference slot in `oop`: the reference fields of an InstanceOop (the primitives are
+ * inline values), but the one at `skip_offset` (the referent of a discovered Reference), and the elements of an array of references.
+ */
+template <typename Func>
+static void oop_iterate(Oop *oop, Func func, int skip_offset = -1)
 {
-	if (origin_oop == nullptr)	return;
-
-	auto iter = new_oop_map.find(origin_oop);			// find the origin_oop has been migrated ? or not ?
-	if (iter != new_oop_map.end()) {
-		const_cast<Oop *&>(origin_oop) = iter->second;
-		return;			// has been in the set already. substitute and return.
-	}
+	if (oop->get_ooptype() == OopType::_BasicTypeOop) {
 
-	Oop *new_oop = Mempool::copy(*origin_oop);			// should copy the origin in next several conditions.
-	new_oop_map.insert(make_pair(origin_oop, new_oop));	// should add to the new_oop_map in next several conditions.
-	const_cast<Oop *&>(origin_oop) = new_oop;
-
-	if (origin_oop->get_ooptype() == OopType::_BasicTypeOop) {
-
-		// only substitute this oop is okay.
+		// no inner oops.
 		return;
 
-	} else if (origin_oop->get_ooptype() == OopType::_InstanceOop) {
+	} else if (oop->get_ooptype() == OopType::_InstanceOop) {
 
-		// next, add its inner member variables!
-		for (auto & iter : ((InstanceOop *)new_oop)->fields) {		// use `&` to modify.
-			// if need, substitute the pointer in origin... to the new pointer.
-//			std::wcout << iter << " to ";		// delete
-			recursive_add_oop_and_its_inner_oops_and_modify_pointers_by_the_way(iter, new_oop_map);		// recursively substitute and add into.
-//			std::wcout << iter << std::endl;		// delete
+		for (int offset : ((InstanceKlass *)oop->get_klass())->get_oop_fields_offsets()) {
+			if (offset == skip_offset)	continue;
+			func(((InstanceOop *)oop)->field_at<Oop *>(offset));
 		}
 		return;
 
+	} else if ((oop->get_ooptype() == OopType::_ObjArrayOop) || (oop->get_ooptype() == OopType::_TypeArrayOop)) {
 
-	} else if ((origin_oop->get_ooptype() == OopType::_ObjArrayOop) || (origin_oop->get_ooptype() == OopType::_TypeArrayOop)) {
-
-		// add this oop and its inner elements!
-		for (auto & iter : ((ArrayOop *)new_oop)->buf) {
-			// if need, substitute the pointer in origin... to the new pointer.
-//			std::wcout << iter << " to ";		// delete
-			recursive_add_oop_and_its_inner_oops_and_modify_pointers_by_the_way(iter, new_oop_map);		// recursively substitute and add into.
-//			std::wcout << iter << std::endl;		// delete
+		ArrayOop *arr = (ArrayOop *)oop;
+		if (arr->has_ref_elems()) {		// (the raw basic type array has none.)
+			for (int i = 0; i < arr->get_length(); i ++) {
+				func((*arr)[i]);
+			}
 		}
 		return;
 
@@ -144,8 +158,98 @@ void GC::recursive_add_oop_and_its_inner_oops_and_modify_pointers_by_the_way(Oop
 	}
 }
 
-void GC::klass_inner_oop_gc(Klass *klass, unordered_map<Oop *, Oop *> & new_oop_map)
+void GC::forward(Oop * & ref)
+{
+	// only the young oops move. the old ones are collected in place.
+	if (ref == nullptr || !Heap::is_in_young(ref))	return;
+	if (Heap::is_in_to_survivor(ref))	return;			// a root slot visited twice: substituted already.
+
+	size_t header = Heap::load_header(ref);
+	Oop *copy = (Oop *)Heap::forwardee_of(header);		// has the ref been copied ? or not ?
+	if (copy == nullptr) {
+		// survived one more minor gc: into the to-survivor space, or, old enough or no room there, promoted into the old generation.
+		// every worker copies into its own plabs. the one which installs the forwarding address with the CAS wins, the others give their copies back.
+		GCWorkerState *self = current_worker();
+		size_t size = (header & Heap::SIZE_MASK) - Heap::HEADER_SIZE;
+		unsigned age = (unsigned)(header >> Heap::AGE_SHIFT) + 1;
+		Tlab *plab = &self->survivor_plab;
+		void *buf = (age < Heap::MAX_TENURING_THRESHOLD) ? Heap::allocate_in_survivor(*plab, size, age) : nullptr;
+		if (buf == nullptr) {
+			plab = &self->old_plab;
+			buf = Heap::allocate_in_old(*plab, size);
+		}
+		if (buf == nullptr) {
+			plab = &self->survivor_plab;
+			buf = Heap::allocate_in_survivor(*plab, size, age);
+		}
+		if (buf == nullptr) {
+			// promotion failure: the object stays where it is, forwarded to itself, and is scanned like a copy. the pause goes
+			// on, and the next one collects the whole heap. see: `Heap::end_minor_gc()`.
+			copy = (Oop *)Heap::par_forward_to(ref, header, ref);
+			if (copy == ref) {
+				self->self_forwarded.push_back(make_pair((void *)ref, header));
+				self->queue.push(ref);
+			}
+			ref = copy;
+			return;
+		}
+		Oop *new_copy = Mempool::copy(*ref, buf);		// only copy. its inner oops are forwarded later, when a worker takes it from a queue.
+		Heap::copy_hash(new_copy, header);				// the identity hash, too.
+		new_copy->m.move_from(ref->m);					// the lock state moves with the object: an inflated monitor is not at the oop's address.
+		copy = (Oop *)Heap::par_forward_to(ref, header, new_copy);
+		if (copy == new_copy) {
+			if (plab == &self->old_plab) {
+				self->promoted_bytes += size + Heap::HEADER_SIZE;
+				self->promoted_objects ++;
+				if (string_klass() != nullptr && copy->get_klass() == string_klass()) {
+					self->dedup_candidates.push_back(copy);
+				}
+			} else {
+				self->survived_bytes += size + Heap::HEADER_SIZE;
+				self->survived_objects ++;
+			}
+			self->queue.push(copy);
+		} else {
+			Heap::undo_allocation(*plab, new_copy);
+		}
+	}
+	ref = copy;			// substitute.
+}
+
+bool GC::discover_young(Oop *oop)
 {
+	// only a copy: a Reference in an old oop of a dirty card may be dead itself. the referent is dead if it's not copied at the end.
+	if (ReferenceProcessor::type_of(oop) == REF_NONE || !Heap::is_in_to_survivor(oop))	return false;
+	Oop *referent = ReferenceProcessor::referent_of(oop);
+	if (referent == nullptr || !Heap::is_in_young(referent) || Heap::is_in_to_survivor(referent))	return false;
+	if (Heap::forwardee_of(Heap::load_header(referent)) != nullptr)	return false;		// copied already: live.
+	if (!ReferenceProcessor::should_discover(oop))	return false;
+	current_worker()->discovered_refs.push_back(oop);
+	return true;
+}
+
+bool GC::scan(Oop *oop)
+{
+	bool has_young_refs = false;
+	oop_iterate(oop, [&has_young_refs](Oop * & ref) {
+		forward(ref);
+		if (ref != nullptr && Heap::is_in_young(ref)) {
+			has_young_refs = true;
+		}
+	}, discover_young(oop) ? ReferenceProcessor::get_referent_offset() : -1);
+	return has_young_refs;
+}
+
+void GC::mark(Oop * & ref)
+{
+	if (ref != nullptr && Heap::mark(ref)) {		// only the worker which marks it scans it.
+		current_worker()->queue.push(ref);
+	}
+}
+
+void GC::klass_inner_oop_do(Klass *klass, void (*f)(Oop * &))
+{
+	current_root().kind = ROOT_KLASS;
 	if (klass->get_type() == ClassType::InstanceClass) {
 
 		InstanceKlass *instanceklass = (InstanceKlass *)klass;
@@ -153,14 +257,15 @@ void GC::klass_inner_oop_gc(Klass *klass, unordered_map<Oop *, Oop *> & new_oop_
 		// for static_fields:
 		for (auto & iter : instanceklass->static_fields) {
 			// if need, substitute the pointer in origin... to the new pointer.
-			recursive_add_oop_and_its_inner_oops_and_modify_pointers_by_the_way(iter, new_oop_map);		// recursively add into.
+			f(iter);
 		}
 		// for java_loader:
 		Oop *mirror = instanceklass->java_loader;
-		recursive_add_oop_and_its_inner_oops_and_modify_pointers_by_the_way(mirror, new_oop_map);		// recursively add into.
+		f(mirror);
 		instanceklass->java_loader = (MirrorOop *)mirror;
 
 		// for rt_pool:
+		current_root().kind = ROOT_VM;
 		auto rt_pool = instanceklass->rt_pool;
 		for (auto & _pair : rt_pool->pool) {
 			if (_pair.first == 0) {		// this position of the pool has not been parsed.
@@ -169,13 +274,20 @@ void GC::klass_inner_oop_gc(Klass *klass, unordered_map<Oop *, Oop *> & new_oop_
 				switch (_pair.first) {		// only for String...
 					case CONSTANT_String:{
 						Oop *addr = boost::any_cast<Oop *>(_pair.second);
-						recursive_add_oop_and_its_inner_oops_and_modify_pointers_by_the_way(addr, new_oop_map);		// recursively add into.
+						f(addr);
 						_pair.second = boost::any(addr);		// re-pack
 						break;
 					}
 				}
 			}
 		}
+		// for the quickened `ldc` String:
+		for (auto & entry : rt_pool->cache) {
+			if (entry.tag == CONSTANT_String) {
+				f(entry.oop);
+			}
+		}
+		current_root().kind = ROOT_KLASS;
 
 	} else if (klass->get_type() == ClassType::TypeArrayClass || klass->get_type() == ClassType::ObjArrayClass) {
 
@@ -183,7 +295,7 @@ void GC::klass_inner_oop_gc(Klass *klass, unordered_map<Oop *, Oop *> & new_oop_
 
 		// for java_loader:
 		Oop *mirror = arrklass->java_loader;
-		recursive_add_oop_and_its_inner_oops_and_modify_pointers_by_the_way(mirror, new_oop_map);		// recursively add into.
+		f(mirror);
 		arrklass->java_loader = (MirrorOop *)mirror;
 
 	} else {
@@ -192,150 +304,666 @@ void GC::klass_inner_oop_gc(Klass *klass, unordered_map<Oop *, Oop *> & new_oop_
 
 	Oop *mirror = klass->java_mirror;
 	// for java_mirror:
-	recursive_add_oop_and_its_inner_oops_and_modify_pointers_by_the_way(mirror, new_oop_map);		// recursively add into.
+	f(mirror);
 	klass->java_mirror = (MirrorOop *)mirror;
 }
 
-void GC::system_gc()
+void GC::prepare_roots()
 {
-	// GC-Root and Copy Algorithm
-	// get all need-gc-threads(in fact all threads):
-	// (**NO NEED TO LOCK**, because there's only this thread in the whole world...)
-
-	// GC-Roots include:
-	// 1. InstanceKlass::static_fields
-	// 2. InstanceKlass::java_mirror (don't include `get_single_basic_type_mirrors()`'s basic mirror)
-	// 3. InstanceKlass::java_loader
-	// 4. InstanceKlass::rt_pool's String...
-	// 5. InstanceOop::fields
-	// 6. ArrayOop::buf
-	// #. (gc temporarily do not support `StringTable`'s StringOop. they are all remained.)
-	// 7. vm_thread::arg
-	// 8. vm_thread::StackFrame[0 ~ the last frame]::localVariableTable
-	// 9. vm_thread::StackFrame[0 ~ the last frame]::op_stack
-	// 10. ThreadTable
-
-	// 0. create a TEMP new-oop-pool:
-	unordered_map<Oop *, Oop *> new_oop_map;		// must be `map/set` instead of list, for getting rid of duplication!!!
-
-	Oop *new_oop;		// global local variable
-
-	// 0.5. first migrate all of the basic type mirrors.
-	for (auto & iter : java_lang_class::get_single_basic_type_mirrors()) {
-		Oop *mirror = iter.second;
-		recursive_add_oop_and_its_inner_oops_and_modify_pointers_by_the_way(mirror, new_oop_map);
-		iter.second = (MirrorOop *)mirror;
-	}
-	// 0.7. I don't want to uninstall all StringTable...
-	unordered_set<Oop *, java_string_hash, java_string_equal_to> new_string_table;
-	for (auto & iter : java_lang_string::get_string_table()) {
-		new_oop = iter;
-		recursive_add_oop_and_its_inner_oops_and_modify_pointers_by_the_way(new_oop, new_oop_map);
-		new_string_table.insert(new_oop);
-	}
-	new_string_table.swap(java_lang_string::get_string_table());
-
-	// 1. for all GC-Roots [InstanceKlass]:
+	root_klasses().clear();
 	for (auto iter : system_classmap) {
-		klass_inner_oop_gc(iter.second, new_oop_map);		// gc the klass
+		root_klasses().push_back(iter.second);
 	}
 	for (auto iter : MyClassLoader::get_loader().classmap) {
-		klass_inner_oop_gc(iter.second, new_oop_map);		// gc the klass
+		root_klasses().push_back(iter.second);
 	}
 	for (auto iter : MyClassLoader::get_loader().anonymous_klassmap) {
-		klass_inner_oop_gc(iter, new_oop_map);		// gc the klass
+		root_klasses().push_back(iter);
 	}
+	std::sort(root_klasses().begin(), root_klasses().end());		// two workers must not substitute the same klass's roots at the same time.
+	root_klasses().erase(std::unique(root_klasses().begin(), root_klasses().end()), root_klasses().end());
 
-	// 2. for all GC-Roots [vm_threads]:
+	root_threads().clear();
 	for (auto & thread : wind_jvm::threads()) {
-//		std::wcout << "thread: " << thread.tid << ", has " << thread.vm_stack.size() << " frames... "<< std::endl;		// delete
-		// 2.3. for thread.args
-		for (auto & iter : thread.arg) {
-//			std::wcout << "arg: " << iter << std::endl;			// delete
-			recursive_add_oop_and_its_inner_oops_and_modify_pointers_by_the_way(iter, new_oop_map);
-		}
-		for (auto & frame : thread.vm_stack) {
-			// 2.5. for vm_stack::StackFrame::LocalVariableTable
-			for (auto & oop : frame.localVariableTable) {
-//				std::wcout << "localVariableTable: " << oop;			// delete
-				recursive_add_oop_and_its_inner_oops_and_modify_pointers_by_the_way(oop, new_oop_map);
-//				std::wcout << " to " << oop;			// delete
+		root_threads().push_back(&thread);
+	}
+	root_tasks_claimed() = 0;
+}
+
+void GC::roots_do(void (*f)(Oop * &))
+{
+	// GC-Roots include:
+	// 1. InstanceKlass::static_fields (in the klass, out of the heap: so `putstatic` needs no write barrier.)
+	// 2. InstanceKlass::java_mirror (and `get_single_basic_type_mirrors()`'s basic mirror)
+	// 3. InstanceKlass::java_loader
+	// 4. InstanceKlass::rt_pool's String...
+	// #. (the `StringTable` is not: its entries are weak. see: `weak_roots_do()`.)
+	// 5. vm_thread::arg, vm_thread::handles
+	// 6. vm_thread::StackFrame[0 ~ the last frame]::localVariableTable
+	// 7. vm_thread::StackFrame[0 ~ the last frame]::op_stack
+	// 8. ThreadTable
+	// the tasks: [0] the basic mirrors, [1] the ThreadTable, then `KLASSES_PER_TASK` klasses each, then one for every thread.
+	int klass_tasks = ((int)root_klasses().size() + KLASSES_PER_TASK - 1) / KLASSES_PER_TASK;
+	int total_tasks = 2 + klass_tasks + (int)root_threads().size();
+	for (int task; (task = root_tasks_claimed().fetch_add(1)) < total_tasks; ) {
+		current_root() = GCRootInfo();
+		if (task == 0) {
+
+			// 0.5. first all of the basic type mirrors.
+			for (auto & iter : java_lang_class::get_single_basic_type_mirrors()) {
+				Oop *mirror = iter.second;
+				f(mirror);
+				iter.second = (MirrorOop *)mirror;
 			}
-			// 2.7. for vm_stack::StackFrame::op_stack
-			// stack can't use iter. so make it with another vector...
-			list<Oop *> temp;
-			while(!frame.op_stack.empty()) {
-				Oop *oop = frame.op_stack.top();	frame.op_stack.pop();
-				temp.push_front(oop);
+
+		} else if (task == 1) {
+
+			// 2.5. for all GC-Roots: ThreadTable
+			current_root().kind = ROOT_THREAD_OBJECT;
+			for (auto & iter : ThreadTable::get_thread_table()) {
+				current_root().thread = std::get<2>(iter.second);
+				Oop *thread = std::get<1>(iter.second);
+				f(thread);
+				std::get<1>(iter.second) = (InstanceOop *)thread;
+			}
+
+		} else if (task < 2 + klass_tasks) {
+
+			// 1. for all GC-Roots [InstanceKlass]:
+			size_t begin = (size_t)(task - 2) * KLASSES_PER_TASK;
+			size_t end = std::min(begin + KLASSES_PER_TASK, root_klasses().size());
+			for (size_t i = begin; i < end; i ++) {
+				klass_inner_oop_do(root_klasses()[i], f);
+			}
+
+		} else {
+
+			// 2. for all GC-Roots [vm_threads]:
+			vm_thread & thread = *root_threads()[task - 2 - klass_tasks];
+			current_root().thread = &thread;
+			// 2.3. for thread.args
+			current_root().kind = ROOT_THREAD_ARG;
+			for (auto & iter : thread.arg) {
+				f(iter);
 			}
-			for (auto & oop : temp) {
-//				std::wcout << "op_stack: " << oop;		// delete
-				recursive_add_oop_and_its_inner_oops_and_modify_pointers_by_the_way(oop, new_oop_map);
-//				std::wcout << " to " << oop;		// delete
+			// 2.4. for thread.handles
+			current_root().kind = ROOT_HANDLE;
+			for (auto & iter : thread.handles) {
+				f(iter);
 			}
-			for (auto & oop : temp) {
-				frame.op_stack.push(oop);
+			for (StackFrame *frame = thread.vm_stack.top_frame(); frame != nullptr; frame = frame->link, current_root().depth ++) {
+				// 2.5. for vm_stack::StackFrame::LocalVariableTable. only the slots tagged as reference are roots.
+				current_root().kind = ROOT_JAVA_FRAME;
+				for (int i = 0; i < frame->localVariableTable.size(); i ++) {
+					if (frame->localVariableTable.is_ref(i)) {
+						f(frame->localVariableTable.slots[i].ref);
+					}
+				}
+				// 2.7. for vm_stack::StackFrame::op_stack
+				for (int i = 0; i < frame->op_stack.size(); i ++) {
+					if (frame->op_stack.tags[i] == SLOT_REFERENCE) {
+						f(frame->op_stack.slots[i].ref);
+					}
+				}
+				// 2.8. for vm_stack::StackFrame::monitor_obj
+				if (frame->monitor_obj != nullptr) {
+					current_root().kind = ROOT_MONITOR;
+					f(frame->monitor_obj);
+				}
 			}
+
 		}
+	}
+}
 
+bool GC::steal(GCWorkerState *self, Oop * & oop)
+{
+	int worker_num = (int)worker_states().size();
+	if (worker_num == 1)	return false;
+	for (int i = 0; i < 2 * worker_num; i ++) {
+		self->seed ^= self->seed << 13;
+		self->seed ^= self->seed >> 17;
+		self->seed ^= self->seed << 5;
+		GCWorkerState *victim = worker_states()[self->seed % worker_num];
+		if (victim != self && victim->queue.steal(oop)) {
+			return true;
+		}
 	}
+	return false;
+}
 
-	// 2.5. for all GC-Roots: ThreadTable
-	for (auto & iter : ThreadTable::get_thread_table()) {
-//		std::wcout << "thread: from " << iter.second.second;
-		Oop *thread = std::get<1>(iter.second);
-		recursive_add_oop_and_its_inner_oops_and_modify_pointers_by_the_way(thread, new_oop_map);
-		std::get<1>(iter.second) = (InstanceOop *)thread;
-//		std::wcout << " to " << iter.second.second;
+template <typename Func>
+void GC::drain(GCWorkerState *self, Func process)
+{
+	Oop *oop;
+	while (true) {
+		while (self->queue.pop(oop)) {
+			process(oop);
+		}
+		if (steal(self, oop)) {
+			process(oop);
+			continue;
+		}
+		bool terminate = terminator().offer_termination([]() -> bool {
+			for (GCWorkerState *state : worker_states()) {
+				if (!state->queue.is_empty())	return true;
+			}
+			return false;
+		});
+		if (terminate)	return;
 	}
+}
 
-	// 3. create a new oop table and exchange with the global Mempool
-	list<Oop *> new_oop_handler_pool;
-	for (auto & iter : new_oop_map) {
-		new_oop_handler_pool.push_back(iter.second);
+void GC::dirty_cards_task(int worker_id)
+{
+	// the old-to-young pointers: queue the old oops in the dirty cards, without forwarding anything yet. so no worker walks
+	// the blocks of a card while another one promotes an oop into a free block of it.
+	GCWorkerState *self = current_worker() = worker_states()[worker_id];
+	size_t total_tasks = (old_cards() + CARDS_PER_TASK - 1) / CARDS_PER_TASK;
+	for (size_t task; (task = card_tasks_claimed().fetch_add(1)) < total_tasks; ) {
+		size_t from = task * CARDS_PER_TASK;
+		Heap::dirty_cards_iterate(from, std::min(from + CARDS_PER_TASK, old_cards()), [self](void *obj) {
+			self->queue.push((Oop *)obj);
+		});
 	}
-	// delete all:
-	for (auto iter : Mempool::oop_handler_pool()) {
-		delete iter;
+}
+
+void GC::copy_task(int worker_id)
+{
+	GCWorkerState *self = current_worker() = worker_states()[worker_id];
+	auto roots_start = std::chrono::steady_clock::now();
+	roots_do(forward);
+	std::chrono::duration<double, std::milli> roots_time = std::chrono::steady_clock::now() - roots_start;
+	self->roots_ms = roots_time.count();
+	// the queued oops: the copies, and the old oops of the dirty cards. an old one which still points to a survivor keeps its card dirty.
+	drain(self, [](Oop *oop) {
+		if (scan(oop) && Heap::is_in_old(oop)) {
+			Heap::post_write_barrier(oop);
+		}
+	});
+	Heap::retire_survivor_plab(self->survivor_plab);
+	Heap::retire_old_plab(self->old_plab);
+}
+
+void GC::mark_task(int worker_id)
+{
+	GCWorkerState *self = current_worker() = worker_states()[worker_id];
+	auto roots_start = std::chrono::steady_clock::now();
+	roots_do(mark);
+	std::chrono::duration<double, std::milli> roots_time = std::chrono::steady_clock::now() - roots_start;
+	self->roots_ms = roots_time.count();
+	drain(self, [](Oop *oop) {
+		oop_iterate(oop, mark, discover_marked(oop) ? ReferenceProcessor::get_referent_offset() : -1);
+	});
+}
+
+bool GC::discover_marked(Oop *oop)
+{
+	if (ReferenceProcessor::type_of(oop) == REF_NONE)	return false;
+	Oop *referent = ReferenceProcessor::referent_of(oop);
+	if (referent == nullptr || Heap::is_marked(referent) || !ReferenceProcessor::should_discover(oop))	return false;
+	current_worker()->discovered_refs.push_back(oop);
+	return true;
+}
+
+Oop *GC::live_referent(Oop *oop)
+{
+	return Heap::is_marked(oop) ? oop : nullptr;
+}
+
+void GC::process_references(Oop *(*referent)(Oop *))
+{
+	for (GCWorkerState *state : worker_states()) {
+		ReferenceProcessor::process(state->discovered_refs, referent, pause().refs_cleared);
 	}
-	// swap.
-	new_oop_handler_pool.swap(Mempool::oop_handler_pool());
+}
 
-	// 4. final: must do this.
-	gc() = false;				// no need to lock.
-	signal_all_thread();
+Oop *GC::young_referent(Oop *oop)
+{
+	if (!Heap::is_in_young(oop))	return oop;
+	return (Oop *)Heap::forwardee_of(Heap::load_header(oop));
+}
 
-	std::wcout << "gc over!!" << std::endl;		// delete
+Oop *GC::marked_referent(Oop *oop)
+{
+	// the young ones are left to the next minor gc.
+	if (Heap::is_in_old(oop) && !Heap::is_marked(oop))	return nullptr;
+	return oop;
 }
 
-void GC::set_safepoint_here(vm_thread *thread)
-{													// change it to block at once.
-	bool gc;
-	gc_lock().lock();
+void GC::weak_roots_do(Oop *(*referent)(Oop *))
+{
+	// the StringTable: rebuilt, for the hash set is keyed on the addresses too. the hashes are cached in the Strings.
+	LockGuard lg(java_lang_string::getLock());
+	unordered_set<Oop *, java_string_hash, java_string_equal_to> new_string_table;
+	new_string_table.reserve(java_lang_string::get_string_table().size());
+	for (Oop *stringoop : java_lang_string::get_string_table()) {
+		Oop *now = referent(stringoop);
+		if (now == nullptr) {
+			pause().strings_purged ++;
+		} else {
+			new_string_table.insert(now);
+		}
+	}
+	new_string_table.swap(java_lang_string::get_string_table());
+	StringDedup::purge(referent);
+	// the inflated monitors point back to their objects weakly, too.
+	pause().monitors_deflated += ThinLock::deflate_monitors([referent](void *obj) -> void * {
+		return referent((Oop *)obj);
+	});
+}
+
+void GC::deduplicate_strings()
+{
+	for (GCWorkerState *state : worker_states()) {
+		for (Oop *stringoop : state->dedup_candidates) {
+			size_t saved = StringDedup::deduplicate((InstanceOop *)stringoop);
+			if (saved == 0)	continue;
+			pause().dedup_strings ++;
+			pause().dedup_saved_bytes += saved;
+			// the promoted String is marked already while the old generation is being marked, and never scanned again.
+			if (cycle_state() == MARKING) {
+				mark_old(java_lang_string::value_of((InstanceOop *)stringoop));
+			}
+		}
+		state->dedup_candidates.clear();
+	}
+}
+
+void GC::minor_gc()
+{
+	// only the young generation: copy the young oops the roots and the dirty cards point to into the to-survivor space (or
+	// promote them), then scan the copies, copying the oops they point to, until no copy is left to scan. the forwarding
+	// address is in the old oop's block header. the dead young oops are never looked at: the pause only depends on the roots,
+	// the dirty cards and the survivors. all the phases are split among the gc workers, which balance by stealing.
+
+	// 1. the old oops in the dirty cards.
+	phase(L"Scan dirty cards", []() {
+		old_cards() = Heap::old_cards();
+		card_tasks_claimed() = 0;
+		GCWorkers::run(dirty_cards_task);
+	});
+
+	// 2. the roots, the dirty cards' oops, and all the copies. the workers go on copying when they are done with the roots:
+	// the roots are the slowest worker's part, the copying the rest.
+	for (GCWorkerState *state : worker_states()) {
+		state->survived_bytes = state->promoted_bytes = 0;
+		state->survived_objects = state->promoted_objects = 0;
+	}
+	if (VMOptions::use_string_deduplication() && string_klass() == nullptr) {
+		auto iter = system_classmap.find(L"java/lang/String.class");
+		string_klass() = (iter == system_classmap.end()) ? nullptr : iter->second;
+	}
+	auto copy_start = std::chrono::steady_clock::now();
+	prepare_roots();
+	terminator().reset(GCWorkers::size());
+	GCWorkers::run(copy_task);
+	std::chrono::duration<double, std::milli> copy_time = std::chrono::steady_clock::now() - copy_start;
+	double roots_ms = 0;
+	for (GCWorkerState *state : worker_states()) {
+		roots_ms = std::max(roots_ms, state->roots_ms);
+		pause().survived_bytes += state->survived_bytes;
+		pause().survived_objects += state->survived_objects;
+		pause().promoted_bytes += state->promoted_bytes;
+		pause().promoted_objects += state->promoted_objects;
+	}
+	pause().phases.push_back(make_pair(L"Scan roots", roots_ms));
+	pause().phases.push_back(make_pair(L"Copy", copy_time.count() - roots_ms));
+
+	// 3. the discovered References and the weak roots: the young ones which are not copied are dead. then the promoted
+	// Strings, whose char[]s are copied now.
+	phase(L"Reference processing", []() {
+		process_references(young_referent);
+	});
+	phase(L"Weak roots", []() {
+		weak_roots_do(young_referent);
+	});
+	if (VMOptions::use_string_deduplication()) {
+		phase(L"String dedup", deduplicate_strings);
+	}
+
+	// 4. eden and the from-survivor space only have dead oops and forwarded ones now, unless the promotion failed.
+	vector<pair<void *, size_t>> self_forwarded;
+	for (GCWorkerState *state : worker_states()) {
+		self_forwarded.insert(self_forwarded.end(), state->self_forwarded.begin(), state->self_forwarded.end());
+		state->self_forwarded.clear();
+		state->queue.reset();
+	}
+	Heap::end_minor_gc(self_forwarded);
+	if (!self_forwarded.empty()) {
+		pause().promotion_failed_objects = self_forwarded.size();
+		pause().kind += L" (Promotion Failed)";
+		full_gc_requested() = true;		// the next pause frees the old generation for them, or the allocations fail with an OutOfMemoryError.
+	}
+}
+
+void GC::full_gc()
+{
+	// the whole heap: mark all the oops reachable from the roots, then sweep the dead old ones into the free list of the old
+	// generation. the young ones are not swept: the minor gc after this one copies the live ones out.
+
+	// 1. mark, in parallel: a worker scans the oops it marked itself, or stole.
+	auto mark_start = std::chrono::steady_clock::now();
+	prepare_roots();
+	terminator().reset(GCWorkers::size());
+	GCWorkers::run(mark_task);
+	std::chrono::duration<double, std::milli> mark_time = std::chrono::steady_clock::now() - mark_start;
+	double roots_ms = 0;
+	for (GCWorkerState *state : worker_states()) {
+		roots_ms = std::max(roots_ms, state->roots_ms);
+		state->queue.reset();
+	}
+	pause().phases.push_back(make_pair(L"Mark roots", roots_ms));
+	pause().phases.push_back(make_pair(L"Mark", mark_time.count() - roots_ms));
+
+	// 2. the discovered References and the weak roots: the dead ones, before their blocks are freed. then sweep.
+	phase(L"Reference processing", []() {
+		process_references(live_referent);
+	});
+	phase(L"Weak roots", []() {
+		weak_roots_do(marked_referent);
+	});
+	phase(L"Sweep", Heap::sweep_old);
+}
+
+/**
+ * the concurrent cycle of the old generation, snapshot-at-the-beginning:
+ *   1. initial mark (in a young pause): mark the old oops the roots and the young oops point to. from then on, the
+ *      mutators log the old oops they overwrite (see: `Satb`), and the old oops allocated meanwhile are marked at once.
+ *   2. concurrent mark: the concurrent thread scans the marked oops and the logged ones, while the mutators run.
+ *   3. remark (in a young pause): the logs the threads still hold, and the oops they lead to. then all the old oops
+ *      reachable at the initial mark, or allocated since, are marked.
+ *   4. concurrent sweep: the concurrent thread sweeps the unmarked old oops into the free list, step by step.
+ * if the old generation fills up before the cycle ends, the pause finishes the cycle by itself, and only collects the
+ * whole heap if that didn't free enough. see: `system_gc()`.
+ */
+void GC::set_cycle_state(int state)
+{
+	pthread_mutex_lock(&cycle_cond_mutex());
+	cycle_state() = state;
+	pthread_cond_broadcast(&cycle_cond());
+	pthread_mutex_unlock(&cycle_cond_mutex());
+}
+
+void GC::mark_old(Oop *oop)
+{
+	// only the old oops are marked: the young ones are not swept, and the ones they point to were marked at the initial mark.
+	if (oop != nullptr && Heap::is_in_old(oop) && Heap::mark(oop)) {
+		mark_stack().push_back(oop);
+	}
+}
+
+void GC::initial_mark_root(Oop * & ref)
+{
+	mark_old(ref);
+}
+
+bool GC::discover_old(Oop *oop)
+{
+	// the young referents are left to the minor gcs. `Reference.get()` logs the referent while the marking runs.
+	if (ReferenceProcessor::type_of(oop) == REF_NONE)	return false;
+	Oop *referent = __atomic_load_n(&ReferenceProcessor::referent_of(oop), __ATOMIC_RELAXED);
+	if (referent == nullptr || !Heap::is_in_old(referent) || Heap::is_marked(referent))	return false;
+	if (!ReferenceProcessor::should_discover(oop))	return false;
+	concurrent_discovered().push_back(oop);
+	return true;
+}
+
+bool GC::trace(int max_oops)
+{
+	Satb::drain([](void *obj) {
+		mark_old((Oop *)obj);
+	});
+	for (int i = 0; i < max_oops && !mark_stack().empty(); i ++) {
+		Oop *oop = mark_stack().back();
+		mark_stack().pop_back();
+		// a mutator may store into `oop` meanwhile: the one it overwrites is logged, so either of them is fine to read.
+		oop_iterate(oop, [](Oop * & ref) {
+			mark_old(__atomic_load_n(&ref, __ATOMIC_RELAXED));
+		}, discover_old(oop) ? ReferenceProcessor::get_referent_offset() : -1);
+	}
+	return mark_stack().empty();
+}
+
+void GC::initial_mark()
+{
+	// right after a minor gc eden is empty: all the young oops are in the from-survivor space (anywhere in the young generation
+	// after a promotion failure). they are taken as roots, so the marking never has to look at the young generation again.
+	prepare_roots();
+	roots_do(initial_mark_root);
+	Heap::young_iterate([](void *obj) {
+		oop_iterate((Oop *)obj, initial_mark_root);
+	});
+	Satb::set_active(true);
+	Heap::set_allocate_black(true);
+	remark_requested() = false;
+	set_cycle_state(MARKING);
+	cycle_id() = pause().id;
+	phase_start() = std::chrono::steady_clock::now();
+}
+
+void GC::remark()
+{
+	// no root is scanned again: an oop the roots point to now was reachable at the initial mark, or is allocated since.
+	std::chrono::duration<double, std::milli> mark_time = std::chrono::steady_clock::now() - phase_start();
+	for (auto & thread : wind_jvm::threads()) {
+		Satb::flush(thread.satb);
+	}
+	while (!trace(INT_MAX));
+	ReferenceProcessor::process(concurrent_discovered(), marked_referent, pause().refs_cleared);
+	Satb::set_active(false);
+	Heap::set_allocate_black(false);
 	{
-		gc = GC::gc();
+		LockGuard lg(stats_lock());
+		stats().concurrent_marks ++;
+		stats().concurrent_mark_ms += mark_time.count();
+	}
+	if (VMOptions::print_gc()) {
+		GCLog(L"gc", cycle_id()) << "Concurrent Mark " << mark_time.count() << "ms";
 	}
-	gc_lock().unlock();
 
-	if (gc) {
-		std::wcout << "block!" << std::endl;			// delete
-		wait_cur_thread(thread);						// stop this thread!!
-	} else {
-		signal_one_thread();		// if not GC, and this thread (maybe) create a new thread using `start0`, then the `new thread` must be hung up. so signal it and start it.
+	// the weak roots nobody marked are left out, before the sweep frees them.
+	weak_roots_do(marked_referent);
+
+	Heap::begin_sweep();
+	set_cycle_state(SWEEPING);
+	phase_start() = std::chrono::steady_clock::now();
+}
+
+void GC::end_sweep()
+{
+	std::chrono::duration<double, std::milli> sweep_time = std::chrono::steady_clock::now() - phase_start();
+	{
+		LockGuard lg(stats_lock());
+		stats().concurrent_sweeps ++;
+		stats().concurrent_sweep_ms += sweep_time.count();
+	}
+	if (VMOptions::print_gc()) {
+		GCLog(L"gc", cycle_id()) << "Concurrent Sweep " << sweep_time.count() << "ms, old generation " << Heap::old_used() / 1024 << "K used";
 	}
+	set_cycle_state(IDLE);
 }
 
-void GC::signal_all_patch()
+void GC::finish_sweep()
 {
-	while(true) {
-		gc_lock().lock();
-		if (!GC::gc()) {		// if not in gc, signal all thread is okay.
-			signal_all_thread();
-			break;
+	while (!Heap::sweep_step(SIZE_MAX));
+	end_sweep();
+}
+
+void *GC::concurrent_thread(void *)
+{
+	while (true) {
+		pthread_mutex_lock(&cycle_cond_mutex());
+		while (cycle_state() == IDLE || (cycle_state() == MARKING && remark_requested())) {
+			pthread_cond_wait(&cycle_cond(), &cycle_cond_mutex());
+		}
+		int state = cycle_state();
+		pthread_mutex_unlock(&cycle_cond_mutex());
+
+		if (state == MARKING) {
+			concurrent_mark();
+		} else {
+			concurrent_sweep();
+		}
+	}
+	return nullptr;
+}
+
+void GC::concurrent_mark()
+{
+	while (true) {
+		pthread_mutex_lock(&concurrent_lock());
+		if (cycle_state() != MARKING) {			// a pause has finished it.
+			pthread_mutex_unlock(&concurrent_lock());
+			return;
+		}
+		bool done = trace(MARK_STEP_OOPS);
+		if (done) {
+			remark_requested() = true;
+		}
+		pthread_mutex_unlock(&concurrent_lock());
+
+		if (done) {
+			init_gc(L"Concurrent Mark Done");		// false: a pause is on the way already, and it will see the request.
+			return;
+		}
+	}
+}
+
+void GC::concurrent_sweep()
+{
+	while (true) {
+		pthread_mutex_lock(&concurrent_lock());
+		if (cycle_state() != SWEEPING) {		// a pause has finished it.
+			pthread_mutex_unlock(&concurrent_lock());
+			return;
+		}
+		if (Heap::sweep_step(SWEEP_STEP_BYTES)) {
+			end_sweep();
+		}
+		pthread_mutex_unlock(&concurrent_lock());
+	}
+}
+
+void GC::system_gc()
+{
+	// get all need-gc-threads(in fact all threads):
+	// (**NO NEED TO LOCK**, because there's only this thread in the whole world...)
+	auto pause_start = std::chrono::steady_clock::now();
+	pthread_mutex_lock(&concurrent_lock());		// the concurrent thread stops at the end of its step.
+
+	// 0. all the tlabs give back their rest.
+	for (auto & thread : wind_jvm::threads()) {
+		thread.tlab.retire();
+	}
+	pause() = GCPause();
+	pause().id = collections();
+	pause().cause = gc_cause();
+	pause().kind = L"Pause Young";
+	pause().eden_before = Heap::eden_used();
+	pause().survivor_before = Heap::survivor_used();
+	pause().old_before = Heap::old_used();
+	pause().old_capacity_before = Heap::old_capacity();
+
+	// 0.5. the heap dump: before the collection, with the oops where the threads left them. (an OutOfMemoryError may leave no room to copy them.)
+	if (HeapDump::is_requested()) {
+		phase(L"Heap dump", HeapDump::dump_requested);
+	}
+
+	// 1. the marker has scanned all it could see: finish the marking.
+	if (cycle_state() == MARKING && remark_requested()) {
+		phase(L"Remark", remark);
+		pause().kind += L" (Remark)";
+	}
+
+	// 2. if the old generation may have no room for the promoted ones even at -Xmx, or an allocation has failed, finish the
+	// concurrent cycle in this pause, and collect the whole heap if it's still not enough. the minor gc must come after it,
+	// to move the marked young oops out.
+	bool full_requested = full_gc_requested().exchange(false);
+	ReferenceProcessor::begin_pause(full_requested);		// an allocation has failed: the SoftReferences go, before an OutOfMemoryError.
+	if (full_requested || Heap::old_max_free() < Heap::young_used()) {
+		if (cycle_state() == MARKING) {
+			phase(L"Remark", remark);
+			pause().kind += L" (Remark)";
+		}
+		if (cycle_state() == SWEEPING) {
+			phase(L"Finish sweep", finish_sweep);
+		}
+		if (full_requested || Heap::old_max_free() < Heap::young_used()) {
+			full_gc();
+			pause().kind = L"Pause Full";
+		}
+	}
+	minor_gc();
+	phase(L"Resize old generation", []() {
+		Heap::resize_old(allocation_request().exchange(0), cycle_state() == IDLE);
+	});
+
+	// 2.5. the cleared References go into their queues, before the initial mark takes the roots.
+	phase(L"Enqueue references", []() {
+		pause().refs_enqueued = ReferenceProcessor::enqueue_pending();
+		ReferenceProcessor::end_pause();
+	});
+
+	// 3. the old generation is full enough to begin a concurrent cycle.
+	if (cycle_state() == IDLE && Heap::old_used() * 100 > Heap::old_capacity() * VMOptions::initiating_heap_occupancy_percent()) {
+		phase(L"Initial mark", initial_mark);
+		pause().kind += L" (Initial Mark)";
+	}
+
+	std::chrono::duration<double, std::milli> pause_time = std::chrono::steady_clock::now() - pause_start;
+	{
+		LockGuard lg(stats_lock());
+		size_t before = pause().eden_before + pause().survivor_before + pause().old_before;
+		size_t after = Heap::young_used() + Heap::old_used();
+		stats().pauses ++;
+		stats().full_pauses += (pause().kind.compare(0, 10, L"Pause Full") == 0) ? 1 : 0;
+		stats().pause_total_ms += pause_time.count();
+		stats().pause_max_ms = std::max(stats().pause_max_ms, pause_time.count());
+		stats().pause_ms.push_back(pause_time.count());
+		stats().reclaimed_bytes += (before > after) ? before - after : 0;
+		stats().promoted_bytes += pause().promoted_bytes;
+		stats().promoted_objects += pause().promoted_objects;
+		stats().strings_purged += pause().strings_purged;
+		stats().monitors_deflated += pause().monitors_deflated;
+		stats().dedup_strings += pause().dedup_strings;
+		stats().dedup_saved_bytes += pause().dedup_saved_bytes;
+		for (int type = REF_SOFT; type <= REF_PHANTOM; type ++) {
+			stats().refs_cleared[type] += pause().refs_cleared[type];
 		}
-		gc_lock().unlock();
+		stats().refs_enqueued += pause().refs_enqueued;
+	}
+	pthread_mutex_unlock(&concurrent_lock());
+	if (VMOptions::print_gc()) {
+		log_pause(pause_time.count());
+	}
+
+	// 4. final: must do this.
+	collections() ++;			// before the threads run: `collect_for_allocation()` retries after it.
+	Safepoint::end();			// resume all the threads.
+	gc() = false;				// no need to lock.
+}
+
+void GC::log_pause(double pause_ms)
+{
+	GCPause & p = pause();
+	size_t before = p.eden_before + p.survivor_before + p.old_before;
+	size_t after = Heap::young_used() + Heap::old_used();
+	GCLog(L"gc", p.id) << p.kind << " (" << p.cause << ") " << before / 1024 << "K->" << after / 1024 << "K(" << Heap::get_capacity() / 1024 << "K) " << pause_ms << "ms";
+	GCLog(L"gc,phases", p.id) << "  Time-to-safepoint: " << stats().last_time_to_safepoint_ms << "ms";
+	for (auto & phase : p.phases) {
+		GCLog(L"gc,phases", p.id) << "  " << phase.first << ": " << phase.second << "ms";
+	}
+	GCLog(L"gc,heap", p.id) << "Eden: " << p.eden_before / 1024 << "K->" << Heap::eden_used() / 1024 << "K(" << Heap::eden_capacity() / 1024 << "K)";
+	GCLog(L"gc,heap", p.id) << "Survivor: " << p.survivor_before / 1024 << "K->" << Heap::survivor_used() / 1024 << "K(" << Heap::survivor_capacity() / 1024 << "K)";
+	GCLog(L"gc,heap", p.id) << "Old: " << p.old_before / 1024 << "K->" << Heap::old_used() / 1024 << "K(" << p.old_capacity_before / 1024 << "K->" << Heap::old_capacity() / 1024 << "K)";
+	GCLog(L"gc,promotion", p.id) << "Promoted: " << p.promoted_objects << " objects, " << p.promoted_bytes / 1024 << "K. Survived: " << p.survived_objects << " objects, " << p.survived_bytes / 1024 << "K. Promotion failed: " << p.promotion_failed_objects << " objects";
+	GCLog(L"gc,stringtable", p.id) << "StringTable: " << java_lang_string::get_string_table().size() << " entries, " << p.strings_purged << " purged";
+	GCLog(L"gc,monitor", p.id) << "Monitors: " << p.monitors_deflated << " deflated";
+	GCLog(L"gc,ref", p.id) << "References: " << p.refs_cleared[REF_SOFT] << " soft, " << p.refs_cleared[REF_WEAK] << " weak, " << p.refs_cleared[REF_PHANTOM] << " phantom cleared, " << p.refs_enqueued << " enqueued";
+	if (VMOptions::use_string_deduplication()) {
+		GCLog(L"gc,stringdedup", p.id) << "String Dedup: " << p.dedup_strings << " strings, " << p.dedup_saved_bytes / 1024 << "K saved, " << StringDedup::size() << " char[]s in the table";
 	}
-	gc_lock().unlock();
 }
 
 void GC::cancel_gc_thread()
@@ -347,7 +975,45 @@ void GC::cancel_gc_thread()
 		} else {
 			pthread_cancel(wind_jvm::gc_thread());
 			pthread_join(wind_jvm::gc_thread(), nullptr);
+			pthread_mutex_lock(&concurrent_lock());		// kept: the concurrent thread never takes another step, the heap is going away.
+			GC::gc() = true;		// and no more gc requests: nobody would end their safepoint.
 			break;
 		}
 	}
 }
+
+void GC::print_summary(std::wostream & os)
+{
+	LockGuard lg(stats_lock());
+	GCStats & st = stats();
+	vector<double> sorted(st.pause_ms);
+	std::sort(sorted.begin(), sorted.end());
+	auto percentile = [&sorted](double p) -> double {		// nearest rank.
+		if (sorted.empty())	return 0;
+		size_t rank = (size_t)std::ceil(p * sorted.size());
+		return sorted[std::max(rank, (size_t)1) - 1];
+	};
+	const double bounds[] = { 0.1, 1, 10, 100 };
+	int buckets[5] = { 0 };
+	for (double ms : sorted) {
+		buckets[std::upper_bound(bounds, bounds + 4, ms) - bounds] ++;
+	}
+	double uptime_ms = GCLog::uptime() * 1000;
+	double concurrent_ms = st.concurrent_mark_ms + st.concurrent_sweep_ms;
+	os << std::fixed << std::setprecision(3);
+	os << "[GC summary]" << std::endl;
+	os << "    pauses:              " << st.pauses << " (" << st.full_pauses << " full), total " << st.pause_total_ms << " ms, p50 " << percentile(0.5) << " ms, p99 " << percentile(0.99) << " ms, max " << st.pause_max_ms << " ms" << std::endl;
+	os << "    pause histogram:     <0.1ms " << buckets[0] << ", <1ms " << buckets[1] << ", <10ms " << buckets[2] << ", <100ms " << buckets[3] << ", >=100ms " << buckets[4] << std::endl;
+	os << "    time-to-safepoint:   " << st.safepoints << " safepoints, total " << st.time_to_safepoint_total_ms << " ms, max " << st.time_to_safepoint_max_ms << " ms" << std::endl;
+	os << "    concurrent marking:  " << st.concurrent_marks << " cycles, total " << st.concurrent_mark_ms << " ms" << std::endl;
+	os << "    concurrent sweeping: " << st.concurrent_sweeps << " cycles, total " << st.concurrent_sweep_ms << " ms" << std::endl;
+	os << "    reclaimed:           " << st.reclaimed_bytes / 1024 << "K, promoted " << st.promoted_bytes / 1024 << "K in " << st.promoted_objects << " objects" << std::endl;
+	os << "    string table:        " << st.strings_purged << " dead entries purged" << std::endl;
+	os << "    monitors:            " << st.monitors_deflated << " deflated" << std::endl;
+	os << "    references cleared:  " << st.refs_cleared[REF_SOFT] << " soft, " << st.refs_cleared[REF_WEAK] << " weak, " << st.refs_cleared[REF_PHANTOM] << " phantom, " << st.refs_enqueued << " enqueued" << std::endl;
+	if (VMOptions::use_string_deduplication()) {
+		os << "    string dedup:        " << st.dedup_strings << " strings, " << st.dedup_saved_bytes / 1024 << "K saved" << std::endl;
+	}
+	os << "    gc time:             " << st.pause_total_ms + concurrent_ms << " ms in " << uptime_ms / 1000 << " s: overhead " << (uptime_ms > 0 ? st.pause_total_ms * 100 / uptime_ms : 0)
+	   << "% in the pauses, " << (uptime_ms > 0 ? concurrent_ms * 100 / uptime_ms : 0) << "% concurrent" << std::endl;
+}
@@ -0,0 +1,51 @@
+/*
+ * gc_log.cpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#include "runtime/gc_log.hpp"
+#include <iomanip>
+
+bool GCLog::open(const std::string & path)
+{
+	start_time() = std::chrono::steady_clock::now();
+	if (path == "")	return true;
+	file().open(path, std::ios::out | std::ios::trunc);
+	return file().is_open();
+}
+
+void GCLog::close()
+{
+	std::lock_guard<std::mutex> guard(mutex());
+	if (file().is_open()) {
+		file().close();
+	}
+}
+
+double GCLog::uptime()
+{
+	std::chrono::duration<double> uptime = std::chrono::steady_clock::now() - start_time();
+	return uptime.count();
+}
+
+void GCLog::write(const std::wstring & text)
+{
+	std::lock_guard<std::mutex> guard(mutex());
+	stream() << text;
+	stream().flush();
+}
+
+GCLog::GCLog(const wchar_t *tags, int gc_id)
+{
+	*this << "[" << std::fixed << std::setprecision(3) << uptime() << "s][" << tags << "] ";
+	if (gc_id != -1) {
+		*this << "GC(" << gc_id << ") ";
+	}
+}
+
+GCLog::~GCLog()
+{
+	*this << std::endl;
+	write(this->str());
+}
@@ -0,0 +1,61 @@
+/*
+ * gc_workers.cpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#include "runtime/gc_workers.hpp"
+#include <signal.h>
+
+void *GCWorkers::worker_loop(void *arg)
+{
+	int worker_id = (int)(long)arg;
+	long done_number = 0;
+	while (true) {
+		void (*current_task)(int);
+		pthread_mutex_lock(&mutex());
+		while (task_number() == done_number) {
+			pthread_cond_wait(&task_cond(), &mutex());
+		}
+		done_number = task_number();
+		current_task = task();
+		pthread_mutex_unlock(&mutex());
+
+		current_task(worker_id);
+
+		pthread_mutex_lock(&mutex());
+		if (-- unfinished() == 0) {
+			pthread_cond_signal(&done_cond());
+		}
+		pthread_mutex_unlock(&mutex());
+	}
+	return nullptr;
+}
+
+void GCWorkers::init(int worker_num)
+{
+	// the workers don't take the signals of the vm (SIGINT triggers a gc, SIGQUIT dumps the profile).
+	sigset_t set, old_set;
+	sigfillset(&set);
+	pthread_sigmask(SIG_BLOCK, &set, &old_set);
+	for (int i = 0; i < worker_num; i ++) {
+		pthread_t tid;
+		pthread_create(&tid, nullptr, worker_loop, (void *)(long)i);
+		pthread_detach(tid);
+		workers().push_back(tid);
+	}
+	pthread_sigmask(SIG_SETMASK, &old_set, nullptr);
+}
+
+void GCWorkers::run(void (*task)(int worker_id))
+{
+	pthread_mutex_lock(&mutex());
+	GCWorkers::task() = task;
+	unfinished() = size();
+	task_number() ++;
+	pthread_cond_broadcast(&task_cond());
+	while (unfinished() != 0) {
+		pthread_cond_wait(&done_cond(), &mutex());
+	}
+	pthread_mutex_unlock(&mutex());
+}
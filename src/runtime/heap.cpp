@@ -0,0 +1,444 @@
+/*
+ * heap.cpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#include "runtime/heap.hpp"
+#include <sys/mman.h>
+#include <algorithm>
+
+/*===---------------- Tlab -------------------===*/
+void Tlab::retire()
+{
+	if (top != nullptr && top < end) {
+		*(size_t *)top = (size_t)(end - top) | Heap::FREE_BIT;
+	}
+	top = end = nullptr;
+}
+
+/*===---------------- Heap -------------------===*/
+bool Heap::init(size_t initial_bytes, size_t max_bytes, size_t young_bytes, bool use_huge_pages)
+{
+	assert(young_bytes < max_bytes && initial_bytes <= max_bytes);
+	young_bytes = align_to_page(young_bytes);
+	size_t old_bytes = align_to_page(std::max(max_bytes, young_bytes + HUGE_PAGE_SIZE) - young_bytes);
+	size_t heap_size = young_bytes + old_bytes;
+	size_t size = heap_size + (use_huge_pages ? HUGE_PAGE_SIZE : 0);		// room to align the heap to a huge page.
+	// only reserved: the pages are committed by the kernel when they are touched first.
+	void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (ptr == MAP_FAILED) {
+		return false;
+	}
+	reserved() = (uint8_t *)ptr;
+	reserved_size() = size;
+	uint8_t *start = (uint8_t *)ptr;
+	if (use_huge_pages) {
+		start = (uint8_t *)(((uintptr_t)start + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1));
+#ifdef MADV_HUGEPAGE
+		madvise(start, heap_size, MADV_HUGEPAGE);		// only a hint: fine if the kernel has no transparent huge pages.
+#endif
+	}
+
+	// the generations. every space starts at a card boundary.
+	size_t survivor_bytes = (young_bytes / (SURVIVOR_RATIO + 2)) & ~(CARD_SIZE - 1);
+	young().start = start;
+	young().end = young().top = start + young_bytes;
+	eden().start = start;
+	eden().end = start + young_bytes - 2 * survivor_bytes;
+	eden_top() = eden().start;
+	from_survivor().start = from_survivor().top = eden().end;
+	from_survivor().end = eden().end + survivor_bytes;
+	to_survivor().start = to_survivor().top = from_survivor().end;
+	to_survivor().end = from_survivor().end + survivor_bytes;
+	to_survivor_top() = to_survivor().start;
+	old().start = old().top = young().end;
+	old().end = old().start + old_bytes;
+	min_old_capacity() = std::min(std::max(align_to_page(initial_bytes > young_bytes ? initial_bytes - young_bytes : 0), (size_t)HUGE_PAGE_SIZE), old_bytes);
+	old_limit() = old().start + min_old_capacity();
+
+	// the side tables, committed lazily like the heap.
+	size_t cards = heap_size >> CARD_SHIFT;
+	size_t old_cards = old_bytes >> CARD_SHIFT;
+	ptr = mmap(nullptr, cards + old_cards, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (ptr == MAP_FAILED) {
+		munmap(reserved(), reserved_size());
+		reserved() = nullptr;
+		return false;
+	}
+	card_table() = (uint8_t *)ptr;				// all clean.
+	card_table_base() = card_table() - card_index(start);
+	block_start_table() = card_table() + cards;
+	memset(block_start_table(), NO_BLOCK, old_cards);
+	return true;
+}
+
+uint8_t *Heap::allocate_eden(size_t size)
+{
+	uint8_t *old_top = eden_top().load(std::memory_order_relaxed);
+	do {
+		if ((size_t)(eden().end - old_top) < size)	return nullptr;
+	} while (!eden_top().compare_exchange_weak(old_top, old_top + size, std::memory_order_relaxed));
+	return old_top;
+}
+
+uint8_t *Heap::allocate_to_survivor(size_t size)
+{
+	uint8_t *old_top = to_survivor_top().load(std::memory_order_relaxed);
+	do {
+		if ((size_t)(to_survivor().end - old_top) < size)	return nullptr;
+	} while (!to_survivor_top().compare_exchange_weak(old_top, old_top + size, std::memory_order_relaxed));
+	return old_top;
+}
+
+void *Heap::allocate_slow(size_t block_size)
+{
+	if (block_size > SIZE_MASK)	return nullptr;			// the size would run into the hash bits of the header.
+	Tlab *tlab = current_tlab();
+	uint8_t *block;
+	if (tlab == nullptr || block_size > TLAB_SIZE / 4) {
+		// no tlab (not a java thread), or too big to waste a tlab on: right in the shared eden.
+		block = allocate_eden(block_size);
+	} else {
+		tlab->retire();
+		uint8_t *old_top = eden_top().load(std::memory_order_relaxed);
+		size_t tlab_size;
+		do {
+			tlab_size = std::min((size_t)TLAB_SIZE, (size_t)(eden().end - old_top));		// the last tlab of eden may be smaller.
+			if (tlab_size < block_size)	break;
+		} while (!eden_top().compare_exchange_weak(old_top, old_top + tlab_size, std::memory_order_relaxed));
+		if (tlab_size >= block_size) {
+			tlab->top = old_top;
+			tlab->end = old_top + tlab_size;
+			return init_block(tlab->allocate(block_size), block_size);
+		}
+		block = nullptr;
+	}
+	if (block != nullptr)	return init_block(block, block_size);
+
+	if (on_eden_full() != nullptr) {
+		on_eden_full()();		// the minor gc happens at the next poll of this thread.
+	}
+	return allocate_old(block_size, false);		// eden is full: into the old generation, until the gc.
+}
+
+void *Heap::allocate_in_reserve(size_t size)
+{
+	size_t block_size = block_size_of(size);
+	if (block_size > SIZE_MASK)	return nullptr;
+	return allocate_old(block_size, true);
+}
+
+void *Heap::allocate_old(size_t block_size, bool use_reserve)
+{
+	// the caller stores the references into the new object without a gc in between, maybe without the write barrier (the
+	// natives fill their new arrays directly), so its card is dirty from the start.
+	LockGuard lg(old_lock());
+	if (!use_reserve && old_max_free() < block_size + VM_RESERVE)	return nullptr;
+	uint8_t *block = allocate_old_block(block_size);
+	if (block == nullptr)	return nullptr;
+	card_table_base()[card_index(block)] = DIRTY_CARD;
+	void *obj = init_block(block, block_size);
+	if (allocate_black()) {
+		header_of(obj) |= MARK_BIT;
+	}
+	return obj;
+}
+
+uint8_t *Heap::allocate_old_block(size_t block_size)
+{
+	// 1. the best fit of the free list. the rest of the free block stays free: a block of only a header at least, to keep the generation parsable.
+	auto iter = old_free_list().lower_bound(block_size);
+	if (iter != old_free_list().end()) {
+		size_t free_size = iter->first;
+		uint8_t *block = iter->second;
+		old_free_list().erase(iter);
+		old_free_bytes() -= free_size;
+		size_t rest = free_size - block_size;
+		if (rest != 0) {
+			add_to_free_list(block + block_size, rest);
+		}
+		*(size_t *)block = block_size;
+		return block;
+	}
+	// 2. bump the top. grow the generation if it's over the limit, till -Xmx.
+	if ((size_t)(old().end - old().top) < block_size)	return nullptr;
+	if ((size_t)(old_limit() - old().top) < block_size) {
+		old_limit() = old().start + std::min(align_to_page(old().top + block_size - old().start), (size_t)(old().end - old().start));
+	}
+	uint8_t *block = old().top;
+	old().top += block_size;
+	*(size_t *)block = block_size;
+	note_block_start(block);
+	return block;
+}
+
+void Heap::add_to_free_list(uint8_t *block, size_t block_size)
+{
+	*(size_t *)block = block_size | FREE_BIT;
+	note_block_start(block);
+	old_free_list().insert(std::make_pair(block_size, block));
+	old_free_bytes() += block_size;
+}
+
+void Heap::note_block_start(uint8_t *block)
+{
+	// the gc workers note the blocks of their plabs without the lock, and two plabs may share a card: an atomic min.
+	uint8_t *entry = &block_start_table()[old_card_index(block)];
+	uint8_t offset = (uint8_t)(((uintptr_t)block & (CARD_SIZE - 1)) / sizeof(size_t));
+	uint8_t current = __atomic_load_n(entry, __ATOMIC_RELAXED);
+	while (current == NO_BLOCK || offset < current) {
+		if (__atomic_compare_exchange_n(entry, &current, offset, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))	break;
+	}
+}
+
+void *Heap::allocate_in_survivor(Tlab & plab, size_t size, unsigned age)
+{
+	if (promotion_failed())	return nullptr;		// the to-survivor space is full of the last minor gc's objects: all are promoted.
+	size_t block_size = block_size_of(size);
+	uint8_t *block = plab.allocate(block_size);
+	if (block == nullptr) {
+		if (block_size > PLAB_SIZE / 4) {		// too big to waste a plab on.
+			block = allocate_to_survivor(block_size);
+		} else {
+			plab.retire();
+			uint8_t *chunk = allocate_to_survivor(PLAB_SIZE);
+			if (chunk == nullptr) {				// the end of the space: only this one.
+				block = allocate_to_survivor(block_size);
+			} else {
+				plab.top = chunk;
+				plab.end = chunk + PLAB_SIZE;
+				block = plab.allocate(block_size);
+			}
+		}
+		if (block == nullptr)	return nullptr;
+	}
+	*(size_t *)block = block_size | ((size_t)age << AGE_SHIFT);
+	return block + HEADER_SIZE;
+}
+
+void *Heap::allocate_in_old(Tlab & plab, size_t size)
+{
+	size_t block_size = block_size_of(size);
+	uint8_t *block = plab.allocate(block_size);
+	if (block == nullptr) {
+		LockGuard lg(old_lock());
+		if (block_size > PLAB_SIZE / 4) {		// too big to waste a plab on.
+			block = allocate_old_block(block_size);
+		} else {
+			uint8_t *chunk = allocate_old_block(PLAB_SIZE);
+			if (chunk == nullptr) {				// no room, or too fragmented for a plab: only this one.
+				block = allocate_old_block(block_size);
+			} else {
+				retire_old_plab(plab);
+				plab.top = chunk;
+				plab.end = chunk + PLAB_SIZE;
+				block = plab.allocate(block_size);
+			}
+		}
+		if (block == nullptr)	return nullptr;
+	}
+	*(size_t *)block = block_size | (allocate_black() ? MARK_BIT : 0);
+	note_block_start(block);
+	return block + HEADER_SIZE;
+}
+
+void Heap::undo_allocation(Tlab & plab, void *obj)
+{
+	uint8_t *block = (uint8_t *)obj - HEADER_SIZE;
+	size_t block_size = block_size_at(block);
+	if (!plab.undo(block, block_size)) {		// not the last one of the plab: a free block.
+		*(size_t *)block = block_size | FREE_BIT;
+	}
+}
+
+void Heap::retire_old_plab(Tlab & plab)
+{
+	LockGuard lg(old_lock());
+	if (plab.top != nullptr && plab.top < plab.end) {
+		add_to_free_list(plab.top, plab.end - plab.top);
+	}
+	plab.top = plab.end = nullptr;
+}
+
+void Heap::end_minor_gc(std::vector<std::pair<void *, size_t>> & failed)
+{
+	// the young cards are dirtied by the barrier too, but never scanned.
+	memset(card_table_base() + card_index(young().start), CLEAN_CARD, (young().end - young().start) >> CARD_SHIFT);
+	if (!failed.empty()) {
+		// promotion failure: nothing is reset. the objects forwarded to themselves get their headers back, and the other
+		// blocks of the spaces copied from become free blocks, to keep them parsable. the copies in the to-survivor space
+		// stay too: till the next minor gc has promoted all of them (survivors have no room left), all the three spaces are
+		// the young generation, and there's no to-survivor space.
+		std::sort(failed.begin(), failed.end());
+		if (promotion_failed()) {
+			free_dead_blocks(to_survivor().start, to_survivor().top, failed);
+		} else {
+			to_survivor().top = to_survivor_top();
+		}
+		free_dead_blocks(eden().start, eden_top(), failed);
+		free_dead_blocks(from_survivor().start, from_survivor().top, failed);
+		promotion_failed() = true;
+		return;
+	}
+	eden_top() = eden().start;
+	if (promotion_failed()) {		// all promoted: the three spaces are empty.
+		promotion_failed() = false;
+		from_survivor().top = from_survivor().start;
+	} else {
+		to_survivor().top = to_survivor_top();
+		std::swap(from_survivor(), to_survivor());
+	}
+	to_survivor().top = to_survivor().start;
+	to_survivor_top() = to_survivor().start;
+}
+
+void Heap::free_dead_blocks(uint8_t *start, uint8_t *end, const std::vector<std::pair<void *, size_t>> & kept)
+{
+	auto next = std::lower_bound(kept.begin(), kept.end(), std::make_pair((void *)start, (size_t)0));
+	for (uint8_t *block = start; block < end; ) {
+		size_t header = *(size_t *)block;
+		size_t block_size;
+		if (next != kept.end() && next->first == block + HEADER_SIZE) {
+			block_size = next->second & SIZE_MASK;
+			*(size_t *)block = next->second & ~MARK_BIT;		// a full gc in this pause may have marked it.
+			next ++;
+		} else {
+			// copied (the copy has the same size), dead, or free already.
+			block_size = (header & FORWARDED_BIT) ? block_size_at((uint8_t *)forwardee_of(header) - HEADER_SIZE) : (header & SIZE_MASK);
+			*(size_t *)block = block_size | FREE_BIT;
+		}
+		block += block_size;
+	}
+}
+
+void Heap::begin_sweep()
+{
+	LockGuard lg(old_lock());
+	// the free list is rebuilt by the sweep. till its end, only the swept free blocks and the rests of the plabs are in it.
+	old_free_list().clear();
+	old_free_bytes() = 0;
+	sweep_cursor() = old().start;
+	sweep_limit() = old().top;
+	sweep_card() = 0;
+}
+
+void Heap::sweep_enter_cards(size_t last_card)
+{
+	// the block start entry of a card is noted again from scratch when the sweep enters it.
+	uint8_t *limit = sweep_limit();
+	for (; sweep_card() <= last_card; sweep_card() ++) {
+		block_start_table()[sweep_card()] = NO_BLOCK;
+		if (sweep_card() == old_card_index(limit) && old().top > limit) {
+			note_block_start(limit);		// the first block allocated since the sweep began shares this card.
+		}
+	}
+}
+
+bool Heap::sweep_step(size_t max_bytes)
+{
+	LockGuard lg(old_lock());
+	uint8_t *limit = sweep_limit();
+	uint8_t *block = sweep_cursor();
+	uint8_t *step_end = ((size_t)(limit - block) <= max_bytes) ? limit : block + max_bytes;
+	uint8_t *free_start = nullptr;		// the start of the run of dead and free blocks, which are coalesced into one.
+	while (block < step_end) {
+		sweep_enter_cards(old_card_index(block));
+		size_t header = *(size_t *)block;
+		if ((header & FREE_BIT) == 0 && (header & MARK_BIT) != 0) {
+			if (free_start != nullptr) {
+				add_to_free_list(free_start, block - free_start);
+				free_start = nullptr;
+			}
+			__atomic_fetch_and((size_t *)block, ~MARK_BIT, __ATOMIC_RELAXED);		// a mutator may install the hash meanwhile.
+			note_block_start(block);
+		} else if (free_start == nullptr) {
+			free_start = block;
+		}
+		block += header & SIZE_MASK;
+	}
+	sweep_cursor() = block;
+
+	if (block < limit) {
+		// the mutators allocate in the swept free blocks between the steps: a run never goes on into the next step. the cards
+		// of the run are all entered before, and the cursor is noted: the blocks after it are not swept yet.
+		sweep_enter_cards(old_card_index(block));
+		if (free_start != nullptr) {
+			add_to_free_list(free_start, block - free_start);
+		}
+		note_block_start(block);
+		return false;
+	}
+	if (limit > old().start) {
+		sweep_enter_cards(old_card_index(limit - 1));		// the tail of the last block.
+	}
+	if (free_start != nullptr) {
+		if (old().top == limit) {		// the end of the old generation is free: give it back to the top.
+			old().top = free_start;
+		} else {
+			add_to_free_list(free_start, limit - free_start);
+		}
+	}
+	return true;
+}
+
+void Heap::resize_old(size_t min_free, bool may_shrink)
+{
+	LockGuard lg(old_lock());
+	size_t capacity = old_limit() - old().start;
+	size_t used = old_used();
+	size_t grow_to = std::max(used * 100 / (100 - MIN_FREE_PERCENT), used + min_free);
+	size_t shrink_to = used * 100 / (100 - MAX_FREE_PERCENT);
+	size_t desired = capacity;
+	if (capacity < grow_to) {
+		desired = grow_to;
+	} else if (may_shrink && capacity > shrink_to) {
+		desired = std::max(shrink_to, min_old_capacity());
+	}
+	// never below the top: the blocks are all below it.
+	desired = std::max(align_to_page(desired), align_to_page(old().top - old().start));
+	desired = std::min(desired, (size_t)(old().end - old().start));
+	uint8_t *limit = old().start + desired;
+	if (limit < old_limit()) {
+		madvise(limit, old_limit() - limit, MADV_DONTNEED);		// the pages are free again, and zeroed if touched later.
+	}
+	old_limit() = limit;
+}
+
+Heap::HashState::HashState()
+{
+	// every thread starts from another point of the sequence.
+	static std::atomic<uint32_t> next_seed(0x9e3779b9);
+	x = next_seed.fetch_add(0x9e3779b9, std::memory_order_relaxed) ^ (uint32_t)(uintptr_t)this;
+}
+
+int Heap::identity_hash(void *obj)
+{
+	size_t header = load_header(obj);
+	assert((header & FORWARDED_BIT) == 0);
+	while ((header & HASH_MASK) == 0) {
+		HashState & s = hash_state();
+		uint32_t t = s.x ^ (s.x << 11);
+		s.x = s.y;
+		s.y = s.z;
+		s.z = s.w;
+		s.w = (s.w ^ (s.w >> 19)) ^ (t ^ (t >> 8));
+		size_t hash = ((size_t)s.w << HASH_SHIFT) & HASH_MASK;
+		if (hash == 0)	continue;		// 0 is "no hash yet".
+		// the marker, the sweeper or another thread may change the header meanwhile: then `header` is the new one, try again.
+		if (__atomic_compare_exchange_n(&header_of(obj), &header, header | hash, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+			return (int)(hash >> HASH_SHIFT);
+		}
+	}
+	return (int)((header & HASH_MASK) >> HASH_SHIFT);
+}
+
+void Heap::cleanup()
+{
+	if (reserved() != nullptr) {
+		munmap(card_table(), ((young().end - young().start) >> CARD_SHIFT) + 2 * ((old().end - old().start) >> CARD_SHIFT));
+		munmap(reserved(), reserved_size());
+		reserved() = nullptr;
+		card_table() = card_table_base() = block_start_table() = nullptr;
+	}
+}
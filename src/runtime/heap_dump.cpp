@@ -0,0 +1,602 @@
+/*
+ * heap_dump.cpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#include "runtime/heap_dump.hpp"
+#include "runtime/gc.hpp"
+#include "runtime/oop.hpp"
+#include "runtime/klass.hpp"
+#include "runtime/field.hpp"
+#include "runtime/safepoint.hpp"
+#include "runtime/thread.hpp"
+#include "system_directory.hpp"
+#include "utils/utils.hpp"
+#include "utils/vm_options.hpp"
+#include <sys/stat.h>
+#include <unistd.h>
+#include <ctime>
+#include <cerrno>
+#include <cstring>
+#include <climits>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+#include <tuple>
+
+enum {		// the hprof record tags.
+	HPROF_UTF8					= 0x01,
+	HPROF_LOAD_CLASS			= 0x02,
+	HPROF_TRACE					= 0x05,
+	HPROF_HEAP_DUMP_SEGMENT		= 0x1C,
+	HPROF_HEAP_DUMP_END			= 0x2C,
+};
+
+enum {		// the sub-records of a heap dump segment.
+	HPROF_GC_ROOT_UNKNOWN		= 0xFF,
+	HPROF_GC_ROOT_JNI_LOCAL		= 0x02,
+	HPROF_GC_ROOT_JAVA_FRAME	= 0x03,
+	HPROF_GC_ROOT_STICKY_CLASS	= 0x05,
+	HPROF_GC_ROOT_MONITOR_USED	= 0x07,
+	HPROF_GC_ROOT_THREAD_OBJ	= 0x08,
+	HPROF_GC_CLASS_DUMP			= 0x20,
+	HPROF_GC_INSTANCE_DUMP		= 0x21,
+	HPROF_GC_OBJ_ARRAY_DUMP		= 0x22,
+	HPROF_GC_PRIM_ARRAY_DUMP	= 0x23,
+};
+
+enum {		// the basic types.
+	HPROF_NORMAL_OBJECT			= 2,
+	HPROF_BOOLEAN				= 4,
+	HPROF_CHAR					= 5,
+	HPROF_FLOAT					= 6,
+	HPROF_DOUBLE				= 7,
+	HPROF_BYTE					= 8,
+	HPROF_SHORT					= 9,
+	HPROF_INT					= 10,
+	HPROF_LONG					= 11,
+};
+
+static const uint32_t OBJECT_TRACE_SERIAL = 1;		// an empty stack trace, for all the oops: their allocation sites are unknown.
+
+static uint8_t hprof_type(wchar_t kind)		// of a field descriptor.
+{
+	switch (kind) {
+		case L'Z':	return HPROF_BOOLEAN;
+		case L'C':	return HPROF_CHAR;
+		case L'F':	return HPROF_FLOAT;
+		case L'D':	return HPROF_DOUBLE;
+		case L'B':	return HPROF_BYTE;
+		case L'S':	return HPROF_SHORT;
+		case L'I':	return HPROF_INT;
+		case L'J':	return HPROF_LONG;
+		default:	return HPROF_NORMAL_OBJECT;		// `L` and `[`.
+	}
+}
+
+static uint32_t hprof_size(wchar_t kind)
+{
+	switch (kind) {
+		case L'Z': case L'B':	return 1;
+		case L'C': case L'S':	return 2;
+		case L'F': case L'I':	return 4;
+		default:				return 8;		// `J`, `D`, and the references: the ids are 8 bytes.
+	}
+}
+
+static uint8_t hprof_array_type(Type type)
+{
+	switch (type) {
+		case Type::BOOLEAN:	return HPROF_BOOLEAN;
+		case Type::CHAR:	return HPROF_CHAR;
+		case Type::FLOAT:	return HPROF_FLOAT;
+		case Type::DOUBLE:	return HPROF_DOUBLE;
+		case Type::BYTE:	return HPROF_BYTE;
+		case Type::SHORT:	return HPROF_SHORT;
+		case Type::INT:		return HPROF_INT;
+		case Type::LONG:	return HPROF_LONG;
+		default:{
+			assert(false);
+			return 0;
+		}
+	}
+}
+
+std::string HeapDump::default_path()
+{
+	// a directory (or none) gets java_pid<pid>.hprof, then java_pid<pid>.1.hprof, ... a file gets `.1`, `.2` ... after the first dump.
+	static std::atomic<int> seq(0);
+	int n = seq ++;
+	std::string path = VMOptions::heap_dump_path();
+	struct stat st;
+	if (path == "" || (stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode))) {
+		std::string name = "java_pid" + std::to_string(getpid()) + (n == 0 ? "" : "." + std::to_string(n)) + ".hprof";
+		return path == "" ? name : path + "/" + name;
+	}
+	return n == 0 ? path : path + "." + std::to_string(n);
+}
+
+bool HeapDump::request(const std::string & path)
+{
+	// the caller holds no oop in its c++ locals: it's as safe as a blocked thread for the pauses while it waits here.
+	Safepoint::enter_blocked();
+	pthread_mutex_lock(&request_mutex());
+	while (requested()) {
+		pthread_cond_wait(&done_cond(), &request_mutex());
+	}
+	requested() = true;
+	requested_path() = path;
+	int count = dumps();
+	while (dumps() == count) {
+		pthread_mutex_unlock(&request_mutex());
+		GC::init_gc(L"Heap Dump");		// false: a pause is on the way already. if it has gone past the dump, the next one takes it.
+		pthread_mutex_lock(&request_mutex());
+		if (dumps() == count) {
+			timespec deadline;
+			clock_gettime(CLOCK_REALTIME, &deadline);
+			deadline.tv_nsec += 10 * 1000 * 1000;
+			if (deadline.tv_nsec >= 1000 * 1000 * 1000) {
+				deadline.tv_sec ++;
+				deadline.tv_nsec -= 1000 * 1000 * 1000;
+			}
+			pthread_cond_timedwait(&done_cond(), &request_mutex(), &deadline);
+		}
+	}
+	bool succeeded = last_succeeded();
+	pthread_mutex_unlock(&request_mutex());
+	Safepoint::leave_blocked();
+	return succeeded;
+}
+
+bool HeapDump::is_requested()
+{
+	pthread_mutex_lock(&request_mutex());
+	bool is_requested = requested();
+	pthread_mutex_unlock(&request_mutex());
+	return is_requested;
+}
+
+void HeapDump::dump_requested()
+{
+	pthread_mutex_lock(&request_mutex());
+	std::string path = requested_path();
+	pthread_mutex_unlock(&request_mutex());
+
+	bool succeeded = dump(path);
+
+	pthread_mutex_lock(&request_mutex());
+	requested() = false;
+	last_succeeded() = succeeded;
+	dumps() ++;
+	pthread_cond_broadcast(&done_cond());
+	pthread_mutex_unlock(&request_mutex());
+}
+
+void HeapDump::on_out_of_memory()
+{
+	static std::atomic<bool> dumped(false);
+	if (!VMOptions::heap_dump_on_out_of_memory_error() || dumped.exchange(true))	return;
+	request(default_path());
+}
+
+bool HeapDump::dump(const std::string & path)
+{
+	std::wcout << "Dumping heap to " << utf8_to_wstring(path) << " ..." << std::endl;
+	auto start = std::chrono::steady_clock::now();
+	FILE *file = fopen(path.c_str(), "wbx");		// never overwrites a file.
+	if (file == nullptr) {
+		std::wcout << "Unable to create " << utf8_to_wstring(path) << ": " << strerror(errno) << std::endl;
+		return false;
+	}
+	HeapDump heap_dump(file);
+	bool succeeded = heap_dump.write();
+	succeeded = (fclose(file) == 0) && succeeded;
+	if (!succeeded) {
+		std::wcout << "Unable to write " << utf8_to_wstring(path) << ": " << strerror(errno) << std::endl;
+		return false;
+	}
+	std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+	std::wcout << "Heap dump file created [" << heap_dump.total_bytes << " bytes in " << time.count() << " secs]" << std::endl;
+	return true;
+}
+
+void HeapDump::flush()
+{
+	if (fwrite(buf.data(), 1, buf.size(), file) != buf.size()) {
+		failed = true;
+	}
+	total_bytes += buf.size();
+	buf.clear();
+}
+
+void HeapDump::begin_record(uint8_t tag)
+{
+	assert(buf.empty());
+	put1(tag);
+	put4(0);		// the microseconds since the header.
+	put4(0);		// the length: patched by `end_record()`.
+}
+
+void HeapDump::end_record()
+{
+	uint32_t length = (uint32_t)(buf.size() - 9);
+	for (int i = 0; i < 4; i ++) {
+		buf[5 + i] = (uint8_t)(length >> (24 - 8 * i));
+	}
+	flush();
+}
+
+void HeapDump::next_sub_record()
+{
+	if (buf.size() >= SEGMENT_BYTES) {
+		end_record();
+		begin_record(HPROF_HEAP_DUMP_SEGMENT);
+	}
+}
+
+uint64_t HeapDump::string_id(const std::wstring & str)
+{
+	auto iter = string_ids.find(str);
+	if (iter != string_ids.end())	return iter->second;
+	uint64_t id = string_ids.size() + 1;
+	string_ids.insert(make_pair(str, id));
+	strings.push_back(make_pair(id, str));
+	return id;
+}
+
+uint64_t HeapDump::class_id(Klass *klass)
+{
+	// the mirror is the class. a klass whose mirror is not made yet is known by its own address.
+	if (klass == nullptr)	return 0;
+	return klass->get_mirror() != nullptr ? (uint64_t)(uintptr_t)klass->get_mirror() : (uint64_t)(uintptr_t)klass;
+}
+
+uint32_t HeapDump::thread_serial(vm_thread *thread)
+{
+	auto iter = thread_serials.find(thread);
+	if (iter != thread_serials.end())	return iter->second;
+	uint32_t serial = thread_serials.size() + 1;
+	thread_serials.insert(make_pair(thread, serial));
+	return serial;
+}
+
+const std::vector<Field_info *> & HeapDump::fields_of(InstanceKlass *klass)
+{
+	auto iter = own_fields.find(klass);
+	if (iter != own_fields.end())	return iter->second;
+	std::vector<Field_info *> & fields = own_fields[klass];
+	for (auto & layout : klass->get_field_layout()) {		// the parents' fields are in it, too.
+		if (layout.second.second->get_klass() == klass) {
+			fields.push_back(layout.second.second);
+		}
+	}
+	std::sort(fields.begin(), fields.end(), [](Field_info *a, Field_info *b) { return a->get_offset() < b->get_offset(); });
+	return fields;
+}
+
+void HeapDump::root(Oop * & ref)
+{
+	HeapDump *self = current();
+	if (ref == nullptr || ref->get_ooptype() == OopType::_BasicTypeOop)	return;		// a boxed static field, or a thread arg.
+	GCRootInfo & info = GC::current_root();
+	uint64_t id = (uint64_t)(uintptr_t)ref;
+	switch (info.kind) {
+		case ROOT_VM:
+			self->roots.push_back({HPROF_GC_ROOT_UNKNOWN, id, 0, 0});
+			break;
+		case ROOT_KLASS:		// the klasses are sticky roots. their statics and loaders are in their CLASS DUMPs.
+			break;
+		case ROOT_THREAD_OBJECT:
+			self->roots.push_back({HPROF_GC_ROOT_THREAD_OBJ, id, self->thread_serial(info.thread), 0});
+			break;
+		case ROOT_THREAD_ARG:
+		case ROOT_HANDLE:
+			self->roots.push_back({HPROF_GC_ROOT_JNI_LOCAL, id, self->thread_serial(info.thread), -1});
+			break;
+		case ROOT_JAVA_FRAME:
+			self->roots.push_back({HPROF_GC_ROOT_JAVA_FRAME, id, self->thread_serial(info.thread), info.depth});
+			break;
+		case ROOT_MONITOR:
+			self->roots.push_back({HPROF_GC_ROOT_MONITOR_USED, id, 0, 0});
+			break;
+	}
+	self->visit(ref);
+}
+
+void HeapDump::add_klass(Klass *klass)
+{
+	if (klass == nullptr || class_serials.find(klass) != class_serials.end())	return;
+	class_serials.insert(make_pair(klass, 0));
+	add_klass(klass->get_type() == ClassType::InstanceClass ? klass->get_parent() : object_klass);		// the parent's CLASS DUMP comes first.
+	klasses.push_back(klass);
+	class_serials[klass] = klasses.size();
+	if (klass->get_type() == ClassType::InstanceClass) {
+		InstanceKlass *instanceklass = (InstanceKlass *)klass;
+		visit(instanceklass->get_java_loader());
+		for (Oop *value : instanceklass->get_static_fields_addr()) {
+			visit(value);
+		}
+	} else {
+		visit(((ArrayKlass *)klass)->get_java_loader());
+	}
+}
+
+void HeapDump::visit(Oop *oop)
+{
+	if (oop == nullptr || oop->get_ooptype() == OopType::_BasicTypeOop)	return;
+	if (!visited.insert(oop).second)	return;
+	if (oop->get_klass() == class_klass && ((MirrorOop *)oop)->get_mirrored_who() != nullptr) {
+		add_klass(((MirrorOop *)oop)->get_mirrored_who());		// a class: its CLASS DUMP stands for the mirror.
+		return;
+	}
+	add_klass(oop->get_klass());
+	oops.push_back(oop);
+	pending.push_back(oop);
+}
+
+void HeapDump::walk()
+{
+	auto iter = system_classmap.find(L"java/lang/Class.class");
+	class_klass = (iter != system_classmap.end()) ? iter->second : nullptr;
+	iter = system_classmap.find(L"java/lang/Object.class");
+	object_klass = (iter != system_classmap.end()) ? iter->second : nullptr;
+
+	// 1. the roots: the same as the gc's.
+	current() = this;
+	GC::prepare_roots();
+	GC::roots_do(root);
+	current() = nullptr;
+	for (Klass *klass : GC::root_klasses()) {
+		add_klass(klass);
+		roots.push_back({HPROF_GC_ROOT_STICKY_CLASS, class_id(klass), 0, 0});
+	}
+	for (auto & iter : ThreadTable::get_thread_table()) {		// a thread with no oop on its stack still has a serial.
+		thread_serial(std::get<2>(iter.second));
+	}
+
+	// 2. all the oops reachable from them.
+	while (!pending.empty()) {
+		Oop *oop = pending.back();
+		pending.pop_back();
+		if (oop->get_ooptype() == OopType::_InstanceOop) {
+			for (int offset : ((InstanceKlass *)oop->get_klass())->get_oop_fields_offsets()) {
+				visit(((InstanceOop *)oop)->field_at<Oop *>(offset));
+			}
+		} else {
+			ArrayOop *arr = (ArrayOop *)oop;
+			if (arr->has_ref_elems()) {
+				for (int i = 0; i < arr->get_length(); i ++) {
+					visit((*arr)[i]);
+				}
+			}
+		}
+	}
+}
+
+void HeapDump::write_field_value(wchar_t kind, Oop *boxed)
+{
+	// a static field: the primitives are boxed. a klass not initialized yet may have no box.
+	switch (kind) {
+		case L'Z': case L'B':	put1(boxed ? (uint8_t)((IntOop *)boxed)->value : 0);			break;
+		case L'C': case L'S':	put2(boxed ? (uint16_t)((IntOop *)boxed)->value : 0);			break;
+		case L'I':				put4(boxed ? (uint32_t)((IntOop *)boxed)->value : 0);			break;
+		case L'J':				put8(boxed ? (uint64_t)((LongOop *)boxed)->value : 0);		break;
+		case L'F':{
+			uint32_t bits = 0;
+			if (boxed)	memcpy(&bits, &((FloatOop *)boxed)->value, sizeof(bits));
+			put4(bits);
+			break;
+		}
+		case L'D':{
+			uint64_t bits = 0;
+			if (boxed)	memcpy(&bits, &((DoubleOop *)boxed)->value, sizeof(bits));
+			put8(bits);
+			break;
+		}
+		default:				put_id(boxed);		// a mirror is the id of its class, too.
+	}
+}
+
+void HeapDump::write_field_value(wchar_t kind, const uint8_t *addr)
+{
+	switch (kind) {
+		case L'Z': case L'B':	put1(*addr);						break;
+		case L'C': case L'S':	put2(*(const uint16_t *)addr);	break;
+		case L'F': case L'I':	put4(*(const uint32_t *)addr);	break;
+		case L'J': case L'D':	put8(*(const uint64_t *)addr);	break;
+		default:				put_id(*(Oop * const *)addr);
+	}
+}
+
+void HeapDump::write_class_dump(Klass *klass)
+{
+	put1(HPROF_GC_CLASS_DUMP);
+	put8(class_id(klass));
+	put4(OBJECT_TRACE_SERIAL);
+	if (klass->get_type() == ClassType::InstanceClass) {
+		InstanceKlass *instanceklass = (InstanceKlass *)klass;
+		put8(class_id(klass->get_parent()));
+		put_id(instanceklass->get_java_loader());
+		put_id(nullptr);		// signers
+		put_id(nullptr);		// protection domain
+		put_id(nullptr);		// reserved
+		put_id(nullptr);		// reserved
+		put4(sizeof(InstanceOop) + instanceklass->non_static_field_bytes());
+		put2(0);				// the constant pool.
+		vector<pair<int, Field_info *>> statics;
+		for (auto & layout : instanceklass->get_static_field_layout()) {
+			statics.push_back(layout.second);
+		}
+		std::sort(statics.begin(), statics.end(), [](const pair<int, Field_info *> & a, const pair<int, Field_info *> & b) { return a.first < b.first; });
+		put2(statics.size());
+		for (auto & field : statics) {
+			wchar_t kind = field.second->get_descriptor()[0];
+			put8(string_id(field.second->get_name()));
+			put1(hprof_type(kind));
+			write_field_value(kind, instanceklass->get_static_fields_addr()[field.first]);
+		}
+		const std::vector<Field_info *> & fields = fields_of(instanceklass);
+		put2(fields.size());
+		for (Field_info *field : fields) {
+			put8(string_id(field->get_name()));
+			put1(hprof_type(field->get_descriptor()[0]));
+		}
+	} else {
+		put8(class_id(object_klass));
+		put_id(((ArrayKlass *)klass)->get_java_loader());
+		for (int i = 0; i < 4; i ++) {
+			put_id(nullptr);
+		}
+		put4(0);
+		put2(0);
+		put2(0);
+		put2(0);
+	}
+}
+
+void HeapDump::write_oop(Oop *oop)
+{
+	if (oop->get_ooptype() == OopType::_InstanceOop) {
+
+		InstanceOop *instance = (InstanceOop *)oop;
+		put1(HPROF_GC_INSTANCE_DUMP);
+		put_id(oop);
+		put4(OBJECT_TRACE_SERIAL);
+		put8(class_id(oop->get_klass()));
+		uint32_t bytes = 0;
+		for (Klass *klass = oop->get_klass(); klass != nullptr; klass = klass->get_parent()) {
+			for (Field_info *field : fields_of((InstanceKlass *)klass)) {
+				bytes += hprof_size(field->get_descriptor()[0]);
+			}
+		}
+		put4(bytes);
+		// the fields of the klass itself first, then the parent's, ... in the order of their CLASS DUMPs.
+		for (Klass *klass = oop->get_klass(); klass != nullptr; klass = klass->get_parent()) {
+			for (Field_info *field : fields_of((InstanceKlass *)klass)) {
+				write_field_value(field->get_descriptor()[0], instance->get_fields_addr() + field->get_offset());
+			}
+		}
+
+	} else {
+
+		ArrayOop *arr = (ArrayOop *)oop;
+		// a record is at most 4g: the rest of a bigger array is cut off.
+		size_t elem_size = arr->has_ref_elems() ? sizeof(Oop *) : arr->get_elem_size();
+		int length = (int)std::min((size_t)arr->get_length(), (UINT32_MAX - 64) / elem_size);
+		if (arr->has_ref_elems()) {
+			put1(HPROF_GC_OBJ_ARRAY_DUMP);
+			put_id(oop);
+			put4(OBJECT_TRACE_SERIAL);
+			put4(length);
+			put8(class_id(oop->get_klass()));
+			for (int i = 0; i < length; i ++) {
+				put_id((*arr)[i]);
+			}
+		} else {
+			TypeArrayOop *typearr = (TypeArrayOop *)oop;
+			put1(HPROF_GC_PRIM_ARRAY_DUMP);
+			put_id(oop);
+			put4(OBJECT_TRACE_SERIAL);
+			put4(length);
+			put1(hprof_array_type(((TypeArrayKlass *)oop->get_klass())->get_basic_type()));
+			const uint8_t *base = typearr->get_base();
+			for (int i = 0; i < length; i ++) {		// big endian.
+				switch (elem_size) {
+					case 1:	put1(base[i]);						break;
+					case 2:	put2(((const uint16_t *)base)[i]);	break;
+					case 4:	put4(((const uint32_t *)base)[i]);	break;
+					case 8:	put8(((const uint64_t *)base)[i]);	break;
+				}
+			}
+		}
+
+	}
+}
+
+bool HeapDump::write()
+{
+	walk();
+
+	// 1. the header.
+	const char header[] = "JAVA PROFILE 1.0.2";
+	buf.insert(buf.end(), header, header + sizeof(header));		// with the '\0'.
+	put4(sizeof(Oop *));
+	put8(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+	flush();
+
+	// 2. the names of the klasses and their fields.
+	for (Klass *klass : klasses) {
+		string_id(klass->get_name());
+		if (klass->get_type() == ClassType::InstanceClass) {
+			for (auto & layout : ((InstanceKlass *)klass)->get_static_field_layout()) {
+				string_id(layout.second.second->get_name());
+			}
+			for (Field_info *field : fields_of((InstanceKlass *)klass)) {
+				string_id(field->get_name());
+			}
+		}
+	}
+	for (auto & str : strings) {
+		begin_record(HPROF_UTF8);
+		put8(str.first);
+		std::string utf8 = wstring_to_utf8(str.second);
+		buf.insert(buf.end(), utf8.begin(), utf8.end());
+		end_record();
+	}
+	for (Klass *klass : klasses) {
+		begin_record(HPROF_LOAD_CLASS);
+		put4(class_serials[klass]);
+		put8(class_id(klass));
+		put4(OBJECT_TRACE_SERIAL);
+		put8(string_id(klass->get_name()));
+		end_record();
+	}
+
+	// 3. the stack traces: an empty one for the oops, and one for every thread. the frames are not dumped.
+	begin_record(HPROF_TRACE);
+	put4(OBJECT_TRACE_SERIAL);
+	put4(0);
+	put4(0);
+	end_record();
+	for (auto & iter : thread_serials) {
+		begin_record(HPROF_TRACE);
+		put4(OBJECT_TRACE_SERIAL + iter.second);
+		put4(iter.second);
+		put4(0);
+		end_record();
+	}
+
+	// 4. the heap: the roots, the klasses, then the oops.
+	begin_record(HPROF_HEAP_DUMP_SEGMENT);
+	for (Root & root : roots) {
+		next_sub_record();
+		put1(root.tag);
+		put8(root.id);
+		switch (root.tag) {
+			case HPROF_GC_ROOT_THREAD_OBJ:
+				put4(root.thread_serial);
+				put4(OBJECT_TRACE_SERIAL + root.thread_serial);
+				break;
+			case HPROF_GC_ROOT_JNI_LOCAL:
+			case HPROF_GC_ROOT_JAVA_FRAME:
+				put4(root.thread_serial);
+				put4((uint32_t)root.depth);
+				break;
+		}
+	}
+	for (Klass *klass : klasses) {
+		next_sub_record();
+		write_class_dump(klass);
+	}
+	for (Oop *oop : oops) {
+		next_sub_record();
+		write_oop(oop);
+	}
+	end_record();
+	begin_record(HPROF_HEAP_DUMP_END);
+	end_record();
+
+	return !failed;
+}
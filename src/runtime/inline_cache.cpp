@@ -0,0 +1,101 @@
+/*
+ * inline_cache.cpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#include "runtime/inline_cache.hpp"
+#include "runtime/method.hpp"
+#include "runtime/klass.hpp"
+#include "utils/synchronize_wcout.hpp"
+
+Method *InlineCache::miss(InstanceKlass *klass, Method *resolved_method)
+{
+	Method *target = klass->select_method(resolved_method);
+	if (megamorphic.load(std::memory_order_relaxed)) {
+		inc(megamorphic_calls);
+		return target;
+	}
+	inc(misses);
+	LockGuard lg(this->lock);
+	int num = size.load(std::memory_order_relaxed);
+	for (int i = 0; i < num; i ++) {
+		if (entries[i].klass == klass)	return target;		// another thread has added it.
+	}
+	if (num < IC_SIZE) {
+		entries[num].klass = klass;
+		entries[num].target = target;
+		size.store(num + 1, std::memory_order_release);		// publish the entry.
+#ifdef BYTECODE_DEBUG
+	sync_wcout{} << "(DEBUG) inline cache of " << caller->get_name() << ":" << caller->get_descriptor() << " @" << bci << " adds receiver <class>: " << klass->get_name() << std::endl;
+#endif
+	} else {
+		megamorphic.store(true, std::memory_order_relaxed);
+#ifdef BYTECODE_DEBUG
+	sync_wcout{} << "(DEBUG) inline cache of " << caller->get_name() << ":" << caller->get_descriptor() << " @" << bci << " becomes megamorphic." << std::endl;
+#endif
+	}
+	return target;
+}
+
+InlineCache *InlineCache::get_inline_cache(Method *caller, int bci)
+{
+	auto & table = caller->get_inline_caches();
+	InlineCache **caches = table.load(std::memory_order_acquire);
+	if (caches != nullptr) {
+		InlineCache *cache = __atomic_load_n(&caches[bci], __ATOMIC_ACQUIRE);
+		if (cache != nullptr)	return cache;
+	}
+	// slow path: make the table and/or the cache.
+	LockGuard lg(all_caches_lock());
+	caches = table.load(std::memory_order_relaxed);
+	if (caches == nullptr) {
+		int code_length = caller->get_code()->code_length;
+		caches = new InlineCache *[code_length]();
+		table.store(caches, std::memory_order_release);
+	}
+	if (caches[bci] == nullptr) {
+		InlineCache *cache = new InlineCache(caller, bci);
+		all_caches().push_back(cache);
+		__atomic_store_n(&caches[bci], cache, __ATOMIC_RELEASE);
+	}
+	return caches[bci];
+}
+
+void InlineCache::print(std::wostream & os)
+{
+	int num = size.load(std::memory_order_acquire);
+	const wchar_t *state;
+	if (megamorphic.load())	state = L"megamorphic";
+	else if (num <= 1)		state = L"monomorphic";
+	else					state = L"polymorphic";
+	os << caller->get_klass()->get_name() << "::" << caller->get_name() << ":" << caller->get_descriptor() << " @" << bci
+	   << "  [" << state << "]  hits: " << hits.load() << ", misses: " << misses.load() << ", megamorphic calls: " << megamorphic_calls.load() << std::endl;
+	for (int i = 0; i < num; i ++) {
+		os << "    receiver <class>: " << entries[i].klass->get_name() << " --> " << entries[i].target->get_klass()->get_name() << "::" << entries[i].target->get_name() << std::endl;
+	}
+}
+
+void InlineCache::dump(std::wostream & os)
+{
+	LockGuard lg(all_caches_lock());
+	int mono = 0, poly = 0, mega = 0;
+	os << "===--------------- Inline Caches ---------------===" << std::endl;
+	for (InlineCache *cache : all_caches()) {
+		cache->print(os);
+		if (cache->megamorphic.load())			mega ++;
+		else if (cache->size.load() <= 1)		mono ++;
+		else									poly ++;
+	}
+	os << "total " << all_caches().size() << " call sites: " << mono << " monomorphic, " << poly << " polymorphic, " << mega << " megamorphic." << std::endl;
+	os << "===---------------------------------------------===" << std::endl;
+}
+
+void InlineCache::cleanup()
+{
+	LockGuard lg(all_caches_lock());
+	for (InlineCache *cache : all_caches()) {
+		delete cache;
+	}
+	all_caches().clear();
+}
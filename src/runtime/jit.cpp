@@ -0,0 +1,769 @@
+/*
+ * jit.cpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#include "runtime/jit.hpp"
+#include "runtime/bytecodeEngine.hpp"
+#include "runtime/klass.hpp"
+#include "runtime/constantpool.hpp"
+#include "class_parser.hpp"
+#include "utils/synchronize_wcout.hpp"
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstring>
+#include <chrono>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+
+static const auto vm_start_time = std::chrono::steady_clock::now();		// for -XX:+PrintCompilation.
+
+/*===----------- CodeCache --------------===*/
+
+uint8_t *CodeCache::install(const uint8_t *code, size_t size)
+{
+	if (base() == nullptr) {
+		void *mem = mmap(nullptr, CODE_CACHE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);		// no PROT_EXEC: W^X.
+		if (mem == MAP_FAILED) {
+			return nullptr;
+		}
+		base() = (uint8_t *)mem;
+	}
+	size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+	size_t aligned_size = (size + page_size - 1) & ~(page_size - 1);		// every method starts at a page.
+	if (used() + aligned_size > CODE_CACHE_SIZE) {
+		return nullptr;
+	}
+	uint8_t *target = base() + used();
+	memcpy(target, code, size);
+	__builtin___clear_cache((char *)target, (char *)target + size);
+	if (mprotect(target, aligned_size, PROT_READ | PROT_EXEC) != 0) {		// e.g. refused by SELinux `execmem`.
+		return nullptr;
+	}
+	used() += aligned_size;
+	return target;
+}
+
+void CodeCache::cleanup()
+{
+	if (base() != nullptr) {
+		munmap(base(), CODE_CACHE_SIZE);
+		base() = nullptr;
+		used() = 0;
+	}
+}
+
+#if defined(__x86_64__) && defined(__linux__)
+
+/*===----------- Assembler --------------===*/
+
+namespace {
+
+enum Register { RAX = 0, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15 };
+
+enum Condition { CC_O = 0, CC_NO, CC_B, CC_AE, CC_E, CC_NE, CC_BE, CC_A, CC_S, CC_NS, CC_P, CC_NP, CC_L, CC_GE, CC_LE, CC_G };
+
+enum AluOp { ALU_ADD = 0, ALU_OR = 1, ALU_AND = 4, ALU_SUB = 5, ALU_XOR = 6, ALU_CMP = 7 };		// the `/digit` of the 0x81/0x83 forms.
+
+struct Address {
+	Register base;
+	int disp;
+};
+
+struct Label {
+	int pos = -1;
+	std::vector<int> fixups;		// rel32 fields waiting for `pos`.
+};
+
+/**
+ * a tiny x86-64 assembler, only with the instructions the templates use.
+ * all the jumps are rel32 inside one method, so the code can be copied to the code cache as is.
+ */
+class Assembler {
+private:
+	std::vector<uint8_t> buf;
+private:
+	void emit(uint8_t b) { buf.push_back(b); }
+	void emit32(uint32_t v) { for (int i = 0; i < 4; i ++)	emit((v >> (i * 8)) & 0xff); }
+	void patch32(int pos, uint32_t v) { for (int i = 0; i < 4; i ++)	buf[pos + i] = (v >> (i * 8)) & 0xff; }
+	void rex(bool w, int reg, int base, bool force = false) {
+		uint8_t prefix = 0x40 | (w << 3) | (((reg >> 3) & 1) << 2) | ((base >> 3) & 1);
+		if (prefix != 0x40 || force)	emit(prefix);
+	}
+	void modrm_reg(int reg, int rm) { emit(0xc0 | ((reg & 7) << 3) | (rm & 7)); }
+	void modrm_mem(int reg, Address addr) {
+		int base = addr.base & 7;
+		int mod = (addr.disp == 0 && base != RBP) ? 0 : (addr.disp >= -128 && addr.disp <= 127) ? 1 : 2;
+		emit((mod << 6) | ((reg & 7) << 3) | base);
+		if (base == RSP)	emit(0x24);		// rsp and r12 need a SIB byte.
+		if (mod == 1)		emit((uint8_t)addr.disp);
+		else if (mod == 2)	emit32(addr.disp);
+	}
+	void op_mem(bool w, std::initializer_list<uint8_t> opcode, int reg, Address addr) {
+		rex(w, reg, addr.base);
+		for (uint8_t b : opcode)	emit(b);
+		modrm_mem(reg, addr);
+	}
+	void op_reg(bool w, std::initializer_list<uint8_t> opcode, int reg, int rm) {
+		rex(w, reg, rm);
+		for (uint8_t b : opcode)	emit(b);
+		modrm_reg(reg, rm);
+	}
+	void rel32(Label & label) {
+		if (label.pos >= 0) {
+			emit32(label.pos - ((int)buf.size() + 4));
+		} else {
+			label.fixups.push_back(buf.size());
+			emit32(0);
+		}
+	}
+public:
+	int size() { return buf.size(); }
+	const std::vector<uint8_t> & code() { return buf; }
+	void bind(Label & label) {
+		assert(label.pos < 0);
+		label.pos = buf.size();
+		for (int pos : label.fixups)	patch32(pos, label.pos - (pos + 4));
+		label.fixups.clear();
+	}
+	// loads and stores
+	void movq(Register dst, Address src) { op_mem(true, {0x8b}, dst, src); }
+	void movl(Register dst, Address src) { op_mem(false, {0x8b}, dst, src); }		// zero-extends to 64 bits.
+	void movq(Address dst, Register src) { op_mem(true, {0x89}, src, dst); }
+	void movb(Address dst, Register src) { assert(src < RSP); op_mem(false, {0x88}, src, dst); }
+	void movb(Address dst, uint8_t imm) { op_mem(false, {0xc6}, 0, dst); emit(imm); }
+	void movl(Address dst, int32_t imm) { op_mem(false, {0xc7}, 0, dst); emit32(imm); }
+	void movq(Address dst, int32_t imm) { op_mem(true, {0xc7}, 0, dst); emit32(imm); }		// sign-extended.
+	void movl(Register dst, int32_t imm) { rex(false, 0, dst); emit(0xb8 + (dst & 7)); emit32(imm); }
+	void movq(Register dst, Register src) { op_reg(true, {0x89}, src, dst); }
+	void movq(Register dst, const void *imm) { rex(true, 0, dst); emit(0xb8 + (dst & 7)); emit32((uint64_t)imm); emit32((uint64_t)imm >> 32); }
+	void movzxb(Register dst, Address src) { op_mem(false, {0x0f, 0xb6}, dst, src); }
+	void movsxb(Register dst, Address src) { op_mem(false, {0x0f, 0xbe}, dst, src); }
+	void movzxw(Register dst, Address src) { op_mem(false, {0x0f, 0xb7}, dst, src); }
+	void movsxw(Register dst, Address src) { op_mem(false, {0x0f, 0xbf}, dst, src); }
+	void movsxd(Register dst, Address src) { op_mem(true, {0x63}, dst, src); }
+	void movsxb(Register dst, Register src) { assert(src < RSP); op_reg(false, {0x0f, 0xbe}, dst, src); }
+	// arithmetic. `w`: 64 bits.
+	void alu(AluOp op, bool w, Register dst, Register src) { op_reg(w, {(uint8_t)(op * 8 + 0x01)}, src, dst); }
+	void alu(AluOp op, bool w, Register dst, Address src) { op_mem(w, {(uint8_t)(op * 8 + 0x03)}, dst, src); }
+	void alu(AluOp op, bool w, Register dst, int32_t imm) {
+		if (imm >= -128 && imm <= 127) { op_reg(w, {0x83}, op, dst); emit((uint8_t)imm); }
+		else						 { op_reg(w, {0x81}, op, dst); emit32(imm); }
+	}
+	void alu(AluOp op, bool w, Address dst, int32_t imm) {
+		if (imm >= -128 && imm <= 127) { op_mem(w, {0x83}, op, dst); emit((uint8_t)imm); }
+		else						 { op_mem(w, {0x81}, op, dst); emit32(imm); }
+	}
+	void imul(bool w, Register dst, Address src) { op_mem(w, {0x0f, 0xaf}, dst, src); }
+	void neg(bool w, Register dst) { op_reg(w, {0xf7}, 3, dst); }
+	void idiv(bool w, Register src) { op_reg(w, {0xf7}, 7, src); }
+	void sign_extend_rax(bool w) { if (w) emit(0x48); emit(0x99); }		// cdq / cqo
+	void shl_cl(bool w, Register dst) { op_reg(w, {0xd3}, 4, dst); }
+	void shr_cl(bool w, Register dst) { op_reg(w, {0xd3}, 5, dst); }
+	void sar_cl(bool w, Register dst) { op_reg(w, {0xd3}, 7, dst); }
+	void test(bool w, Register a, Register b) { op_reg(w, {0x85}, b, a); }
+	void setcc(Condition cc, Register dst) { assert(dst < RSP); op_reg(false, {0x0f, (uint8_t)(0x90 + cc)}, 0, dst); }
+	// control flow
+	void jcc(Condition cc, Label & label) { emit(0x0f); emit(0x80 + cc); rel32(label); }
+	void jmp(Label & label) { emit(0xe9); rel32(label); }
+	void jmp(Register target) { op_reg(false, {0xff}, 4, target); }
+	void push(Register reg) { rex(false, 0, reg); emit(0x50 + (reg & 7)); }
+	void pop(Register reg) { rex(false, 0, reg); emit(0x58 + (reg & 7)); }
+	void ret() { emit(0xc3); }
+};
+
+/*===----------- TemplateCompiler --------------===*/
+
+// the registers of the compiled code. all callee-saved, so they needn't be saved around the calls into the vm.
+const Register FRAME = RBX;			// StackFrame *
+const Register LOCALS = R12;		// lvt slots
+const Register LOCAL_TAGS = R13;
+const Register STACK = R14;			// op_stack slots
+const Register STACK_TAGS = R15;
+
+const int HUGE_METHOD_LIMIT = 8000;		// bytes of bytecode. bigger methods are always interpreted.
+
+/**
+ * compiles one method by pasting a machine code template for every bytecode.
+ * the stack depth before every bytecode is known at compile time, so the templates address the op_stack slots directly
+ * and `OperandStack::sp` is only written back when the code goes back to the interpreter.
+ * the bytecodes without a template go back to the interpreter, and the interpreter goes on with them.
+ */
+class TemplateCompiler {
+private:
+	Method *method;
+	uint8_t *code;
+	int code_length;
+	int max_stack;
+	const Code_attribute *code_attr;
+	rt_constant_pool *rt_pool;
+	std::vector<int> depth;				// the op_stack depth before every bytecode. -1: not the start of a reachable bytecode.
+	Assembler masm;
+	std::vector<Label> bci_labels;
+	std::vector<Label> slow_labels;		// the slow paths of the templates: go back to the interpreter and run the bytecode there.
+	std::vector<int> slow_bcis;
+	Label epilogue;
+	int template_num = 0;				// bytecodes compiled to templates.
+	const char *fail_reason = nullptr;
+private:
+	static Address local(int index) { return Address{LOCALS, index * 8}; }
+	static Address local_tag(int index) { return Address{LOCAL_TAGS, index}; }
+	static Address stack(int index) { return Address{STACK, index * 8}; }
+	static Address stack_tag(int index) { return Address{STACK_TAGS, index}; }
+	uint8_t bytecode_at(int bci);
+	int s2_at(int bci) { return (int16_t)((code[bci] << 8) | code[bci+1]); }
+	int u2_at(int bci) { return (code[bci] << 8) | code[bci+1]; }
+	int s4_at(int bci) { return (int32_t)(((uint32_t)code[bci] << 24) | (code[bci+1] << 16) | (code[bci+2] << 8) | code[bci+3]); }
+	int length_at(int bci, uint8_t bc);
+	bool stack_effect(int bci, uint8_t bc, int & effect);
+	bool analyze();
+	void emit_prologue();
+	void emit_exit(int bci);
+	Label & slow_path(int bci);
+	void copy_stack_slot(int from, int to);
+	void emit_branch(int bci, Condition cc, bool always);
+	bool emit_template(int bci, uint8_t bc, int d);
+public:
+	TemplateCompiler(Method *method) : method(method), code_attr(method->get_code()), rt_pool(method->get_klass()->get_rtpool()) {
+		code = code_attr->code;
+		code_length = code_attr->code_length;
+		max_stack = code_attr->max_stack;
+	}
+	JitCode *compile(int compile_id, bool is_osr);
+	const char *get_fail_reason() { return fail_reason; }
+};
+
+uint8_t TemplateCompiler::bytecode_at(int bci)
+{
+	// the interpreter may be quickening the bytecodes now. the quickened ones have the same stack effect as the originals.
+	static const uint8_t original[] = { 0x12, 0x13, 0x14, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9 };
+	uint8_t bc = __atomic_load_n(code + bci, __ATOMIC_ACQUIRE);
+	if (bc >= FAST_LDC && bc <= FAST_INVOKEINTERFACE)	return original[bc - FAST_LDC];
+	return bc;
+}
+
+int TemplateCompiler::length_at(int bci, uint8_t bc)
+{
+	if (bc == 0xaa || bc == 0xab) {
+		int base = (bci + 4) & ~3;		// skip the padding.
+		if (bc == 0xaa)	return base - bci + 12 + 4 * (s4_at(base + 8) - s4_at(base + 4) + 1);
+		else			return base - bci + 8 + 8 * s4_at(base + 4);
+	}
+	return bccode_length[bc] + 1;
+}
+
+bool TemplateCompiler::stack_effect(int bci, uint8_t bc, int & effect)
+{
+	static const int8_t effects[0xc8] = {
+		0,  1,  1,  1,  1,  1,  1,  1,  1,  2,  2,  1,  1,  1,  2,  2,		// 0x00
+		1,  1,  1,  1,  2,  1,  2,  1,  2,  1,  1,  1,  1,  1,  2,  2,		// 0x10
+		2,  2,  1,  1,  1,  1,  2,  2,  2,  2,  1,  1,  1,  1, -1,  0,		// 0x20
+		-1, 0, -1, -1, -1, -1, -1, -2, -1, -2, -1, -1, -1, -1, -1, -2,		// 0x30
+		-2, -2, -2, -1, -1, -1, -1, -2, -2, -2, -2, -1, -1, -1, -1, -3,		// 0x40
+		-4, -3, -4, -3, -3, -3, -3, -1, -2,  1,  1,  1,  2,  2,  2,  0,		// 0x50
+		-1, -2, -1, -2, -1, -2, -1, -2, -1, -2, -1, -2, -1, -2, -1, -2,		// 0x60
+		-1, -2, -1, -2,  0,  0,  0,  0, -1, -1, -1, -1, -1, -1, -1, -2,		// 0x70
+		-1, -2, -1, -2,  0,  1,  0,  1, -1, -1,  0,  0,  1,  1, -1,  0,		// 0x80
+		-1,  0,  0,  0, -3, -1, -1, -3, -3, -1, -1, -1, -1, -1, -1, -2,		// 0x90
+		-2, -2, -2, -2, -2, -2, -2,  0,  0,  0, -1, -1, -1, -2, -1, -2,		// 0xa0
+		-1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  0,  0,  0, -1,		// 0xb0
+		0,  0, -1, -1,  0,  0, -1, -1,										// 0xc0
+	};
+	switch (bc) {
+		case 0xa8: case 0xa9: case 0xc4: case 0xc8: case 0xc9:		// jsr, ret, wide, goto_w, jsr_w
+			fail_reason = "unsupported bytecode";
+			return false;
+		case 0xb2: case 0xb3: case 0xb4: case 0xb5: {		// get/put static/field
+			wstring descriptor = rt_pool->symbolic_descriptor(u2_at(bci + 1) - 1);
+			int size = (descriptor[0] == L'J' || descriptor[0] == L'D') ? 2 : 1;
+			effect = (bc == 0xb2) ? size : (bc == 0xb3) ? -size : (bc == 0xb4) ? size - 1 : -size - 1;
+			return true;
+		}
+		case 0xb6: case 0xb7: case 0xb8: case 0xb9: case 0xba: {		// invokes
+			wstring descriptor = rt_pool->symbolic_descriptor(u2_at(bci + 1) - 1);
+			vector<wchar_t> arg_kinds;
+			int arg_slot_num;
+			wchar_t ret_kind = Method::parse_descriptor_kinds(descriptor, arg_kinds, arg_slot_num);
+			int ret_size = (ret_kind == L'V') ? 0 : (ret_kind == L'J' || ret_kind == L'D') ? 2 : 1;
+			effect = ret_size - arg_slot_num - ((bc == 0xb8 || bc == 0xba) ? 0 : 1);
+			return true;
+		}
+		case 0xc5:		// multianewarray
+			effect = 1 - code[bci + 3];
+			return true;
+		default:
+			if (bc >= sizeof(effects)) {
+				fail_reason = "unknown bytecode";
+				return false;
+			}
+			effect = effects[bc];
+			return true;
+	}
+}
+
+bool TemplateCompiler::analyze()
+{
+	depth.assign(code_length, -1);
+	std::vector<int> worklist;
+	auto reach = [&](int bci, int d) -> bool {
+		if (bci < 0 || bci >= code_length) {
+			fail_reason = "branch out of the code";
+			return false;
+		}
+		if (depth[bci] == -1) {
+			depth[bci] = d;
+			worklist.push_back(bci);
+		} else if (depth[bci] != d) {
+			fail_reason = "inconsistent stack depth";
+			return false;
+		}
+		return true;
+	};
+	if (!reach(0, 0))	return false;
+	for (int i = 0; i < code_attr->exception_table_length; i ++) {
+		if (!reach(code_attr->exception_table[i].handler_pc, 1))	return false;		// only the exception on the stack.
+	}
+	while (!worklist.empty()) {
+		int bci = worklist.back();
+		worklist.pop_back();
+		uint8_t bc = bytecode_at(bci);
+		int effect;
+		if (!stack_effect(bci, bc, effect))	return false;
+		int after = depth[bci] + effect;
+		if (after < 0 || after > max_stack) {
+			fail_reason = "op_stack out of bounds";
+			return false;
+		}
+		int next = bci + length_at(bci, bc);
+		bool ok = true;
+		if ((bc >= 0x99 && bc <= 0xa6) || bc == 0xc6 || bc == 0xc7) {		// if<cond>, if_icmp<cond>, if_acmp<cond>, ifnull, ifnonnull
+			ok = reach(bci + s2_at(bci + 1), after) && reach(next, after);
+		} else if (bc == 0xa7) {		// goto
+			ok = reach(bci + s2_at(bci + 1), after);
+		} else if (bc == 0xaa || bc == 0xab) {		// tableswitch, lookupswitch
+			int base = (bci + 4) & ~3;
+			ok = reach(bci + s4_at(base), after);
+			if (bc == 0xaa) {
+				int num = s4_at(base + 8) - s4_at(base + 4) + 1;
+				for (int i = 0; ok && i < num; i ++)	ok = reach(bci + s4_at(base + 12 + 4 * i), after);
+			} else {
+				int num = s4_at(base + 4);
+				for (int i = 0; ok && i < num; i ++)	ok = reach(bci + s4_at(base + 12 + 8 * i), after);
+			}
+		} else if ((bc >= 0xac && bc <= 0xb1) || bc == 0xbf) {		// returns, athrow
+			// no successor.
+		} else {
+			ok = reach(next, after);
+		}
+		if (!ok)	return false;
+	}
+	return true;
+}
+
+// int entry(StackFrame *frame, uint8_t *target, const void *poll): save the callee-saved registers, load the frame's slots, and jump to `target`.
+void TemplateCompiler::emit_prologue()
+{
+	masm.push(RBP);
+	masm.movq(RBP, RSP);
+	masm.push(RBX);
+	masm.push(R12);
+	masm.push(R13);
+	masm.push(R14);
+	masm.push(R15);
+	masm.push(RDX);		// the safepoint poll word, in the slot which keeps rsp 16-byte aligned. see: `emit_branch()`.
+	masm.movq(FRAME, RDI);
+	masm.movq(LOCALS, Address{FRAME, (int)(offsetof(StackFrame, localVariableTable) + offsetof(LocalVariableTable, slots))});
+	masm.movq(LOCAL_TAGS, Address{FRAME, (int)(offsetof(StackFrame, localVariableTable) + offsetof(LocalVariableTable, tags))});
+	masm.movq(STACK, Address{FRAME, (int)(offsetof(StackFrame, op_stack) + offsetof(OperandStack, slots))});
+	masm.movq(STACK_TAGS, Address{FRAME, (int)(offsetof(StackFrame, op_stack) + offsetof(OperandStack, tags))});
+	masm.jmp(RSI);
+}
+
+// go back to the interpreter at `bci`: write back the op_stack's sp, and return the bci.
+void TemplateCompiler::emit_exit(int bci)
+{
+	masm.movl(Address{FRAME, (int)(offsetof(StackFrame, op_stack) + offsetof(OperandStack, sp))}, depth[bci]);
+	masm.movl(RAX, bci);
+	masm.jmp(epilogue);
+}
+
+Label & TemplateCompiler::slow_path(int bci)
+{
+	if (slow_labels[bci].pos < 0 && slow_labels[bci].fixups.empty()) {
+		slow_bcis.push_back(bci);
+	}
+	return slow_labels[bci];
+}
+
+void TemplateCompiler::copy_stack_slot(int from, int to)
+{
+	masm.movq(RAX, stack(from));
+	masm.movq(stack(to), RAX);
+	masm.movzxb(RAX, stack_tag(from));
+	masm.movb(stack_tag(to), RAX);
+}
+
+// jump to the branch target of the bytecode at `bci` if `cc` (or `always`). a taken backward branch counts in the method's back-edge counter,
+// and polls: if a safepoint is in progress, go back to the interpreter at the target, which stops there.
+void TemplateCompiler::emit_branch(int bci, Condition cc, bool always)
+{
+	int target = bci + s2_at(bci + 1);
+	if (target > bci) {
+		if (always)	masm.jmp(bci_labels[target]);
+		else		masm.jcc(cc, bci_labels[target]);
+		return;
+	}
+	Label not_taken;
+	if (!always)	masm.jcc((Condition)(cc ^ 1), not_taken);		// the x86 conditions come in pairs: cc ^ 1 is the negation.
+	masm.movq(RAX, &method->get_backedge_counter());
+	masm.alu(ALU_ADD, false, Address{RAX, 0}, 1);		// the same as `Method::inc_backedge_counter`, without the jit check.
+	masm.movq(RAX, Address{RSP, 0});
+	masm.alu(ALU_CMP, false, Address{RAX, 0}, 0);
+	masm.jcc(CC_NE, slow_path(target));
+	masm.jmp(bci_labels[target]);
+	if (!always)	masm.bind(not_taken);
+}
+
+// emit the template of the bytecode at `bci`, whose stack depth is `d`. false if the bytecode has no template.
+bool TemplateCompiler::emit_template(int bci, uint8_t bc, int d)
+{
+	static const Condition conditions[] = { CC_E, CC_NE, CC_L, CC_GE, CC_G, CC_LE };		// eq, ne, lt, ge, gt, le
+	switch (bc) {
+		case 0x00:		// nop
+			return true;
+		case 0x01:		// aconst_null
+			masm.movq(stack(d), 0);
+			masm.movb(stack_tag(d), SLOT_REFERENCE);
+			return true;
+		case 0x02: case 0x03: case 0x04: case 0x05: case 0x06: case 0x07: case 0x08:		// iconst_<i>
+		case 0x10: case 0x11: {		// bipush, sipush
+			int value = (bc == 0x10) ? (int8_t)code[bci + 1] : (bc == 0x11) ? s2_at(bci + 1) : bc - 0x03;
+			masm.movl(RAX, value);		// the upper half of an int slot is 0, the same as `OperandStack::push_int`.
+			masm.movq(stack(d), RAX);
+			masm.movb(stack_tag(d), SLOT_PRIMITIVE);
+			return true;
+		}
+		case 0x09: case 0x0a:		// lconst_<l>
+			masm.movq(stack(d), bc - 0x09);
+			masm.movb(stack_tag(d), SLOT_PRIMITIVE);
+			masm.movb(stack_tag(d + 1), SLOT_PRIMITIVE);
+			return true;
+		case 0x15: case 0x17: case 0x19:		// iload, fload, aload
+		case 0x1a: case 0x1b: case 0x1c: case 0x1d: case 0x22: case 0x23: case 0x24: case 0x25: case 0x2a: case 0x2b: case 0x2c: case 0x2d: {
+			int index = (bc < 0x1a) ? code[bci + 1] : (bc - 0x1a) % 4;
+			masm.movq(RAX, local(index));
+			masm.movq(stack(d), RAX);
+			masm.movb(stack_tag(d), (bc == 0x19 || bc >= 0x2a) ? SLOT_REFERENCE : SLOT_PRIMITIVE);
+			return true;
+		}
+		case 0x16: case 0x18:		// lload, dload
+		case 0x1e: case 0x1f: case 0x20: case 0x21: case 0x26: case 0x27: case 0x28: case 0x29: {
+			int index = (bc < 0x1a) ? code[bci + 1] : (bc - 0x1e) % 4;
+			masm.movq(RAX, local(index));
+			masm.movq(stack(d), RAX);
+			masm.movb(stack_tag(d), SLOT_PRIMITIVE);
+			masm.movb(stack_tag(d + 1), SLOT_PRIMITIVE);
+			return true;
+		}
+		case 0x36: case 0x38: case 0x3a:		// istore, fstore, astore
+		case 0x3b: case 0x3c: case 0x3d: case 0x3e: case 0x43: case 0x44: case 0x45: case 0x46: case 0x4b: case 0x4c: case 0x4d: case 0x4e: {
+			int index = (bc < 0x3b) ? code[bci + 1] : (bc - 0x3b) % 4;
+			masm.movq(RAX, stack(d - 1));
+			masm.movq(local(index), RAX);
+			masm.movb(local_tag(index), (bc == 0x3a || bc >= 0x4b) ? SLOT_REFERENCE : SLOT_PRIMITIVE);
+			return true;
+		}
+		case 0x37: case 0x39:		// lstore, dstore
+		case 0x3f: case 0x40: case 0x41: case 0x42: case 0x47: case 0x48: case 0x49: case 0x4a: {
+			int index = (bc < 0x3b) ? code[bci + 1] : (bc - 0x3f) % 4;
+			masm.movq(RAX, stack(d - 2));
+			masm.movq(local(index), RAX);
+			masm.movb(local_tag(index), SLOT_PRIMITIVE);
+			masm.movb(local_tag(index + 1), SLOT_PRIMITIVE);
+			return true;
+		}
+		case 0x57: case 0x58:		// pop, pop2
+			return true;
+		case 0x59:		// dup
+			copy_stack_slot(d - 1, d);
+			return true;
+		case 0x5a:		// dup_x1
+			copy_stack_slot(d - 1, d);
+			copy_stack_slot(d - 2, d - 1);
+			copy_stack_slot(d, d - 2);
+			return true;
+		case 0x5b:		// dup_x2
+			copy_stack_slot(d - 1, d);
+			copy_stack_slot(d - 2, d - 1);
+			copy_stack_slot(d - 3, d - 2);
+			copy_stack_slot(d, d - 3);
+			return true;
+		case 0x5c:		// dup2
+			copy_stack_slot(d - 2, d);
+			copy_stack_slot(d - 1, d + 1);
+			return true;
+		case 0x5d:		// dup2_x1
+			copy_stack_slot(d - 1, d + 1);
+			copy_stack_slot(d - 2, d);
+			copy_stack_slot(d - 3, d - 1);
+			copy_stack_slot(d + 1, d - 2);
+			copy_stack_slot(d, d - 3);
+			return true;
+		case 0x5e:		// dup2_x2
+			copy_stack_slot(d - 1, d + 1);
+			copy_stack_slot(d - 2, d);
+			copy_stack_slot(d - 3, d - 1);
+			copy_stack_slot(d - 4, d - 2);
+			copy_stack_slot(d + 1, d - 3);
+			copy_stack_slot(d, d - 4);
+			return true;
+		case 0x5f:		// swap. slot `d` may be out of the op_stack, so swap in registers.
+			masm.movq(RAX, stack(d - 1));
+			masm.movq(RCX, stack(d - 2));
+			masm.movq(stack(d - 2), RAX);
+			masm.movq(stack(d - 1), RCX);
+			masm.movzxb(RAX, stack_tag(d - 1));
+			masm.movzxb(RCX, stack_tag(d - 2));
+			masm.movb(stack_tag(d - 2), RAX);
+			masm.movb(stack_tag(d - 1), RCX);
+			return true;
+		case 0x60: case 0x64: case 0x7e: case 0x80: case 0x82: {		// iadd, isub, iand, ior, ixor
+			AluOp op = (bc == 0x60) ? ALU_ADD : (bc == 0x64) ? ALU_SUB : (bc == 0x7e) ? ALU_AND : (bc == 0x80) ? ALU_OR : ALU_XOR;
+			masm.movl(RAX, stack(d - 2));
+			masm.alu(op, false, RAX, stack(d - 1));
+			masm.movq(stack(d - 2), RAX);
+			return true;
+		}
+		case 0x61: case 0x65: case 0x7f: case 0x81: case 0x83: {		// ladd, lsub, land, lor, lxor
+			AluOp op = (bc == 0x61) ? ALU_ADD : (bc == 0x65) ? ALU_SUB : (bc == 0x7f) ? ALU_AND : (bc == 0x81) ? ALU_OR : ALU_XOR;
+			masm.movq(RAX, stack(d - 4));
+			masm.alu(op, true, RAX, stack(d - 2));
+			masm.movq(stack(d - 4), RAX);
+			return true;
+		}
+		case 0x68:		// imul
+			masm.movl(RAX, stack(d - 2));
+			masm.imul(false, RAX, stack(d - 1));
+			masm.movq(stack(d - 2), RAX);
+			return true;
+		case 0x69:		// lmul
+			masm.movq(RAX, stack(d - 4));
+			masm.imul(true, RAX, stack(d - 2));
+			masm.movq(stack(d - 4), RAX);
+			return true;
+		case 0x6c: case 0x70: case 0x6d: case 0x71: {		// idiv, irem, ldiv, lrem
+			bool w = (bc == 0x6d || bc == 0x71);
+			bool rem = (bc == 0x70 || bc == 0x71);
+			int dividend = w ? d - 4 : d - 2, divisor = w ? d - 2 : d - 1;
+			Label not_minus_one, done;
+			if (w)	masm.movq(RCX, stack(divisor));
+			else	masm.movl(RCX, stack(divisor));
+			masm.test(w, RCX, RCX);
+			masm.jcc(CC_E, slow_path(bci));		// the interpreter throws the ArithmeticException.
+			if (w)	masm.movq(RAX, stack(dividend));
+			else	masm.movl(RAX, stack(dividend));
+			masm.alu(ALU_CMP, w, RCX, -1);		// MIN_VALUE / -1 traps on x86, and -x is the same for all the dividends.
+			masm.jcc(CC_NE, not_minus_one);
+			if (rem)	masm.alu(ALU_XOR, false, RAX, RAX);
+			else		masm.neg(w, RAX);
+			masm.jmp(done);
+			masm.bind(not_minus_one);
+			masm.sign_extend_rax(w);
+			masm.idiv(w, RCX);
+			if (rem)	masm.movq(RAX, RDX);
+			masm.bind(done);		// the 32-bit instructions have zeroed the upper half of rax.
+			masm.movq(stack(dividend), RAX);
+			return true;
+		}
+		case 0x74:		// ineg
+			masm.movl(RAX, stack(d - 1));
+			masm.neg(false, RAX);
+			masm.movq(stack(d - 1), RAX);
+			return true;
+		case 0x75:		// lneg
+			masm.movq(RAX, stack(d - 2));
+			masm.neg(true, RAX);
+			masm.movq(stack(d - 2), RAX);
+			return true;
+		case 0x78: case 0x7a: case 0x7c: {		// ishl, ishr, iushr. x86 masks the count with 0x1f, the same as java.
+			masm.movl(RCX, stack(d - 1));
+			masm.movl(RAX, stack(d - 2));
+			if (bc == 0x78)			masm.shl_cl(false, RAX);
+			else if (bc == 0x7a)	masm.sar_cl(false, RAX);
+			else					masm.shr_cl(false, RAX);
+			masm.movq(stack(d - 2), RAX);
+			return true;
+		}
+		case 0x79: case 0x7b: case 0x7d: {		// lshl, lshr, lushr. the count is an int, and x86 masks it with 0x3f.
+			masm.movl(RCX, stack(d - 1));
+			masm.movq(RAX, stack(d - 3));
+			if (bc == 0x79)			masm.shl_cl(true, RAX);
+			else if (bc == 0x7b)	masm.sar_cl(true, RAX);
+			else					masm.shr_cl(true, RAX);
+			masm.movq(stack(d - 3), RAX);
+			return true;
+		}
+		case 0x84: {		// iinc
+			int index = code[bci + 1];
+			masm.alu(ALU_ADD, false, local(index), (int8_t)code[bci + 2]);
+			return true;
+		}
+		case 0x85:		// i2l
+			masm.movsxd(RAX, stack(d - 1));
+			masm.movq(stack(d - 1), RAX);
+			masm.movb(stack_tag(d), SLOT_PRIMITIVE);
+			return true;
+		case 0x88:		// l2i
+			masm.movl(RAX, stack(d - 2));
+			masm.movq(stack(d - 2), RAX);
+			return true;
+		case 0x91: case 0x92: case 0x93:		// i2b, i2c, i2s
+			if (bc == 0x91)			masm.movsxb(RAX, stack(d - 1));
+			else if (bc == 0x92)	masm.movzxw(RAX, stack(d - 1));
+			else					masm.movsxw(RAX, stack(d - 1));
+			masm.movq(stack(d - 1), RAX);
+			return true;
+		case 0x94:		// lcmp
+			masm.movq(RAX, stack(d - 4));
+			masm.alu(ALU_CMP, true, RAX, stack(d - 2));
+			masm.setcc(CC_G, RAX);
+			masm.setcc(CC_L, RCX);
+			masm.alu(ALU_SUB, false, RAX, RCX);		// al = (v1 > v2) - (v1 < v2)
+			masm.movsxb(RAX, RAX);
+			masm.movq(stack(d - 4), RAX);
+			return true;
+		case 0x99: case 0x9a: case 0x9b: case 0x9c: case 0x9d: case 0x9e:		// if<cond>
+			masm.alu(ALU_CMP, false, stack(d - 1), 0);
+			emit_branch(bci, conditions[bc - 0x99], false);
+			return true;
+		case 0x9f: case 0xa0: case 0xa1: case 0xa2: case 0xa3: case 0xa4:		// if_icmp<cond>
+			masm.movl(RAX, stack(d - 2));
+			masm.alu(ALU_CMP, false, RAX, stack(d - 1));
+			emit_branch(bci, conditions[bc - 0x9f], false);
+			return true;
+		case 0xa5: case 0xa6:		// if_acmpeq, if_acmpne
+			masm.movq(RAX, stack(d - 2));
+			masm.alu(ALU_CMP, true, RAX, stack(d - 1));
+			emit_branch(bci, bc == 0xa5 ? CC_E : CC_NE, false);
+			return true;
+		case 0xc6: case 0xc7:		// ifnull, ifnonnull
+			masm.alu(ALU_CMP, true, stack(d - 1), 0);
+			emit_branch(bci, bc == 0xc6 ? CC_E : CC_NE, false);
+			return true;
+		case 0xa7:		// goto
+			emit_branch(bci, CC_E, true);
+			return true;
+		default:
+			return false;
+	}
+}
+
+JitCode *TemplateCompiler::compile(int compile_id, bool is_osr)
+{
+	if (code_length > HUGE_METHOD_LIMIT) {
+		fail_reason = "method too big";
+		return nullptr;
+	}
+	if (!analyze())	return nullptr;
+
+	bci_labels.resize(code_length);
+	slow_labels.resize(code_length);
+	std::vector<int> entries(code_length, -1);
+	emit_prologue();
+	for (int bci = 0; bci < code_length; bci ++) {
+		if (depth[bci] == -1)	continue;
+		masm.bind(bci_labels[bci]);
+		entries[bci] = masm.size();
+		uint8_t bc = bytecode_at(bci);
+		if (emit_template(bci, bc, depth[bci])) {
+			template_num ++;
+		} else {
+			emit_exit(bci);
+		}
+	}
+	for (int bci : slow_bcis) {
+		masm.bind(slow_labels[bci]);
+		emit_exit(bci);
+	}
+	masm.bind(epilogue);
+	masm.alu(ALU_ADD, true, RSP, 8);
+	masm.pop(R15);
+	masm.pop(R14);
+	masm.pop(R13);
+	masm.pop(R12);
+	masm.pop(RBX);
+	masm.pop(RBP);
+	masm.ret();
+
+	if (template_num == 0) {
+		fail_reason = "no bytecode to compile";
+		return nullptr;
+	}
+	uint8_t *target = CodeCache::install(masm.code().data(), masm.size());
+	if (target == nullptr) {
+		fail_reason = "code cache is full, or can't be made executable";
+		return nullptr;
+	}
+	return new JitCode(method, target, masm.size(), std::move(entries), compile_id, is_osr);
+}
+
+}	// namespace
+
+#endif	// x86-64 Linux
+
+/*===----------- Jit --------------===*/
+
+JitCode *Jit::compile(Method *method, bool is_osr)
+{
+	LockGuard lg(compile_lock());
+	JitCode *jit_code = method->get_jit_code().load(std::memory_order_acquire);
+	if (jit_code != nullptr || method->get_not_compilable().load(std::memory_order_relaxed)) {		// another thread has done it.
+		return jit_code;
+	}
+
+	static int compile_num = 0;
+	int compile_id = ++ compile_num;
+	const char *fail_reason;
+#if defined(__x86_64__) && defined(__linux__)
+	TemplateCompiler compiler(method);
+	jit_code = compiler.compile(compile_id, is_osr);
+	fail_reason = compiler.get_fail_reason();
+#else
+	fail_reason = "the jit only supports x86-64 Linux";
+#endif
+
+	if (VMOptions::print_compilation()) {
+		auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - vm_start_time).count();
+		std::wostringstream ss;
+		ss << std::setw(8) << ms << std::setw(6) << compile_id << (is_osr ? L"  % " : L"    ")
+		   << method->get_klass()->get_name() << L"::" << method->get_name() << L":" << method->get_descriptor()
+		   << L" (" << method->get_code()->code_length << L" bytes)";
+		if (jit_code != nullptr)	ss << L" -> " << jit_code->get_code_size() << L" bytes";
+		else						ss << L"   COMPILE SKIPPED: " << fail_reason;
+		std::wcout << ss.str() << std::endl;
+	}
+#ifdef BYTECODE_DEBUG
+	sync_wcout{} << "(DEBUG) jit " << (jit_code != nullptr ? "compiled " : "skipped ") << method->get_klass()->get_name() << "::" << method->get_name() << ":" << method->get_descriptor() << std::endl;
+#endif
+
+	if (jit_code == nullptr) {
+		method->get_not_compilable().store(true, std::memory_order_relaxed);
+		return nullptr;
+	}
+	all_codes().push_back(jit_code);
+	method->get_jit_code().store(jit_code, std::memory_order_release);		// publish it after the code is in the code cache.
+	return jit_code;
+}
+
+void Jit::cleanup()
+{
+	LockGuard lg(compile_lock());
+	for (JitCode *jit_code : all_codes()) {
+		jit_code->method->get_jit_code().store(nullptr, std::memory_order_relaxed);
+		delete jit_code;
+	}
+	all_codes().clear();
+	CodeCache::cleanup();
+}
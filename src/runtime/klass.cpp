@@ -11,6 +11,7 @@
 #include "classloader.hpp"
 #include "runtime/constantpool.hpp"
 #include "runtime/oop.hpp"
+#include "runtime/reference_processor.hpp"
 #include <utility>
 #include <cstring>
 #include <sstream>
@@ -88,8 +89,8 @@ void Rt_Pool::cleanup() {
 /*===----------------  InstanceKlass  ------------------===*/
 void InstanceKlass::parse_fields(ClassFile *cf)
 {
-	// ** first copy parent's non-static fields / interfaces' non-static fields here ** (don't copy static fields !!)
-	// 1. super_klass
+	// ** first copy parent's non-static fields here ** (don't copy static fields !!)
+	// 1. super_klass. parent's layout is the prefix of this klass's, so an inherited field has the same offset in all subclasses.
 	if (this->parent != nullptr) {		// if this_klass is **NOT** java.lang.Object
 		auto & super_map = ((InstanceKlass *)this->parent)->fields_layout;
 #ifdef DEBUG
@@ -100,34 +101,36 @@ void InstanceKlass::parse_fields(ClassFile *cf)
 			this->is_this_klass_field.insert(make_pair(this->fields_layout[iter.first].first, false));		// not this klass's field. it's parents'
 		}
 		this->total_non_static_fields_num = ((InstanceKlass *)this->parent)->total_non_static_fields_num;
-	}
-	// 2. interfaces
-	for (auto iter : this->interfaces) {
-		auto layout = iter.second->fields_layout;
-		for (auto field_iter : layout) {
-			this->fields_layout[iter.first] = make_pair(total_non_static_fields_num, field_iter.second.second);
-			total_non_static_fields_num ++;
-			this->is_this_klass_field.insert(make_pair(this->fields_layout[iter.first].first, false));		// as above
-		}
-	}
+		this->total_non_static_fields_bytes = ((InstanceKlass *)this->parent)->total_non_static_fields_bytes;
+		this->oop_fields_offsets = ((InstanceKlass *)this->parent)->oop_fields_offsets;
+		this->reference_type = ((InstanceKlass *)this->parent)->reference_type;
+	}
+	if (this->name == L"java/lang/ref/SoftReference")			this->reference_type = REF_SOFT;
+	else if (this->name == L"java/lang/ref/WeakReference")		this->reference_type = REF_WEAK;
+	else if (this->name == L"java/lang/ref/PhantomReference")	this->reference_type = REF_PHANTOM;
+	// 2. interfaces: only have static fields. (JVMS 4.5: fields of interfaces must be `public static final`)
 	// 3. this_klass
 	wstringstream ss;
+	vector<Field_info *> this_klass_fields;
 	// set up Runtime Field_info to transfer Non-Dynamic field_info
 	for (int i = 0; i < cf->fields_count; i ++) {
 		Field_info *metaField = new Field_info(this, cf->fields[i], cf->constant_pool);
 		Field_Pool::put(metaField);		// put it into global area
-		if (!metaField->is_static()) {
-			ss << metaField->get_klass()->get_name() << L":";		// for fixing bug: must have the namespace in field_layout... !!!
-		}
-		ss << metaField->get_name() << L":" << metaField->get_descriptor();
 		if(metaField->is_static()) {	// static field
+			ss << metaField->get_name() << L":" << metaField->get_descriptor();
 			this->static_fields_layout.insert(make_pair(ss.str(), make_pair(total_static_fields_num, metaField)));
 			total_static_fields_num ++;	// offset +++
-		} else {		// non-static field
-			this->fields_layout.insert(make_pair(ss.str(), make_pair(total_non_static_fields_num, metaField)));
-			this->is_this_klass_field.insert(make_pair(total_non_static_fields_num, true));		// field in this klass
-			total_non_static_fields_num ++;
+			ss.str(L"");
+		} else {		// non-static field: give it an offset below.
+			this_klass_fields.push_back(metaField);
 		}
+	}
+	layout_fields(this_klass_fields);
+	for (Field_info *metaField : this_klass_fields) {
+		ss << metaField->get_klass()->get_name() << L":" << metaField->get_name() << L":" << metaField->get_descriptor();		// for fixing bug: must have the namespace in field_layout... !!!
+		this->fields_layout.insert(make_pair(ss.str(), make_pair(metaField->get_offset(), metaField)));
+		this->is_this_klass_field.insert(make_pair(metaField->get_offset(), true));		// field in this klass
+		total_non_static_fields_num ++;
 		ss.str(L"");
 	}
 
@@ -140,6 +143,8 @@ void InstanceKlass::parse_fields(ClassFile *cf)
 
 	// initialize static BasicTypeOop...
 	initialize_field(this->static_fields_layout, this->static_fields);
+	// the gc reads and writes the fields of java/lang/ref raw.
+	ReferenceProcessor::register_klass(this);
 
 #ifdef KLASS_DEBUG
 	sync_wcout{} << "===--------------- (" << this->get_name() << ") Debug Runtime FieldPool ---------------===" << std::endl;
@@ -158,6 +163,45 @@ void InstanceKlass::parse_fields(ClassFile *cf)
 #endif
 }
 
+static int field_width(wchar_t kind)		// aux
+{
+	switch (kind) {
+		case L'Z':
+		case L'B':	return 1;
+		case L'C':
+		case L'S':	return 2;
+		case L'I':
+		case L'F':	return 4;
+		case L'J':
+		case L'D':	return 8;
+		default:		return sizeof(Oop *);		// L, [
+	}
+}
+
+void InstanceKlass::layout_fields(vector<Field_info *> & this_klass_fields)
+{
+	// pack this klass's fields after the parent's: references first (so gc sees them as one group), then the primitives
+	// from the widest to the narrowest, so that every value is aligned to its width with padding only before the first one.
+	std::stable_sort(this_klass_fields.begin(), this_klass_fields.end(), [](Field_info *a, Field_info *b){
+		bool a_is_ref = (a->get_descriptor()[0] == L'L' || a->get_descriptor()[0] == L'[');
+		bool b_is_ref = (b->get_descriptor()[0] == L'L' || b->get_descriptor()[0] == L'[');
+		if (a_is_ref != b_is_ref)	return a_is_ref;
+		return field_width(a->get_descriptor()[0]) > field_width(b->get_descriptor()[0]);
+	});
+	int offset = this->total_non_static_fields_bytes;
+	for (Field_info *field : this_klass_fields) {
+		wchar_t kind = field->get_descriptor()[0];
+		int width = field_width(kind);
+		offset = (offset + width - 1) & ~(width - 1);
+		field->set_offset(offset);
+		if (kind == L'L' || kind == L'[') {
+			this->oop_fields_offsets.push_back(offset);
+		}
+		offset += width;
+	}
+	this->total_non_static_fields_bytes = (offset + sizeof(Oop *) - 1) & ~(sizeof(Oop *) - 1);		// keep the next oop aligned.
+}
+
 void InstanceKlass::parse_superclass(ClassFile *cf, ClassLoader *loader)
 {
 	if (cf->super_class == 0) {	// this class = java/lang/Object
@@ -221,6 +265,7 @@ void InstanceKlass::parse_methods(ClassFile *cf)
 	if (this->parent != nullptr) {	// if this class is not java.lang.Object
 		InstanceKlass *the_parent = ((InstanceKlass *)parent);
 		this->vtable = the_parent->vtable;		// copy directly
+		this->vtable_slots = the_parent->vtable_slots;
 	}
 
 	// traverse all this.Methods
@@ -234,16 +279,26 @@ void InstanceKlass::parse_methods(ClassFile *cf)
 		this->methods.insert(make_pair(signature, make_pair(i, method)));
 		// override method into [vtable]
 //		auto iter = std::find_if(vtable.begin(), vtable.end(), [method](Method *lhs){ return *method == *lhs; });	// 这个 lambda 还挺好看，留下了。
-		auto iter = vtable.find(signature);
-		if (iter == vtable.end()) {
-			if (!method->is_static()/* && !method->is_private()*/)		// bug report: private is also in vtable！！
-				vtable.insert(make_pair(signature, method));
+		auto iter = vtable_slots.find(signature);
+		if (iter == vtable_slots.end()) {
+			if (!method->is_static()/* && !method->is_private()*/) {		// bug report: private is also in vtable！！
+				method->set_vtable_index(vtable.size());
+				vtable_slots.insert(make_pair(signature, vtable.size()));
+				vtable.push_back(method);
+			}
 		} else {
-			iter->second = method;		// override parent's method
+			method->set_vtable_index(iter->second);
+			vtable[iter->second] = method;		// override parent's method
+		}
+		// an interface's own methods make up its itable block.
+		if (this->is_interface() && !method->is_static() && method->get_name() != L"<clinit>") {
+			method->set_itable_index(itable.size());
+			itable.push_back(method);
 		}
 
 		ss.str(L"");		// make empty
 	}
+	link_itable();
 #ifdef KLASS_DEBUG
 	sync_wcout{} << "===--------------- (" << this->get_name() << ") Debug Runtime MethodPool ---------------===" << std::endl;
 	sync_wcout{} << "methods: total " << this->methods.size() << std::endl;
@@ -618,15 +673,78 @@ bool InstanceKlass::check_interfaces(const wstring & signature)
 
 Method *InstanceKlass::search_vtable(const wstring & signature)
 {
-	auto iter = this->vtable.find(signature);
-	if (iter == this->vtable.end()) {
+	auto iter = this->vtable_slots.find(signature);
+	if (iter == this->vtable_slots.end()) {
 		return nullptr;
 	}
-	return iter->second;
+	return this->vtable[iter->second];
+}
+
+void InstanceKlass::link_itable()
+{
+	if (this->is_interface())	return;		// interface's itable is only its own methods. (made in `parse_methods`)
+	// parent's interfaces first, so the blocks have the same order as the parent's. then this klass's own interfaces.
+	if (this->parent != nullptr) {
+		for (auto & iter : ((InstanceKlass *)this->parent)->itable_offsets) {
+			add_itable_block(iter.first);
+		}
+	}
+	for (auto & iter : this->interfaces) {
+		add_itable_block(iter.second);
+	}
+}
+
+void InstanceKlass::add_itable_block(InstanceKlass *interface)
+{
+	assert(interface->is_interface());
+	for (auto & iter : this->itable_offsets) {
+		if (iter.first == interface)	return;		// already added.
+	}
+	this->itable_offsets.push_back(make_pair(interface, (int)this->itable.size()));
+	// the same as the old `invokeinterface`: search in this klass, parents and then interfaces (for the default methods).
+	for (Method *interface_method : interface->itable) {
+		this->itable.push_back(this->get_class_method(interface_method->get_name() + L":" + interface_method->get_descriptor()));
+	}
+	// and all the super interfaces.
+	for (auto & iter : interface->interfaces) {
+		add_itable_block(iter.second);
+	}
+}
+
+Method *InstanceKlass::select_method(Method *resolved_method)
+{
+	InstanceKlass *resolved_klass = resolved_method->get_klass();
+	if (resolved_klass->is_interface()) {
+		int index = resolved_method->get_itable_index();
+		if (index != -1) {
+			for (auto & iter : this->itable_offsets) {		// usually only a few interfaces. linear search is enough.
+				if (iter.first == resolved_klass) {
+					return this->itable[iter.second + index];
+				}
+			}
+		}
+	} else {
+		int index = resolved_method->get_vtable_index();
+		if (index != -1 && index < this->vtable.size()) {
+			return this->vtable[index];
+		}
+	}
+	// can't get here with the verified bytecodes. fall back to search by name.
+	return this->get_class_method(resolved_method->get_name() + L":" + resolved_method->get_descriptor());
 }
 
 InstanceOop * InstanceKlass::new_instance() {
-	return new InstanceOop(this);
+	void *buf = MemAlloc::allocate(sizeof(InstanceOop) + this->total_non_static_fields_bytes);
+	constructor((InstanceOop *)buf, this);
+	return (InstanceOop *)buf;
+}
+
+InstanceOop * InstanceKlass::try_new_instance() {
+	// the fields are inline, right after the oop header. MemAlloc zeroes them, which is the default value of every type.
+	void *buf = MemAlloc::try_allocate(sizeof(InstanceOop) + this->total_non_static_fields_bytes);
+	if (buf == nullptr)	return nullptr;
+	constructor((InstanceOop *)buf, this);
+	return (InstanceOop *)buf;
 }
 
 InstanceKlass::~InstanceKlass() {
@@ -697,9 +815,9 @@ int InstanceKlass::get_static_field_offset(const wstring & signature)
 	int offset = iter->second.first;
 
 #ifdef DEBUG
-	sync_wcout{} << "this: [" << this << "], klass_name:[" << this->get_name() << "], (static)" << signature << ":[" << "(encoding: " << offset + this->non_static_field_num() << ")]" << std::endl;
+	sync_wcout{} << "this: [" << this << "], klass_name:[" << this->get_name() << "], (static)" << signature << ":[" << "(encoding: " << offset + this->non_static_field_bytes() << ")]" << std::endl;
 #endif
-	return offset + this->non_static_field_num();
+	return offset + this->non_static_field_bytes();		// encoded after all the non-static byte offsets.
 }
 
 int InstanceKlass::get_all_field_offset(const wstring & BIG_signature)
@@ -725,7 +843,10 @@ MirrorOop *MirrorKlass::new_mirror(Klass *mirrored_who, MirrorOop *loader) {
 		wstring ll(L"java/lang/Class");
 		loaderr.loadClass(ll);
 	}
-	auto mirror = new MirrorOop(mirrored_who);
+	auto class_klass = ((InstanceKlass *)BootStrapClassLoader::get_bootstrap().loadClass(L"java/lang/Class"));
+	void *buf = MemAlloc::allocate(sizeof(MirrorOop) + class_klass->non_static_field_bytes());
+	constructor((MirrorOop *)buf, mirrored_who);
+	auto mirror = (MirrorOop *)buf;
 	if (loader != nullptr) {
 		// need to initialize the `ClassLoader.class` by using ClassLoader's constructor!!
 		mirror->set_field_value(L"java/lang/Class:classLoader:Ljava/lang/ClassLoader;", loader);
@@ -744,42 +865,29 @@ ArrayKlass::ArrayKlass(int dimension, ClassLoader *loader, Klass *lower_dimensio
 
 ArrayOop* ArrayKlass::new_instance(int length)
 {
+	return allocate_instance(length, MemAlloc::allocate);
+}
+
+ArrayOop* ArrayKlass::try_new_instance(int length)
+{
+	return allocate_instance(length, MemAlloc::try_allocate);
+}
+
+ArrayOop* ArrayKlass::allocate_instance(int length, void *(*alloc)(size_t))
+{
+	// the elements are inline, right after the oop. MemAlloc zeroes them: null, or the default value of the basic type.
 	ArrayOop *oop;
-	if (this->get_type() == ClassType::TypeArrayClass)
-		oop = new TypeArrayOop((TypeArrayKlass *)this, length);
-	else
-		oop = new ObjArrayOop((ObjArrayKlass *)this, length);
-	for (int i = 0; i < length; i ++) {
-		if (this->get_type() == ClassType::ObjArrayClass) {
-			(*oop)[i] = nullptr;		// nullptr is the best !
-		} else {		// allocate basic type...
-			Type basic_type = ((TypeArrayKlass *)this)->get_basic_type();
-			switch (basic_type) {
-				case Type::BOOLEAN:
-				case Type::BYTE:
-				case Type::SHORT:
-				case Type::CHAR:
-				case Type::INT:{
-					(*oop)[i] = new IntOop(0);		// default value
-					break;
-				}
-				case Type::DOUBLE:{
-					(*oop)[i] = new DoubleOop(0);		// default value
-					break;
-				}
-				case Type::FLOAT:{
-					(*oop)[i] = new FloatOop(0);		// default value
-					break;
-				}
-				case Type::LONG:{
-					(*oop)[i] = new LongOop(0);		// default value
-					break;
-				}
-				default:{
-					assert(false);
-				}
-			}
-		}
+	if (this->get_type() == ClassType::TypeArrayClass) {
+		size_t elem_size = (this->dimension == 1) ? ((TypeArrayKlass *)this)->get_elem_size() : sizeof(Oop *);		// more than one dimension: the elements are the lower dimension arrays.
+		void *buf = alloc(sizeof(TypeArrayOop) + (size_t)length * elem_size);
+		if (buf == nullptr)	return nullptr;
+		constructor((TypeArrayOop *)buf, (TypeArrayKlass *)this, length);
+		oop = (TypeArrayOop *)buf;
+	} else {
+		void *buf = alloc(sizeof(ObjArrayOop) + (size_t)length * sizeof(Oop *));
+		if (buf == nullptr)	return nullptr;
+		constructor((ObjArrayOop *)buf, (ObjArrayKlass *)this, length);
+		oop = (ObjArrayOop *)buf;
 	}
 	return oop;
 }
@@ -798,34 +906,42 @@ TypeArrayKlass::TypeArrayKlass(Type type, int dimension, ClassLoader *loader, Kl
 	switch (type) {
 		case Type::BOOLEAN:{
 			ss << L"Z";
+			elem_size = sizeof(uint8_t);
 			break;
 		}
 		case Type::BYTE:{
 			ss << L"B";
+			elem_size = sizeof(int8_t);
 			break;
 		}
 		case Type::CHAR:{
 			ss << L"C";
+			elem_size = sizeof(uint16_t);
 			break;
 		}
 		case Type::SHORT:{
 			ss << L"S";
+			elem_size = sizeof(int16_t);
 			break;
 		}
 		case Type::INT:{
 			ss << L"I";
+			elem_size = sizeof(int);
 			break;
 		}
 		case Type::FLOAT:{
 			ss << L"F";
+			elem_size = sizeof(float);
 			break;
 		}
 		case Type::LONG:{
 			ss << L"J";
+			elem_size = sizeof(long);
 			break;
 		}
 		case Type::DOUBLE:{
 			ss << L"D";
+			elem_size = sizeof(double);
 			break;
 		}
 		default:{
@@ -19,6 +19,10 @@ void Method_Pool::put(Method *method) {
 	LockGuard lg(method_pool_lock());
 	method_pool().push_back(method);
 }
+list<Method *> Method_Pool::get_all_methods() {
+	LockGuard lg(method_pool_lock());
+	return method_pool();
+}
 void Method_Pool::cleanup() {
 	LockGuard lg(method_pool_lock());
 	for (auto iter : method_pool()) {
@@ -134,6 +138,36 @@ Method::Method(InstanceKlass *klass, method_info & mi, cp_info **constant_pool)
 		}
 
 	}
+
+	parse_arg_kinds(descriptor);
+}
+
+void Method::parse_arg_kinds(const wstring & descriptor)
+{
+	ret_kind = parse_descriptor_kinds(descriptor, arg_kinds, arg_slot_num);
+}
+
+wchar_t Method::parse_descriptor_kinds(const wstring & descriptor, vector<wchar_t> & arg_kinds, int & arg_slot_num)
+{
+	arg_kinds.clear();
+	arg_slot_num = 0;
+	for (int i = 1; descriptor[i] != L')'; i ++) {
+		if (descriptor[i] == L'[') {
+			while (descriptor[i] == L'[')	i ++;
+			if (descriptor[i] == L'L')	i = descriptor.find(L';', i);
+			arg_kinds.push_back(L'L');
+			arg_slot_num ++;
+		} else if (descriptor[i] == L'L') {
+			i = descriptor.find(L';', i);
+			arg_kinds.push_back(L'L');
+			arg_slot_num ++;
+		} else {
+			arg_kinds.push_back(descriptor[i]);
+			arg_slot_num += (descriptor[i] == L'J' || descriptor[i] == L'D') ? 2 : 1;
+		}
+	}
+	wchar_t ret = descriptor[descriptor.find(L')') + 1];
+	return (ret == L'[') ? L'L' : ret;
 }
 
 
@@ -377,6 +411,7 @@ Method::~Method() {
 	}
 	delete[] attributes;
 	delete lnt;		// delete LineNumberTable.
+	delete[] inline_caches.load();		// the InlineCaches themselves are deleted by `InlineCache::cleanup()`.
 
 	destructor(this->rva);
 	free(this->rva);
@@ -7,44 +7,65 @@
 
 #include "runtime/oop.hpp"
 #include "classloader.hpp"
+#include "runtime/heap_dump.hpp"
 #include "utils/synchronize_wcout.hpp"
 
 /*===---------------- Memory -------------------===*/
-Oop *Mempool::copy(Oop & oop) {
-	return oop.copy();		// do not record in `Mempool::oop_handler_pool()`.
+Oop *Mempool::copy(Oop & oop, void *buf) {
+	return oop.copy(buf);		// `buf` is in a survivor space or the old generation, chosen by the gc.
 }
 
-void *MemAlloc::allocate(size_t size, bool dont_record)
+void *MemAlloc::allocate(size_t size)
 {
 	if (size == 0) {
 		return nullptr;
 	}
 
-	void *ptr = malloc(size);
-	memset(ptr, 0, size);		// default bzero!
-
-	// add it to the Mempool
-	if (!dont_record) {
-		LockGuard lg(mem_lock());
-		Mempool::oop_handler_pool().push_back((Oop *)ptr);
+	void *ptr = Heap::allocate(size);		// default bzero!
+	if (ptr == nullptr) {
+		// out of the allocation bytecodes: a native, a box, a String or an exception of the vm. the caller may hold oops in
+		// its c++ locals, so there's no gc here: the vm reserve takes it, and the thread collects when it's back in java.
+		ptr = Heap::allocate_in_reserve(size);
+		if (ptr == nullptr) {
+			out_of_memory(size);
+		}
+		out_of_memory_pending() = true;
 	}
 
 	return ptr;
 }
 
+void *MemAlloc::try_allocate(size_t size)
+{
+	assert(size != 0);
+	void *ptr = Heap::allocate(size);
+	if (ptr == nullptr) {
+		failed_size() = size;
+	}
+	return ptr;
+}
+
+void MemAlloc::out_of_memory(size_t size)
+{
+	// the vm has used up its reserve too, in one go out of the java code: nowhere to throw the OutOfMemoryError from.
+	std::wcerr << "java.lang.OutOfMemoryError: Java heap space, allocating " << size << " bytes out of the java code with the vm reserve used up, with the heap at "
+			   << Heap::get_capacity() / (1024 * 1024) << "m of -Xmx " << Heap::max_capacity() / (1024 * 1024) << "m." << std::endl;
+	HeapDump::on_out_of_memory();		// the oops in the c++ locals of this thread are not in it.
+	exit(-1);
+}
+
 void MemAlloc::deallocate(void *ptr)
 {
-	free(ptr);
 }
 
-void *MemAlloc::operator new(size_t size, bool dont_record) throw()
+void *MemAlloc::operator new(size_t size) throw()
 {
-	return allocate(size, dont_record);
+	return allocate(size);
 }
 
-void *MemAlloc::operator new[](size_t size, bool dont_record) throw()
+void *MemAlloc::operator new[](size_t size) throw()
 {
-	return allocate(size, dont_record);
+	return allocate(size);
 }
 
 void MemAlloc::operator delete(void *ptr)
@@ -58,46 +79,63 @@ void MemAlloc::operator delete[](void *ptr)
 }
 
 void MemAlloc::cleanup() {
-	LockGuard lg(mem_lock());
-	for (auto iter : Mempool::oop_handler_pool()) {
-		delete iter;
-	}
+	Heap::cleanup();
 }
 
 /*===----------------  Oop  -----------------===*/
-Oop *Oop::copy()
+Oop *Oop::copy(void *buf)
 {
-	void *buf = MemAlloc::operator new(sizeof(*this), true);
 	constructor((Oop *)buf, *this);
 	return (Oop *)buf;
 }
 
 /*===----------------  InstanceOop  -----------------===*/
 InstanceOop::InstanceOop(InstanceKlass *klass) : Oop(klass, OopType::_InstanceOop) {
-	// alloc non-static-field memory.
-	this->field_length = klass->non_static_field_num();
-	if (this->field_length != 0) {
-		fields.resize(this->field_length, nullptr);
-	}
-
-	// initialize BasicTypeOop...
-	klass->initialize_field(klass->fields_layout, this->fields);
+	// the non-static-field memory is allocated with this oop and zeroed: every type's default value. (int 0, null, 0.0 ...)
+	this->fields_offset = sizeof(InstanceOop);
+	this->field_length = klass->non_static_field_bytes();
 }
 
-InstanceOop::InstanceOop(const InstanceOop & rhs) : Oop(rhs), field_length(rhs.field_length), fields(rhs.fields)	// TODO: not gc control......
+InstanceOop::InstanceOop(const InstanceOop & rhs) : Oop(rhs), fields_offset(rhs.fields_offset), field_length(rhs.field_length)
 {
+	memcpy(get_fields_addr(), const_cast<InstanceOop &>(rhs).get_fields_addr(), field_length);
 }
 
 bool InstanceOop::get_field_value(Field_info *field, Oop **result)
 {
-	wstring BIG_signature = field->get_klass()->get_name() + L":" + field->get_name() + L":" + field->get_descriptor();
-	return this->get_field_value(BIG_signature, result);
+	int offset = field->get_offset();
+	switch (field->get_descriptor()[0]) {
+		case L'Z':	*result = new IntOop(field_at<uint8_t>(offset));		break;
+		case L'B':	*result = new IntOop(field_at<int8_t>(offset));		break;
+		case L'C':	*result = new IntOop(field_at<uint16_t>(offset));		break;
+		case L'S':	*result = new IntOop(field_at<int16_t>(offset));		break;
+		case L'I':	*result = new IntOop(field_at<int>(offset));			break;
+		case L'F':	*result = new FloatOop(field_at<float>(offset));		break;
+		case L'J':	*result = new LongOop(field_at<long>(offset));		break;
+		case L'D':	*result = new DoubleOop(field_at<double>(offset));		break;
+		default:		*result = field_at<Oop *>(offset);
+	}
+	return true;
 }
 
 void InstanceOop::set_field_value(Field_info *field, Oop *value)
 {
-	wstring BIG_signature = field->get_klass()->get_name() + L":" + field->get_name() + L":" + field->get_descriptor();
-	this->set_field_value(BIG_signature, value);
+	int offset = field->get_offset();
+	wchar_t kind = field->get_descriptor()[0];
+	if (kind != L'L' && kind != L'[') {
+		assert(value != nullptr && value->get_ooptype() == OopType::_BasicTypeOop);
+	}
+	switch (kind) {
+		case L'Z':	field_at<uint8_t>(offset) = ((IntOop *)value)->value;		break;
+		case L'B':	field_at<int8_t>(offset) = ((IntOop *)value)->value;		break;
+		case L'C':	field_at<uint16_t>(offset) = ((IntOop *)value)->value;		break;
+		case L'S':	field_at<int16_t>(offset) = ((IntOop *)value)->value;		break;
+		case L'I':	field_at<int>(offset) = ((IntOop *)value)->value;			break;
+		case L'F':	field_at<float>(offset) = ((FloatOop *)value)->value;		break;
+		case L'J':	field_at<long>(offset) = ((LongOop *)value)->value;		break;
+		case L'D':	field_at<double>(offset) = ((DoubleOop *)value)->value;	break;
+		default:		oop_store(this, field_at<Oop *>(offset), value);
+	}
 }
 
 bool InstanceOop::get_field_value(const wstring & BIG_signature, Oop **result) 				// use for forging String Oop at parsing constant_pool.
@@ -108,10 +146,7 @@ bool InstanceOop::get_field_value(const wstring & BIG_signature, Oop **result)
 		std::wcerr << "didn't find field [" << BIG_signature << "] in InstanceKlass " << instance_klass->name << std::endl;
 		assert(false);
 	}
-	int offset = iter->second.first;
-
-	*result = this->fields[offset];
-	return true;
+	return this->get_field_value(iter->second.second, result);
 }
 
 void InstanceOop::set_field_value(const wstring & BIG_signature, Oop *value)
@@ -122,9 +157,7 @@ void InstanceOop::set_field_value(const wstring & BIG_signature, Oop *value)
 		std::wcerr << "didn't find field [" << BIG_signature << "] in InstanceKlass " << instance_klass->name << std::endl;
 		assert(false);
 	}
-	int offset = iter->second.first;
-
-	this->fields[offset] = value;
+	this->set_field_value(iter->second.second, value);
 }
 
 int InstanceOop::get_all_field_offset(const wstring & BIG_signature)
@@ -140,9 +173,17 @@ int InstanceOop::get_static_field_offset(const wstring & signature)
 	return instance_klass->get_static_field_offset(signature);
 }
 
-Oop *InstanceOop::copy()
+InstanceOop *InstanceOop::clone()
+{
+	assert(fields_offset == sizeof(InstanceOop));		// not a MirrorOop: java/lang/Class is not Cloneable.
+	void *buf = MemAlloc::try_allocate(sizeof(InstanceOop) + field_length);
+	if (buf == nullptr)	return nullptr;
+	constructor((InstanceOop *)buf, *this);
+	return (InstanceOop *)buf;
+}
+
+Oop *InstanceOop::copy(void *buf)
 {
-	void *buf = MemAlloc::operator new(sizeof(*this), true);
 	constructor((InstanceOop *)buf, *this);
 	return (Oop *)buf;
 }
@@ -150,62 +191,93 @@ Oop *InstanceOop::copy()
 /*===----------------  MirrorOop  -------------------===*/
 MirrorOop::MirrorOop(Klass *mirrored_who)
 					: InstanceOop(((InstanceKlass *)BootStrapClassLoader::get_bootstrap().loadClass(L"java/lang/Class"))),
-					  mirrored_who(mirrored_who){}
+					  mirrored_who(mirrored_who)
+{
+	this->fields_offset = sizeof(MirrorOop);		// the fields are after the MirrorOop's members. see: `MirrorKlass::new_mirror()`.
+}
 
 MirrorOop::MirrorOop(const MirrorOop & rhs)
 					: InstanceOop(rhs), mirrored_who(rhs.mirrored_who), extra(rhs.extra) {}
 
-Oop *MirrorOop::copy()
+Oop *MirrorOop::copy(void *buf)
 {
-	void *buf = MemAlloc::operator new(sizeof(*this), true);
 	constructor((MirrorOop *)buf, *this);
 	return (Oop *)buf;
 }
 
+/*===----------------  ArrayOop  -------------------===*/
+ArrayOop::ArrayOop(ArrayKlass *klass, int length, OopType ooptype) : Oop(klass, ooptype), length(length)
+{
+	// the elements are allocated with this oop and zeroed: null, or the default value of every basic type.
+	if (ooptype == OopType::_TypeArrayOop && klass->get_dimension() == 1) {
+		this->elem_size = ((TypeArrayKlass *)klass)->get_elem_size();
+	} else {
+		this->elem_size = sizeof(Oop *);
+	}
+}
+
+ArrayOop::ArrayOop(const ArrayOop & rhs) : Oop(rhs), length(rhs.length), elem_size(rhs.elem_size)
+{
+	memcpy(get_elems(), const_cast<ArrayOop &>(rhs).get_elems(), (size_t)length * elem_size);
+}
+
 /*===----------------  TypeArrayOop  -------------------===*/
-ArrayOop::ArrayOop(const ArrayOop & rhs) : Oop(rhs), buf(rhs.buf)
+TypeArrayOop *TypeArrayOop::clone()
+{
+	void *buf = MemAlloc::try_allocate(get_size());
+	if (buf == nullptr)	return nullptr;
+	constructor((TypeArrayOop *)buf, *this);
+	return (TypeArrayOop *)buf;
+}
+
+Oop *TypeArrayOop::copy(void *buf)
+{
+	constructor((TypeArrayOop *)buf, *this);
+	return (Oop *)buf;
+}
+
+/*===----------------  ObjArrayOop  -------------------===*/
+ObjArrayOop *ObjArrayOop::clone()
 {
+	void *buf = MemAlloc::try_allocate(get_size());
+	if (buf == nullptr)	return nullptr;
+	constructor((ObjArrayOop *)buf, *this);
+	return (ObjArrayOop *)buf;
 }
 
-Oop *ArrayOop::copy()
+Oop *ObjArrayOop::copy(void *buf)
 {
-	void *buf = MemAlloc::operator new(sizeof(*this), true);
-	constructor((ArrayOop *)buf, *this);
+	constructor((ObjArrayOop *)buf, *this);
 	return (Oop *)buf;
 }
 
 /*===---------------- BasicTypeOop ---------------------===*/
-Oop *BasicTypeOop::copy()
+Oop *BasicTypeOop::copy(void *buf)
 {
-	void *buf = MemAlloc::operator new(sizeof(*this), true);
 	constructor((BasicTypeOop *)buf, *this);
 	return (Oop *)buf;
 }
 
-Oop *IntOop::copy()
+Oop *IntOop::copy(void *buf)
 {
-	void *buf = MemAlloc::operator new(sizeof(*this), true);
 	constructor((IntOop *)buf, *this);
 	return (Oop *)buf;
 }
 
-Oop *FloatOop::copy()
+Oop *FloatOop::copy(void *buf)
 {
-	void *buf = MemAlloc::operator new(sizeof(*this), true);
 	constructor((FloatOop *)buf, *this);
 	return (Oop *)buf;
 }
 
-Oop *DoubleOop::copy()
+Oop *DoubleOop::copy(void *buf)
 {
-	void *buf = MemAlloc::operator new(sizeof(*this), true);
 	constructor((DoubleOop *)buf, *this);
 	return (Oop *)buf;
 }
 
-Oop *LongOop::copy()
+Oop *LongOop::copy(void *buf)
 {
-	void *buf = MemAlloc::operator new(sizeof(*this), true);
 	constructor((LongOop *)buf, *this);
 	return (Oop *)buf;
 }
@@ -0,0 +1,100 @@
+/*
+ * profiler.cpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#include "runtime/profiler.hpp"
+#include "runtime/method.hpp"
+#include "runtime/klass.hpp"
+#include "runtime/jit.hpp"
+#include "wind_jvm.hpp"
+#include <signal.h>
+#include <sys/time.h>
+#include <pthread.h>
+#include <vector>
+#include <algorithm>
+#include <iomanip>
+#include <cstring>
+
+void Profiler::SIGPROF_handler(int signo)
+{
+	// async-signal-safe: only reads this thread's own stack and bumps the counters.
+	if (!sampling().load(std::memory_order_relaxed))	return;
+	total_samples().fetch_add(1, std::memory_order_relaxed);
+	vm_thread *thread = current_thread();
+	StackFrame *top = (thread == nullptr) ? nullptr : thread->vm_stack.top_frame();
+	if (top == nullptr) {
+		vm_samples().fetch_add(1, std::memory_order_relaxed);
+	} else {
+		top->method->inc_sample_counter();
+	}
+}
+
+void Profiler::start()
+{
+	struct sigaction sa;
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = SIGPROF_handler;
+	sa.sa_flags = SA_RESTART;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGPROF, &sa, nullptr);
+
+	sampling() = true;
+	struct itimerval timer;
+	timer.it_interval.tv_sec = 0;
+	timer.it_interval.tv_usec = SAMPLE_INTERVAL_US;
+	timer.it_value = timer.it_interval;
+	setitimer(ITIMER_PROF, &timer, nullptr);
+}
+
+void Profiler::stop()
+{
+	struct itimerval timer;
+	memset(&timer, 0, sizeof(timer));
+	setitimer(ITIMER_PROF, &timer, nullptr);
+	sampling() = false;
+}
+
+void Profiler::dump(std::wostream & os)
+{
+	struct Entry {
+		Method *method;
+		unsigned samples;
+		unsigned invocations;
+		unsigned backedges;
+	};
+	std::vector<Entry> entries;
+	for (Method *method : Method_Pool::get_all_methods()) {
+		Entry entry{method, method->get_sample_counter().load(std::memory_order_relaxed),
+					method->get_invocation_counter().load(std::memory_order_relaxed), method->get_backedge_counter().load(std::memory_order_relaxed)};
+		if (entry.samples != 0 || entry.invocations != 0 || entry.backedges != 0) {
+			entries.push_back(entry);
+		}
+	}
+	// the hottest first: by self time, then by the work the counters have seen.
+	std::sort(entries.begin(), entries.end(), [](const Entry & a, const Entry & b) {
+		if (a.samples != b.samples)	return a.samples > b.samples;
+		return (unsigned long)a.invocations + a.backedges > (unsigned long)b.invocations + b.backedges;
+	});
+
+	long total = total_samples().load();
+	os << "===---------------- Method Profile ----------------===" << std::endl;
+	os << std::setw(8) << "self%" << std::setw(10) << "samples" << std::setw(14) << "invocations" << std::setw(14) << "back-edges" << "  method" << std::endl;
+	int printed = 0;
+	for (const Entry & entry : entries) {
+		if (printed ++ == MAX_PRINT_METHODS) {
+			os << "... " << entries.size() - MAX_PRINT_METHODS << " more methods." << std::endl;
+			break;
+		}
+		double share = (total == 0) ? 0.0 : entry.samples * 100.0 / total;
+		os << std::setw(7) << std::fixed << std::setprecision(1) << share << "%" << std::setw(10) << entry.samples
+		   << std::setw(14) << entry.invocations << std::setw(14) << entry.backedges << "  "
+		   << entry.method->get_klass()->get_name() << "::" << entry.method->get_name() << ":" << entry.method->get_descriptor();
+		if (entry.method->is_native())									os << "  [native]";
+		else if (entry.method->get_jit_code().load() != nullptr)		os << "  [compiled]";
+		os << std::endl;
+	}
+	os << "total " << total << " samples (" << SAMPLE_INTERVAL_US / 1000 << "ms of cpu time each), " << vm_samples().load() << " of them outside of java code." << std::endl;
+	os << "===--------------------------------------------------===" << std::endl;
+}
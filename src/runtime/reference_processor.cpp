@@ -0,0 +1,156 @@
+/*
+ * reference_processor.cpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#include "runtime/reference_processor.hpp"
+#include "runtime/field.hpp"
+#include "runtime/heap.hpp"
+#include "utils/vm_options.hpp"
+#include <chrono>
+#include <cassert>
+
+static int field_offset(InstanceKlass *klass, const wstring & name_and_descriptor)		// aux
+{
+	auto iter = klass->get_field_layout().find(klass->get_name() + L":" + name_and_descriptor);
+	assert(iter != klass->get_field_layout().end());
+	return iter->second.first;
+}
+
+static int static_index(InstanceKlass *klass, const wstring & name_and_descriptor)		// aux
+{
+	auto iter = klass->get_static_field_layout().find(name_and_descriptor);
+	assert(iter != klass->get_static_field_layout().end());
+	return iter->second.first;
+}
+
+long ReferenceProcessor::now_ms()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void ReferenceProcessor::register_klass(InstanceKlass *klass)
+{
+	const wstring & name = klass->get_name();
+	if (name == L"java/lang/ref/Reference") {
+		auto iter = klass->get_field_layout().find(L"java/lang/ref/Reference:referent:Ljava/lang/Object;");
+		assert(iter != klass->get_field_layout().end());
+		referent_field() = iter->second.second;
+		referent_offset() = iter->second.first;
+		queue_offset() = field_offset(klass, L"queue:Ljava/lang/ref/ReferenceQueue;");
+		next_offset() = field_offset(klass, L"next:Ljava/lang/ref/Reference;");
+		discovered_offset() = field_offset(klass, L"discovered:Ljava/lang/ref/Reference;");
+		pending_index() = static_index(klass, L"pending:Ljava/lang/ref/Reference;");
+		reference_lock_index() = static_index(klass, L"lock:Ljava/lang/ref/Reference$Lock;");
+		reference_klass() = klass;
+	} else if (name == L"java/lang/ref/SoftReference") {
+		timestamp_offset() = field_offset(klass, L"timestamp:J");
+		clock_index() = static_index(klass, L"clock:J");
+		// the clock starts now, as the timestamps of the first SoftReferences.
+		Oop *clock = static_at(klass, clock_index());
+		if (clock != nullptr)	((LongOop *)clock)->value = now_ms();
+		soft_reference_klass() = klass;
+	} else if (name == L"java/lang/ref/ReferenceQueue") {
+		null_queue_index() = static_index(klass, L"NULL:Ljava/lang/ref/ReferenceQueue;");
+		enqueued_queue_index() = static_index(klass, L"ENQUEUED:Ljava/lang/ref/ReferenceQueue;");
+		queue_lock_offset() = field_offset(klass, L"lock:Ljava/lang/ref/ReferenceQueue$Lock;");
+		queue_head_offset() = field_offset(klass, L"head:Ljava/lang/ref/Reference;");
+		queue_length_offset() = field_offset(klass, L"queueLength:J");
+		queue_klass() = klass;
+	} else if (name == L"sun/misc/Cleaner") {
+		cleaner_klass() = klass;
+	}
+}
+
+bool ReferenceProcessor::should_discover(Oop *ref)
+{
+	if (type_of(ref) != REF_SOFT || clear_all_soft())	return true;
+	long timestamp = ((InstanceOop *)ref)->field_at<long>(timestamp_offset());
+	return soft_clock() - timestamp > soft_max_interval();
+}
+
+void ReferenceProcessor::begin_pause(bool clear_all)
+{
+	clear_all_soft() = clear_all;
+	if (soft_reference_klass() == nullptr)	return;
+	Oop *clock = static_at(soft_reference_klass(), clock_index());
+	soft_clock() = (clock != nullptr) ? ((LongOop *)clock)->value : 0;
+	soft_max_interval() = (long)(free_at_last_gc() / (1024 * 1024)) * VMOptions::soft_ref_lru_policy_ms_per_mb();
+}
+
+void ReferenceProcessor::process(std::vector<Oop *> & discovered, Oop *(*referent)(Oop *), long *cleared)
+{
+	for (Oop *ref : discovered) {
+		Oop * & slot = referent_of(ref);
+		if (slot == nullptr)	continue;			// cleared by the program meanwhile, or met twice.
+		Oop *live = referent(slot);
+		if (live != nullptr) {
+			if (live != slot) {			// copied.
+				slot = live;
+				Heap::post_write_barrier(ref);
+			}
+			continue;
+		}
+		slot = nullptr;
+		cleared[type_of(ref)] ++;
+		// enqueued by the program already, or registered with no queue: nobody waits for it.
+		if (field(ref, next_offset()) != nullptr)	continue;
+		if (queue_klass() == nullptr || field(ref, queue_offset()) == static_at(queue_klass(), null_queue_index()))	continue;
+		field(ref, next_offset()) = ref;			// not active any more.
+		field(ref, discovered_offset()) = pending();
+		pending() = ref;
+		Heap::post_write_barrier(ref);
+	}
+	discovered.clear();
+}
+
+int ReferenceProcessor::enqueue(Oop *ref)
+{
+	// ReferenceQueue.enqueue(), under the lock of the queue: the threads are stopped, so it must be free.
+	Oop *queue = field(ref, queue_offset());
+	Oop *enqueued = static_at(queue_klass(), enqueued_queue_index());
+	if (queue == nullptr || queue == enqueued || queue == static_at(queue_klass(), null_queue_index()))	return 0;
+	Oop *lock = field(queue, queue_lock_offset());
+	if (lock != nullptr && lock->is_locked())	return -1;
+	Oop *head = field(queue, queue_head_offset());
+	oop_store(ref, field(ref, queue_offset()), enqueued);
+	oop_store(ref, field(ref, next_offset()), (head == nullptr) ? ref : head);
+	oop_store(queue, field(queue, queue_head_offset()), ref);
+	((InstanceOop *)queue)->field_at<long>(queue_length_offset()) ++;
+	if (lock != nullptr)	lock->notify_all();		// `remove()` waits on it.
+	return 1;
+}
+
+long ReferenceProcessor::enqueue_pending()
+{
+	if (reference_klass() == nullptr || pending() == nullptr || queue_klass() == nullptr)	return 0;
+	Oop *reference_lock = static_at(reference_klass(), reference_lock_index());
+	if (reference_lock != nullptr && reference_lock->is_locked())	return 0;		// a thread is taking from the list.
+	long enqueued = 0;
+	Oop *left = nullptr;						// the ones which wait for the next pause, in reverse.
+	for (Oop *ref = pending(); ref != nullptr; ) {
+		Oop *next_pending = field(ref, discovered_offset());
+		bool is_cleaner = cleaner_klass() != nullptr && (ref->get_klass() == cleaner_klass() || ((InstanceKlass *)ref->get_klass())->check_parent((InstanceKlass *)cleaner_klass()));
+		int result = is_cleaner ? -1 : enqueue(ref);
+		if (result >= 0) {
+			oop_store(ref, field(ref, discovered_offset()), nullptr);
+			enqueued += result;
+		} else {
+			oop_store(ref, field(ref, discovered_offset()), left);
+			left = ref;
+		}
+		ref = next_pending;
+	}
+	pending() = left;
+	if (left != nullptr && reference_lock != nullptr)	reference_lock->notify_all();
+	return enqueued;
+}
+
+void ReferenceProcessor::end_pause()
+{
+	free_at_last_gc() = Heap::max_capacity() - Heap::young_used() - Heap::old_used();
+	if (soft_reference_klass() == nullptr)	return;
+	Oop *clock = static_at(soft_reference_klass(), clock_index());
+	if (clock != nullptr)	((LongOop *)clock)->value = now_ms();
+}
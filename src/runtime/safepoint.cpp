@@ -0,0 +1,120 @@
+/*
+ * safepoint.cpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#include "runtime/safepoint.hpp"
+#include "runtime/thread.hpp"
+#include "wind_jvm.hpp"
+
+static void unlock_wait_mutex(void *)		// a thread may be cancelled in `pthread_cond_wait()`, with the mutex locked again.
+{
+	pthread_mutex_unlock(&_all_thread_wait_mutex);
+}
+
+void Safepoint::arm(int value)
+{
+	LockGuard lg(ThreadTable::get_lock());
+	for (auto & iter : ThreadTable::get_thread_table()) {
+		std::get<2>(iter.second)->safepoint_poll.word.store(value, std::memory_order_relaxed);
+	}
+}
+
+bool Safepoint::all_safe()
+{
+	LockGuard lg(ThreadTable::get_lock());
+	for (auto & iter : ThreadTable::get_thread_table()) {
+		vm_thread *thread = std::get<2>(iter.second);
+		if (thread->state == Running && thread != current()) {		// the SIGINT handler may run on a java thread.
+			return false;
+		}
+	}
+	return true;
+}
+
+void Safepoint::attach(vm_thread *thread)
+{
+	// under the mutex: either `begin()` arms the poll after the thread is in the ThreadTable, or the thread sees `requested()` here.
+	pthread_mutex_lock(&_all_thread_wait_mutex);
+	current() = thread;
+	thread->safepoint_poll.word.store(requested().load() ? 1 : 0, std::memory_order_relaxed);
+	pthread_mutex_unlock(&_all_thread_wait_mutex);
+}
+
+void Safepoint::begin()
+{
+	pthread_mutex_lock(&_all_thread_wait_mutex);
+	requested().store(true);
+	begin_time() = std::chrono::steady_clock::now();
+	pthread_mutex_unlock(&_all_thread_wait_mutex);
+	arm(1);
+}
+
+double Safepoint::synchronize()
+{
+	pthread_mutex_lock(&_all_thread_wait_mutex);
+	while (!all_safe()) {
+		pthread_cond_wait(&safe_cond(), &_all_thread_wait_mutex);
+	}
+	pthread_mutex_unlock(&_all_thread_wait_mutex);
+	std::chrono::duration<double, std::milli> time_to_safepoint = std::chrono::steady_clock::now() - begin_time();
+#ifdef DEBUG
+	sync_wcout{} << "(DEBUG) all the threads are safe after " << time_to_safepoint.count() << " ms." << std::endl;
+#endif
+	return time_to_safepoint.count();
+}
+
+void Safepoint::end()
+{
+	arm(0);			// first: the next safepoint can't begin before `GC::gc()` is cleared.
+	pthread_mutex_lock(&_all_thread_wait_mutex);
+	requested().store(false);
+	pthread_cond_broadcast(&_all_thread_wait_cond);
+	pthread_mutex_unlock(&_all_thread_wait_mutex);
+}
+
+void Safepoint::block(vm_thread *thread)
+{
+	pthread_mutex_lock(&_all_thread_wait_mutex);
+	pthread_cleanup_push(unlock_wait_mutex, nullptr);
+	thread->state = Waiting;
+	pthread_cond_signal(&safe_cond());
+	while (requested().load()) {
+		pthread_cond_wait(&_all_thread_wait_cond, &_all_thread_wait_mutex);
+	}
+	thread->safepoint_poll.word.store(0, std::memory_order_relaxed);		// maybe armed by `attach()` just before `end()`.
+	thread->state = Running;
+	pthread_cleanup_pop(1);
+}
+
+void Safepoint::set_dead(vm_thread *thread)
+{
+	pthread_mutex_lock(&_all_thread_wait_mutex);
+	thread->state = Death;
+	pthread_cond_signal(&safe_cond());
+	pthread_mutex_unlock(&_all_thread_wait_mutex);
+}
+
+void Safepoint::enter_blocked()
+{
+	vm_thread *thread = current();
+	if (thread == nullptr)	return;
+	pthread_mutex_lock(&_all_thread_wait_mutex);
+	thread->state = Blocked;
+	pthread_cond_signal(&safe_cond());
+	pthread_mutex_unlock(&_all_thread_wait_mutex);
+}
+
+void Safepoint::leave_blocked()
+{
+	vm_thread *thread = current();
+	if (thread == nullptr)	return;
+	pthread_mutex_lock(&_all_thread_wait_mutex);
+	pthread_cleanup_push(unlock_wait_mutex, nullptr);
+	while (requested().load()) {		// don't touch the heap before the gc is over.
+		pthread_cond_wait(&_all_thread_wait_cond, &_all_thread_wait_mutex);
+	}
+	thread->state = Running;
+	pthread_cleanup_pop(1);
+}
@@ -0,0 +1,35 @@
+/*
+ * satb.cpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#include "runtime/satb.hpp"
+
+void Satb::enqueue(void *old_value)
+{
+	SatbBuffer *buffer = current_buffer();
+	if (buffer == nullptr) {		// not a java thread: right into the completed ones.
+		LockGuard lg(completed_lock());
+		completed().push_back(old_value);
+		return;
+	}
+	if (buffer->index == SatbBuffer::CAPACITY) {
+		flush(*buffer);
+	}
+	buffer->buf[buffer->index ++] = old_value;
+}
+
+void Satb::flush(SatbBuffer & buffer)
+{
+	if (buffer.index == 0)	return;
+	LockGuard lg(completed_lock());
+	completed().insert(completed().end(), buffer.buf, buffer.buf + buffer.index);
+	buffer.index = 0;
+}
+
+void Satb::detach()
+{
+	if (current_buffer() != nullptr) flush(*current_buffer());
+	current_buffer() = nullptr;
+}
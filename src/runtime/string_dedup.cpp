@@ -0,0 +1,45 @@
+/*
+ * string_dedup.cpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#include "runtime/string_dedup.hpp"
+#include "runtime/oop.hpp"
+#include "runtime/heap.hpp"
+#include "native/java_lang_String.hpp"
+
+size_t StringDedup::deduplicate(InstanceOop *stringoop)
+{
+	TypeArrayOop * & value = java_lang_string::value_of(stringoop);
+	if (value == nullptr)	return 0;
+	int hash = java_lang_string::hash_of(stringoop);
+	auto range = table().equal_range(hash);
+	for (auto iter = range.first; iter != range.second; ++iter) {
+		if (iter->second == value)	return 0;			// shared already.
+		if (java_lang_string::equals(iter->second, value)) {
+			size_t saved = value->get_size() + Heap::HEADER_SIZE;
+			value = iter->second;
+			Heap::post_write_barrier(stringoop);		// the shared one may be young.
+			return saved;
+		}
+	}
+	table().insert(std::make_pair(hash, value));
+	return 0;
+}
+
+size_t StringDedup::purge(Oop *(*referent)(Oop *))
+{
+	size_t purged = 0;
+	for (auto iter = table().begin(); iter != table().end(); ) {
+		Oop *now = referent((Oop *)iter->second);
+		if (now == nullptr) {
+			iter = table().erase(iter);
+			purged ++;
+		} else {
+			iter->second = (TypeArrayOop *)now;
+			++iter;
+		}
+	}
+	return purged;
+}
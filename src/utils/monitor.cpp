@@ -0,0 +1,218 @@
+/*
+ * monitor.cpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#include "utils/monitor.hpp"
+#include "utils/synchronize_wcout.hpp"
+#include <cassert>
+#include <ctime>
+
+/*===---------------- ObjectMonitor -------------------===*/
+ObjectMonitor::ObjectMonitor(void *object, ThinLock *lock, long owner, long recursions) : _object(object), _lock(lock), _owner(owner), _recursions(recursions), _entrants(0), _waiters(0)
+{
+	pthread_mutex_init(&_mutex, nullptr);
+	pthread_cond_init(&_entry_cond, nullptr);
+	pthread_cond_init(&_wait_cond, nullptr);
+}
+
+void ObjectMonitor::enter(long self)
+{
+	bool blocked = false;
+	pthread_mutex_lock(&_mutex);
+	if (_owner == self) {
+		_recursions ++;
+	} else {
+		_entrants ++;
+		if (_owner != 0 && before_blocking() != nullptr) {		// contended: tell the vm first.
+			pthread_mutex_unlock(&_mutex);
+			before_blocking()();
+			blocked = true;
+			pthread_mutex_lock(&_mutex);
+		}
+		while (_owner != 0) {
+			pthread_cond_wait(&_entry_cond, &_mutex);
+		}
+		_owner = self;
+		_recursions = 1;
+		_entrants --;
+	}
+	pthread_mutex_unlock(&_mutex);
+	if (blocked) {
+		after_blocking()();
+	}
+}
+
+void ObjectMonitor::leave(long self)
+{
+	pthread_mutex_lock(&_mutex);
+	assert(_owner == self);
+	if (-- _recursions == 0) {
+		_owner = 0;
+		pthread_cond_signal(&_entry_cond);
+	}
+	pthread_mutex_unlock(&_mutex);
+}
+
+void ObjectMonitor::wait(long self, long millis)
+{
+	if (before_blocking() != nullptr)	before_blocking()();
+	pthread_mutex_lock(&_mutex);
+	assert(_owner == self);
+	// give the monitor away for the whole wait, with all the recursions, and take it back after.
+	long recursions = _recursions;
+	_owner = 0;
+	_recursions = 0;
+	_waiters ++;
+	pthread_cond_signal(&_entry_cond);
+	if (millis == 0) {
+		pthread_cond_wait(&_wait_cond, &_mutex);
+	} else {
+		struct timespec spec;
+		clock_gettime(CLOCK_REALTIME, &spec);
+		spec.tv_sec += millis / 1000;
+		spec.tv_nsec += (millis % 1000) * 1000000;
+		if (spec.tv_nsec >= 1000000000) {
+			spec.tv_sec ++;
+			spec.tv_nsec -= 1000000000;
+		}
+		pthread_cond_timedwait(&_wait_cond, &_mutex, &spec);
+	}
+	while (_owner != 0) {
+		pthread_cond_wait(&_entry_cond, &_mutex);
+	}
+	_owner = self;
+	_recursions = recursions;
+	_waiters --;
+	pthread_mutex_unlock(&_mutex);
+	if (after_blocking() != nullptr)	after_blocking()();
+}
+
+void ObjectMonitor::notify()
+{
+	pthread_mutex_lock(&_mutex);
+	pthread_cond_signal(&_wait_cond);
+	pthread_mutex_unlock(&_mutex);
+}
+
+void ObjectMonitor::notify_all()
+{
+	pthread_mutex_lock(&_mutex);
+	pthread_cond_broadcast(&_wait_cond);
+	pthread_mutex_unlock(&_mutex);
+}
+
+bool ObjectMonitor::is_owned()
+{
+	pthread_mutex_lock(&_mutex);
+	bool owned = _owner != 0;			// 0 in `wait()` too.
+	pthread_mutex_unlock(&_mutex);
+	return owned;
+}
+
+bool ObjectMonitor::is_idle()
+{
+	pthread_mutex_lock(&_mutex);
+	bool idle = _owner == 0 && _entrants == 0 && _waiters == 0;
+	pthread_mutex_unlock(&_mutex);
+	return idle;
+}
+
+ObjectMonitor::~ObjectMonitor()
+{
+	pthread_mutex_destroy(&_mutex);
+	pthread_cond_destroy(&_entry_cond);
+	pthread_cond_destroy(&_wait_cond);
+}
+
+/*===---------------- ThinLock -------------------===*/
+ObjectMonitor *ThinLock::inflate(void *obj)
+{
+	while (true) {
+		uintptr_t w = word.load(std::memory_order_acquire);
+		if (is_inflated(w))	return monitor_of(w);
+		// the monitor takes over the thin lock as it is: maybe owned by another thread, maybe by none.
+		ObjectMonitor *monitor = new ObjectMonitor(obj, this, owner_of(w), recursions_of(w));
+		if (word.compare_exchange_strong(w, (uintptr_t)monitor | INFLATED, std::memory_order_acq_rel)) {
+#ifdef BYTECODE_DEBUG
+	sync_wcout{} << "(DEBUG) inflate the thin lock at [" << this << "] to monitor [" << monitor << "]. owner thread: [" << owner_of(w) << "]." << std::endl;
+#endif
+			LockGuard lg(monitor_table_lock());
+			monitor_table().push_back(monitor);
+			return monitor;
+		}
+		delete monitor;			// the owner changed the word in the meantime. try again.
+	}
+}
+
+void ThinLock::slow_enter(void *obj)
+{
+	long self = current_thread_id();
+	while (true) {
+		uintptr_t w = word.load(std::memory_order_acquire);
+		if (w == 0) {
+			if (word.compare_exchange_weak(w, ((uintptr_t)self << OWNER_SHIFT) | RECURSION_ONE, std::memory_order_acquire))	return;
+			continue;
+		}
+		if (is_inflated(w)) {
+			monitor_of(w)->enter(self);
+			return;
+		}
+		if (owner_of(w) == self && (w & RECURSION_MASK) != RECURSION_MASK) {		// recursive enter.
+			if (word.compare_exchange_weak(w, w + RECURSION_ONE, std::memory_order_relaxed))	return;
+			continue;
+		}
+		inflate(obj);			// contended, or too many recursions.
+	}
+}
+
+void ThinLock::leave()
+{
+	long self = current_thread_id();
+	while (true) {
+		uintptr_t w = word.load(std::memory_order_acquire);		// acquire: see the monitor made by the inflating thread.
+		if (is_inflated(w)) {
+			monitor_of(w)->leave(self);
+			return;
+		}
+		assert(owner_of(w) == self);
+		uintptr_t next = (recursions_of(w) == 1) ? 0 : w - RECURSION_ONE;
+		// a CAS, not a store: a contending thread may inflate the lock at the same time.
+		if (word.compare_exchange_weak(w, next, std::memory_order_release, std::memory_order_relaxed))	return;
+	}
+}
+
+void ThinLock::wait(void *obj, long millis)
+{
+	inflate(obj)->wait(current_thread_id(), millis);
+}
+
+void ThinLock::notify()
+{
+	uintptr_t w = word.load(std::memory_order_acquire);
+	if (!is_inflated(w))	return;		// nobody can be waiting: `wait()` inflates.
+	monitor_of(w)->notify();
+}
+
+void ThinLock::notify_all()
+{
+	uintptr_t w = word.load(std::memory_order_acquire);
+	if (!is_inflated(w))	return;
+	monitor_of(w)->notify_all();
+}
+
+bool ThinLock::is_locked()
+{
+	uintptr_t w = word.load(std::memory_order_acquire);
+	if (!is_inflated(w))	return w != 0;
+	return monitor_of(w)->is_owned();
+}
+
+void ThinLock::cleanup()
+{
+	for (ObjectMonitor *monitor : monitor_table()) {
+		delete monitor;
+	}
+	monitor_table().clear();
+}
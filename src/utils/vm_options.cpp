@@ -0,0 +1,169 @@
+/*
+ * vm_options.cpp
+ *
+ *  Created on: 2026年10月17日
+ */
+
+#include "utils/vm_options.hpp"
+#include <iostream>
+#include <algorithm>
+
+static bool parse_bool_flag(const std::string & option, const std::string & name, bool & flag)	// aux
+{
+	if (option == "-XX:+" + name) {
+		flag = true;
+		return true;
+	} else if (option == "-XX:-" + name) {
+		flag = false;
+		return true;
+	}
+	return false;
+}
+
+static bool parse_size(const std::string & option, const std::string & prefix, size_t & size)	// aux
+{
+	if (option.compare(0, prefix.size(), prefix) != 0 || option.size() == prefix.size())	return false;
+	size_t end;
+	unsigned long long value;
+	try {
+		value = std::stoull(option.substr(prefix.size()), &end);
+	} catch (...) {
+		return false;
+	}
+	std::string unit = option.substr(prefix.size() + end);
+	if (unit == "k" || unit == "K")			value <<= 10;
+	else if (unit == "m" || unit == "M")	value <<= 20;
+	else if (unit == "g" || unit == "G")	value <<= 30;
+	else if (unit != "")					return false;
+	size = value;
+	return true;
+}
+
+static bool parse_int(const std::string & option, const std::string & prefix, int & value)		// aux
+{
+	if (option.compare(0, prefix.size(), prefix) != 0 || option.size() == prefix.size())	return false;
+	size_t end;
+	try {
+		value = std::stoi(option.substr(prefix.size()), &end);
+	} catch (...) {
+		return false;
+	}
+	return end == option.size() - prefix.size();
+}
+
+bool VMOptions::parse(const std::string & option)
+{
+	if (parse_bool_flag(option, "PrintInlineCaches", print_inline_caches()))	return true;
+	if (parse_bool_flag(option, "PrintCompilation", print_compilation()))		return true;
+	if (parse_bool_flag(option, "UseTransparentHugePages", use_transparent_huge_pages()))	return true;
+	if (parse_bool_flag(option, "PrintGC", print_gc()))	return true;
+	if (parse_bool_flag(option, "HeapDumpOnOutOfMemoryError", heap_dump_on_out_of_memory_error()))	return true;
+	if (parse_bool_flag(option, "HeapDumpOnCtrlBreak", heap_dump_on_ctrl_break()))	return true;
+	if (parse_bool_flag(option, "UseStringDeduplication", use_string_deduplication()))	return true;
+	if (option.compare(0, 17, "-XX:HeapDumpPath=") == 0 && option.size() > 17) {
+		heap_dump_path() = option.substr(17);
+		return true;
+	}
+	if (option == "-Xint") {
+		use_interpreter_only() = true;
+		return true;
+	}
+	if (option == "-Xprof") {
+		profile() = true;
+		return true;
+	}
+	if (option == "-Xlog:gc" || option.compare(0, 9, "-Xlog:gc:") == 0) {		// -Xlog:gc:<file> or -Xlog:gc:file=<file>.
+		std::string file = (option.size() > 9) ? option.substr(9) : "";
+		if (file.compare(0, 5, "file=") == 0)	file = file.substr(5);
+		print_gc() = true;
+		gc_log_file() = file;
+		return true;
+	}
+	if (parse_int(option, "-XX:ParallelGCThreads=", parallel_gc_threads())) {
+		if (parallel_gc_threads() < 1) {
+			std::wcerr << "-XX:ParallelGCThreads should be at least 1." << std::endl;
+			return false;
+		}
+		return true;
+	}
+	if (parse_int(option, "-XX:InitiatingHeapOccupancyPercent=", initiating_heap_occupancy_percent())) {
+		if (initiating_heap_occupancy_percent() < 0 || initiating_heap_occupancy_percent() > 100) {
+			std::wcerr << "-XX:InitiatingHeapOccupancyPercent should be between 0 and 100." << std::endl;
+			return false;
+		}
+		return true;
+	}
+	if (parse_int(option, "-XX:SoftRefLRUPolicyMSPerMB=", soft_ref_lru_policy_ms_per_mb())) {
+		if (soft_ref_lru_policy_ms_per_mb() < 0) {
+			std::wcerr << "-XX:SoftRefLRUPolicyMSPerMB should not be negative." << std::endl;
+			return false;
+		}
+		return true;
+	}
+	if (parse_size(option, "-Xss", thread_stack_size())) {
+		if (thread_stack_size() < 128 * 1024) {
+			std::wcerr << "the java stack is too small: -Xss should be at least 128k." << std::endl;
+			return false;
+		}
+		return true;
+	}
+	if (parse_size(option, "-Xmx", max_heap_size()))	return true;
+	if (parse_size(option, "-Xms", initial_heap_size()))	return true;
+	if (parse_size(option, "-Xmn", young_size()))	return true;
+	return false;
+}
+
+int VMOptions::parallel_gc_threads_for(int cpus)
+{
+	// all of the first 8 cpus, then 5/8 of the rest: the pause stops getting shorter before the workers run out of cpus.
+	if (parallel_gc_threads() != 0)	return parallel_gc_threads();
+	if (cpus <= 8)	return cpus < 1 ? 1 : cpus;
+	return 8 + (cpus - 8) * 5 / 8;
+}
+
+bool VMOptions::heap_sizes(size_t & initial, size_t & max, size_t & young)
+{
+	// the options may come in any order: checked together, after all of them are parsed.
+	const size_t min_young = 4 * 1024 * 1024, min_old = 4 * 1024 * 1024;
+	max = max_heap_size();
+	young = young_size() != 0 ? young_size() : max / 3;
+	if (young < min_young) {
+		std::wcerr << "the young generation is too small: -Xmn should be at least 4m, and -Xmx at least 12m." << std::endl;
+		return false;
+	}
+	if (young + min_old > max) {
+		std::wcerr << "-Xmn should be smaller than -Xmx by 4m at least: the old generation needs some room." << std::endl;
+		return false;
+	}
+	initial = initial_heap_size() != 0 ? initial_heap_size() : std::min(young + 64 * 1024 * 1024, max);
+	if (initial > max) {
+		std::wcerr << "-Xms should not be bigger than -Xmx." << std::endl;
+		return false;
+	}
+	initial = std::max(initial, young + min_old);
+	return true;
+}
+
+void VMOptions::print_usage()
+{
+	std::wcerr << "usage: wind_jvm [-options] <main class>" << std::endl;
+	std::wcerr << "options:" << std::endl;
+	std::wcerr << "    -Xint                     interpret all the methods, without the jit." << std::endl;
+	std::wcerr << "    -Xprof                    print the invocations, loop iterations and sampled cpu time of the hot methods at exit or on SIGQUIT." << std::endl;
+	std::wcerr << "    -Xss<size>                the java stack size of every thread, e.g. -Xss2m. default is 1m." << std::endl;
+	std::wcerr << "    -Xmx<size>                the maximum heap size. default is 768m." << std::endl;
+	std::wcerr << "    -Xms<size>                the initial heap size: the heap grows and shrinks between it and -Xmx. default is -Xmn + 64m." << std::endl;
+	std::wcerr << "    -Xmn<size>                the young generation size. default is a third of -Xmx." << std::endl;
+	std::wcerr << "    -XX:+PrintInlineCaches    dump the inline caches of all the invokevirtual/invokeinterface sites at exit." << std::endl;
+	std::wcerr << "    -XX:+PrintCompilation     print a line when a method is compiled by the jit." << std::endl;
+	std::wcerr << "    -XX:+UseTransparentHugePages  back the java heap with transparent huge pages." << std::endl;
+	std::wcerr << "    -XX:ParallelGCThreads=<n>  the gc worker threads. default is decided by the cpus." << std::endl;
+	std::wcerr << "    -XX:+PrintGC              log every gc pause (cause, phases, generations before and after, promotion) and concurrent phase, and the totals at exit." << std::endl;
+	std::wcerr << "    -Xlog:gc[:<file>]         the same as -XX:+PrintGC, into <file> if given." << std::endl;
+	std::wcerr << "    -XX:+HeapDumpOnOutOfMemoryError  write an hprof heap dump when the first OutOfMemoryError is thrown." << std::endl;
+	std::wcerr << "    -XX:+HeapDumpOnCtrlBreak  write an hprof heap dump on SIGQUIT." << std::endl;
+	std::wcerr << "    -XX:HeapDumpPath=<path>   the file or the directory of the heap dumps. default is java_pid<pid>.hprof in the working directory." << std::endl;
+	std::wcerr << "    -XX:+UseStringDeduplication  let the Strings promoted into the old generation share their equal char[]s. the bytes saved are in the gc log." << std::endl;
+	std::wcerr << "    -XX:SoftRefLRUPolicyMSPerMB=<n>  keep a SoftReference not used for n ms per MB free in the heap. 0: clear them at every gc. default is 1000." << std::endl;
+	std::wcerr << "    -XX:InitiatingHeapOccupancyPercent=<n>  start marking the old generation concurrently when it is n% full. default is 45." << std::endl;
+}
@@ -12,6 +12,12 @@
 #include "native/native.hpp"
 #include "system_directory.hpp"
 #include "classloader.hpp"
+#include "runtime/inline_cache.hpp"
+#include "runtime/jit.hpp"
+#include "runtime/profiler.hpp"
+#include "runtime/gc_log.hpp"
+#include "runtime/heap_dump.hpp"
+#include "utils/vm_options.hpp"
 #include "runtime/thread.hpp"
 #include <regex>
 #include "utils/synchronize_wcout.hpp"
@@ -26,9 +32,10 @@ void * scapegoat (void *pp) {
 //	if (real->cur_thread_obj != nullptr) {		// so the ThreadTable::get_thread_obj may be nullptr.		// I add all thread into Table due to gc should stop all threads.
 		ThreadTable::add_a_thread(pthread_self(), real->cur_thread_obj, real->thread);		// the cur_thread_obj is from `java/lang/Thread.start0()`.
 //	}
+	Safepoint::attach(real->thread);
 
 	if (real->should_be_stop_first) {		// if this thread is a child thread created by `start0`: should stop it first because of gc's race.
-		// it will be hung up at the `global pthread_cond`. and will be wake up by `signal_all_thread()`.
+		// it will be hung up at the `global pthread_cond` if a gc is in progress, and will be wake up by `Safepoint::end()`.
 		wait_cur_thread_and_set_bit(&real->the_first_wait_executed, real->thread);
 	}
 
@@ -57,8 +64,6 @@ void vm_thread::launch(InstanceOop *cur_thread_obj)
 
 		pthread_join(tid, nullptr);
 
-		GC::signal_all_patch();
-
 		int remain_thread_num;
 		while(true) {
 			wind_jvm::num_lock().lock();
@@ -89,6 +94,11 @@ void vm_thread::launch(InstanceOop *cur_thread_obj)
 
 void vm_thread::start(list<Oop *> & arg)
 {
+	vm_stack.init(VMOptions::thread_stack_size());
+	Profiler::attach(this);
+	Heap::attach(&this->tlab);
+	Satb::attach(&this->satb);
+
 	if (wind_jvm::inited() == false) {
 		assert(method == nullptr);			// if this is the init thread, method will be nullptr. this thread will get `main()` automatically.
 		assert(arg.size() == 0);
@@ -101,8 +111,10 @@ void vm_thread::start(list<Oop *> & arg)
 		assert(this->vm_stack.size() == 0);	// check
 		assert(arg.size() == 1);				// run() only has one argument `this`.
 
-		this->vm_stack.push_back(StackFrame(method, nullptr, nullptr, arg, this));
+		this->vm_stack.push_frame(method, nullptr, nullptr, arg);
 		this->execute();
+		Heap::detach();			// before the count down: the vm may end and walk the heap at once.
+		Satb::detach();
 
 		wind_jvm::num_lock().lock();
 		{
@@ -112,9 +124,13 @@ void vm_thread::start(list<Oop *> & arg)
 		wind_jvm::num_lock().unlock();
 	}
 
-	pthread_mutex_lock(&_all_thread_wait_mutex);
-	this->state = Death;
-	pthread_mutex_unlock(&_all_thread_wait_mutex);
+	Safepoint::set_dead(this);
+
+	Profiler::detach();
+	Heap::detach();
+	Satb::detach();
+	Safepoint::detach();
+	vm_stack.destroy();
 }
 
 Oop *vm_thread::execute()
@@ -141,10 +157,9 @@ Oop *vm_thread::execute()
 				// do nothing
 			} else {
 				all_jvm_return_value = return_val;
-				cur_frame.op_stack.push(return_val);
 			}
 		}
-		vm_stack.pop_back();	// another half push_back() is in wind_jvm() constructor.
+		vm_stack.pop_frame();	// another half push_frame() is in `start()` and `init_and_do_main()`.
 	}
 	return all_jvm_return_value;
 }
@@ -153,9 +168,9 @@ Oop * vm_thread::add_frame_and_execute(Method *new_method, const std::list<Oop *
 	// for defense:
 	int frame_num = this->vm_stack.size();
 	uint8_t *backup_pc = this->pc;
-	this->vm_stack.push_back(StackFrame(new_method, this->pc, nullptr, list, this));
-	Oop * result = BytecodeEngine::execute(*this, this->vm_stack.back(), this->thread_no);
-	this->vm_stack.pop_back();
+	StackFrame & new_frame = this->vm_stack.push_frame(new_method, this->pc, nullptr, list);
+	Oop * result = BytecodeEngine::execute(*this, new_frame, this->thread_no);
+	this->vm_stack.pop_frame();
 	this->pc = backup_pc;
 	assert(frame_num == this->vm_stack.size());
 	return result;
@@ -167,7 +182,7 @@ MirrorOop *vm_thread::get_caller_class_CallerSensitive()
 	int level = 0;
 	int total_levelnum = this->vm_stack.size();
 	Method *m;
-	for (list<StackFrame>::reverse_iterator it = this->vm_stack.rbegin(); it != this->vm_stack.rend(); ++it, ++level) {
+	for (StackFrame *it = this->vm_stack.top_frame(); it != nullptr; it = it->link, ++level) {
 		m = it->method;
 		if (level == 0 || level == 1) {
 			// if level == 0, this method must be `getCallerClass`.
@@ -305,7 +320,7 @@ void vm_thread::init_and_do_main()
 	// new a String.
 	InstanceOop *main_klass = (InstanceOop *)java_lang_string::intern(wind_jvm::main_class_name());
 
-	this->vm_stack.push_back(StackFrame(load_main_method, nullptr, nullptr, {new IntOop(true), new IntOop(1), main_klass}, this));
+	this->vm_stack.push_frame(load_main_method, nullptr, nullptr, {new IntOop(true), new IntOop(1), main_klass});
 	MirrorOop *main_class_mirror = (MirrorOop *)this->execute();
 	assert(main_class_mirror->get_ooptype() == OopType::_InstanceOop);
 
@@ -332,7 +347,7 @@ void vm_thread::init_and_do_main()
 	}
 
 	// The World's End!
-	this->vm_stack.push_back(StackFrame(main_method, nullptr, nullptr, {string_arr_oop}, this));
+	this->vm_stack.push_frame(main_method, nullptr, nullptr, {string_arr_oop});
 	this->execute();
 
 }
@@ -350,7 +365,7 @@ ArrayOop * vm_thread::get_stack_trace()
 
 	uint8_t *last_frame_pc = this->pc;
 	int i = 0;
-	for (list<StackFrame>::reverse_iterator it = this->vm_stack.rbegin(); it != this->vm_stack.rend(); ++it) {
+	for (StackFrame *it = this->vm_stack.top_frame(); it != nullptr; it = it->link) {
 		Method *m = it->method;
 		auto klass_name = java_lang_string::intern(m->get_klass()->get_name());
 		auto method_name = java_lang_string::intern(m->get_name());
@@ -384,14 +399,12 @@ ArrayOop * vm_thread::get_stack_trace()
 
 #ifdef DEBUG
 	ss << "[backtrace " << this->vm_stack.size() - i - 1 << "] pc: [" << last_pc_debug << "], at <" << m->get_klass()->get_name() << ">::[" << m->get_name() << ":" << m->get_descriptor() << "], at [" << m->get_klass()->get_source_file_name() << "], line [" << line_num << "]." << std::endl;
-	int j = 1;
-	for (Oop * value : it->localVariableTable) {
-		ss << "    the localVariableTable[" << j-1 << "] is " << it->print_arg_msg(value, this) << std::endl;
-		if (value != nullptr && value->get_ooptype() == OopType::_BasicTypeOop
-						&& ((((BasicTypeOop *)value)->get_type() == Type::LONG) || (((BasicTypeOop *)value)->get_type() == Type::DOUBLE))) {
-			j ++;		// jump. because `long` and `double` take 2 places.
+	for (int j = 0; j < it->localVariableTable.size(); j ++) {
+		if (it->localVariableTable.is_ref(j)) {
+			ss << "    the localVariableTable[" << j << "] is " << it->print_arg_msg(it->localVariableTable.get_ref(j), this) << std::endl;
+		} else {
+			ss << "    the localVariableTable[" << j << "] is raw slot: [" << it->localVariableTable.slots[j].raw << "]" << std::endl;
 		}
-		j ++;
 	}
 #endif
 
@@ -412,52 +425,18 @@ ArrayOop * vm_thread::get_stack_trace()
 
 void vm_thread::set_exception_at_last_second_frame() {
 	assert(this->vm_stack.size() >= 2);
-	auto iter = this->vm_stack.rbegin();
-	++iter;							// get cur_frame's prev...
-	iter->has_exception = true;
+	this->vm_stack.back().link->has_exception = true;		// get cur_frame's prev...
 }
 
 pthread_mutex_t _all_thread_wait_mutex;
 pthread_cond_t _all_thread_wait_cond;
 
-void wait_cur_thread(vm_thread *thread)
-{
-	pthread_mutex_lock(&_all_thread_wait_mutex);
-	thread->set_state(Waiting);
-	while (true) {
-		bool gc;
-		GC::gc_lock().lock();
-		{
-			gc = GC::gc();
-		}
-		GC::gc_lock().unlock();
-
-		if (gc) {
-			pthread_cond_wait(&_all_thread_wait_cond, &_all_thread_wait_mutex);
-			pthread_testcancel();
-		} else {
-			break;
-		}
-
-	}
-	thread->set_state(Running);
-	pthread_mutex_unlock(&_all_thread_wait_mutex);
-}
-
 void wait_cur_thread_and_set_bit(volatile bool *bit, vm_thread *thread)
 {
 	pthread_mutex_lock(&_all_thread_wait_mutex);
 	*bit = true;
-	thread->set_state(Waiting);
-	pthread_cond_wait(&_all_thread_wait_cond, &_all_thread_wait_mutex);
-	pthread_testcancel();
-	thread->set_state(Running);
 	pthread_mutex_unlock(&_all_thread_wait_mutex);
-}
-
-void signal_one_thread()
-{
-	pthread_cond_signal(&_all_thread_wait_cond);
+	Safepoint::block(thread);		// only waits if a gc is in progress.
 }
 
 void signal_all_thread()
@@ -482,6 +461,7 @@ void SIGINT_handler(int signo)
 			GC::gc_lock().lock();
 			{
 				GC::gc() = true;
+				Safepoint::begin();
 			}
 			GC::gc_lock().unlock();
 
@@ -500,9 +480,66 @@ void SIGINT_handler(int signo)
 
 }
 
+static void print_gc_summary()
+{
+	std::wostringstream summary;
+	GC::print_summary(summary);
+	GCLog::write(summary.str());
+}
+
+void *SIGQUIT_thread(void *)		// `kill -3`: the method profile (-Xprof), the gc summary (-XX:+PrintGC, -Xlog:gc) and the heap dump (-XX:+HeapDumpOnCtrlBreak) on demand.
+{
+	sigset_t set;
+	sigemptyset(&set);
+	sigaddset(&set, SIGQUIT);
+	while (true) {
+		int signo;
+		if (sigwait(&set, &signo) == 0 && signo == SIGQUIT) {
+			if (VMOptions::profile()) {
+				Profiler::dump(std::wcout);
+			}
+			if (VMOptions::print_gc()) {
+				print_gc_summary();
+			}
+			if (VMOptions::heap_dump_on_ctrl_break()) {
+				HeapDump::request(HeapDump::default_path());
+			}
+		}
+	}
+	return nullptr;
+}
+
 void wind_jvm::run(const wstring & main_class_name, const vector<wstring> & argv)
 {
 	signal(SIGINT, SIGINT_handler);
+	ObjectMonitor::before_blocking() = Safepoint::enter_blocked;		// a thread blocked in a monitor is safe for the gc.
+	ObjectMonitor::after_blocking() = Safepoint::leave_blocked;
+	size_t initial_heap_size, max_heap_size, young_size;
+	if (!VMOptions::heap_sizes(initial_heap_size, max_heap_size, young_size)) {
+		exit(-1);
+	}
+	if (!Heap::init(initial_heap_size, max_heap_size, young_size, VMOptions::use_transparent_huge_pages())) {
+		std::wcerr << "could not reserve the java heap." << std::endl;
+		exit(-1);
+	}
+	Heap::on_eden_full() = GC::request_gc;		// a minor gc at the next safepoint.
+	if (VMOptions::print_gc() && !GCLog::open(VMOptions::gc_log_file())) {
+		std::wcerr << "could not open the gc log: " << utf8_to_wstring(VMOptions::gc_log_file()) << std::endl;
+		exit(-1);
+	}
+	if (VMOptions::profile() || VMOptions::print_gc() || VMOptions::heap_dump_on_ctrl_break()) {
+		// SIGQUIT is blocked in all the threads, which inherit the mask from this one, and is waited for by a thread of its own.
+		sigset_t set;
+		sigemptyset(&set);
+		sigaddset(&set, SIGQUIT);
+		pthread_sigmask(SIG_BLOCK, &set, nullptr);
+		pthread_t tid;
+		pthread_create(&tid, nullptr, SIGQUIT_thread, nullptr);
+		pthread_detach(tid);
+	}
+	if (VMOptions::profile()) {
+		Profiler::start();
+	}
 
 	wind_jvm::main_class_name() = std::regex_replace(main_class_name, std::wregex(L"\\."), L"/");
 	wind_jvm::argv() = const_cast<vector<wstring> &>(argv);
@@ -528,6 +565,21 @@ void wind_jvm::run(const wstring & main_class_name, const vector<wstring> & argv
 
 void wind_jvm::end()
 {
+	if (VMOptions::profile()) {
+		Profiler::stop();
+		Profiler::dump(std::wcout);
+	}
+	if (VMOptions::print_inline_caches()) {
+		InlineCache::dump(std::wcout);
+	}
+	if (VMOptions::print_gc()) {
+		print_gc_summary();
+		GCLog::close();
+	}
+	InlineCache::cleanup();
+	Jit::cleanup();
+	ThinLock::cleanup();
+
 	Method_Pool::cleanup();
 	Field_Pool::cleanup();
 
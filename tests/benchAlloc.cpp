@@ -0,0 +1,77 @@
+/*
+ * benchAlloc.cpp
+ *
+ * micro benchmark of the oop allocation path with 1, 4 and 16 threads.
+ * every thread allocates the same number of small objects (the size of an `IntOop`) with:
+ *   1. malloc + memset + push to a global list under a global lock (the old `MemAlloc::allocate`).
+ *   2. a bump pointer in the thread's own tlab, refilled from the shared eden top with a CAS (`Heap::allocate`).
+ */
+
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <list>
+#include <mutex>
+#include <cstdlib>
+#include <cstring>
+#include "runtime/heap.hpp"
+
+using std::chrono::steady_clock;
+using std::chrono::duration_cast;
+using std::chrono::nanoseconds;
+
+static const int ALLOC_PER_THREAD = 500000;
+static const size_t OBJ_SIZE = 32;
+
+static std::mutex list_lock;
+static std::list<void *> all_objs;
+
+void malloc_and_list()
+{
+	for (int i = 0; i < ALLOC_PER_THREAD; i ++) {
+		void *ptr = malloc(OBJ_SIZE);
+		memset(ptr, 0, OBJ_SIZE);
+		std::lock_guard<std::mutex> lg(list_lock);
+		all_objs.push_back(ptr);
+	}
+}
+
+void tlab()
+{
+	Tlab tlab;
+	Heap::attach(&tlab);
+	for (int i = 0; i < ALLOC_PER_THREAD; i ++) {
+		if (Heap::allocate(OBJ_SIZE) == nullptr)	abort();
+	}
+	Heap::detach();
+}
+
+double run(void (*func)(), int thread_num)		// returns million allocations per second.
+{
+	std::vector<std::thread> threads;
+	auto start = steady_clock::now();
+	for (int i = 0; i < thread_num; i ++) {
+		threads.emplace_back(func);
+	}
+	for (auto & thread : threads) {
+		thread.join();
+	}
+	long ns = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+	return (double)ALLOC_PER_THREAD * thread_num * 1000 / ns;
+}
+
+int main()
+{
+	if (!Heap::init(1536 * 1024 * 1024UL, 1536 * 1024 * 1024UL, 1024 * 1024 * 1024, false))	abort();		// eden holds all of one run.
+	std::cout << "threads   malloc+lock+list   tlab       (M allocations/s)" << std::endl;
+	for (int thread_num : {1, 4, 16}) {
+		double old_rate = run(malloc_and_list, thread_num);
+		for (void *ptr : all_objs)	free(ptr);
+		all_objs.clear();
+		double tlab_rate = run(tlab, thread_num);
+		Heap::end_minor_gc();		// nothing is alive: start over with an empty eden.
+		std::cout << thread_num << "\t  " << old_rate << "\t\t     " << tlab_rate << std::endl;
+	}
+	Heap::cleanup();
+}
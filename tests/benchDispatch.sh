@@ -0,0 +1,33 @@
+#!/bin/sh
+#
+# benchDispatch.sh
+#
+# the dispatch cost of the real interpreter, `BytecodeEngine::execute`: builds wind_jvm twice with the top Makefile, with
+# computed goto (the default) and with -DSWITCH_DISPATCH, and runs the counting loop of BenchDispatch.java on both with
+# -Xint, so the jit doesn't take it over. run it at the wind_jvm folder: ./tests/benchDispatch.sh [times]
+#
+
+set -e
+TIMES=${1:-5}
+OUT=$(mktemp -d)
+
+javac -cp . BenchDispatch.java
+for dispatch in goto switch; do
+	if [ $dispatch = switch ]; then
+		FLAGS="-std=c++14 -O3 -DSWITCH_DISPATCH"
+	else
+		FLAGS="-std=c++14 -O3"
+	fi
+	make clean
+	make -j"$(nproc)" all CPP_FLAGS="$FLAGS" LINK_FLAGS="-std=c++14" > /dev/null
+	cp bin/wind_jvm "$OUT/wind_jvm_$dispatch"
+done
+make clean
+
+for dispatch in goto switch; do
+	echo "$dispatch:"
+	for i in $(seq "$TIMES"); do
+		"$OUT/wind_jvm_$dispatch" -Xint BenchDispatch
+	done
+done
+rm -rf "$OUT"